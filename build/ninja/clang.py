@@ -456,8 +456,13 @@ class ClangToolchain(toolchain.Toolchain):
       localvariables += [('cconfigflags', cconfigflags)]
     if self.target.is_android():
       localvariables += [('sysroot', self.android.make_sysroot_path(arch))]
+    cmoreflags = []
     if 'defines' in variables:
-      localvariables += [('cmoreflags', ['-D' + define for define in variables['defines']])]
+      cmoreflags += ['-D' + define for define in variables['defines']]
+    if 'cflags' in variables:
+      cmoreflags += list(variables['cflags'])
+    if cmoreflags != []:
+      localvariables += [('cmoreflags', cmoreflags)]
     return localvariables
 
   def ar_variables(self, config, arch, targettype, variables):
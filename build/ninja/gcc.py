@@ -267,8 +267,13 @@ class GCCToolchain(toolchain.Toolchain):
     cconfigflags = self.make_cconfigflags(config, targettype)
     if cconfigflags != []:
       localvariables += [('cconfigflags', cconfigflags)]
+    cmoreflags = []
     if 'defines' in variables:
-      localvariables += [('cmoreflags', ['-D' + define for define in variables['defines']])]
+      cmoreflags += ['-D' + define for define in variables['defines']]
+    if 'cflags' in variables:
+      cmoreflags += list(variables['cflags'])
+    if cmoreflags != []:
+      localvariables += [('cmoreflags', cmoreflags)]
     return localvariables
 
   def ar_variables(self, config, arch, targettype, variables):
@@ -349,11 +349,14 @@ class MSVCToolchain(toolchain.Toolchain):
     cconfigflags = self.make_cconfigflags(config, targettype)
     if cconfigflags != []:
       localvariables += [('cconfigflags', cconfigflags)]
+    cmoreflags = []
     if 'defines' in variables:
-      definelist = []
       for define in variables['defines']:
-        definelist += ['/D', '"' + define + '"']
-      localvariables += [('cmoreflags', definelist)]
+        cmoreflags += ['/D', '"' + define + '"']
+    if 'cflags' in variables:
+      cmoreflags += list(variables['cflags'])
+    if cmoreflags != []:
+      localvariables += [('cmoreflags', cmoreflags)]
     return localvariables
 
   def ar_variables(self, config, arch, targettype, variables):
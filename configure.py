@@ -16,8 +16,21 @@ target = generator.target
 writer = generator.writer
 toolchain = generator.toolchain
 
-vector_lib = generator.lib(module = 'vector', sources = [
-  'euler.c', 'vector.c', 'version.c'])
+vector_sources = [
+  'animation.c', 'arena.c', 'batch.c', 'broadphase.c', 'bvh.c', 'convex.c', 'decompose.c', 'euler.c',
+  'half.c', 'hashgrid.c', 'ik.c', 'job.c', 'mesh.c', 'morton.c', 'obb.c', 'pack.c', 'particle.c',
+  'pose.c', 'projection.c', 'registration.c', 'rigid.c', 'soa.c', 'vector.c', 'vector64.c',
+  'version.c']
+
+vector_lib = generator.lib(module = 'vector', sources = vector_sources)
+
+#Deterministic mode library, code using it must be built with the same define and floating point flags
+if toolchain.name() == 'msvc':
+  deterministic_flags = ['/fp:precise']
+else:
+  deterministic_flags = ['-fno-unsafe-math-optimizations', '-ffp-contract=off']
+deterministic_variables = {'defines': ['VECTOR_DETERMINISTIC=1'], 'cflags': deterministic_flags}
+vector_deterministic_lib = generator.lib(module = 'vector', sources = vector_sources, libname = 'vector_deterministic', variables = deterministic_variables)
 
 if not target.is_ios() and not target.is_android() and not target.is_tizen():
   configs = [config for config in toolchain.configs if config not in ['profile', 'deploy']]
@@ -30,8 +43,10 @@ if generator.skip_tests():
 includepaths = generator.test_includepaths()
 
 test_cases = [
-  'matrix', 'quaternion', 'vector'
+  'animation', 'arena', 'broadphase', 'bvh', 'convex', 'cpp', 'decompose', 'half', 'hashgrid', 'ik', 'job', 'matrix', 'mesh', 'morton', 'obb', 'pack', 'particle', 'pose', 'projection', 'quaternion', 'registration', 'rigid', 'soa', 'vector', 'vector64'
 ]
+#Test cases written in C++ instead of C
+test_sources = {'cpp': 'main.cpp'}
 if toolchain.is_monolithic() or target.is_ios() or target.is_android() or target.is_tizen():
   #Build one fat binary with all test cases
   test_resources = []
@@ -55,13 +70,15 @@ if toolchain.is_monolithic() or target.is_ios() or target.is_android() or target
     ]]
   dependlibs = ['test'] + dependlibs
   if target.is_macos() or target.is_ios() or target.is_android() or target.is_tizen():
-    generator.app(module = '', sources = [os.path.join(module, 'main.c') for module in test_cases] + test_extrasources, binname = 'test-vector', basepath = 'test', libs = dependlibs, dependlibs = dependlibs, resources = test_resources, includepaths = includepaths)
+    generator.app(module = '', sources = [os.path.join(module, test_sources.get(module, 'main.c')) for module in test_cases] + test_extrasources, binname = 'test-vector', basepath = 'test', libs = dependlibs, dependlibs = dependlibs, resources = test_resources, includepaths = includepaths)
   else:
-    generator.bin(module = '', sources = [os.path.join(module, 'main.c') for module in test_cases] + test_extrasources, binname = 'test-vector', basepath = 'test', libs = dependlibs, dependlibs = dependlibs, resources = test_resources, includepaths = includepaths)
+    generator.bin(module = '', sources = [os.path.join(module, test_sources.get(module, 'main.c')) for module in test_cases] + test_extrasources, binname = 'test-vector', basepath = 'test', libs = dependlibs, dependlibs = dependlibs, resources = test_resources, includepaths = includepaths)
 else:
   #Build one binary per test case
   if not generator.is_subninja():
     generator.bin(module = 'all', sources = ['main.c'], binname = 'test-all', basepath = 'test', implicit_deps = [vector_lib], dependlibs = dependlibs, includepaths = includepaths)
   dependlibs = ['test'] + dependlibs
   for test in test_cases:
-    generator.bin(module = test, sources = ['main.c'], binname = 'test-' + test, basepath = 'test', implicit_deps = [vector_lib], dependlibs = dependlibs, includepaths = includepaths)
+    generator.bin(module = test, sources = [test_sources.get(test, 'main.c')], binname = 'test-' + test, basepath = 'test', implicit_deps = [vector_lib], dependlibs = dependlibs, includepaths = includepaths)
+  #Deterministic test is built and linked with the deterministic mode library
+  generator.bin(module = 'deterministic', sources = ['main.c'], binname = 'test-deterministic', basepath = 'test', implicit_deps = [vector_deterministic_lib], dependlibs = ['test', 'vector_deterministic', 'foundation'], includepaths = includepaths, variables = deterministic_variables)
@@ -184,11 +184,55 @@ main_initialize(void) {
 
 #if BUILD_MONOLITHIC
 extern int
+test_animation_run(void);
+extern int
+test_arena_run(void);
+extern int
+test_broadphase_run(void);
+extern int
+test_bvh_run(void);
+extern int
+test_convex_run(void);
+extern int
+test_cpp_run(void);
+extern int
+test_decompose_run(void);
+extern int
+test_half_run(void);
+extern int
+test_hashgrid_run(void);
+extern int
+test_ik_run(void);
+extern int
+test_job_run(void);
+extern int
 test_matrix_run(void);
 extern int
+test_mesh_run(void);
+extern int
+test_morton_run(void);
+extern int
+test_obb_run(void);
+extern int
+test_pack_run(void);
+extern int
+test_particle_run(void);
+extern int
+test_pose_run(void);
+extern int
+test_projection_run(void);
+extern int
 test_quaternion_run(void);
 extern int
+test_registration_run(void);
+extern int
+test_rigid_run(void);
+extern int
+test_soa_run(void);
+extern int
 test_vector_run(void);
+extern int
+test_vector64_run(void);
 typedef int (*test_run_fn)(void);
 
 static void*
@@ -270,7 +314,7 @@ main_run(void* main_arg) {
 
 #if BUILD_MONOLITHIC
 
-	test_run_fn tests[] = {test_matrix_run, test_quaternion_run, test_vector_run, 0};
+	test_run_fn tests[] = {test_animation_run, test_arena_run, test_broadphase_run, test_bvh_run, test_convex_run, test_cpp_run, test_decompose_run, test_half_run, test_hashgrid_run, test_ik_run, test_job_run, test_matrix_run, test_mesh_run, test_morton_run, test_obb_run, test_pack_run, test_particle_run, test_pose_run, test_projection_run, test_quaternion_run, test_registration_run, test_rigid_run, test_soa_run, test_vector_run, test_vector64_run, 0};
 
 #if FOUNDATION_PLATFORM_ANDROID
 
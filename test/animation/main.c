@@ -0,0 +1,300 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_animation_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Animation tests"));
+	app.short_name = string_const(STRING_CONST("test_animation"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_animation_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_animation_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_animation_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_animation_finalize(void) {
+	vector_module_finalize();
+}
+
+#define ANIMATION_TEST_FRAMES 61
+#define ANIMATION_TEST_BONES 70
+#define ANIMATION_TEST_RATE REAL_C(30.0)
+#define ANIMATION_TEST_ROTATION_TOLERANCE REAL_C(0.002)
+#define ANIMATION_TEST_TRANSLATION_TOLERANCE REAL_C(0.001)
+
+static quaternion_t
+animation_test_axis_angle(const vector_t axis, real angle) {
+	const real s = math_sin(angle * REAL_C(0.5));
+	return vector(vector_x(axis) * s, vector_y(axis) * s, vector_z(axis) * s, math_cos(angle * REAL_C(0.5)));
+}
+
+//! Reference transform of bone at time, three kinds of bones repeated
+static transform_t
+animation_test_transform(size_t bone, real time) {
+	transform_t transform;
+	switch (bone % 3) {
+		case 0:
+			// Accelerating rotation, linear translation, constant scale
+			transform.rotation = animation_test_axis_angle(vector(0, 0, 1, 0), time * time * REAL_C(0.5));
+			transform.translation = vector(1 + time, 2, -time, 1);
+			break;
+		case 1:
+			// Constant rotation and translation, linear scale
+			transform.rotation = quaternion_identity();
+			transform.translation = vector(3, (real)bone, 0, REAL_C(1.0) + (time * REAL_C(0.5)));
+			break;
+		default:
+			// Constant rotation with sign alternating between frames
+			transform.rotation = animation_test_axis_angle(vector(1, 0, 0, 0), REAL_C(0.75));
+			if ((int)(time * ANIMATION_TEST_RATE + REAL_C(0.5)) & 1)
+				transform.rotation = quaternion_neg(transform.rotation);
+			transform.translation = vector(0, 0, 0, 2);
+			break;
+	}
+	return transform;
+}
+
+static transform_t*
+animation_test_frames(void) {
+	transform_t* frames = memory_allocate(
+	    HASH_TEST, sizeof(transform_t) * ANIMATION_TEST_FRAMES * ANIMATION_TEST_BONES, 16, MEMORY_PERSISTENT);
+	for (size_t iframe = 0; iframe < ANIMATION_TEST_FRAMES; ++iframe) {
+		for (size_t ibone = 0; ibone < ANIMATION_TEST_BONES; ++ibone)
+			frames[(iframe * ANIMATION_TEST_BONES) + ibone] =
+			    animation_test_transform(ibone, (real)iframe / ANIMATION_TEST_RATE);
+	}
+	return frames;
+}
+
+static real
+animation_test_rotation_error(const quaternion_t q, const quaternion_t reference) {
+	const real same = vector_x(vector_length(vector_sub(q, reference)));
+	const real opposite = vector_x(vector_length(vector_add(q, reference)));
+	return 2 * ((same < opposite) ? same : opposite);
+}
+
+DECLARE_TEST(animation, reduce) {
+	transform_t* frames = animation_test_frames();
+	animation_clip_t clip;
+	animation_clip_initialize(&clip, frames, ANIMATION_TEST_FRAMES, ANIMATION_TEST_BONES, ANIMATION_TEST_RATE,
+	                          ANIMATION_TEST_ROTATION_TOLERANCE, ANIMATION_TEST_TRANSLATION_TOLERANCE);
+
+	EXPECT_UINTEQ(clip.bone_count, ANIMATION_TEST_BONES);
+	EXPECT_UINTEQ(clip.frame_count, ANIMATION_TEST_FRAMES);
+	EXPECT_REALEQ(clip.duration, REAL_C(2.0));
+
+	for (size_t ibone = 0; ibone < ANIMATION_TEST_BONES; ++ibone) {
+		const animation_track_t* track = clip.track + ibone;
+		const uint16_t* rotation_frame = clip.frame[ANIMATION_ROTATION] + track->key[ANIMATION_ROTATION];
+		EXPECT_UINTEQ(rotation_frame[0], 0);
+		if ((ibone % 3) == 0) {
+			EXPECT_INTGT(track->key_count[ANIMATION_ROTATION], 2);
+			EXPECT_INTLT(track->key_count[ANIMATION_ROTATION], ANIMATION_TEST_FRAMES / 2);
+			EXPECT_UINTEQ(rotation_frame[track->key_count[ANIMATION_ROTATION] - 1], ANIMATION_TEST_FRAMES - 1);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_TRANSLATION], 2);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_SCALE], 1);
+		} else if ((ibone % 3) == 1) {
+			EXPECT_UINTEQ(track->key_count[ANIMATION_ROTATION], 1);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_TRANSLATION], 1);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_SCALE], 2);
+		} else {
+			EXPECT_UINTEQ(track->key_count[ANIMATION_ROTATION], 1);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_TRANSLATION], 1);
+			EXPECT_UINTEQ(track->key_count[ANIMATION_SCALE], 1);
+		}
+	}
+	EXPECT_INTLT(animation_clip_key_count(&clip), (size_t)ANIMATION_TEST_BONES * 3 * ANIMATION_TEST_FRAMES / 10);
+
+	animation_clip_finalize(&clip);
+	memory_deallocate(frames);
+	return 0;
+}
+
+DECLARE_TEST(animation, sample) {
+	transform_t* frames = animation_test_frames();
+	transform_t* pose = memory_allocate(HASH_TEST, sizeof(transform_t) * ANIMATION_TEST_BONES, 16, MEMORY_PERSISTENT);
+	animation_clip_t clip;
+	animation_clip_initialize(&clip, frames, ANIMATION_TEST_FRAMES, ANIMATION_TEST_BONES, ANIMATION_TEST_RATE,
+	                          ANIMATION_TEST_ROTATION_TOLERANCE, ANIMATION_TEST_TRANSLATION_TOLERANCE);
+
+	// Samples at and between frames, error bounded by tolerance, quantization and the curvature between frames
+	real max_rotation_error = 0;
+	real max_translation_error = 0;
+	for (int isample = 0; isample < (ANIMATION_TEST_FRAMES - 1) * 4; ++isample) {
+		const real time = (real)isample / (ANIMATION_TEST_RATE * 4);
+		animation_clip_sample(&clip, 0, time, pose);
+		for (size_t ibone = 0; ibone < ANIMATION_TEST_BONES; ++ibone) {
+			const transform_t reference = animation_test_transform(ibone, time);
+			real error = animation_test_rotation_error(pose[ibone].rotation, reference.rotation);
+			if (error > max_rotation_error)
+				max_rotation_error = error;
+			EXPECT_REALONE(vector_x(vector_length(pose[ibone].rotation)));
+			error = vector_x(vector_length(vector_sub(pose[ibone].translation, reference.translation)));
+			if (error > max_translation_error)
+				max_translation_error = error;
+		}
+	}
+	EXPECT_TRUE(max_rotation_error < ANIMATION_TEST_ROTATION_TOLERANCE * 3);
+	EXPECT_TRUE(max_translation_error < ANIMATION_TEST_TRANSLATION_TOLERANCE * 2);
+
+	// Time clamped to clip duration
+	transform_t* clamped = memory_allocate(HASH_TEST, sizeof(transform_t) * ANIMATION_TEST_BONES, 16,
+	                                       MEMORY_PERSISTENT);
+	animation_clip_sample(&clip, 0, -1, pose);
+	animation_clip_sample(&clip, 0, 0, clamped);
+	EXPECT_EQ(memcmp(pose, clamped, sizeof(transform_t) * ANIMATION_TEST_BONES), 0);
+	animation_clip_sample(&clip, 0, 100, pose);
+	animation_clip_sample(&clip, 0, clip.duration, clamped);
+	EXPECT_EQ(memcmp(pose, clamped, sizeof(transform_t) * ANIMATION_TEST_BONES), 0);
+	for (size_t ibone = 0; ibone < ANIMATION_TEST_BONES; ++ibone) {
+		const transform_t reference = animation_test_transform(ibone, clip.duration);
+		EXPECT_TRUE(animation_test_rotation_error(pose[ibone].rotation, reference.rotation) <
+		            ANIMATION_TEST_ROTATION_TOLERANCE);
+		EXPECT_VECTORALMOSTEQ(pose[ibone].translation, reference.translation);
+	}
+
+	animation_clip_finalize(&clip);
+	memory_deallocate(clamped);
+	memory_deallocate(pose);
+	memory_deallocate(frames);
+	return 0;
+}
+
+DECLARE_TEST(animation, cursor) {
+	transform_t* frames = animation_test_frames();
+	transform_t* pose = memory_allocate(HASH_TEST, sizeof(transform_t) * ANIMATION_TEST_BONES, 16, MEMORY_PERSISTENT);
+	transform_t* reference =
+	    memory_allocate(HASH_TEST, sizeof(transform_t) * ANIMATION_TEST_BONES, 16, MEMORY_PERSISTENT);
+	animation_clip_t clip;
+	animation_clip_initialize(&clip, frames, ANIMATION_TEST_FRAMES, ANIMATION_TEST_BONES, ANIMATION_TEST_RATE,
+	                          ANIMATION_TEST_ROTATION_TOLERANCE, ANIMATION_TEST_TRANSLATION_TOLERANCE);
+	animation_cursor_t cursor;
+	animation_cursor_initialize(&cursor, &clip);
+	EXPECT_UINTEQ(cursor.bone_count, ANIMATION_TEST_BONES);
+
+	// Forward playback, cursor gives the same result as searching
+	for (int isample = 0; isample <= 150; ++isample) {
+		const real time = (real)isample * REAL_C(0.0137);
+		animation_clip_sample(&clip, &cursor, time, pose);
+		animation_clip_sample(&clip, 0, time, reference);
+		EXPECT_EQ(memcmp(pose, reference, sizeof(transform_t) * ANIMATION_TEST_BONES), 0);
+	}
+
+	// Seeking backwards and looping
+	const real seek[] = {REAL_C(1.5), REAL_C(0.1), REAL_C(0.1), REAL_C(1.99), REAL_C(0.0), REAL_C(0.7), REAL_C(0.69)};
+	for (size_t iseek = 0; iseek < sizeof(seek) / sizeof(seek[0]); ++iseek) {
+		animation_clip_sample(&clip, &cursor, seek[iseek], pose);
+		animation_clip_sample(&clip, 0, seek[iseek], reference);
+		EXPECT_EQ(memcmp(pose, reference, sizeof(transform_t) * ANIMATION_TEST_BONES), 0);
+	}
+
+	animation_cursor_finalize(&cursor);
+	animation_clip_finalize(&clip);
+	memory_deallocate(reference);
+	memory_deallocate(pose);
+	memory_deallocate(frames);
+	return 0;
+}
+
+static void
+test_animation_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(animation, reduce);
+	ADD_TEST(animation, sample);
+	ADD_TEST(animation, cursor);
+}
+
+static test_suite_t test_animation_suite = {test_animation_application,
+                                            test_animation_memory_system,
+                                            test_animation_config,
+                                            test_animation_declare,
+                                            test_animation_initialize,
+                                            test_animation_finalize,
+                                            0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_animation_run(void);
+
+int
+test_animation_run(void) {
+	test_suite = test_animation_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_animation_suite;
+}
+
+#endif
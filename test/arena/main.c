@@ -0,0 +1,261 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_arena_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Arena tests"));
+	app.short_name = string_const(STRING_CONST("test_arena"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_arena_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_arena_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_arena_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_arena_finalize(void) {
+	vector_module_finalize();
+}
+
+static void
+arena_test_thread(void* context, size_t begin, size_t end) {
+	atomicptr_t* seen = context;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	for (size_t item = begin; item < end; ++item) {
+		uint32_t* value = vector_arena_allocate(arena, sizeof(uint32_t) * 4, 0);
+		value[0] = (uint32_t)item;
+		FOUNDATION_ASSERT(vector_arena_thread() == arena);
+		atomic_storeptr(seen + item, arena, memory_order_relaxed);
+		FOUNDATION_ASSERT(value[0] == (uint32_t)item);
+	}
+	vector_arena_rewind(arena, mark);
+}
+
+DECLARE_TEST(arena, allocate) {
+	vector_arena_t arena;
+	vector_arena_initialize(&arena, 1000);
+	EXPECT_SIZEEQ(arena.capacity, 1024);
+	EXPECT_EQ((uintptr_t)arena.buffer % VECTOR_ARENA_MAX_ALIGNMENT, 0);
+
+	const size_t align[] = {0, 4, 16, 32, 64};
+	for (size_t ialign = 0; ialign < sizeof(align) / sizeof(align[0]); ++ialign) {
+		const size_t expect = align[ialign] ? align[ialign] : VECTOR_ALIGNMENT;
+		vector_arena_allocate(&arena, 3, 1);
+		void* block = vector_arena_allocate(&arena, 7, align[ialign]);
+		EXPECT_EQ((uintptr_t)block % expect, 0);
+	}
+	EXPECT_TRUE(arena.offset <= arena.capacity);
+	EXPECT_EQ(arena.overflow, 0);
+
+	// Rewind releases the allocations after the mark
+	const size_t mark = vector_arena_mark(&arena);
+	vector_t* vec = vector_arena_allocate(&arena, sizeof(vector_t) * 4, 0);
+	vec[3] = vector_one();
+	vector_arena_rewind(&arena, mark);
+	EXPECT_EQ(vector_arena_allocate(&arena, sizeof(vector_t) * 4, 0), vec);
+	vector_arena_rewind(&arena, mark);
+
+	vector_arena_reset(&arena);
+	EXPECT_SIZEEQ(arena.offset, 0);
+	EXPECT_SIZEEQ(arena.capacity, 1024);
+	EXPECT_EQ(vector_arena_allocate(&arena, 16, 64), arena.buffer);
+
+	vector_arena_finalize(&arena);
+	EXPECT_EQ(arena.buffer, 0);
+
+	return 0;
+}
+
+DECLARE_TEST(arena, overflow) {
+	vector_arena_t arena;
+	vector_arena_initialize(&arena, 0);
+	EXPECT_EQ(arena.buffer, 0);
+
+	// Overflow blocks are released by rewind
+	matrix_t* first = vector_arena_allocate(&arena, sizeof(matrix_t) * 10, 64);
+	EXPECT_NE(first, 0);
+	EXPECT_EQ((uintptr_t)first % 64, 0);
+	const size_t mark = vector_arena_mark(&arena);
+	EXPECT_SIZEEQ(mark, sizeof(matrix_t) * 10);
+	for (int iblock = 0; iblock < 10; ++iblock) {
+		vector_t* block = vector_arena_allocate(&arena, 1000, 32);
+		EXPECT_EQ((uintptr_t)block % 32, 0);
+		block[0] = vector_zero();
+	}
+	first[9] = matrix_identity();
+	vector_arena_rewind(&arena, mark);
+	EXPECT_NE(arena.overflow, 0);
+	EXPECT_VECTOREQ(first[9].row[3], vector(0, 0, 0, 1));
+	vector_arena_rewind(&arena, 0);
+	EXPECT_EQ(arena.overflow, 0);
+
+	// Reset grows the block to fit the peak usage
+	vector_arena_allocate(&arena, 5000, 0);
+	vector_arena_allocate(&arena, 5000, 0);
+	EXPECT_TRUE(arena.peak >= 10000);
+	vector_arena_reset(&arena);
+	EXPECT_EQ(arena.overflow, 0);
+	EXPECT_TRUE(arena.capacity >= 10000);
+	EXPECT_EQ((uintptr_t)arena.buffer % VECTOR_ARENA_MAX_ALIGNMENT, 0);
+	vector_arena_allocate(&arena, 5000, 0);
+	vector_arena_allocate(&arena, 5000, 0);
+	EXPECT_EQ(arena.overflow, 0);
+
+	vector_arena_finalize(&arena);
+
+	return 0;
+}
+
+DECLARE_TEST(arena, thread) {
+	const size_t count = 4096;
+	atomicptr_t* seen = memory_allocate(HASH_TEST, sizeof(atomicptr_t) * count, 0, MEMORY_PERSISTENT);
+	for (size_t item = 0; item < count; ++item)
+		atomic_storeptr(seen + item, 0, memory_order_relaxed);
+
+	vector_arena_t* arena = vector_arena_thread();
+	EXPECT_NE(arena, 0);
+	EXPECT_EQ(vector_arena_thread(), arena);
+
+	vector_parallel_for(STRING_CONST("arena"), arena_test_thread, seen, count, 16);
+	for (size_t item = 0; item < count; ++item)
+		EXPECT_NE(atomic_loadptr(seen + item, memory_order_relaxed), 0);
+
+	vector_arena_allocate(arena, 100, 0);
+	vector_arena_frame_reset();
+	EXPECT_SIZEEQ(vector_arena_mark(arena), 0);
+
+	memory_deallocate(seen);
+
+	return 0;
+}
+
+DECLARE_TEST(arena, pool) {
+	matrix_t* matrix = vector_pool_allocate_matrix(16);
+	EXPECT_EQ((uintptr_t)matrix % VECTOR_ARENA_MAX_ALIGNMENT, 0);
+	for (int imat = 0; imat < 16; ++imat)
+		matrix[imat] = matrix_identity();
+	vector_pool_deallocate_matrix(matrix, 16);
+
+	// Blocks of the same size class are reused
+	matrix_t* reused = vector_pool_allocate_matrix(13);
+	EXPECT_EQ(reused, matrix);
+	transform_t* transform = vector_pool_allocate_transform(16);
+	EXPECT_NE((void*)transform, (void*)reused);
+	EXPECT_EQ((uintptr_t)transform % VECTOR_ARENA_MAX_ALIGNMENT, 0);
+	vector_pool_deallocate_transform(transform, 16);
+	vector_pool_deallocate_matrix(reused, 13);
+
+	// Large blocks are not pooled
+	matrix_t* large = vector_pool_allocate_matrix(100000);
+	EXPECT_EQ((uintptr_t)large % VECTOR_ARENA_MAX_ALIGNMENT, 0);
+	large[99999] = matrix_identity();
+	vector_pool_deallocate_matrix(large, 100000);
+
+	vector_pool_deallocate(0, 100);
+
+	return 0;
+}
+
+static void
+test_arena_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(arena, allocate);
+	ADD_TEST(arena, overflow);
+	ADD_TEST(arena, thread);
+	ADD_TEST(arena, pool);
+}
+
+static test_suite_t test_arena_suite = {test_arena_application,
+                                        test_arena_memory_system,
+                                        test_arena_config,
+                                        test_arena_declare,
+                                        test_arena_initialize,
+                                        test_arena_finalize,
+                                        0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_arena_run(void);
+
+int
+test_arena_run(void) {
+	test_suite = test_arena_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_arena_suite;
+}
+
+#endif
@@ -0,0 +1,284 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_broadphase_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Broadphase tests"));
+	app.short_name = string_const(STRING_CONST("test_broadphase"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_broadphase_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_broadphase_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_broadphase_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_broadphase_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_broadphase_seed;
+
+static real
+test_broadphase_random(real low, real high) {
+	test_broadphase_seed = test_broadphase_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_broadphase_seed >> 8) / (real)(1U << 24));
+}
+
+static aabb_t
+test_broadphase_box(const vector_t center, real size) {
+	const vector_t extent = vector(test_broadphase_random(REAL_C(0.1), size), test_broadphase_random(REAL_C(0.1), size),
+	                               test_broadphase_random(REAL_C(0.1), size), 0);
+	return aabb(vector_sub(center, extent), vector_add(center, extent));
+}
+
+//! Compare pairs with brute force test of all active handles, each pair must be found exactly once
+static bool
+test_broadphase_verify(const aabb_t* box, const bool* active, uint32_t count, const broadphase_pair_t* pair,
+                       size_t pair_count) {
+	uint8_t* found = memory_allocate(HASH_TEST, (size_t)count * count, 0, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	bool valid = true;
+	for (size_t ipair = 0; ipair < pair_count; ++ipair) {
+		const uint32_t first = pair[ipair].first;
+		const uint32_t second = pair[ipair].second;
+		if ((first >= second) || (second >= count) || !active[first] || !active[second] ||
+		    found[(first * count) + second])
+			valid = false;
+		else
+			found[(first * count) + second] = 1;
+	}
+	size_t expected = 0;
+	for (uint32_t first = 0; valid && (first < count); ++first) {
+		for (uint32_t second = first + 1; active[first] && (second < count); ++second) {
+			if (!active[second] || !aabb_overlap(box[first], box[second]))
+				continue;
+			++expected;
+			if (!found[(first * count) + second])
+				valid = false;
+		}
+	}
+	memory_deallocate(found);
+	return valid && (expected == pair_count);
+}
+
+DECLARE_TEST(broadphase, basic) {
+	broadphase_pair_t pair[8];
+	broadphase_t* broadphase = broadphase_allocate(0);
+	EXPECT_UINTEQ(broadphase_find_pairs(broadphase, pair, 8), 0);
+
+	const uint32_t handle0 = broadphase_add(broadphase, aabb(vector(0, 0, 0, 1), vector(2, 2, 2, 1)));
+	const uint32_t handle1 = broadphase_add(broadphase, aabb(vector(1, 1, 1, 1), vector(3, 3, 3, 1)));
+	const uint32_t handle2 = broadphase_add(broadphase, aabb(vector(1, 5, 1, 1), vector(3, 6, 3, 1)));
+	// Touching in x and overlapping in y and z
+	const uint32_t handle3 = broadphase_add(broadphase, aabb(vector(3, 2, 0, 1), vector(4, 3, 1, 1)));
+	EXPECT_UINTEQ(handle0, 0);
+	EXPECT_UINTEQ(handle1, 1);
+	EXPECT_UINTEQ(handle2, 2);
+	EXPECT_UINTEQ(handle3, 3);
+
+	EXPECT_UINTEQ(broadphase_find_pairs(broadphase, pair, 8), 2);
+	EXPECT_UINTEQ(pair[0].first, handle0);
+	EXPECT_UINTEQ(pair[0].second, handle1);
+	EXPECT_UINTEQ(pair[1].first, handle1);
+	EXPECT_UINTEQ(pair[1].second, handle3);
+
+	// Move third box down onto the first two and check count with too small buffer
+	broadphase_update(broadphase, handle2, aabb(vector(1, 1, 1, 1), vector(3, 2, 3, 1)));
+	EXPECT_VECTOREQ(broadphase_bounds(broadphase, handle2).max, vector(3, 2, 3, 1));
+	EXPECT_UINTEQ(broadphase_find_pairs(broadphase, pair, 1), 5);
+	EXPECT_UINTEQ(pair[0].first, handle0);
+
+	// Removed handle is reused only after the next pair query
+	broadphase_remove(broadphase, handle1);
+	const uint32_t handle4 = broadphase_add(broadphase, aabb(vector(10, 10, 10, 1), vector(11, 11, 11, 1)));
+	EXPECT_UINTEQ(handle4, 4);
+	EXPECT_UINTEQ(broadphase_find_pairs(broadphase, pair, 8), 2);
+	const uint32_t handle5 = broadphase_add(broadphase, aabb(vector(10, 10, 10, 1), vector(11, 11, 11, 1)));
+	EXPECT_UINTEQ(handle5, handle1);
+	EXPECT_UINTEQ(broadphase_find_pairs(broadphase, pair, 8), 3);
+	EXPECT_UINTEQ(pair[2].first, handle1);
+	EXPECT_UINTEQ(pair[2].second, handle4);
+
+	broadphase_deallocate(broadphase);
+
+	return 0;
+}
+
+DECLARE_TEST(broadphase, moving) {
+	const uint32_t count = 1000;
+	const size_t capacity = 16 * 1024;
+	aabb_t* box = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	vector_t* velocity = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	aabb_t* moved = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	uint32_t* handle = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	bool* active = memory_allocate(HASH_TEST, sizeof(bool) * count, 0, MEMORY_PERSISTENT);
+	broadphase_pair_t* pair = memory_allocate(HASH_TEST, sizeof(broadphase_pair_t) * capacity, 0, MEMORY_PERSISTENT);
+
+	for (unsigned int axis = 0; axis < 3; ++axis) {
+		broadphase_t broadphase;
+		broadphase_initialize(&broadphase, axis);
+		test_broadphase_seed = 1 + axis;
+		for (uint32_t ibox = 0; ibox < count; ++ibox) {
+			const vector_t center = vector(test_broadphase_random(-20, 20), test_broadphase_random(-20, 20),
+			                               test_broadphase_random(-20, 20), 1);
+			box[ibox] = test_broadphase_box(center, 2);
+			velocity[ibox] = vector(test_broadphase_random(-1, 1), test_broadphase_random(-1, 1),
+			                        test_broadphase_random(-1, 1), 0);
+			EXPECT_UINTEQ(broadphase_add(&broadphase, box[ibox]), ibox);
+			active[ibox] = true;
+		}
+
+		for (int frame = 0; frame < 16; ++frame) {
+			const size_t pair_count = broadphase_find_pairs(&broadphase, pair, capacity);
+			EXPECT_TRUE(pair_count > 0);
+			EXPECT_TRUE(pair_count < capacity);
+			EXPECT_TRUE(test_broadphase_verify(box, active, count, pair, pair_count));
+
+			// Move all boxes, then remove a few and add new boxes for them every fourth frame. Test
+			// arrays are indexed by handle since handles are reused
+			uint32_t moved_count = 0;
+			for (uint32_t ibox = 0; ibox < count; ++ibox) {
+				box[ibox] = aabb(vector_add(box[ibox].min, velocity[ibox]), vector_add(box[ibox].max, velocity[ibox]));
+				if (active[ibox]) {
+					handle[moved_count] = ibox;
+					moved[moved_count++] = box[ibox];
+				}
+			}
+			broadphase_update_array(&broadphase, handle, moved, moved_count);
+			for (int iremove = 0; iremove < 20; ++iremove) {
+				const uint32_t ibox = (uint32_t)test_broadphase_random(0, (real)count) % count;
+				if (active[ibox]) {
+					broadphase_remove(&broadphase, ibox);
+					active[ibox] = false;
+				}
+			}
+			if (frame % 4 == 3) {
+				broadphase_find_pairs(&broadphase, 0, 0);
+				for (uint32_t ibox = 0; ibox < count; ++ibox) {
+					if (active[ibox])
+						continue;
+					const vector_t center = vector(test_broadphase_random(-20, 20), test_broadphase_random(-20, 20),
+					                               test_broadphase_random(-20, 20), 1);
+					const aabb_t added = test_broadphase_box(center, 2);
+					const uint32_t reused = broadphase_add(&broadphase, added);
+					EXPECT_TRUE(reused < count);
+					EXPECT_FALSE(active[reused]);
+					box[reused] = added;
+					active[reused] = true;
+				}
+			}
+		}
+
+		broadphase_finalize(&broadphase);
+	}
+
+	memory_deallocate(box);
+	memory_deallocate(velocity);
+	memory_deallocate(moved);
+	memory_deallocate(handle);
+	memory_deallocate(active);
+	memory_deallocate(pair);
+
+	return 0;
+}
+
+static void
+test_broadphase_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(broadphase, basic);
+	ADD_TEST(broadphase, moving);
+}
+
+static test_suite_t test_broadphase_suite = {test_broadphase_application,
+                                             test_broadphase_memory_system,
+                                             test_broadphase_config,
+                                             test_broadphase_declare,
+                                             test_broadphase_initialize,
+                                             test_broadphase_finalize,
+                                             0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_broadphase_run(void);
+
+int
+test_broadphase_run(void) {
+	test_suite = test_broadphase_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_broadphase_suite;
+}
+
+#endif
@@ -0,0 +1,364 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_bvh_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("BVH tests"));
+	app.short_name = string_const(STRING_CONST("test_bvh"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_bvh_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_bvh_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_bvh_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	config.thread_count = 4;
+	return vector_module_initialize(config);
+}
+
+static void
+test_bvh_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_bvh_seed;
+
+static real
+test_bvh_random(real low, real high) {
+	test_bvh_seed = test_bvh_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_bvh_seed >> 8) / (real)(1U << 24));
+}
+
+static vector_t
+test_bvh_random_point(real low, real high) {
+	return vector(test_bvh_random(low, high), test_bvh_random(low, high), test_bvh_random(low, high), 0);
+}
+
+static aabb_t
+test_bvh_random_box(real low, real high) {
+	const vector_t center = test_bvh_random_point(low, high);
+	const vector_t extent = vector(test_bvh_random(0.1f, 2), test_bvh_random(0.1f, 2), test_bvh_random(0.1f, 2), 0);
+	return aabb(vector_sub(center, extent), vector_add(center, extent));
+}
+
+DECLARE_TEST(bvh, aabb) {
+	aabb_t box = aabb_empty();
+	EXPECT_REALZERO(aabb_surface_area(box));
+
+	box = aabb_add_point(box, vector(1, 2, 3, 1));
+	EXPECT_VECTOREQ(box.min, vector(1, 2, 3, 1));
+	EXPECT_VECTOREQ(box.max, vector(1, 2, 3, 1));
+	EXPECT_TRUE(aabb_contains_point(box, vector(1, 2, 3, 1)));
+
+	box = aabb_add_point(box, vector(-1, 4, 0, 1));
+	EXPECT_VECTOREQ(box.min, vector(-1, 2, 0, 1));
+	EXPECT_VECTOREQ(box.max, vector(1, 4, 3, 1));
+	EXPECT_VECTOREQ(aabb_size(box), vector(2, 2, 3, 0));
+	EXPECT_VECTOREQ(aabb_center(box), vector(0, 3, 1.5f, 1));
+	EXPECT_REALEQ(aabb_surface_area(box), 2 * (2 * 2 + 2 * 3 + 3 * 2));
+
+	EXPECT_TRUE(aabb_overlap(box, aabb(vector(1, 4, 3, 1), vector(2, 5, 4, 1))));
+	EXPECT_FALSE(aabb_overlap(box, aabb(vector(1.5f, 4, 3, 1), vector(2, 5, 4, 1))));
+	EXPECT_FALSE(aabb_contains_point(box, vector(0, 0, 0, 1)));
+
+	return 0;
+}
+
+DECLARE_TEST(bvh, ray) {
+	const ray_t r = ray(vector(0, 0, -5, 1), vector(0, 0, 1, 0));
+	const aabb_t box = aabb(vector(-1, -1, -1, 1), vector(1, 1, 1, 1));
+	real distance = 0;
+	real u = 0, v = 0;
+
+	EXPECT_VECTOREQ(ray_point(r, 2), vector(0, 0, -3, 1));
+	EXPECT_TRUE(ray_intersect_aabb(r, ray_inverse_direction(r), box, 10, &distance));
+	EXPECT_REALEQ(distance, 4);
+	EXPECT_FALSE(ray_intersect_aabb(r, ray_inverse_direction(r), box, 3, &distance));
+
+	const ray_t inside = ray(vector(0, 0.5f, 0, 1), vector(1, 0, 0, 0));
+	EXPECT_TRUE(ray_intersect_aabb(inside, ray_inverse_direction(inside), box, 10, &distance));
+	EXPECT_REALZERO(distance);
+
+	const ray_t miss = ray(vector(0, 2, -5, 1), vector(0, 0, 1, 0));
+	EXPECT_FALSE(ray_intersect_aabb(miss, ray_inverse_direction(miss), box, 10, &distance));
+
+	const vector_t v0 = vector(-1, -1, 0, 1);
+	const vector_t v1 = vector(1, -1, 0, 1);
+	const vector_t v2 = vector(-1, 1, 0, 1);
+	EXPECT_TRUE(ray_intersect_triangle(r, v0, v1, v2, 10, &distance, &u, &v));
+	EXPECT_REALEQ(distance, 5);
+	EXPECT_REALEQ(u, 0.5f);
+	EXPECT_REALEQ(v, 0.5f);
+	EXPECT_FALSE(ray_intersect_triangle(r, v0, v1, v2, 4, &distance, &u, &v));
+	EXPECT_FALSE(ray_intersect_triangle(miss, v0, v1, v2, 10, &distance, &u, &v));
+
+	return 0;
+}
+
+DECLARE_TEST(bvh, build) {
+	const size_t count = 10000;
+	aabb_t* box = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	uint32_t* found = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	bvh_t* bvh = bvh_allocate();
+
+	bvh_build_aabb(bvh, box, 0);
+	EXPECT_UINTEQ(bvh->node_count, 0);
+	EXPECT_FALSE(bvh_query_ray_any(bvh, ray(vector_zero(), vector(1, 0, 0, 0)), 100));
+
+	test_bvh_seed = 1;
+	aabb_t total = aabb_empty();
+	for (size_t ibox = 0; ibox < count; ++ibox) {
+		box[ibox] = test_bvh_random_box(-50, 50);
+		total = aabb_merge(total, box[ibox]);
+	}
+
+	bvh_build_aabb(bvh, box, count);
+	EXPECT_UINTEQ(bvh->primitive_count, count);
+	EXPECT_TRUE(bvh->node_count <= count);
+	EXPECT_VECTOREQ(bvh_bounds(bvh).min, total.min);
+	EXPECT_VECTOREQ(bvh_bounds(bvh).max, total.max);
+
+	for (int iquery = 0; iquery < 100; ++iquery) {
+		const aabb_t query = test_bvh_random_box(-50, 50);
+		size_t expected = 0;
+		for (size_t ibox = 0; ibox < count; ++ibox) {
+			if (aabb_overlap(box[ibox], query))
+				++expected;
+		}
+		const size_t overlap = bvh_query_aabb(bvh, query, found, count);
+		EXPECT_SIZEEQ(overlap, expected);
+		for (size_t ifound = 0; ifound < overlap; ++ifound)
+			EXPECT_TRUE(aabb_overlap(box[found[ifound]], query));
+		EXPECT_SIZEEQ(bvh_query_aabb(bvh, query, found, 0), expected);
+	}
+
+	for (int iquery = 0; iquery < 100; ++iquery) {
+		const vector_t origin = test_bvh_random_point(-60, 60);
+		const vector_t target = test_bvh_random_point(-30, 30);
+		const ray_t r = ray(origin, vector_normalize3(vector_sub(target, origin)));
+		const vector_t inv_direction = ray_inverse_direction(r);
+		real closest = REAL_MAX;
+		for (size_t ibox = 0; ibox < count; ++ibox) {
+			real distance;
+			if (ray_intersect_aabb(r, inv_direction, box[ibox], 200, &distance) && (distance < closest))
+				closest = distance;
+		}
+		bvh_hit_t hit;
+		const bool has_hit = bvh_query_ray(bvh, r, 200, &hit);
+		EXPECT_EQ(has_hit, closest < REAL_MAX);
+		EXPECT_EQ(bvh_query_ray_any(bvh, r, 200), has_hit);
+		if (has_hit) {
+			EXPECT_REALEQ(hit.distance, closest);
+			EXPECT_TRUE(ray_intersect_aabb(r, inv_direction, box[hit.primitive], 200, 0));
+		}
+	}
+
+	bvh_deallocate(bvh);
+	memory_deallocate(found);
+	memory_deallocate(box);
+
+	return 0;
+}
+
+DECLARE_TEST(bvh, triangles) {
+	// Height field grid of quads split into two triangles each
+	const uint32_t size = 32;
+	const uint32_t triangle_count = (size - 1) * (size - 1) * 2;
+	vector_t* vertex = memory_allocate(HASH_TEST, sizeof(vector_t) * size * size, 16, MEMORY_PERSISTENT);
+	uint32_t* index = memory_allocate(HASH_TEST, sizeof(uint32_t) * triangle_count * 3, 0, MEMORY_PERSISTENT);
+	bvh_t bvh;
+
+	test_bvh_seed = 2;
+	for (uint32_t iz = 0; iz < size; ++iz) {
+		for (uint32_t ix = 0; ix < size; ++ix)
+			vertex[iz * size + ix] = vector((real)ix, test_bvh_random(-1, 1), (real)iz, 1);
+	}
+	uint32_t* corner = index;
+	for (uint32_t iz = 0; iz < size - 1; ++iz) {
+		for (uint32_t ix = 0; ix < size - 1; ++ix) {
+			const uint32_t base = iz * size + ix;
+			*corner++ = base;
+			*corner++ = base + 1;
+			*corner++ = base + size;
+			*corner++ = base + 1;
+			*corner++ = base + size + 1;
+			*corner++ = base + size;
+		}
+	}
+
+	bvh_initialize(&bvh);
+	bvh_build_triangles(&bvh, vertex, index, triangle_count);
+	EXPECT_UINTEQ(bvh.primitive_count, triangle_count);
+
+	for (int iquery = 0; iquery < 200; ++iquery) {
+		const vector_t origin =
+		    vector(test_bvh_random(-4, (real)size + 4), 10, test_bvh_random(-4, (real)size + 4), 1);
+		const vector_t direction =
+		    vector_normalize3(vector(test_bvh_random(-0.2f, 0.2f), -1, test_bvh_random(-0.2f, 0.2f), 0));
+		const ray_t r = ray(origin, direction);
+		real closest = REAL_MAX;
+		for (uint32_t itri = 0; itri < triangle_count; ++itri) {
+			real distance, u, v;
+			const uint32_t* tri = index + itri * 3;
+			if (ray_intersect_triangle(r, vertex[tri[0]], vertex[tri[1]], vertex[tri[2]], 100, &distance, &u, &v) &&
+			    (distance < closest))
+				closest = distance;
+		}
+		bvh_hit_t hit;
+		const bool has_hit = bvh_query_ray(&bvh, r, 100, &hit);
+		EXPECT_EQ(has_hit, closest < REAL_MAX);
+		EXPECT_EQ(bvh_query_ray_any(&bvh, r, 100), has_hit);
+		if (has_hit) {
+			EXPECT_REALEQ(hit.distance, closest);
+			EXPECT_TRUE(hit.primitive < triangle_count);
+		}
+	}
+
+	bvh_finalize(&bvh);
+	memory_deallocate(index);
+	memory_deallocate(vertex);
+
+	return 0;
+}
+
+DECLARE_TEST(bvh, refit) {
+	const size_t count = 500;
+	aabb_t* box = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	uint32_t* found = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	bvh_t bvh;
+
+	test_bvh_seed = 3;
+	for (size_t ibox = 0; ibox < count; ++ibox)
+		box[ibox] = test_bvh_random_box(-20, 20);
+
+	bvh_initialize(&bvh);
+	bvh_build_aabb(&bvh, box, count);
+
+	// Move every box and verify queries against refitted tree match brute force
+	aabb_t total = aabb_empty();
+	for (size_t ibox = 0; ibox < count; ++ibox) {
+		const vector_t offset = test_bvh_random_point(-5, 5);
+		box[ibox] = aabb(vector_add(box[ibox].min, offset), vector_add(box[ibox].max, offset));
+		total = aabb_merge(total, box[ibox]);
+	}
+	bvh_refit_aabb(&bvh, box);
+	EXPECT_VECTOREQ(bvh_bounds(&bvh).min, total.min);
+	EXPECT_VECTOREQ(bvh_bounds(&bvh).max, total.max);
+
+	for (int iquery = 0; iquery < 100; ++iquery) {
+		const aabb_t query = test_bvh_random_box(-25, 25);
+		size_t expected = 0;
+		for (size_t ibox = 0; ibox < count; ++ibox) {
+			if (aabb_overlap(box[ibox], query))
+				++expected;
+		}
+		EXPECT_SIZEEQ(bvh_query_aabb(&bvh, query, found, count), expected);
+	}
+
+	bvh_finalize(&bvh);
+	memory_deallocate(found);
+	memory_deallocate(box);
+
+	return 0;
+}
+
+static void
+test_bvh_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(bvh, aabb);
+	ADD_TEST(bvh, ray);
+	ADD_TEST(bvh, build);
+	ADD_TEST(bvh, triangles);
+	ADD_TEST(bvh, refit);
+}
+
+static test_suite_t test_bvh_suite = {test_bvh_application,
+                                      test_bvh_memory_system,
+                                      test_bvh_config,
+                                      test_bvh_declare,
+                                      test_bvh_initialize,
+                                      test_bvh_finalize,
+                                      0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_bvh_run(void);
+
+int
+test_bvh_run(void) {
+	test_suite = test_bvh_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_bvh_suite;
+}
+
+#endif
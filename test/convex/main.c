@@ -0,0 +1,376 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_convex_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Convex tests"));
+	app.short_name = string_const(STRING_CONST("test_convex"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_convex_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_convex_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_convex_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_convex_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_convex_seed;
+
+static real
+test_convex_random(real low, real high) {
+	test_convex_seed = test_convex_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_convex_seed >> 8) / (real)(1U << 24));
+}
+
+static quaternion_t
+test_convex_random_rotation(void) {
+	return quaternion_normalize(vector(test_convex_random(-1, 1), test_convex_random(-1, 1),
+	                                   test_convex_random(-1, 1), test_convex_random(-1, 1)));
+}
+
+static vector_t
+test_convex_random_point(real range) {
+	const real x = test_convex_random(-range, range);
+	const real y = test_convex_random(-range, range);
+	const real z = test_convex_random(-range, range);
+	return vector(x, y, z, 1);
+}
+
+static obb_t
+test_convex_random_box(real range) {
+	const vector_t center = test_convex_random_point(range);
+	const real x = test_convex_random(REAL_C(0.2), 2);
+	const real y = test_convex_random(REAL_C(0.2), 2);
+	const real z = test_convex_random(REAL_C(0.2), 2);
+	return obb(center, vector(x, y, z, 0), test_convex_random_rotation());
+}
+
+static bool
+test_convex_near(real value, real expect, real tolerance) {
+	return math_abs(value - expect) <= tolerance;
+}
+
+static real
+test_convex_length(const vector_t p0, const vector_t p1) {
+	return vector_x(vector_length3(vector_sub(p1, p0)));
+}
+
+static vector_t
+test_convex_cube_support(const void* data, const vector_t direction) {
+	const real half = *(const real*)data;
+	return vector(vector_x(direction) < 0 ? -half : half, vector_y(direction) < 0 ? -half : half,
+	              vector_z(direction) < 0 ? -half : half, 1);
+}
+
+DECLARE_TEST(convex, support) {
+	vector_t point[11];
+	for (int ipt = 0; ipt < 11; ++ipt)
+		point[ipt] = vector((real)(ipt % 4) - 2, (real)((ipt * 7) % 5) - 2, (real)ipt, 1);
+	test_convex_seed = 1;
+	for (int iter = 0; iter < 256; ++iter) {
+		const vector_t direction = vector_set_component(test_convex_random_point(1), 3, 0);
+		const size_t count = 1 + (size_t)iter % 11;
+		size_t expect = 0;
+		for (size_t ipt = 1; ipt < count; ++ipt) {
+			if (vector_x(vector_dot3(point[ipt], direction)) > vector_x(vector_dot3(point[expect], direction)))
+				expect = ipt;
+		}
+		EXPECT_UINTEQ(convex_support_index(point, count, direction), expect);
+	}
+	// Ties resolve to the first point regardless of lane
+	EXPECT_UINTEQ(convex_support_index(point, 11, vector(1, 0, 0, 0)), 3);
+
+	const convex_t sphere = convex_sphere(vector(1, 2, 3, 1), 2);
+	EXPECT_VECTORALMOSTEQ(convex_support(&sphere, vector(0, 3, 0, 0)), vector(1, 4, 3, 1));
+	const convex_t capsule = convex_capsule(vector(0, 0, 0, 1), vector(0, 4, 0, 1), 1);
+	EXPECT_VECTORALMOSTEQ(convex_support(&capsule, vector(1, 1, 0, 0)),
+	                      vector(math_sqrt(REAL_C(0.5)), 4 + math_sqrt(REAL_C(0.5)), 0, 1));
+	EXPECT_VECTORALMOSTEQ(convex_support(&capsule, vector(0, -1, 0, 0)), vector(0, -1, 0, 1));
+
+	const quaternion_t about_z = vector(0, 0, math_sin(REAL_PI / 8), math_cos(REAL_PI / 8));
+	const convex_t box = convex_box(vector(5, 0, 0, 1), vector(1, 2, 3, 0), about_z);
+	const matrix_t axes = matrix_from_quaternion(about_z);
+	const vector_t corner =
+	    vector_add(vector(5, 0, 0, 1), vector_rotate(vector(1, -2, 3, 0), axes));
+	EXPECT_VECTORALMOSTEQ(convex_support(&box, vector_rotate(vector(1, -1, 1, 0), axes)), corner);
+
+	const real half = 1;
+	matrix_t transform = matrix_from_quaternion(about_z);
+	transform.row[3] = vector(0, 0, 3, 1);
+	const convex_t cube = convex_custom(test_convex_cube_support, &half, transform);
+	const convex_t cube_box = convex_box(vector(0, 0, 3, 1), vector(1, 1, 1, 0), about_z);
+	for (int iter = 0; iter < 16; ++iter) {
+		const vector_t direction = vector_set_component(test_convex_random_point(1), 3, 0);
+		EXPECT_VECTORALMOSTEQ(convex_support(&cube, direction), convex_support(&cube_box, direction));
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(convex, distance) {
+	convex_contact_t contact;
+
+	const convex_t sphere0 = convex_sphere(vector(0, 0, 0, 1), 1);
+	const convex_t sphere1 = convex_sphere(vector(3, 4, 0, 1), 2);
+	EXPECT_TRUE(convex_distance(&sphere0, &sphere1, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, 2, REAL_C(1e-4)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(REAL_C(0.6), REAL_C(0.8), 0, 0));
+	EXPECT_VECTORALMOSTEQ(contact.point0, vector(REAL_C(0.6), REAL_C(0.8), 0, 1));
+	EXPECT_VECTORALMOSTEQ(contact.point1, vector(REAL_C(1.8), REAL_C(2.4), 0, 1));
+	EXPECT_FALSE(convex_penetration(&sphere0, &sphere1, &contact));
+	EXPECT_FALSE(convex_overlap(&sphere0, &sphere1));
+
+	// Capsule segment closest to a box edge
+	const convex_t box = convex_box(vector(0, 0, 0, 1), vector(1, 1, 1, 0), quaternion_identity());
+	const convex_t capsule = convex_capsule(vector(3, 3, -5, 1), vector(3, 3, 5, 1), REAL_C(0.5));
+	EXPECT_TRUE(convex_distance(&box, &capsule, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, 2 * math_sqrt(REAL_C(2.0)) - REAL_C(0.5), REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(contact.point0), 1, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_y(contact.point0), 1, REAL_C(1e-4)));
+	EXPECT_TRUE(math_abs(vector_z(contact.point0)) <= 1 + REAL_C(1e-4));
+
+	// Face to face boxes, the hull of the box corners gives the same result
+	const quaternion_t rotation = vector(0, 0, math_sin(REAL_PI / 8), math_cos(REAL_PI / 8));
+	const convex_t side = convex_box(vector(REAL_C(4.5), 0, 0, 1), vector(1, 2, 1, 0), quaternion_identity());
+	EXPECT_TRUE(convex_distance(&box, &side, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, REAL_C(2.5), REAL_C(1e-4)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(1, 0, 0, 0));
+	vector_t corner[8];
+	for (int icorner = 0; icorner < 8; ++icorner)
+		corner[icorner] = vector((icorner & 1) ? 1 : -1, (icorner & 2) ? 1 : -1, (icorner & 4) ? 1 : -1, 1);
+	matrix_t transform = matrix_from_quaternion(rotation);
+	transform.row[3] = vector(0, 5, 0, 1);
+	const convex_t hull = convex_hull(corner, 8, transform);
+	const convex_t hull_box = convex_box(vector(0, 5, 0, 1), vector(1, 1, 1, 0), rotation);
+	convex_contact_t box_contact;
+	EXPECT_TRUE(convex_distance(&box, &hull, &contact));
+	EXPECT_TRUE(convex_distance(&box, &hull_box, &box_contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, 4 - math_sqrt(REAL_C(2.0)), REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(contact.distance, box_contact.distance, REAL_C(1e-5)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(0, 1, 0, 0));
+
+	// Random boxes agree with the separating axis test away from touching, and closest points lie
+	// on the boxes at the reported distance
+	test_convex_seed = 2;
+	int separated = 0;
+	for (int iter = 0; iter < 512; ++iter) {
+		const obb_t obb0 = test_convex_random_box(3);
+		const obb_t obb1 = test_convex_random_box(3);
+		const convex_t shape0 = convex_from_obb(obb0);
+		const convex_t shape1 = convex_from_obb(obb1);
+		const bool overlap = obb_overlap(obb0, obb1);
+		const bool distance = convex_distance(&shape0, &shape1, &contact);
+		EXPECT_EQ(convex_overlap(&shape0, &shape1), overlap);
+		EXPECT_EQ(distance, !overlap);
+		if (!distance)
+			continue;
+		++separated;
+		EXPECT_TRUE(test_convex_near(test_convex_length(contact.point0, contact.point1), contact.distance,
+		                             REAL_C(1e-3)));
+		const obb_t grown0 = obb(obb0.center, vector_add(obb0.extent, vector_uniform(REAL_C(0.001))), obb0.rotation);
+		const obb_t grown1 = obb(obb1.center, vector_add(obb1.extent, vector_uniform(REAL_C(0.001))), obb1.rotation);
+		EXPECT_TRUE(obb_contains_point(grown0, contact.point0));
+		EXPECT_TRUE(obb_contains_point(grown1, contact.point1));
+		// Moving the second box back along the normal by the distance makes the boxes touch
+		const vector_t offset = vector_scale(contact.normal, contact.distance * REAL_C(0.99));
+		const vector_t offset_touch = vector_scale(contact.normal, contact.distance * REAL_C(1.01));
+		EXPECT_FALSE(obb_overlap(obb0, obb(vector_sub(obb1.center, offset), obb1.extent, obb1.rotation)));
+		EXPECT_TRUE(obb_overlap(obb0, obb(vector_sub(obb1.center, offset_touch), obb1.extent, obb1.rotation)));
+	}
+	EXPECT_TRUE(separated > 64);
+
+	return 0;
+}
+
+DECLARE_TEST(convex, penetration) {
+	convex_contact_t contact;
+
+	const convex_t sphere0 = convex_sphere(vector(0, 0, 0, 1), 1);
+	const convex_t sphere1 = convex_sphere(vector(0, REAL_C(1.5), 0, 1), 1);
+	EXPECT_TRUE(convex_overlap(&sphere0, &sphere1));
+	EXPECT_FALSE(convex_distance(&sphere0, &sphere1, &contact));
+	EXPECT_TRUE(convex_penetration(&sphere0, &sphere1, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, REAL_C(-0.5), REAL_C(1e-4)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(0, 1, 0, 0));
+	EXPECT_VECTORALMOSTEQ(contact.point0, vector(0, 1, 0, 1));
+	EXPECT_VECTORALMOSTEQ(contact.point1, vector(0, REAL_C(0.5), 0, 1));
+
+	// Concentric spheres have a degenerate core difference
+	EXPECT_TRUE(convex_penetration(&sphere0, &sphere0, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, -2, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(vector_length3(contact.normal)), 1, REAL_C(1e-4)));
+
+	// Parallel capsules with overlapping segments
+	const convex_t capsule0 = convex_capsule(vector(-2, 0, 0, 1), vector(2, 0, 0, 1), REAL_C(0.5));
+	const convex_t capsule1 = convex_capsule(vector(-1, 0, 0, 1), vector(3, 0, 0, 1), REAL_C(0.5));
+	EXPECT_TRUE(convex_penetration(&capsule0, &capsule1, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, -1, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(contact.normal), 0, REAL_C(1e-4)));
+
+	// Sphere centered on the end of the capsule segment, the core difference is a segment ending
+	// at the origin
+	const convex_t end_sphere = convex_sphere(vector(2, 0, 0, 1), REAL_C(0.5));
+	const convex_t end_capsule = convex_capsule(vector(0, 0, 0, 1), vector(2, 0, 0, 1), REAL_C(0.5));
+	convex_contact(&end_sphere, &end_capsule, &contact);
+	EXPECT_TRUE(test_convex_near(contact.distance, -1, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(contact.normal), 0, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(vector_length3(contact.normal)), 1, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(test_convex_length(contact.point0, vector(2, 0, 0, 1)), REAL_C(0.5), REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(test_convex_length(contact.point1, vector(2, 0, 0, 1)), REAL_C(0.5), REAL_C(1e-4)));
+
+	// Collinear capsules touching at the segment ends
+	const convex_t line0 = convex_capsule(vector(-2, 0, 0, 1), vector(0, 0, 0, 1), REAL_C(0.25));
+	const convex_t line1 = convex_capsule(vector(0, 0, 0, 1), vector(3, 0, 0, 1), REAL_C(0.25));
+	convex_contact(&line0, &line1, &contact);
+	EXPECT_TRUE(test_convex_near(contact.distance, REAL_C(-0.5), REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(vector_x(contact.normal), 0, REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(test_convex_length(contact.point0, vector_zero()), REAL_C(0.25), REAL_C(1e-4)));
+	EXPECT_TRUE(test_convex_near(test_convex_length(contact.point1, vector_zero()), REAL_C(0.25), REAL_C(1e-4)));
+
+	// Box sunk into a box face
+	const convex_t floor = convex_box(vector(0, -1, 0, 1), vector(10, 1, 10, 0), quaternion_identity());
+	const convex_t box = convex_box(vector(1, REAL_C(0.8), 2, 1), vector(1, 1, 1, 0), quaternion_identity());
+	EXPECT_TRUE(convex_penetration(&floor, &box, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, REAL_C(-0.2), REAL_C(1e-3)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(0, 1, 0, 0));
+	EXPECT_TRUE(test_convex_near(vector_y(contact.point0), 0, REAL_C(1e-3)));
+	EXPECT_TRUE(test_convex_near(vector_y(contact.point1), REAL_C(-0.2), REAL_C(1e-3)));
+
+	// Sphere inside a box, pushed out through the nearest face
+	const convex_t inside = convex_sphere(vector(REAL_C(0.7), 0, REAL_C(-0.2), 1), REAL_C(0.1));
+	const convex_t cube = convex_box(vector(0, 0, 0, 1), vector(1, 1, 1, 0), quaternion_identity());
+	EXPECT_TRUE(convex_penetration(&cube, &inside, &contact));
+	EXPECT_TRUE(test_convex_near(contact.distance, REAL_C(-0.4), REAL_C(1e-3)));
+	EXPECT_VECTORALMOSTEQ(contact.normal, vector(1, 0, 0, 0));
+
+	// Random overlapping boxes separate when the second is moved by the penetration depth along
+	// the normal, and not when moved by slightly less
+	test_convex_seed = 3;
+	int overlapping = 0;
+	for (int iter = 0; iter < 512; ++iter) {
+		const obb_t obb0 = test_convex_random_box(1);
+		const obb_t obb1 = test_convex_random_box(1);
+		const convex_t shape0 = convex_from_obb(obb0);
+		const convex_t shape1 = convex_from_obb(obb1);
+		if (!convex_penetration(&shape0, &shape1, &contact)) {
+			EXPECT_FALSE(obb_overlap(obb0, obb1));
+			continue;
+		}
+		++overlapping;
+		EXPECT_TRUE(contact.distance <= 0);
+		EXPECT_TRUE(test_convex_near(vector_x(vector_length3(contact.normal)), 1, REAL_C(1e-4)));
+		const real depth = -contact.distance;
+		const vector_t beyond = vector_scale(contact.normal, depth + REAL_C(0.01));
+		const vector_t within = vector_scale(contact.normal, depth * REAL_C(0.98));
+		EXPECT_FALSE(obb_overlap(obb0, obb(vector_add(obb1.center, beyond), obb1.extent, obb1.rotation)));
+		EXPECT_TRUE(obb_overlap(obb0, obb(vector_add(obb1.center, within), obb1.extent, obb1.rotation)));
+	}
+	EXPECT_TRUE(overlapping > 64);
+
+	return 0;
+}
+
+static void
+test_convex_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(convex, support);
+	ADD_TEST(convex, distance);
+	ADD_TEST(convex, penetration);
+}
+
+static test_suite_t test_convex_suite = {test_convex_application,
+                                         test_convex_memory_system,
+                                         test_convex_config,
+                                         test_convex_declare,
+                                         test_convex_initialize,
+                                         test_convex_finalize,
+                                         0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_convex_run(void);
+
+int
+test_convex_run(void) {
+	test_suite = test_convex_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_convex_suite;
+}
+
+#endif
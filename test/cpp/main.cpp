@@ -0,0 +1,430 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.hpp>
+#include <vector/constant.hpp>
+
+#include "../test/vector.h"
+
+static application_t
+test_cpp_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("C++ wrapper tests"));
+	app.short_name = string_const(STRING_CONST("test_cpp"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_cpp_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_cpp_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_cpp_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_cpp_finalize(void) {
+	vector_module_finalize();
+}
+
+DECLARE_TEST(cpp, vector) {
+	const vector_t v0 = vector(REAL_C(1.25), REAL_C(-2.5), REAL_C(3.75), REAL_C(0.5));
+	const vector_t v1 = vector(REAL_C(-0.3), REAL_C(0.7), REAL_C(1.1), REAL_C(-1.9));
+	const vector_t v2 = vector(REAL_C(0.1), REAL_C(0.2), REAL_C(-0.3), REAL_C(0.4));
+	const vectorlib::Vec4 a(v0);
+	const vectorlib::Vec4 b(v1);
+	const vectorlib::Vec4 c(v2);
+	vectorlib::Vec4 r;
+
+	r = a + b;
+	EXPECT_VECTOREQ(r, vector_add(v0, v1));
+	r = a - b;
+	EXPECT_VECTOREQ(r, vector_sub(v0, v1));
+	r = a * b;
+	EXPECT_VECTOREQ(r, vector_mul(v0, v1));
+	r = a / b;
+	EXPECT_VECTOREQ(r, vector_div(v0, v1));
+	r = -a;
+	EXPECT_VECTOREQ(r, vector_neg(v0));
+	r = a * REAL_C(3.0);
+	EXPECT_VECTOREQ(r, vector_scale(v0, REAL_C(3.0)));
+	r = REAL_C(3.0) * a;
+	EXPECT_VECTOREQ(r, vector_scale(v0, REAL_C(3.0)));
+
+	// Products in sums are evaluated as multiply-add
+	r = a * b + c;
+	EXPECT_VECTOREQ(r, vector_muladd(v0, v1, v2));
+	r = c + a * b;
+	EXPECT_VECTOREQ(r, vector_muladd(v0, v1, v2));
+	r = a * b + b * c;
+	EXPECT_VECTOREQ(r, vector_muladd(v0, v1, vector_mul(v1, v2)));
+	r = a * REAL_C(2.0) + c;
+	EXPECT_VECTOREQ(r, vector_muladd(v0, vector_uniform(REAL_C(2.0)), v2));
+	r = (a + b) * c - a;
+	EXPECT_VECTOREQ(r, vector_sub(vector_mul(vector_add(v0, v1), v2), v0));
+
+	// Expressions hold operands by value and can be stored
+	auto expr = a * b + c;
+	r = expr;
+	EXPECT_VECTOREQ(r, vector_muladd(v0, v1, v2));
+
+	r = a;
+	r += b * c;
+	EXPECT_VECTOREQ(r, vector_muladd(v1, v2, v0));
+	r = a;
+	r -= b;
+	EXPECT_VECTOREQ(r, vector_sub(v0, v1));
+	r = a;
+	r *= b;
+	EXPECT_VECTOREQ(r, vector_mul(v0, v1));
+	r = a;
+	r /= b;
+	EXPECT_VECTOREQ(r, vector_div(v0, v1));
+	r = a;
+	r *= REAL_C(0.5);
+	EXPECT_VECTOREQ(r, vector_scale(v0, REAL_C(0.5)));
+
+	EXPECT_REALEQ(vectorlib::dot(a, b), vector_x(vector_dot(v0, v1)));
+	EXPECT_REALEQ(vectorlib::dot3(a, b), vector_x(vector_dot3(v0, v1)));
+	EXPECT_REALEQ(vectorlib::length(a), vector_x(vector_length(v0)));
+	EXPECT_REALEQ(vectorlib::length3(a), vector_x(vector_length3(v0)));
+	EXPECT_REALEQ(vectorlib::length_sqr(a), vector_x(vector_length_sqr(v0)));
+	EXPECT_REALEQ(vectorlib::length3_sqr(a), vector_x(vector_length3_sqr(v0)));
+	EXPECT_VECTOREQ(vectorlib::cross3(a, b), vector_cross3(v0, v1));
+	EXPECT_VECTOREQ(vectorlib::normalize(a), vector_normalize(v0));
+	EXPECT_VECTOREQ(vectorlib::normalize3(a), vector_normalize3(v0));
+	EXPECT_VECTOREQ(vectorlib::lerp(a, b, REAL_C(0.25)), vector_lerp(v0, v1, REAL_C(0.25)));
+	EXPECT_VECTOREQ(vectorlib::project(a, b), vector_project(v0, v1));
+	EXPECT_VECTOREQ(vectorlib::reflect(a, b), vector_reflect(v0, v1));
+	EXPECT_VECTOREQ(vectorlib::min(a, b), vector_min(v0, v1));
+	EXPECT_VECTOREQ(vectorlib::max(a, b), vector_max(v0, v1));
+	EXPECT_VECTOREQ(vectorlib::abs(b), vector_abs(v1));
+	EXPECT_VECTOREQ(vectorlib::floor(a), vector_floor(v0));
+	EXPECT_VECTOREQ(vectorlib::ceil(a), vector_ceil(v0));
+	EXPECT_VECTOREQ(vectorlib::round(a), vector_round(v0));
+
+	// Expressions are accepted by functions taking vectors
+	EXPECT_VECTOREQ(vectorlib::normalize(a * b + c), vector_normalize(vector_muladd(v0, v1, v2)));
+
+	EXPECT_REALEQ(a.x(), REAL_C(1.25));
+	EXPECT_REALEQ(a.y(), REAL_C(-2.5));
+	EXPECT_REALEQ(a.z(), REAL_C(3.75));
+	EXPECT_REALEQ(a.w(), REAL_C(0.5));
+	EXPECT_REALEQ(a[2], REAL_C(3.75));
+
+	return 0;
+}
+
+DECLARE_TEST(cpp, matrix) {
+	const vector_t v0 = vector(REAL_C(1.25), REAL_C(-2.5), REAL_C(3.75), REAL_C(1.0));
+	const quaternion_t q0 = quaternion_normalize(vector(REAL_C(0.1), REAL_C(-0.4), REAL_C(0.2), REAL_C(0.9)));
+	const matrix_t m0 = matrix_mul(matrix_from_quaternion(q0), matrix_translation(vector(1, 2, 3, 1)));
+	const matrix_t m1 = matrix_scaling(vector(2, 3, 4, 1));
+	const vectorlib::Mat4 a(m0);
+	const vectorlib::Mat4 b(m1);
+	const vectorlib::Vec4 v(v0);
+	vectorlib::Mat4 r;
+
+	matrix_t expect;
+
+	r = a * b;
+	expect = matrix_mul(m0, m1);
+	EXPECT_TRUE(memcmp(&r.m, &expect, sizeof(matrix_t)) == 0);
+	r = a + b;
+	expect = matrix_add(m0, m1);
+	EXPECT_TRUE(memcmp(&r.m, &expect, sizeof(matrix_t)) == 0);
+	r = a - b;
+	expect = matrix_sub(m0, m1);
+	EXPECT_TRUE(memcmp(&r.m, &expect, sizeof(matrix_t)) == 0);
+	r = vectorlib::transpose(a);
+	expect = matrix_transpose(m0);
+	EXPECT_TRUE(memcmp(&r.m, &expect, sizeof(matrix_t)) == 0);
+
+	EXPECT_VECTOREQ(v * a, vector_transform(v0, m0));
+	EXPECT_VECTOREQ(vectorlib::transform(v, a), vector_transform(v0, m0));
+	EXPECT_VECTOREQ(vectorlib::rotate(v, a), vector_rotate(v0, m0));
+	EXPECT_VECTOREQ(a.get_translation(), matrix_get_translation(m0));
+	EXPECT_VECTOREQ(a.row(1), m0.row[1]);
+	EXPECT_VECTOREQ(vectorlib::Mat4::translation(v).get_translation(), matrix_get_translation(matrix_translation(v0)));
+
+	r = vectorlib::Mat4::identity();
+	EXPECT_VECTOREQ(v * r, v0);
+
+	return 0;
+}
+
+DECLARE_TEST(cpp, quaternion) {
+	const quaternion_t q0 = quaternion_normalize(vector(REAL_C(0.1), REAL_C(-0.4), REAL_C(0.2), REAL_C(0.9)));
+	const quaternion_t q1 = quaternion_normalize(vector(REAL_C(-0.6), REAL_C(0.3), REAL_C(0.5), REAL_C(0.4)));
+	const vector_t v0 = vector(REAL_C(1.25), REAL_C(-2.5), REAL_C(3.75), REAL_C(0.0));
+	const vectorlib::Quat a(q0);
+	const vectorlib::Quat b(q1);
+	vectorlib::Quat r;
+
+	r = a * b;
+	EXPECT_VECTOREQ(r, quaternion_mul(q0, q1));
+	r = a + b;
+	EXPECT_VECTOREQ(r, quaternion_add(q0, q1));
+	r = a - b;
+	EXPECT_VECTOREQ(r, quaternion_sub(q0, q1));
+	r = -a;
+	EXPECT_VECTOREQ(r, quaternion_neg(q0));
+	EXPECT_VECTOREQ(vectorlib::conjugate(a), quaternion_conjugate(q0));
+	EXPECT_VECTOREQ(vectorlib::inverse(a), quaternion_inverse(q0));
+	EXPECT_VECTOREQ(vectorlib::normalize(a * b), quaternion_normalize(quaternion_mul(q0, q1)));
+	EXPECT_VECTOREQ(vectorlib::slerp(a, b, REAL_C(0.3)), quaternion_slerp(q0, q1, REAL_C(0.3)));
+	EXPECT_VECTOREQ(vectorlib::rotate(a, v0), quaternion_rotate(q0, v0));
+	EXPECT_VECTOREQ(vectorlib::Quat::identity(), quaternion_identity());
+
+	const vectorlib::Mat4 m(a);
+	const matrix_t expect = matrix_from_quaternion(q0);
+	EXPECT_TRUE(memcmp(&m.m, &expect, sizeof(matrix_t)) == 0);
+	EXPECT_VECTOREQ(vectorlib::Quat::from_matrix(m), quaternion_from_matrix(m.m));
+
+	return 0;
+}
+
+static constexpr vectorlib::ConstQuat test_constant_quat =
+    vectorlib::constant::euler_angles_to_quaternion(REAL_C(0.3), REAL_C(-1.2), REAL_C(2.1), EULER_XYZs);
+static constexpr vectorlib::ConstMat4 test_constant_rig =
+    vectorlib::constant::matrix_mul(vectorlib::constant::matrix_from_quaternion(test_constant_quat),
+                                    vectorlib::constant::matrix_translation(REAL_C(1.0), REAL_C(2.0), REAL_C(3.0)));
+static constexpr vectorlib::ConstMat4 test_constant_perspective =
+    vectorlib::constant::matrix_perspective(REAL_C(1.2), REAL_C(1.5), REAL_C(0.5), REAL_C(100.0),
+                                            PROJECTION_DEPTH_ZERO_TO_ONE);
+
+static_assert(alignof(vectorlib::ConstMat4) == 16, "Constant matrix must be aligned");
+static_assert(vectorlib::constant::matrix_identity().m[15] == 1, "Constant identity matrix");
+static_assert(vectorlib::constant::matrix_translation(1, 2, 3).m[13] == 2, "Constant translation matrix");
+
+static bool
+test_constant_near(const vector_t v0, const vector_t v1, real tolerance) {
+	const vector_t diff = vector_abs(vector_sub(v0, v1));
+	for (int icomp = 0; icomp < 4; ++icomp) {
+		if (vector_component(diff, icomp) > tolerance)
+			return false;
+	}
+	return true;
+}
+
+DECLARE_TEST(cpp, constant) {
+	const euler_angles_order_t order[] = {EULER_XYZs, EULER_XYXs, EULER_XZYs, EULER_XZXs, EULER_YZXs,
+	                                      EULER_YXZs, EULER_ZXYr, EULER_ZYXr, EULER_XYXr, EULER_ZYZr};
+	for (size_t iorder = 0; iorder < sizeof(order) / sizeof(order[0]); ++iorder) {
+		const vectorlib::ConstQuat q = vectorlib::constant::euler_angles_to_quaternion(
+		    REAL_C(0.7), REAL_C(-0.4), REAL_C(2.5), order[iorder]);
+		const quaternion_t expect =
+		    euler_angles_to_quaternion(euler_angles(REAL_C(0.7), REAL_C(-0.4), REAL_C(2.5), order[iorder]));
+		EXPECT_TRUE(test_constant_near(q.load(), expect, REAL_C(1e-5)));
+	}
+
+	const quaternion_t q0 =
+	    euler_angles_to_quaternion(euler_angles(REAL_C(0.3), REAL_C(-1.2), REAL_C(2.1), EULER_XYZs));
+	const matrix_t rig = test_constant_rig.load();
+	const matrix_t expect = matrix_mul(matrix_from_quaternion(q0), matrix_translation(vector(1, 2, 3, 1)));
+	for (int row = 0; row < 4; ++row)
+		EXPECT_TRUE(test_constant_near(rig.row[row], expect.row[row], REAL_C(1e-5)));
+	EXPECT_TRUE(test_constant_near(test_constant_quat.load(), q0, REAL_C(1e-5)));
+
+	const vectorlib::ConstQuat q1 = vectorlib::constant::quaternion_normalize(
+	    vectorlib::constant::quaternion(REAL_C(-0.6), REAL_C(0.3), REAL_C(0.5), REAL_C(0.4)));
+	const quaternion_t q1_expect = quaternion_normalize(vector(REAL_C(-0.6), REAL_C(0.3), REAL_C(0.5), REAL_C(0.4)));
+	EXPECT_TRUE(test_constant_near(q1.load(), q1_expect, REAL_C(1e-6)));
+	// Compare to the double precision product
+	const quaternion_t q_mul = quaternion64_to_quaternion(
+	    quaternion64_mul(quaternion64_from_quaternion(q0), quaternion64_from_quaternion(q1_expect)));
+	EXPECT_TRUE(test_constant_near(vectorlib::constant::quaternion_mul(test_constant_quat, q1).load(), q_mul,
+	                               REAL_C(1e-5)));
+
+	const matrix_t transposed = vectorlib::constant::matrix_transpose(test_constant_rig).load();
+	const matrix_t transposed_expect = matrix_transpose(rig);
+	EXPECT_TRUE(memcmp(&transposed, &transposed_expect, sizeof(matrix_t)) == 0);
+
+	const matrix_t identity = vectorlib::constant::matrix_identity().load();
+	const matrix_t identity_expect = matrix_identity();
+	EXPECT_TRUE(memcmp(&identity, &identity_expect, sizeof(matrix_t)) == 0);
+	const matrix_t scaling = vectorlib::constant::matrix_scaling(2, 3, 4).load();
+	const matrix_t scaling_expect = matrix_scaling(vector(2, 3, 4, 1));
+	EXPECT_TRUE(memcmp(&scaling, &scaling_expect, sizeof(matrix_t)) == 0);
+
+	// Near plane maps to depth 0, far plane to depth 1
+	const matrix_t proj = test_constant_perspective.load();
+	vector_t clip = vector_transform(vector(0, 0, REAL_C(-0.5), 1), proj);
+	EXPECT_REALEQ(vector_z(clip) / vector_w(clip), 0);
+	clip = vector_transform(vector(0, 0, REAL_C(-100.0), 1), proj);
+	EXPECT_TRUE(math_abs(vector_z(clip) / vector_w(clip) - 1) < REAL_C(1e-6));
+	// Top of the frustum maps to y 1
+	clip = vector_transform(vector(0, math_tan(REAL_C(0.6)) * 10, -10, 1), proj);
+	EXPECT_TRUE(math_abs(vector_y(clip) / vector_w(clip) - 1) < REAL_C(1e-5));
+
+	for (unsigned int flags = 0; flags < 8; ++flags) {
+		const matrix_t persp =
+		    vectorlib::constant::matrix_perspective(REAL_C(1.2), REAL_C(1.5), REAL_C(0.5), REAL_C(100.0), flags).load();
+		const matrix_t persp_expect = matrix_perspective(REAL_C(1.2), REAL_C(1.5), REAL_C(0.5), REAL_C(100.0), flags);
+		for (int row = 0; row < 4; ++row)
+			EXPECT_TRUE(test_constant_near(persp.row[row], persp_expect.row[row], REAL_C(1e-5)));
+	}
+
+	const matrix_t ortho =
+	    vectorlib::constant::matrix_orthographic(-2, 6, -1, 3, REAL_C(1.0), REAL_C(11.0), PROJECTION_DEPTH_ZERO_TO_ONE)
+	        .load();
+	EXPECT_TRUE(test_constant_near(vector_transform(vector(6, -1, -11, 1), ortho), vector(1, -1, 1, 1),
+	                               REAL_C(1e-6)));
+	EXPECT_TRUE(test_constant_near(vector_transform(vector(-2, 3, -1, 1), ortho), vector(-1, 1, 0, 1),
+	                               REAL_C(1e-6)));
+
+	return 0;
+}
+
+DECLARE_TEST(cpp, overhead) {
+	// Particle integration step through the C API and through the wrapper operators, the
+	// wrapper must produce the same results at no extra cost
+	const size_t count = 4096;
+	const int passes = 256;
+	vector_t* position = static_cast<vector_t*>(
+	    memory_allocate(HASH_TEST, sizeof(vector_t) * count * 4, 16, MEMORY_PERSISTENT));
+	vector_t* velocity = position + count;
+	vectorlib::Vec4* wrap_position = reinterpret_cast<vectorlib::Vec4*>(velocity + count);
+	vectorlib::Vec4* wrap_velocity = wrap_position + count;
+	for (size_t item = 0; item < count; ++item) {
+		const real value = (real)item;
+		position[item] = vector(value, -value, value * REAL_C(0.5), 1);
+		velocity[item] = vector(REAL_C(0.25), value * REAL_C(0.01), -REAL_C(0.5), 0);
+		wrap_position[item] = position[item];
+		wrap_velocity[item] = velocity[item];
+	}
+
+	const vector_t dt = vector_uniform(REAL_C(1.0) / REAL_C(60.0));
+	const vector_t damping = vector_uniform(REAL_C(0.999));
+	const vector_t gravity = vector(0, REAL_C(-9.81), 0, 0);
+
+	tick_t start = time_current();
+	for (int pass = 0; pass < passes; ++pass) {
+		for (size_t item = 0; item < count; ++item) {
+			position[item] = vector_muladd(velocity[item], dt, position[item]);
+			velocity[item] = vector_muladd(velocity[item], damping, vector_mul(gravity, dt));
+		}
+	}
+	const tick_t c_ticks = time_elapsed_ticks(start);
+
+	const vectorlib::Vec4 wrap_dt(dt);
+	const vectorlib::Vec4 wrap_damping(damping);
+	const vectorlib::Vec4 wrap_gravity(gravity);
+	start = time_current();
+	for (int pass = 0; pass < passes; ++pass) {
+		for (size_t item = 0; item < count; ++item) {
+			wrap_position[item] = wrap_velocity[item] * wrap_dt + wrap_position[item];
+			wrap_velocity[item] = wrap_velocity[item] * wrap_damping + wrap_gravity * wrap_dt;
+		}
+	}
+	const tick_t wrap_ticks = time_elapsed_ticks(start);
+
+	log_infof(HASH_TEST, STRING_CONST("Integration of %d points x %d passes: C API %.3fms, C++ wrapper %.3fms"),
+	          (int)count, passes, (double)time_ticks_to_seconds(c_ticks) * 1000.0,
+	          (double)time_ticks_to_seconds(wrap_ticks) * 1000.0);
+	FOUNDATION_UNUSED(c_ticks);
+	FOUNDATION_UNUSED(wrap_ticks);
+
+	for (size_t item = 0; item < count; ++item) {
+		EXPECT_VECTOREQ(wrap_position[item], position[item]);
+		EXPECT_VECTOREQ(wrap_velocity[item], velocity[item]);
+	}
+
+	memory_deallocate(position);
+	return 0;
+}
+
+static void
+test_cpp_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(cpp, vector);
+	ADD_TEST(cpp, matrix);
+	ADD_TEST(cpp, quaternion);
+	ADD_TEST(cpp, constant);
+	ADD_TEST(cpp, overhead);
+}
+
+static test_suite_t test_cpp_suite = {test_cpp_application,
+                                      test_cpp_memory_system,
+                                      test_cpp_config,
+                                      test_cpp_declare,
+                                      test_cpp_initialize,
+                                      test_cpp_finalize,
+                                      0};
+
+#if BUILD_MONOLITHIC
+
+extern "C" int
+test_cpp_run(void);
+
+extern "C" int
+test_cpp_run(void) {
+	test_suite = test_cpp_suite;
+	return test_run_all();
+}
+
+#else
+
+extern "C" test_suite_t
+test_suite_define(void);
+
+extern "C" test_suite_t
+test_suite_define(void) {
+	return test_cpp_suite;
+}
+
+#endif
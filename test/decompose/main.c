@@ -0,0 +1,327 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_decompose_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Decompose tests"));
+	app.short_name = string_const(STRING_CONST("test_decompose"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_decompose_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_decompose_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_decompose_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_decompose_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_decompose_seed;
+
+static real
+test_decompose_random(real low, real high) {
+	test_decompose_seed = test_decompose_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_decompose_seed >> 8) / (real)(1U << 24));
+}
+
+static quaternion_t
+test_decompose_random_rotation(void) {
+	return quaternion_normalize(vector(test_decompose_random(-1, 1), test_decompose_random(-1, 1),
+	                                   test_decompose_random(-1, 1), test_decompose_random(-1, 1)));
+}
+
+//! Compare upper left 3x3 parts with tolerance relative to the largest element
+static bool
+test_decompose_matrix_near(const matrix_t m0, const matrix_t m1, real tolerance) {
+	real largest = 1;
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 3; ++col)
+			largest = (math_abs(m1.frow[row][col]) > largest) ? math_abs(m1.frow[row][col]) : largest;
+	}
+	for (int row = 0; row < 3; ++row) {
+		for (int col = 0; col < 3; ++col) {
+			if (math_abs(m0.frow[row][col] - m1.frow[row][col]) > tolerance * largest)
+				return false;
+		}
+	}
+	return true;
+}
+
+//! Orthonormal rows with determinant one
+static bool
+test_decompose_is_rotation(const matrix_t m) {
+	const matrix_t product = matrix_mul(m, matrix_transpose(m));
+	if (!test_decompose_matrix_near(product, matrix_identity(), REAL_C(1e-5)))
+		return false;
+	const real det = vector_x(vector_dot3(vector_cross3(m.row[0], m.row[1]), m.row[2]));
+	return math_abs(det - 1) < REAL_C(1e-5);
+}
+
+static matrix_t
+test_decompose_diagonal(real x, real y, real z) {
+	return matrix_scaling(vector(x, y, z, 1));
+}
+
+DECLARE_TEST(decompose, eigen) {
+	vector_t value;
+	matrix_t vec;
+
+	// Diagonal matrix is sorted, repeated eigenvalues give an orthonormal basis
+	matrix_eigen_symmetric(test_decompose_diagonal(2, 5, -1), &value, &vec);
+	EXPECT_VECTOREQ(value, vector(5, 2, -1, 0));
+	EXPECT_TRUE(test_decompose_is_rotation(vec));
+	EXPECT_REALONE(math_abs(vector_y(vec.row[0])));
+	matrix_eigen_symmetric(matrix_identity(), &value, &vec);
+	EXPECT_VECTOREQ(value, vector(1, 1, 1, 0));
+	EXPECT_TRUE(test_decompose_is_rotation(vec));
+
+	test_decompose_seed = 1;
+	for (int iter = 0; iter < 256; ++iter) {
+		// Random symmetric matrix from random rotation and eigenvalues, some repeated
+		const matrix_t rot = matrix_from_quaternion(test_decompose_random_rotation());
+		const real l0 = test_decompose_random(-10, 10);
+		const real l1 = (iter % 4) ? test_decompose_random(-10, 10) : l0;
+		const real l2 = test_decompose_random(-10, 10);
+		const matrix_t m = matrix_mul(matrix_transpose(rot), matrix_mul(test_decompose_diagonal(l0, l1, l2), rot));
+
+		matrix_eigen_symmetric(m, &value, &vec);
+		EXPECT_TRUE(test_decompose_is_rotation(vec));
+		EXPECT_TRUE(vector_x(value) >= vector_y(value));
+		EXPECT_TRUE(vector_y(value) >= vector_z(value));
+		const matrix_t diagonal = test_decompose_diagonal(vector_x(value), vector_y(value), vector_z(value));
+		const matrix_t rebuilt = matrix_mul(matrix_transpose(vec), matrix_mul(diagonal, vec));
+		EXPECT_TRUE(test_decompose_matrix_near(rebuilt, m, REAL_C(1e-5)));
+		const real trace = m.frow[0][0] + m.frow[1][1] + m.frow[2][2];
+		EXPECT_TRUE(math_abs(vector_x(value) + vector_y(value) + vector_z(value) - trace) < REAL_C(1e-4));
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(decompose, polar) {
+	matrix_t rotation, stretch;
+
+	test_decompose_seed = 2;
+	for (int iter = 0; iter < 256; ++iter) {
+		// Positive definite stretch in random frame followed by random rotation
+		const matrix_t frame = matrix_from_quaternion(test_decompose_random_rotation());
+		const matrix_t scale =
+		    test_decompose_diagonal(test_decompose_random(REAL_C(0.2), 4), test_decompose_random(REAL_C(0.2), 4),
+		                            test_decompose_random(REAL_C(0.2), 4));
+		const matrix_t expect_stretch = matrix_mul(matrix_transpose(frame), matrix_mul(scale, frame));
+		const matrix_t expect_rotation = matrix_from_quaternion(test_decompose_random_rotation());
+		matrix_t m = matrix_mul(expect_stretch, expect_rotation);
+		m.row[3] = vector(1, 2, 3, 1);
+
+		matrix_polar_decompose(m, &rotation, &stretch);
+		EXPECT_TRUE(test_decompose_is_rotation(rotation));
+		EXPECT_TRUE(test_decompose_matrix_near(rotation, expect_rotation, REAL_C(1e-4)));
+		EXPECT_TRUE(test_decompose_matrix_near(stretch, expect_stretch, REAL_C(1e-4)));
+		EXPECT_TRUE(test_decompose_matrix_near(matrix_mul(stretch, rotation), m, REAL_C(1e-5)));
+		EXPECT_VECTOREQ(rotation.row[3], vector(0, 0, 0, 1));
+		EXPECT_VECTOREQ(stretch.row[3], vector(0, 0, 0, 1));
+	}
+
+	// Flattened matrix still gives a proper rotation
+	const matrix_t flat_rotation = matrix_from_quaternion(test_decompose_random_rotation());
+	const matrix_t flat = matrix_mul(test_decompose_diagonal(2, 3, 0), flat_rotation);
+	matrix_polar_decompose(flat, &rotation, &stretch);
+	EXPECT_TRUE(test_decompose_is_rotation(rotation));
+	EXPECT_TRUE(test_decompose_matrix_near(matrix_mul(stretch, rotation), flat, REAL_C(1e-5)));
+	const matrix_t line = matrix_mul(test_decompose_diagonal(0, 3, 0), flat_rotation);
+	matrix_polar_decompose(line, &rotation, &stretch);
+	EXPECT_TRUE(test_decompose_is_rotation(rotation));
+	EXPECT_TRUE(test_decompose_matrix_near(matrix_mul(stretch, rotation), line, REAL_C(1e-5)));
+	matrix_polar_decompose(matrix_zero(), &rotation, &stretch);
+	EXPECT_TRUE(test_decompose_is_rotation(rotation));
+
+	// Reflection keeps a proper rotation and puts the negative sign in the stretch
+	const matrix_t mirror = matrix_mul(test_decompose_diagonal(-1, 2, 2), flat_rotation);
+	matrix_polar_decompose(mirror, &rotation, &stretch);
+	EXPECT_TRUE(test_decompose_is_rotation(rotation));
+	EXPECT_TRUE(test_decompose_matrix_near(matrix_mul(stretch, rotation), mirror, REAL_C(1e-5)));
+	EXPECT_TRUE(vector_x(vector_dot3(vector_cross3(stretch.row[0], stretch.row[1]), stretch.row[2])) < 0);
+
+	return 0;
+}
+
+DECLARE_TEST(decompose, transform) {
+	transform_t transform;
+	vector_t scale;
+
+	const quaternion_t q = quaternion_normalize(vector(REAL_C(0.2), REAL_C(-0.5), REAL_C(0.3), REAL_C(0.8)));
+	const matrix_t rot = matrix_from_quaternion(q);
+	matrix_t m = matrix_mul(test_decompose_diagonal(3, 3, 3), rot);
+	m.row[3] = vector(4, 5, 6, 1);
+	EXPECT_UINTEQ(matrix_decompose(m, &transform, &scale), 0);
+	EXPECT_VECTORALMOSTEQ(transform.translation, vector(4, 5, 6, 3));
+	EXPECT_VECTORALMOSTEQ(scale, vector(3, 3, 3, 0));
+	const vector_t point = vector(1, -2, 3, 1);
+	const vector_t rotated = quaternion_rotate(transform.rotation, vector_scale(vector(1, -2, 3, 0), 3));
+	const vector_t expect = vector_set_component(vector_add(rotated, vector(4, 5, 6, 0)), 3, 1);
+	EXPECT_VECTORALMOSTEQ(expect, vector_transform(point, m));
+
+	m = matrix_mul(test_decompose_diagonal(1, 2, 3), rot);
+	EXPECT_UINTEQ(matrix_decompose(m, &transform, &scale), MATRIX_DECOMPOSE_NONUNIFORM_SCALE);
+	EXPECT_VECTORALMOSTEQ(scale, vector(1, 2, 3, 0));
+	EXPECT_REALEQ(vector_w(transform.translation), 2);
+
+	matrix_t shear = matrix_identity();
+	shear.frow[1][0] = REAL_C(0.5);
+	m = matrix_mul(shear, rot);
+	EXPECT_TRUE(matrix_decompose(m, &transform, 0) & MATRIX_DECOMPOSE_SHEAR);
+
+	m = matrix_mul(test_decompose_diagonal(2, -2, 2), rot);
+	EXPECT_TRUE(matrix_decompose(m, &transform, 0) & MATRIX_DECOMPOSE_REFLECTION);
+
+	return 0;
+}
+
+DECLARE_TEST(decompose, array) {
+	const size_t count = 77;
+	matrix_t* m = memory_allocate(HASH_TEST, sizeof(matrix_t) * count * 6, 16, MEMORY_PERSISTENT);
+	matrix_t* eigenvectors = m + count;
+	matrix_t* rotation = m + count * 2;
+	matrix_t* stretch = m + count * 3;
+	vector_t* value = memory_allocate(HASH_TEST, sizeof(vector_t) * count * 2, 16, MEMORY_PERSISTENT);
+	vector_t* scale = value + count;
+	transform_t* transform = memory_allocate(HASH_TEST, sizeof(transform_t) * count, 16, MEMORY_PERSISTENT);
+	uint8_t* flags = memory_allocate(HASH_TEST, count, 0, MEMORY_PERSISTENT);
+
+	test_decompose_seed = 3;
+	for (size_t imat = 0; imat < count; ++imat) {
+		m[imat] = matrix_mul(test_decompose_diagonal(test_decompose_random(1, 2), test_decompose_random(1, 2),
+		                                             test_decompose_random(1, 2)),
+		                     matrix_from_quaternion(test_decompose_random_rotation()));
+		m[imat].row[3] = vector(test_decompose_random(-5, 5), test_decompose_random(-5, 5), 0, 1);
+	}
+
+	matrix_eigen_symmetric_array(m, count, value, eigenvectors);
+	matrix_polar_decompose_array(m, count, rotation, stretch);
+	matrix_decompose_array(m, count, transform, scale, flags);
+	for (size_t imat = 0; imat < count; ++imat) {
+		vector_t single_value, single_scale;
+		matrix_t single_vec, single_rotation, single_stretch;
+		transform_t single_transform;
+		matrix_eigen_symmetric(m[imat], &single_value, &single_vec);
+		EXPECT_TRUE(memcmp(&single_value, value + imat, sizeof(vector_t)) == 0);
+		EXPECT_TRUE(memcmp(&single_vec, eigenvectors + imat, sizeof(matrix_t)) == 0);
+		matrix_polar_decompose(m[imat], &single_rotation, &single_stretch);
+		EXPECT_TRUE(memcmp(&single_rotation, rotation + imat, sizeof(matrix_t)) == 0);
+		EXPECT_TRUE(memcmp(&single_stretch, stretch + imat, sizeof(matrix_t)) == 0);
+		EXPECT_UINTEQ(matrix_decompose(m[imat], &single_transform, &single_scale), flags[imat]);
+		EXPECT_TRUE(memcmp(&single_transform, transform + imat, sizeof(transform_t)) == 0);
+		EXPECT_TRUE(memcmp(&single_scale, scale + imat, sizeof(vector_t)) == 0);
+	}
+
+	memory_deallocate(m);
+	memory_deallocate(value);
+	memory_deallocate(transform);
+	memory_deallocate(flags);
+
+	return 0;
+}
+
+static void
+test_decompose_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(decompose, eigen);
+	ADD_TEST(decompose, polar);
+	ADD_TEST(decompose, transform);
+	ADD_TEST(decompose, array);
+}
+
+static test_suite_t test_decompose_suite = {test_decompose_application,
+                                            test_decompose_memory_system,
+                                            test_decompose_config,
+                                            test_decompose_declare,
+                                            test_decompose_initialize,
+                                            test_decompose_finalize,
+                                            0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_decompose_run(void);
+
+int
+test_decompose_run(void) {
+	test_suite = test_decompose_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_decompose_suite;
+}
+
+#endif
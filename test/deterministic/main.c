@@ -0,0 +1,359 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+#if !VECTOR_DETERMINISTIC
+#error Deterministic test must be built with VECTOR_DETERMINISTIC=1, linked with the vector_deterministic library
+#endif
+
+static application_t
+test_deterministic_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Deterministic math tests"));
+	app.short_name = string_const(STRING_CONST("test_deterministic"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_deterministic_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_deterministic_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_deterministic_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_deterministic_finalize(void) {
+	vector_module_finalize();
+}
+
+#define DETERMINISTIC_TEST_COUNT 256
+
+// Expected hashes of results, the same for all implementations and platforms
+static const uint32_t deterministic_test_vector_expect[33] = {
+	0x848993b2U, 0x244f799fU, 0x1facd205U, 0x7def52bdU, 0xfc59ec99U, 0xd78b700dU, 0x894c87b1U,
+	0x8e2f311cU, 0xecfd449cU, 0xc79e5d28U, 0x671af4d9U, 0x88310c6eU, 0x102756daU, 0xa81faf17U,
+	0xba0c87c1U, 0xd8454c4cU, 0x15279b63U, 0x110e3172U, 0x7a1f1d35U, 0x7a1f1d35U, 0x9876bfc5U,
+	0x6da90435U, 0x6da90435U, 0x44771bedU, 0x233fcf34U, 0xc5bfb6adU, 0xba3b7f91U, 0xed953151U,
+	0xf48172b6U, 0xf1c3be84U, 0xfe252e20U, 0x5619d540U, 0xed953151U};
+
+static const uint32_t deterministic_test_quaternion_expect[9] = {
+	0x00e00e9bU, 0x17760692U, 0xc4fbe5ecU, 0xd2f1900fU, 0xd5d2aec1U, 0x04c7ed1eU, 0x7f665a47U,
+	0x9a461bbaU, 0x7666517cU};
+
+static const uint32_t deterministic_test_matrix_expect[5] = {
+	0xb4feb43cU, 0xa0a43390U, 0x52eb4a88U, 0xf281d64bU, 0x0c773647U};
+
+static const uint32_t deterministic_test_scalar_expect[5] = {
+	0x9f59cbe3U, 0xff944973U, 0xc5d8d9f6U, 0x3020c8bdU, 0x5585da76U};
+
+static uint32_t deterministic_test_seed;
+
+//! Random value with 16 bits of fraction in [-range, range], exactly representable
+static real
+deterministic_test_random(real range) {
+	deterministic_test_seed = deterministic_test_seed * 1664525U + 1013904223U;
+	const int32_t value = (int32_t)(deterministic_test_seed >> 16) - 32768;
+	return (real)value * (range / REAL_C(32768.0));
+}
+
+static vector_t
+deterministic_test_vector(real range) {
+	const real x = deterministic_test_random(range);
+	const real y = deterministic_test_random(range);
+	const real z = deterministic_test_random(range);
+	const real w = deterministic_test_random(range);
+	return vector(x, y, z, w);
+}
+
+static quaternion_t
+deterministic_test_quaternion(void) {
+	return quaternion_normalize(deterministic_test_vector(1));
+}
+
+//! FNV-1a over the bits of the result
+static uint32_t
+deterministic_test_hash(uint32_t hash, const void* data, size_t size) {
+	const unsigned char* byte = data;
+	for (size_t ibyte = 0; ibyte < size; ++ibyte)
+		hash = (hash ^ byte[ibyte]) * 16777619U;
+	return hash;
+}
+
+static uint32_t
+deterministic_test_hash_vector(uint32_t hash, const vector_t v) {
+	float32_t value[4] = {vector_x(v), vector_y(v), vector_z(v), vector_w(v)};
+	return deterministic_test_hash(hash, value, sizeof(value));
+}
+
+static uint32_t
+deterministic_test_hash_real(uint32_t hash, real value) {
+	const float32_t bits = (float32_t)value;
+	return deterministic_test_hash(hash, &bits, sizeof(bits));
+}
+
+static uint32_t
+deterministic_test_hash_matrix(uint32_t hash, const matrix_t m) {
+	for (int row = 0; row < 4; ++row)
+		hash = deterministic_test_hash_vector(hash, m.row[row]);
+	return hash;
+}
+
+#define DETERMINISTIC_TEST_BASIS 2166136261U
+
+DECLARE_TEST(deterministic, vector) {
+	const uint32_t* expect = deterministic_test_vector_expect;
+	uint32_t hash[33];
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		hash[ihash] = DETERMINISTIC_TEST_BASIS;
+
+	deterministic_test_seed = 1;
+	for (int iloop = 0; iloop < DETERMINISTIC_TEST_COUNT; ++iloop) {
+		const vector_t v0 = deterministic_test_vector(100);
+		const vector_t v1 = deterministic_test_vector(100);
+		const vector_t v2 = deterministic_test_vector(100);
+		const real factor = deterministic_test_random(1);
+		matrix_t m;
+		m.row[0] = deterministic_test_vector(2);
+		m.row[1] = deterministic_test_vector(2);
+		m.row[2] = deterministic_test_vector(2);
+		m.row[3] = deterministic_test_vector(100);
+
+		int op = 0;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_normalize(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_normalize3(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_dot(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_dot3(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_cross3(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_mul(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_div(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_add(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_add_triple(v0, v1, v2)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_sub(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_neg(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_muladd(v0, v1, v2)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_scale(v0, factor)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_lerp(v0, v1, factor)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_project(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_reflect(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_project3(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_reflect3(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length_fast(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length_sqr(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length3(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length3_fast(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_length3_sqr(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_sqrt(vector_abs(v0))), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_min(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_max(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_floor(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_ceil(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_round(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_rotate(v0, m)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vector_transform(v0, m)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], vectori_to_vector(vector_to_vectori_floor(v0))), ++op;
+	}
+
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		EXPECT_UINTEQ(hash[ihash], expect[ihash]);
+	return 0;
+}
+
+DECLARE_TEST(deterministic, quaternion) {
+	const uint32_t* expect = deterministic_test_quaternion_expect;
+	uint32_t hash[9];
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		hash[ihash] = DETERMINISTIC_TEST_BASIS;
+
+	deterministic_test_seed = 2;
+	for (int iloop = 0; iloop < DETERMINISTIC_TEST_COUNT; ++iloop) {
+		const quaternion_t q0 = deterministic_test_quaternion();
+		const quaternion_t q1 = deterministic_test_quaternion();
+		const vector_t v0 = deterministic_test_vector(100);
+		const vector_t v1 = deterministic_test_vector(100);
+		const real factor = deterministic_test_random(1);
+		const matrix_t m = matrix_from_quaternion(q0);
+
+		int op = 0;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_mul(q0, q1)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_conjugate(q0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_inverse(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_normalize(v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_slerp(q0, q1, factor)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_rotate(q0, v0)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_from_matrix(m)), ++op;
+		hash[op] = deterministic_test_hash_vector(hash[op], quaternion_rotating_vector(v0, v1)), ++op;
+		hash[op] = deterministic_test_hash_matrix(hash[op], m), ++op;
+	}
+
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		EXPECT_UINTEQ(hash[ihash], expect[ihash]);
+	return 0;
+}
+
+DECLARE_TEST(deterministic, matrix) {
+	const uint32_t* expect = deterministic_test_matrix_expect;
+	uint32_t hash[5];
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		hash[ihash] = DETERMINISTIC_TEST_BASIS;
+
+	deterministic_test_seed = 3;
+	for (int iloop = 0; iloop < DETERMINISTIC_TEST_COUNT; ++iloop) {
+		matrix_t m0;
+		matrix_t m1;
+		for (int row = 0; row < 4; ++row) {
+			m0.row[row] = deterministic_test_vector(10);
+			m1.row[row] = deterministic_test_vector(10);
+		}
+
+		int op = 0;
+		hash[op] = deterministic_test_hash_matrix(hash[op], matrix_mul(m0, m1)), ++op;
+		hash[op] = deterministic_test_hash_matrix(hash[op], matrix_transpose(m0)), ++op;
+		hash[op] = deterministic_test_hash_matrix(hash[op], matrix_add(m0, m1)), ++op;
+		hash[op] = deterministic_test_hash_matrix(hash[op], matrix_sub(m0, m1)), ++op;
+
+		// Projection parameters from the first row, keeping the random sequence of the other ops
+		const real fov = REAL_C(1.5) + vector_x(m0.row[0]) * REAL_C(0.0625);
+		const real aspect = REAL_C(1.5) + vector_y(m0.row[0]) * REAL_C(0.03125);
+		const real znear = REAL_C(0.5) + vector_z(m0.row[0]) * REAL_C(0.03125);
+		const real zfar = REAL_C(100.0) + vector_w(m0.row[0]) * 4;
+		const unsigned int flags = (unsigned int)iloop & 7;
+		hash[op] = deterministic_test_hash_matrix(hash[op], matrix_perspective(fov, aspect, znear, zfar, flags)), ++op;
+	}
+
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		EXPECT_UINTEQ(hash[ihash], expect[ihash]);
+	return 0;
+}
+
+DECLARE_TEST(deterministic, scalar) {
+	const uint32_t* expect = deterministic_test_scalar_expect;
+	uint32_t hash[5];
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		hash[ihash] = DETERMINISTIC_TEST_BASIS;
+
+	deterministic_test_seed = 4;
+	for (int iloop = 0; iloop < DETERMINISTIC_TEST_COUNT; ++iloop) {
+		const real angle = deterministic_test_random(10);
+		const real cosval = deterministic_test_random(1);
+		const real y = deterministic_test_random(10);
+		const real x = deterministic_test_random(10);
+
+		int op = 0;
+		hash[op] = deterministic_test_hash_real(hash[op], vector_scalar_sin(angle)), ++op;
+		hash[op] = deterministic_test_hash_real(hash[op], vector_scalar_cos(angle)), ++op;
+		hash[op] = deterministic_test_hash_real(hash[op], vector_scalar_acos(cosval)), ++op;
+		hash[op] = deterministic_test_hash_real(hash[op], vector_scalar_atan2(y, x)), ++op;
+		hash[op] = deterministic_test_hash_real(hash[op], vector_scalar_tan(angle)), ++op;
+
+		EXPECT_TRUE(math_abs(vector_scalar_sin(angle) - math_sin(angle)) < REAL_C(2e-6));
+		EXPECT_TRUE(math_abs(vector_scalar_cos(angle) - math_cos(angle)) < REAL_C(2e-6));
+		EXPECT_TRUE(math_abs(vector_scalar_acos(cosval) - math_acos(cosval)) < REAL_C(2e-6));
+		EXPECT_TRUE(math_abs(vector_scalar_atan2(y, x) - math_atan2(y, x)) < REAL_C(2e-6));
+		// Error of the ratio grows with the derivative of tan
+		const real tanval = math_tan(angle);
+		EXPECT_TRUE(math_abs(vector_scalar_tan(angle) - tanval) < REAL_C(4e-6) * (1 + tanval * tanval));
+	}
+
+	for (size_t ihash = 0; ihash < sizeof(hash) / sizeof(hash[0]); ++ihash)
+		EXPECT_UINTEQ(hash[ihash], expect[ihash]);
+	return 0;
+}
+
+static void
+test_deterministic_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(deterministic, vector);
+	ADD_TEST(deterministic, quaternion);
+	ADD_TEST(deterministic, matrix);
+	ADD_TEST(deterministic, scalar);
+}
+
+static test_suite_t test_deterministic_suite = {test_deterministic_application,
+                                                test_deterministic_memory_system,
+                                                test_deterministic_config,
+                                                test_deterministic_declare,
+                                                test_deterministic_initialize,
+                                                test_deterministic_finalize,
+                                                0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_deterministic_run(void);
+
+int
+test_deterministic_run(void) {
+	test_suite = test_deterministic_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_deterministic_suite;
+}
+
+#endif
@@ -0,0 +1,237 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_half_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Half precision tests"));
+	app.short_name = string_const(STRING_CONST("test_half"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_half_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_half_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_half_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_half_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t
+half_test_bits(float32_t value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+static float32_t
+half_test_float(uint32_t bits) {
+	float32_t value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+DECLARE_TEST(half, scalar) {
+	EXPECT_UINTEQ(half_from_float(0), 0);
+	EXPECT_UINTEQ(half_from_float(-0.0f), 0x8000);
+	EXPECT_UINTEQ(half_from_float(1), 0x3C00);
+	EXPECT_UINTEQ(half_from_float(-2), 0xC000);
+	EXPECT_UINTEQ(half_from_float(65504), 0x7BFF);
+	EXPECT_UINTEQ(half_from_float(65519), 0x7BFF);
+	EXPECT_UINTEQ(half_from_float(65520), 0x7C00);
+	EXPECT_UINTEQ(half_from_float(-1e10f), 0xFC00);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x7F800000)), 0x7C00);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0xFFC00000)), 0xFE00);
+	// Signaling NaN is quieted
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x7F802000)), 0x7E01);
+
+	// Ties round to even
+	EXPECT_UINTEQ(half_from_float(1.0f + (1.0f / 2048.0f)), 0x3C00);
+	EXPECT_UINTEQ(half_from_float(1.0f + (3.0f / 2048.0f)), 0x3C02);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x3F801001)), 0x3C01);
+
+	// Subnormals, smallest is 2^-24
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x33800000)), 0x0001);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x33000000)), 0x0000);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x33000001)), 0x0001);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x33C00000)), 0x0002);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x34400000)), 0x0003);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0xB3C00000)), 0x8002);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x387FC000)), 0x03FF);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x387FE000)), 0x0400);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x387FF000)), 0x0400);
+	EXPECT_UINTEQ(half_from_float(half_test_float(0x38800000)), 0x0400);
+	EXPECT_UINTEQ(half_from_float(1e-10f), 0);
+
+	EXPECT_UINTEQ(half_test_bits(half_to_float(0x0001)), 0x33800000);
+	EXPECT_UINTEQ(half_test_bits(half_to_float(0x83FF)), 0xB87FC000);
+	EXPECT_UINTEQ(half_test_bits(half_to_float(0x7C00)), 0x7F800000);
+	EXPECT_UINTEQ(half_test_bits(half_to_float(0x7E01)), 0x7FC02000);
+	EXPECT_REALEQ(half_to_float(0x3555), REAL_C(0.333251953125));
+
+	// Every half converts to float and back unchanged, except that NaN is made quiet
+	for (uint32_t value = 0; value < 0x10000; ++value) {
+		const uint16_t half = (uint16_t)value;
+		const bool nan = ((half & 0x7C00) == 0x7C00) && (half & 0x3FF);
+		EXPECT_UINTEQ(half_from_float(half_to_float(half)), nan ? (half | 0x200) : half);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(half, vector) {
+	const vector_t v = vector(REAL_C(0.5), REAL_C(-3.25), REAL_C(1e-6), REAL_C(70000.0));
+	uint16_t half[4];
+	vector_to_half4(v, half);
+	EXPECT_UINTEQ(half[0], half_from_float(0.5f));
+	EXPECT_UINTEQ(half[1], half_from_float(-3.25f));
+	EXPECT_UINTEQ(half[2], half_from_float(1e-6f));
+	EXPECT_UINTEQ(half[3], 0x7C00);
+	EXPECT_VECTOREQ(vector_from_half4(half), vector(REAL_C(0.5), REAL_C(-3.25), half_to_float(half[2]),
+	                                                half_to_float(0x7C00)));
+
+	const float32_t special[4] = {half_test_float(0x7F802000), half_test_float(0xFFC00000), half_test_float(0xFF800000),
+	                              half_test_float(0x33000001)};
+	vector_to_half4(vector_unaligned(special), half);
+	for (int icomp = 0; icomp < 4; ++icomp)
+		EXPECT_UINTEQ(half[icomp], half_from_float(special[icomp]));
+
+	// Vector and array paths match the scalar conversion bit for bit
+	const size_t count = 4099;
+	float32_t* value = memory_allocate(HASH_TEST, sizeof(float32_t) * count, 16, MEMORY_PERSISTENT);
+	float32_t* restored = memory_allocate(HASH_TEST, sizeof(float32_t) * count, 16, MEMORY_PERSISTENT);
+	uint16_t* packed = memory_allocate(HASH_TEST, sizeof(uint16_t) * count, 0, MEMORY_PERSISTENT);
+	uint32_t seed = 1;
+	for (size_t ival = 0; ival < count; ++ival) {
+		// Random bit patterns cover normal, subnormal, overflow and rounding cases
+		seed = (seed * 1664525U) + 1013904223U;
+		value[ival] = half_test_float(seed & 0xC7FFFFFF);
+		if ((seed & 0x7F800000) == 0x7F800000)
+			value[ival] = 1;
+	}
+	half_from_float_array(value, count, packed);
+	for (size_t ival = 0; ival < count; ++ival)
+		EXPECT_UINTEQ(packed[ival], half_from_float(value[ival]));
+	half_to_float_array(packed, count, restored);
+	for (size_t ival = 0; ival < count; ++ival)
+		EXPECT_UINTEQ(half_test_bits(restored[ival]), half_test_bits(half_to_float(packed[ival])));
+
+	const size_t vector_count = count / 4;
+	vector_t* vec = memory_allocate(HASH_TEST, sizeof(vector_t) * vector_count, 16, MEMORY_PERSISTENT);
+	vector_t* vec_restored = memory_allocate(HASH_TEST, sizeof(vector_t) * vector_count, 16, MEMORY_PERSISTENT);
+	memcpy(vec, value, sizeof(vector_t) * vector_count);
+	vector_to_half4_array(vec, vector_count, packed);
+	for (size_t ival = 0; ival < vector_count * 4; ++ival)
+		EXPECT_UINTEQ(packed[ival], half_from_float(value[ival]));
+	vector_from_half4_array(packed, vector_count, vec_restored);
+	EXPECT_EQ(memcmp(vec_restored, restored, sizeof(vector_t) * vector_count), 0);
+
+	memory_deallocate(vec_restored);
+	memory_deallocate(vec);
+	memory_deallocate(packed);
+	memory_deallocate(restored);
+	memory_deallocate(value);
+
+	return 0;
+}
+
+static void
+test_half_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(half, scalar);
+	ADD_TEST(half, vector);
+}
+
+static test_suite_t test_half_suite = {test_half_application,
+                                       test_half_memory_system,
+                                       test_half_config,
+                                       test_half_declare,
+                                       test_half_initialize,
+                                       test_half_finalize,
+                                       0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_half_run(void);
+
+int
+test_half_run(void) {
+	test_suite = test_half_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_half_suite;
+}
+
+#endif
@@ -0,0 +1,322 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_hashgrid_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Hash grid tests"));
+	app.short_name = string_const(STRING_CONST("test_hashgrid"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_hashgrid_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_hashgrid_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_hashgrid_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_hashgrid_finalize(void) {
+	vector_module_finalize();
+}
+
+static real
+hashgrid_random(uint32_t* seed) {
+	*seed = *seed * 1664525U + 1013904223U;
+	return (real)(*seed >> 8) / (real)(1 << 24);
+}
+
+static vector_t
+hashgrid_random_point(uint32_t* seed, real scale) {
+	const real x = (hashgrid_random(seed) - REAL_C(0.5)) * scale;
+	const real y = (hashgrid_random(seed) - REAL_C(0.5)) * scale;
+	const real z = (hashgrid_random(seed) - REAL_C(0.5)) * scale;
+	return vector(x, y, z, 1);
+}
+
+static real
+hashgrid_test_distance_sqr(const vector_t point, const aabb_t box) {
+	const vector_t outside =
+	    vector_max(vector_max(vector_sub(box.min, point), vector_sub(point, box.max)), vector_zero());
+	return vector_x(vector_dot3(outside, outside));
+}
+
+static bool
+hashgrid_test_contains(const uint32_t* item, size_t count, uint32_t value) {
+	for (size_t iitem = 0; iitem < count; ++iitem) {
+		if (item[iitem] == value)
+			return true;
+	}
+	return false;
+}
+
+DECLARE_TEST(hashgrid, build) {
+	hashgrid_t* grid = hashgrid_allocate(REAL_C(1.0));
+	uint32_t item[8];
+
+	EXPECT_SIZEEQ(hashgrid_query_radius(grid, vector_zero(), 10, item, 8), 0);
+	EXPECT_SIZEEQ(hashgrid_query_nearest(grid, vector_zero(), 4, item, 0), 0);
+
+	const vector_t point[5] = {vector(0.5f, 0.5f, 0.5f, 1), vector(0.25f, 0.75f, 0.5f, 1), vector(-0.5f, 0.5f, 0.5f, 1),
+	                           vector(3.5f, -2.5f, 1.5f, 1), vector(-1.5f, -0.5f, 7.5f, 1)};
+	hashgrid_build_points(grid, point, 5);
+	EXPECT_UINTEQ(grid->count, 5);
+	EXPECT_UINTEQ(grid->cell_count, 4);
+	EXPECT_VECTORIEQ(grid->cell_min, vectori(-2, -3, 0, 1));
+	EXPECT_VECTORIEQ(grid->cell_max, vectori(3, 0, 7, 1));
+
+	EXPECT_SIZEEQ(hashgrid_query_radius(grid, vector(0.5f, 0.5f, 0.5f, 1), REAL_C(0.4), item, 8), 2);
+	EXPECT_TRUE(hashgrid_test_contains(item, 2, 0));
+	EXPECT_TRUE(hashgrid_test_contains(item, 2, 1));
+	EXPECT_SIZEEQ(hashgrid_query_radius(grid, vector(0.5f, 0.5f, 0.5f, 1), REAL_C(1.1), item, 1), 3);
+	EXPECT_SIZEEQ(hashgrid_query_aabb(grid, aabb(vector(3, -3, 1, 0), vector(4, -2, 2, 0)), item, 8), 1);
+	EXPECT_UINTEQ(item[0], 3);
+
+	real distance[3];
+	EXPECT_SIZEEQ(hashgrid_query_nearest(grid, vector(10, -2.5f, 1.5f, 1), 3, item, distance), 3);
+	EXPECT_UINTEQ(item[0], 3);
+	EXPECT_REALEQ(distance[0], REAL_C(6.5) * REAL_C(6.5));
+	EXPECT_TRUE(distance[0] <= distance[1]);
+	EXPECT_TRUE(distance[1] <= distance[2]);
+	EXPECT_SIZEEQ(hashgrid_query_nearest(grid, vector_zero(), 8, item, 0), 5);
+
+	// Rebuild reuses memory
+	hashgrid_build_points(grid, point, 2);
+	EXPECT_UINTEQ(grid->count, 2);
+	EXPECT_UINTEQ(grid->cell_count, 1);
+	EXPECT_SIZEEQ(hashgrid_query_radius(grid, vector(-0.5f, 0.5f, 0.5f, 1), REAL_C(0.1), item, 8), 0);
+
+	hashgrid_deallocate(grid);
+
+	return 0;
+}
+
+DECLARE_TEST(hashgrid, points) {
+	const size_t count = 2048;
+	vector_t* point = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	uint32_t* item = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	uint32_t seed = 17;
+	for (size_t ipt = 0; ipt < count; ++ipt)
+		point[ipt] = hashgrid_random_point(&seed, 20);
+
+	hashgrid_t grid;
+	hashgrid_initialize(&grid, REAL_C(1.5));
+	hashgrid_build_points(&grid, point, count);
+
+	for (int iquery = 0; iquery < 64; ++iquery) {
+		const vector_t center = hashgrid_random_point(&seed, 24);
+		const real radius = hashgrid_random(&seed) * 4;
+		const aabb_t box = aabb(vector_sub(center, vector_uniform(radius)), vector_add(center, vector_uniform(radius)));
+
+		size_t found = hashgrid_query_radius(&grid, center, radius, item, count);
+		size_t expected = 0;
+		for (uint32_t ipt = 0; ipt < count; ++ipt) {
+			const vector_t diff = vector_sub(point[ipt], center);
+			if (vector_x(vector_dot3(diff, diff)) <= radius * radius) {
+				EXPECT_TRUE(hashgrid_test_contains(item, found, ipt));
+				++expected;
+			}
+		}
+		EXPECT_SIZEEQ(found, expected);
+
+		found = hashgrid_query_aabb(&grid, box, item, count);
+		expected = 0;
+		for (uint32_t ipt = 0; ipt < count; ++ipt) {
+			if (aabb_contains_point(box, point[ipt])) {
+				EXPECT_TRUE(hashgrid_test_contains(item, found, ipt));
+				++expected;
+			}
+		}
+		EXPECT_SIZEEQ(found, expected);
+
+		uint32_t nearest[8];
+		real distance[8];
+		EXPECT_SIZEEQ(hashgrid_query_nearest(&grid, center, 8, nearest, distance), 8);
+		for (int inear = 0; inear < 8; ++inear) {
+			const vector_t diff = vector_sub(point[nearest[inear]], center);
+			EXPECT_REALEQ(distance[inear], vector_x(vector_dot3(diff, diff)));
+		}
+		size_t closer = 0;
+		for (uint32_t ipt = 0; ipt < count; ++ipt) {
+			const vector_t diff = vector_sub(point[ipt], center);
+			if (vector_x(vector_dot3(diff, diff)) < distance[7])
+				++closer;
+		}
+		EXPECT_TRUE(closer <= 7);
+	}
+
+	hashgrid_finalize(&grid);
+	memory_deallocate(item);
+	memory_deallocate(point);
+
+	return 0;
+}
+
+DECLARE_TEST(hashgrid, boxes) {
+	const size_t count = 1024;
+	aabb_t* bounds = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	uint32_t* item = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	uint32_t seed = 31;
+	for (size_t ibox = 0; ibox < count; ++ibox) {
+		const vector_t center = hashgrid_random_point(&seed, 20);
+		const vector_t extent = vector_abs(hashgrid_random_point(&seed, REAL_C(1.5)));
+		bounds[ibox] = aabb(vector_sub(center, extent), vector_add(center, extent));
+	}
+
+	hashgrid_t* grid = hashgrid_allocate(REAL_C(1.0));
+	hashgrid_build_aabb(grid, bounds, count);
+	EXPECT_UINTEQ(grid->count, count);
+	EXPECT_TRUE(grid->entry_count > count);
+
+	for (int iquery = 0; iquery < 64; ++iquery) {
+		const vector_t center = hashgrid_random_point(&seed, 24);
+		const real radius = hashgrid_random(&seed) * 3;
+		const aabb_t box = aabb(vector_sub(center, vector_uniform(radius)), vector_add(center, vector_uniform(radius)));
+
+		// Each box must be reported exactly once even if stored in several cells
+		size_t found = hashgrid_query_radius(grid, center, radius, item, count);
+		size_t expected = 0;
+		for (uint32_t ibox = 0; ibox < count; ++ibox) {
+			if (hashgrid_test_distance_sqr(center, bounds[ibox]) <= radius * radius) {
+				EXPECT_TRUE(hashgrid_test_contains(item, found, ibox));
+				++expected;
+			}
+		}
+		EXPECT_SIZEEQ(found, expected);
+
+		found = hashgrid_query_aabb(grid, box, item, count);
+		expected = 0;
+		for (uint32_t ibox = 0; ibox < count; ++ibox) {
+			if (aabb_overlap(box, bounds[ibox])) {
+				EXPECT_TRUE(hashgrid_test_contains(item, found, ibox));
+				++expected;
+			}
+		}
+		EXPECT_SIZEEQ(found, expected);
+
+		uint32_t nearest[4];
+		real distance[4];
+		EXPECT_SIZEEQ(hashgrid_query_nearest(grid, center, 4, nearest, distance), 4);
+		for (int inear = 0; inear < 4; ++inear) {
+			EXPECT_REALEQ(distance[inear], hashgrid_test_distance_sqr(center, bounds[nearest[inear]]));
+			for (int iprev = 0; iprev < inear; ++iprev)
+				EXPECT_NE(nearest[iprev], nearest[inear]);
+		}
+		size_t closer = 0;
+		for (uint32_t ibox = 0; ibox < count; ++ibox) {
+			if (hashgrid_test_distance_sqr(center, bounds[ibox]) < distance[3])
+				++closer;
+		}
+		EXPECT_TRUE(closer <= 3);
+	}
+
+	// Rebuild as points in the same grid
+	vector_t point[3] = {vector(0, 0, 0, 1), vector(0.5f, 0, 0, 1), vector(5, 0, 0, 1)};
+	hashgrid_build_points(grid, point, 3);
+	EXPECT_SIZEEQ(hashgrid_query_radius(grid, vector_zero(), 1, item, count), 2);
+
+	hashgrid_deallocate(grid);
+	memory_deallocate(item);
+	memory_deallocate(bounds);
+
+	return 0;
+}
+
+static void
+test_hashgrid_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(hashgrid, build);
+	ADD_TEST(hashgrid, points);
+	ADD_TEST(hashgrid, boxes);
+}
+
+static test_suite_t test_hashgrid_suite = {test_hashgrid_application,
+                                           test_hashgrid_memory_system,
+                                           test_hashgrid_config,
+                                           test_hashgrid_declare,
+                                           test_hashgrid_initialize,
+                                           test_hashgrid_finalize,
+                                           0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_hashgrid_run(void);
+
+int
+test_hashgrid_run(void) {
+	test_suite = test_hashgrid_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_hashgrid_suite;
+}
+
+#endif
@@ -0,0 +1,298 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_ik_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Inverse kinematics tests"));
+	app.short_name = string_const(STRING_CONST("test_ik"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_ik_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_ik_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_ik_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_ik_finalize(void) {
+	vector_module_finalize();
+}
+
+#define IK_TEST_CHAINS 11
+#define IK_TEST_JOINTS 5
+
+static real
+ik_test_random(uint32_t* seed) {
+	*seed = (*seed * 1664525U) + 1013904223U;
+	return (real)(*seed >> 8) / (real)(1 << 24);
+}
+
+static vector_t
+ik_test_direction(uint32_t* seed) {
+	while (true) {
+		const vector_t v = vector((ik_test_random(seed) * 2) - 1, (ik_test_random(seed) * 2) - 1,
+		                          (ik_test_random(seed) * 2) - 1, 0);
+		const real length = vector_x(vector_length3(v));
+		if ((length > REAL_C(0.1)) && (length <= 1))
+			return vector_scale(v, 1 / length);
+	}
+}
+
+//! Rotate v by unit quaternion q
+static vector_t
+ik_test_rotate(const quaternion_t q, const vector_t v) {
+	const vector_t axis = vector(vector_x(q), vector_y(q), vector_z(q), 0);
+	const vector_t t = vector_scale(vector_cross3(axis, v), 2);
+	const vector_t r = vector_add(vector_add(v, vector_scale(t, vector_w(q))), vector_cross3(axis, t));
+	return vector(vector_x(r), vector_y(r), vector_z(r), 0);
+}
+
+static real
+ik_test_distance(const vector_t v0, const vector_t v1) {
+	return vector_x(vector_length3(vector_sub(v0, v1)));
+}
+
+static void
+ik_test_chain(transform_t* joint) {
+	for (size_t ijoint = 0; ijoint < IK_TEST_JOINTS; ++ijoint) {
+		joint[ijoint].rotation = quaternion_identity();
+		joint[ijoint].translation = vector((real)ijoint, 0, 0, 1);
+	}
+}
+
+//! Bones keep their length and joint rotations follow the bone directions
+static bool
+ik_test_chain_valid(const transform_t* joint) {
+	if (ik_test_distance(joint[0].translation, vector(0, 0, 0, 0)) > REAL_C(0.0001))
+		return false;
+	for (size_t ijoint = 0; ijoint + 1 < IK_TEST_JOINTS; ++ijoint) {
+		const vector_t bone = vector_sub(joint[ijoint + 1].translation, joint[ijoint].translation);
+		const real length = vector_x(vector_length3(bone));
+		if (math_abs(length - 1) > REAL_C(0.001))
+			return false;
+		const vector_t direction = ik_test_rotate(joint[ijoint].rotation, vector(1, 0, 0, 0));
+		if (ik_test_distance(direction, vector_scale(bone, 1 / length)) > REAL_C(0.001))
+			return false;
+		if (math_abs(vector_x(vector_length(joint[ijoint].rotation)) - 1) > REAL_C(0.0001))
+			return false;
+	}
+	return math_abs(vector_w(joint[IK_TEST_JOINTS - 1].translation) - 1) < REAL_C(0.0001);
+}
+
+DECLARE_TEST(ik, two_bone) {
+	vector_t root[IK_TEST_CHAINS];
+	vector_t mid[IK_TEST_CHAINS];
+	vector_t end[IK_TEST_CHAINS];
+	vector_t target[IK_TEST_CHAINS];
+	vector_t pole[IK_TEST_CHAINS];
+	quaternion_t root_rotation[IK_TEST_CHAINS];
+	quaternion_t mid_rotation[IK_TEST_CHAINS];
+	real length[IK_TEST_CHAINS][2];
+	uint32_t seed = 1;
+	for (size_t ichain = 0; ichain < IK_TEST_CHAINS; ++ichain) {
+		length[ichain][0] = REAL_C(0.5) + ik_test_random(&seed);
+		length[ichain][1] = REAL_C(0.5) + ik_test_random(&seed);
+		root[ichain] = vector_scale(ik_test_direction(&seed), 5);
+		mid[ichain] = vector_add(root[ichain], vector_scale(ik_test_direction(&seed), length[ichain][0]));
+		end[ichain] = vector_add(mid[ichain], vector_scale(ik_test_direction(&seed), length[ichain][1]));
+		const real min_reach = math_abs(length[ichain][0] - length[ichain][1]) + REAL_C(0.05);
+		const real max_reach = length[ichain][0] + length[ichain][1] - REAL_C(0.05);
+		// Last chains have unreachable targets
+		const real factor = ik_test_random(&seed);
+		const real distance = (ichain < IK_TEST_CHAINS - 3) ? min_reach + (factor * (max_reach - min_reach)) :
+		                                                      max_reach + 1 + factor;
+		target[ichain] = vector_add(root[ichain], vector_scale(ik_test_direction(&seed), distance));
+		pole[ichain] = ik_test_direction(&seed);
+	}
+	// Straight chain with target straight ahead
+	mid[0] = vector_add(root[0], vector(length[0][0], 0, 0, 0));
+	end[0] = vector_add(mid[0], vector(length[0][1], 0, 0, 0));
+	target[0] = vector_add(root[0], vector(REAL_C(0.5) + math_abs(length[0][0] - length[0][1]), 0, 0, 0));
+	pole[0] = vector(0, 1, 0, 0);
+
+	ik_two_bone(root, mid, end, target, pole, IK_TEST_CHAINS, root_rotation, mid_rotation);
+
+	for (size_t ichain = 0; ichain < IK_TEST_CHAINS; ++ichain) {
+		EXPECT_REALONE(vector_x(vector_length(root_rotation[ichain])));
+		EXPECT_REALONE(vector_x(vector_length(mid_rotation[ichain])));
+		const vector_t new_mid =
+		    vector_add(root[ichain], ik_test_rotate(root_rotation[ichain], vector_sub(mid[ichain], root[ichain])));
+		const vector_t new_end =
+		    vector_add(new_mid, ik_test_rotate(mid_rotation[ichain], vector_sub(end[ichain], mid[ichain])));
+		EXPECT_TRUE(math_abs(ik_test_distance(new_mid, root[ichain]) - length[ichain][0]) < REAL_C(0.001));
+		EXPECT_TRUE(math_abs(ik_test_distance(new_end, new_mid) - length[ichain][1]) < REAL_C(0.001));
+
+		const vector_t to_target = vector_sub(target[ichain], root[ichain]);
+		const vector_t direction = vector_scale(to_target, 1 / vector_x(vector_length3(to_target)));
+		if (ichain < IK_TEST_CHAINS - 3) {
+			EXPECT_TRUE(ik_test_distance(new_end, target[ichain]) < REAL_C(0.001));
+		} else {
+			// Stretched towards target
+			const vector_t reach = vector_sub(new_end, root[ichain]);
+			const real reach_length = vector_x(vector_length3(reach));
+			EXPECT_TRUE(math_abs(reach_length - (length[ichain][0] + length[ichain][1])) < REAL_C(0.01));
+			EXPECT_TRUE(ik_test_distance(vector_scale(reach, 1 / reach_length), direction) < REAL_C(0.001));
+		}
+
+		// Middle joint bends towards the pole
+		const vector_t bend = vector_sub(new_mid, root[ichain]);
+		const vector_t bend_side = vector_sub(bend, vector_scale(direction, vector_x(vector_dot3(bend, direction))));
+		EXPECT_TRUE(vector_x(vector_dot3(bend_side, pole[ichain])) >= 0);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(ik, fabrik) {
+	transform_t joint[IK_TEST_JOINTS];
+	ik_test_chain(joint);
+	const vector_t target = vector(2, 2, 1, 1);
+	const unsigned int iterations = ik_fabrik(joint, IK_TEST_JOINTS, target, REAL_C(0.001), 100);
+	EXPECT_INTGT(iterations, 0);
+	EXPECT_INTLT(iterations, 100);
+	EXPECT_TRUE(ik_test_distance(joint[IK_TEST_JOINTS - 1].translation, target) <= REAL_C(0.001));
+	EXPECT_TRUE(ik_test_chain_valid(joint));
+
+	// Already solved chain takes no iterations
+	EXPECT_INTEQ(ik_fabrik(joint, IK_TEST_JOINTS, target, REAL_C(0.001), 100), 0);
+
+	// Unreachable target stretches the chain, but not without any iterations allowed
+	ik_test_chain(joint);
+	const vector_t far = vector(0, 10, 0, 1);
+	transform_t unsolved[IK_TEST_JOINTS];
+	memcpy(unsolved, joint, sizeof(joint));
+	EXPECT_INTEQ(ik_fabrik(joint, IK_TEST_JOINTS, far, REAL_C(0.001), 0), 0);
+	EXPECT_INTEQ(memcmp(unsolved, joint, sizeof(joint)), 0);
+	EXPECT_INTEQ(ik_fabrik(joint, IK_TEST_JOINTS, far, REAL_C(0.001), 100), 1);
+	EXPECT_TRUE(ik_test_distance(joint[IK_TEST_JOINTS - 1].translation, vector(0, IK_TEST_JOINTS - 1, 0, 0)) <
+	            REAL_C(0.001));
+	EXPECT_TRUE(ik_test_chain_valid(joint));
+
+	return 0;
+}
+
+DECLARE_TEST(ik, ccd) {
+	transform_t joint[IK_TEST_JOINTS];
+	ik_test_chain(joint);
+	const vector_t target = vector(1, 2, -1, 1);
+	const unsigned int iterations = ik_ccd(joint, IK_TEST_JOINTS, target, REAL_C(0.001), 100);
+	EXPECT_INTGT(iterations, 0);
+	EXPECT_INTLT(iterations, 100);
+	EXPECT_TRUE(ik_test_distance(joint[IK_TEST_JOINTS - 1].translation, target) <= REAL_C(0.001));
+	EXPECT_TRUE(ik_test_chain_valid(joint));
+
+	// Iteration cap, target behind the chain
+	ik_test_chain(joint);
+	EXPECT_INTEQ(ik_ccd(joint, IK_TEST_JOINTS, vector(-2, 0, 0, 1), REAL_C(0.00001), 1), 1);
+	EXPECT_TRUE(ik_test_chain_valid(joint));
+
+	// Unreachable target points the chain at the target
+	ik_test_chain(joint);
+	ik_ccd(joint, IK_TEST_JOINTS, vector(0, 0, 10, 1), REAL_C(0.001), 20);
+	EXPECT_TRUE(ik_test_distance(joint[IK_TEST_JOINTS - 1].translation, vector(0, 0, IK_TEST_JOINTS - 1, 0)) <
+	            REAL_C(0.01));
+	EXPECT_TRUE(ik_test_chain_valid(joint));
+
+	return 0;
+}
+
+static void
+test_ik_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(ik, two_bone);
+	ADD_TEST(ik, fabrik);
+	ADD_TEST(ik, ccd);
+}
+
+static test_suite_t test_ik_suite = {test_ik_application,
+                                     test_ik_memory_system,
+                                     test_ik_config,
+                                     test_ik_declare,
+                                     test_ik_initialize,
+                                     test_ik_finalize,
+                                     0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_ik_run(void);
+
+int
+test_ik_run(void) {
+	test_suite = test_ik_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_ik_suite;
+}
+
+#endif
@@ -0,0 +1,278 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static atomic32_t job_timing_count;
+static atomic64_t job_timing_items;
+
+static void
+job_test_timing(const char* name, size_t length, const vector_job_timing_t* timing) {
+	FOUNDATION_UNUSED(name);
+	FOUNDATION_UNUSED(length);
+	FOUNDATION_ASSERT(timing->ranges >= 1);
+	FOUNDATION_ASSERT(timing->stolen < timing->ranges);
+	atomic_incr32(&job_timing_count, memory_order_relaxed);
+	atomic_add64(&job_timing_items, (int64_t)timing->count, memory_order_relaxed);
+}
+
+static application_t
+test_job_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Job tests"));
+	app.short_name = string_const(STRING_CONST("test_job"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_job_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_job_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_job_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	config.thread_count = 4;
+	config.grain_size = 64;
+	config.job_timing = job_test_timing;
+	return vector_module_initialize(config);
+}
+
+static void
+test_job_finalize(void) {
+	vector_module_finalize();
+}
+
+static void
+job_test_count(void* context, size_t begin, size_t end) {
+	atomic32_t* visits = context;
+	for (size_t item = begin; item < end; ++item)
+		atomic_incr32(visits + item, memory_order_relaxed);
+}
+
+static void
+job_test_nested(void* context, size_t begin, size_t end) {
+	atomic32_t* visits = context;
+	// Nested jobs run directly on the calling thread
+	for (size_t item = begin; item < end; ++item)
+		vector_parallel_for(STRING_CONST("nested"), job_test_count, visits + (item * 16), 16, 1);
+}
+
+DECLARE_TEST(job, parallel_for) {
+	const size_t count = 100000;
+	atomic32_t* visits = memory_allocate(HASH_TEST, sizeof(atomic32_t) * count, 0, MEMORY_PERSISTENT);
+
+	// Configuration is only applied if this suite initialized the module
+	const bool timed = (vector_job_thread_count() > 1);
+	const size_t counts[] = {0, 1, 63, 64, 65, 1000, 4097, count};
+	for (size_t icount = 0; icount < sizeof(counts) / sizeof(counts[0]); ++icount) {
+		for (size_t item = 0; item < count; ++item)
+			atomic_store32(visits + item, 0, memory_order_relaxed);
+		atomic_store32(&job_timing_count, 0, memory_order_relaxed);
+		atomic_store64(&job_timing_items, 0, memory_order_relaxed);
+
+		vector_parallel_for(STRING_CONST("count"), job_test_count, visits, counts[icount], 0);
+
+		for (size_t item = 0; item < count; ++item)
+			EXPECT_INTEQ(atomic_load32(visits + item, memory_order_relaxed), (item < counts[icount]) ? 1 : 0);
+		if (timed) {
+			EXPECT_INTEQ(atomic_load32(&job_timing_count, memory_order_relaxed), counts[icount] ? 1 : 0);
+			EXPECT_INTEQ((int)atomic_load64(&job_timing_items, memory_order_relaxed), (int)counts[icount]);
+		}
+	}
+
+	for (size_t item = 0; item < count; ++item)
+		atomic_store32(visits + item, 0, memory_order_relaxed);
+	vector_parallel_for(STRING_CONST("nested"), job_test_nested, visits, count / 16, 4);
+	for (size_t item = 0; item < count; ++item)
+		EXPECT_INTEQ(atomic_load32(visits + item, memory_order_relaxed), 1);
+
+	memory_deallocate(visits);
+
+	return 0;
+}
+
+DECLARE_TEST(job, batch) {
+	const size_t count = 5000;
+	vector_t* point = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	vector_t* out = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	matrix_t* bind = memory_allocate(HASH_TEST, sizeof(matrix_t) * count, 16, MEMORY_PERSISTENT);
+	matrix_t* pose = memory_allocate(HASH_TEST, sizeof(matrix_t) * count, 16, MEMORY_PERSISTENT);
+	matrix_t* palette = memory_allocate(HASH_TEST, sizeof(matrix_t) * count, 16, MEMORY_PERSISTENT);
+	aabb_t* bounds = memory_allocate(HASH_TEST, sizeof(aabb_t) * count, 16, MEMORY_PERSISTENT);
+	uint8_t* visible = memory_allocate(HASH_TEST, count, 0, MEMORY_PERSISTENT);
+
+	for (size_t item = 0; item < count; ++item) {
+		const real value = (real)item;
+		point[item] = vector(value, -value, value * REAL_C(0.5), 1);
+		bind[item] = matrix_translation_scalar(-value, 0, 1);
+		pose[item] = matrix_scaling_scalar(2, 1, value);
+		bounds[item] = aabb(vector(value, 0, 0, 0), vector(value + 2, 1, 1, 0));
+	}
+
+	const matrix_t transform = matrix_mul(matrix_scaling_scalar(2, 3, 4), matrix_translation_scalar(1, 2, 3));
+	batch_transform_points(transform, point, out, count);
+	for (size_t item = 0; item < count; ++item)
+		EXPECT_VECTOREQ(out[item], vector_transform(point[item], transform));
+
+	batch_matrix_palette(bind, pose, palette, count);
+	for (size_t item = 0; item < count; ++item) {
+		const matrix_t expect = matrix_mul(bind[item], pose[item]);
+		EXPECT_EQ(memcmp(palette + item, &expect, sizeof(matrix_t)), 0);
+	}
+
+	// Slab 100 <= x <= 1000 plus a plane with no effect
+	const vector_t plane[3] = {vector(1, 0, 0, -100), vector(-1, 0, 0, 1000), vector(0, 1, 0, 10)};
+	EXPECT_SIZEEQ(batch_cull_aabb(plane, 3, bounds, count, visible), 903);
+	for (size_t item = 0; item < count; ++item)
+		EXPECT_INTEQ(visible[item], ((item >= 98) && (item <= 1000)) ? 1 : 0);
+	EXPECT_SIZEEQ(batch_cull_aabb(plane, 0, bounds, count, visible), count);
+
+	memory_deallocate(visible);
+	memory_deallocate(bounds);
+	memory_deallocate(palette);
+	memory_deallocate(pose);
+	memory_deallocate(bind);
+	memory_deallocate(out);
+	memory_deallocate(point);
+
+	return 0;
+}
+
+DECLARE_TEST(job, normals) {
+	const uint32_t side = 101;
+	const uint32_t vertex_count = side * side;
+	const uint32_t triangle_count = (side - 1) * (side - 1) * 2;
+	vector_t* position = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* normal = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* gathered = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* face_normal = memory_allocate(HASH_TEST, sizeof(vector_t) * triangle_count, 16, MEMORY_PERSISTENT);
+	uint32_t* index = memory_allocate(HASH_TEST, sizeof(uint32_t) * triangle_count * 3, 0, MEMORY_PERSISTENT);
+
+	for (uint32_t y = 0; y < side; ++y) {
+		for (uint32_t x = 0; x < side; ++x)
+			position[(y * side) + x] = vector((real)x, (real)y, (real)((x * y) % 7), 1);
+	}
+	for (uint32_t y = 0; y < side - 1; ++y) {
+		for (uint32_t x = 0; x < side - 1; ++x) {
+			const uint32_t v0 = (y * side) + x;
+			uint32_t* quad = index + ((y * (side - 1)) + x) * 6;
+			quad[0] = v0;
+			quad[1] = v0 + 1;
+			quad[2] = v0 + side + 1;
+			quad[3] = v0;
+			quad[4] = v0 + side + 1;
+			quad[5] = v0 + side;
+		}
+	}
+
+	mesh_adjacency_t adjacency;
+	mesh_adjacency_initialize(&adjacency, index, triangle_count, vertex_count);
+	mesh_calculate_normals_parallel(&adjacency, position, index, face_normal, normal);
+	// Gathering gives the same result regardless of how the work is split
+	mesh_face_normals(position, index, 0, triangle_count, face_normal);
+	mesh_vertex_normals(&adjacency, face_normal, 0, vertex_count, gathered);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert)
+		EXPECT_VECTOREQ(normal[ivert], gathered[ivert]);
+
+	mesh_adjacency_finalize(&adjacency);
+	memory_deallocate(index);
+	memory_deallocate(face_normal);
+	memory_deallocate(gathered);
+	memory_deallocate(normal);
+	memory_deallocate(position);
+
+	return 0;
+}
+
+static void
+test_job_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(job, parallel_for);
+	ADD_TEST(job, batch);
+	ADD_TEST(job, normals);
+}
+
+static test_suite_t test_job_suite = {test_job_application,
+                                      test_job_memory_system,
+                                      test_job_config,
+                                      test_job_declare,
+                                      test_job_initialize,
+                                      test_job_finalize,
+                                      0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_job_run(void);
+
+int
+test_job_run(void) {
+	test_suite = test_job_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_job_suite;
+}
+
+#endif
@@ -0,0 +1,278 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_mesh_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Mesh tests"));
+	app.short_name = string_const(STRING_CONST("test_mesh"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_mesh_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_mesh_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_mesh_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_mesh_finalize(void) {
+	vector_module_finalize();
+}
+
+//! Build a grid of quads in the xy plane with side vertices per row, z displaced by a bump
+static void
+mesh_test_grid(uint32_t side, vector_t* position, float32_t* texcoord, uint32_t* index, real bump) {
+	for (uint32_t y = 0; y < side; ++y) {
+		for (uint32_t x = 0; x < side; ++x) {
+			const real fx = (real)x / (real)(side - 1);
+			const real fy = (real)y / (real)(side - 1);
+			const real z = bump * fx * (1 - fx) * fy * (1 - fy);
+			position[(y * side) + x] = vector(fx, fy, z, 1);
+			if (texcoord) {
+				texcoord[((y * side) + x) * 2] = (float32_t)fx;
+				texcoord[((y * side) + x) * 2 + 1] = (float32_t)fy;
+			}
+		}
+	}
+	for (uint32_t y = 0; y < side - 1; ++y) {
+		for (uint32_t x = 0; x < side - 1; ++x) {
+			const uint32_t v0 = (y * side) + x;
+			uint32_t* quad = index + ((y * (side - 1)) + x) * 6;
+			quad[0] = v0;
+			quad[1] = v0 + 1;
+			quad[2] = v0 + side + 1;
+			quad[3] = v0;
+			quad[4] = v0 + side + 1;
+			quad[5] = v0 + side;
+		}
+	}
+}
+
+DECLARE_TEST(mesh, normals) {
+	// Vertex 0 shared by a large triangle in the xy plane and a small one in the xz plane
+	const vector_t position[5] = {vector(0, 0, 0, 1), vector(4, 0, 0, 1), vector(0, 4, 0, 1), vector(0, 0, -1, 1),
+	                              vector(9, 9, 9, 1)};
+	const uint32_t index[6] = {0, 1, 2, 0, 3, 1};
+	vector_t normal[5];
+	mesh_calculate_normals(position, 5, index, 2, normal);
+
+	EXPECT_VECTORALMOSTEQ(normal[2], vector(0, 0, 1, 0));
+	EXPECT_VECTORALMOSTEQ(normal[3], vector(0, -1, 0, 0));
+	// Area weighted, face areas 8 and 2
+	EXPECT_VECTORALMOSTEQ(normal[0], vector_normalize3(vector(0, -2, 8, 0)));
+	EXPECT_VECTORALMOSTEQ(normal[1], normal[0]);
+	// Unreferenced vertex
+	EXPECT_VECTOREQ(normal[4], vector_zero());
+
+	const float32_t packed[15] = {0, 0, 0, 4, 0, 0, 0, 4, 0, 0, 0, -1, 9, 9, 9};
+	float32_t packed_normal[15];
+	mesh_calculate_normals_float3(packed, 5, index, 2, packed_normal);
+	for (int ivert = 0; ivert < 5; ++ivert) {
+		EXPECT_VECTORALMOSTEQ(vector(packed_normal[ivert * 3], packed_normal[ivert * 3 + 1],
+		                             packed_normal[ivert * 3 + 2], 0),
+		                      normal[ivert]);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(mesh, gather) {
+	const uint32_t side = 33;
+	const uint32_t vertex_count = side * side;
+	const uint32_t triangle_count = (side - 1) * (side - 1) * 2;
+	vector_t* position = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* normal = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* gathered = memory_allocate(HASH_TEST, sizeof(vector_t) * vertex_count, 16, MEMORY_PERSISTENT);
+	vector_t* face_normal = memory_allocate(HASH_TEST, sizeof(vector_t) * triangle_count, 16, MEMORY_PERSISTENT);
+	uint32_t* index = memory_allocate(HASH_TEST, sizeof(uint32_t) * triangle_count * 3, 0, MEMORY_PERSISTENT);
+	mesh_test_grid(side, position, 0, index, 4);
+
+	mesh_adjacency_t adjacency;
+	mesh_adjacency_initialize(&adjacency, index, triangle_count, vertex_count);
+	EXPECT_UINTEQ(adjacency.offset[vertex_count], triangle_count * 3);
+	// Corner vertex used by two triangles, interior vertex by six
+	EXPECT_UINTEQ(adjacency.offset[1] - adjacency.offset[0], 2);
+	EXPECT_UINTEQ(adjacency.offset[side + 2] - adjacency.offset[side + 1], 6);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert) {
+		for (uint32_t icorner = adjacency.offset[ivert]; icorner < adjacency.offset[ivert + 1]; ++icorner)
+			EXPECT_UINTEQ(index[adjacency.corner[icorner]], ivert);
+	}
+
+	// Frames of a deforming mesh, split in uneven ranges as separate jobs would
+	for (int frame = 0; frame < 3; ++frame) {
+		mesh_test_grid(side, position, 0, index, (real)frame * 2);
+		mesh_calculate_normals(position, vertex_count, index, triangle_count, normal);
+
+		mesh_face_normals(position, index, 0, 100, face_normal);
+		mesh_face_normals(position, index, 100, triangle_count, face_normal);
+		mesh_vertex_normals(&adjacency, face_normal, 0, 64, gathered);
+		mesh_vertex_normals(&adjacency, face_normal, 64, 67, gathered);
+		mesh_vertex_normals(&adjacency, face_normal, 67, vertex_count, gathered);
+
+		for (uint32_t ivert = 0; ivert < vertex_count; ++ivert) {
+			EXPECT_VECTORALMOSTEQ(gathered[ivert], normal[ivert]);
+			EXPECT_REALONE(vector_x(vector_length3(normal[ivert])));
+			EXPECT_REALZERO(vector_w(normal[ivert]));
+			EXPECT_TRUE(vector_z(normal[ivert]) > 0);
+		}
+		if (!frame)
+			EXPECT_VECTORALMOSTEQ(normal[side + 1], vector(0, 0, 1, 0));
+	}
+
+	mesh_adjacency_finalize(&adjacency);
+	memory_deallocate(index);
+	memory_deallocate(face_normal);
+	memory_deallocate(gathered);
+	memory_deallocate(normal);
+	memory_deallocate(position);
+
+	return 0;
+}
+
+DECLARE_TEST(mesh, tangents) {
+	const uint32_t side = 9;
+	const uint32_t vertex_count = side * side;
+	const uint32_t triangle_count = (side - 1) * (side - 1) * 2;
+	vector_t position[81];
+	vector_t normal[81];
+	vector_t tangent[81];
+	float32_t texcoord[162];
+	uint32_t index[384];
+	mesh_test_grid(side, position, texcoord, index, 0);
+	mesh_calculate_normals(position, vertex_count, index, triangle_count, normal);
+
+	mesh_calculate_tangents(position, normal, texcoord, vertex_count, index, triangle_count, tangent);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert)
+		EXPECT_VECTORALMOSTEQ(tangent[ivert], vector(1, 0, 0, 1));
+
+	// Mirrored texture u flips tangent and handedness, bitangent stays along +v
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert)
+		texcoord[ivert * 2] = -texcoord[ivert * 2];
+	mesh_calculate_tangents(position, normal, texcoord, vertex_count, index, triangle_count, tangent);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert) {
+		EXPECT_VECTORALMOSTEQ(tangent[ivert], vector(-1, 0, 0, -1));
+		const vector_t bitangent = vector_scale(vector_cross3(normal[ivert], tangent[ivert]), vector_w(tangent[ivert]));
+		EXPECT_REALEQ(vector_y(bitangent), 1);
+	}
+
+	// Curved surface, tangents orthonormal to normals
+	mesh_test_grid(side, position, texcoord, index, 8);
+	mesh_calculate_normals(position, vertex_count, index, triangle_count, normal);
+	mesh_calculate_tangents(position, normal, texcoord, vertex_count, index, triangle_count, tangent);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert) {
+		EXPECT_REALONE(vector_x(vector_length3(tangent[ivert])));
+		EXPECT_TRUE(math_abs(vector_x(vector_dot3(tangent[ivert], normal[ivert]))) < REAL_C(0.0001));
+		EXPECT_TRUE(vector_x(tangent[ivert]) > 0);
+		EXPECT_REALONE(vector_w(tangent[ivert]));
+	}
+
+	// Degenerate texture coordinates still produce a valid tangent frame
+	memset(texcoord, 0, sizeof(texcoord));
+	mesh_calculate_tangents(position, normal, texcoord, vertex_count, index, triangle_count, tangent);
+	for (uint32_t ivert = 0; ivert < vertex_count; ++ivert) {
+		EXPECT_REALONE(vector_x(vector_length3(tangent[ivert])));
+		EXPECT_TRUE(math_abs(vector_x(vector_dot3(tangent[ivert], normal[ivert]))) < REAL_C(0.0001));
+	}
+
+	return 0;
+}
+
+static void
+test_mesh_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(mesh, normals);
+	ADD_TEST(mesh, gather);
+	ADD_TEST(mesh, tangents);
+}
+
+static test_suite_t test_mesh_suite = {test_mesh_application,
+                                       test_mesh_memory_system,
+                                       test_mesh_config,
+                                       test_mesh_declare,
+                                       test_mesh_initialize,
+                                       test_mesh_finalize,
+                                       0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_mesh_run(void);
+
+int
+test_mesh_run(void) {
+	test_suite = test_mesh_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_mesh_suite;
+}
+
+#endif
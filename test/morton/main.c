@@ -0,0 +1,258 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_morton_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Morton tests"));
+	app.short_name = string_const(STRING_CONST("test_morton"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_morton_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_morton_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_morton_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_morton_finalize(void) {
+	vector_module_finalize();
+}
+
+DECLARE_TEST(morton, encode) {
+	EXPECT_UINTEQ(morton_encode30(0, 0, 0), 0);
+	EXPECT_UINTEQ(morton_encode30(1, 0, 0), 1);
+	EXPECT_UINTEQ(morton_encode30(0, 1, 0), 2);
+	EXPECT_UINTEQ(morton_encode30(0, 0, 1), 4);
+	EXPECT_UINTEQ(morton_encode30(3, 3, 3), 63);
+	EXPECT_UINTEQ(morton_encode30(1023, 1023, 1023), 0x3FFFFFFF);
+	EXPECT_UINTEQ(morton_encode30(1024, 0, 0), 0);
+
+	EXPECT_EQ(morton_encode63(1, 0, 0), 1ULL);
+	EXPECT_EQ(morton_encode63(0, 0, 1U << 20), 1ULL << 62);
+	EXPECT_EQ(morton_encode63(0x1FFFFF, 0x1FFFFF, 0x1FFFFF), 0x7FFFFFFFFFFFFFFFULL);
+
+	for (uint32_t value = 0; value < 1024; value += 7) {
+		EXPECT_EQ(morton_encode63(value, value >> 1, value >> 2),
+		          (uint64_t)morton_encode30(value, value >> 1, value >> 2));
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(morton, hilbert) {
+	// Walk all cells of a 8x8x8 grid in Hilbert order, each step must move to a face neighbour
+	const unsigned int bits = 3;
+	const uint32_t side = 1U << bits;
+	uint32_t cell[512][3];
+	bool visited[512];
+	memset(visited, 0, sizeof(visited));
+	for (uint32_t z = 0; z < side; ++z) {
+		for (uint32_t y = 0; y < side; ++y) {
+			for (uint32_t x = 0; x < side; ++x) {
+				const uint64_t code = hilbert_encode(x, y, z, bits);
+				EXPECT_TRUE(code < 512);
+				EXPECT_FALSE(visited[code]);
+				visited[code] = true;
+				cell[code][0] = x;
+				cell[code][1] = y;
+				cell[code][2] = z;
+			}
+		}
+	}
+	for (uint32_t icode = 1; icode < 512; ++icode) {
+		uint32_t distance = 0;
+		for (int axis = 0; axis < 3; ++axis) {
+			const uint32_t prev = cell[icode - 1][axis];
+			distance += (prev > cell[icode][axis]) ? (prev - cell[icode][axis]) : (cell[icode][axis] - prev);
+		}
+		EXPECT_UINTEQ(distance, 1);
+	}
+
+	EXPECT_EQ(hilbert_encode(0, 0, 0, 21), 0ULL);
+	EXPECT_TRUE(hilbert_encode(0x1FFFFF, 0x1FFFFF, 0x1FFFFF, 21) <= 0x7FFFFFFFFFFFFFFFULL);
+
+	return 0;
+}
+
+DECLARE_TEST(morton, points) {
+	const aabb_t bounds = aabb(vector(-1, -1, -1, 0), vector(1, 3, 1, 0));
+	vector_t point[6] = {vector(-1, -1, -1, 1), vector(1, 3, 1, 1),     vector(0, 1, 0, 1),
+	                     vector(-5, 10, 0, 1),  vector(0.999f, -1, -1, 1), vector(-1, -1, 0.999f, 1)};
+	uint32_t code30[6];
+	uint64_t code63[6];
+	uint64_t hilbert[6];
+
+	morton_encode_points30(point, 6, bounds, code30);
+	morton_encode_points63(point, 6, bounds, code63);
+	hilbert_encode_points(point, 6, bounds, hilbert);
+
+	EXPECT_UINTEQ(code30[0], 0);
+	EXPECT_UINTEQ(code30[1], 0x3FFFFFFF);
+	EXPECT_UINTEQ(code30[2], morton_encode30(512, 512, 512));
+	EXPECT_UINTEQ(code30[3], morton_encode30(0, 1023, 512));
+	EXPECT_UINTEQ(code30[4], morton_encode30(1023, 0, 0));
+	EXPECT_UINTEQ(code30[5], morton_encode30(0, 0, 1023));
+	EXPECT_EQ(code63[0], 0ULL);
+	EXPECT_EQ(code63[1], 0x7FFFFFFFFFFFFFFFULL);
+	EXPECT_EQ(code63[2], morton_encode63(1U << 20, 1U << 20, 1U << 20));
+	EXPECT_EQ(hilbert[0], 0ULL);
+	EXPECT_EQ(hilbert[2], hilbert_encode(1U << 20, 1U << 20, 1U << 20, 21));
+
+	// Degenerate bounds map all points to the same code
+	morton_encode_points30(point, 6, aabb(vector_zero(), vector_zero()), code30);
+	for (int ipt = 0; ipt < 6; ++ipt)
+		EXPECT_UINTEQ(code30[ipt], 0);
+
+	return 0;
+}
+
+DECLARE_TEST(morton, sort) {
+	const size_t count = 4096;
+	uint32_t* code32 = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	uint32_t* original32 = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	uint64_t* code64 = memory_allocate(HASH_TEST, sizeof(uint64_t) * count, 0, MEMORY_PERSISTENT);
+	uint64_t* original64 = memory_allocate(HASH_TEST, sizeof(uint64_t) * count, 0, MEMORY_PERSISTENT);
+	uint32_t* order = memory_allocate(HASH_TEST, sizeof(uint32_t) * count, 0, MEMORY_PERSISTENT);
+	vector_t* point = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+
+	uint32_t seed = 7;
+	for (size_t icode = 0; icode < count; ++icode) {
+		seed = seed * 1664525U + 1013904223U;
+		// Keep upper bits of 32-bit codes constant to exercise skipped passes
+		original32[icode] = code32[icode] = seed & 0x0003FFFF;
+		original64[icode] = code64[icode] = ((uint64_t)seed << 29) ^ (uint64_t)(seed >> 7);
+		point[icode] = vector((real)icode, 0, 0, 1);
+	}
+
+	morton_sort32(code32, order, count);
+	for (size_t icode = 0; icode < count; ++icode) {
+		EXPECT_UINTEQ(code32[icode], original32[order[icode]]);
+		if (icode) {
+			EXPECT_TRUE(code32[icode - 1] <= code32[icode]);
+			if (code32[icode - 1] == code32[icode])
+				EXPECT_TRUE(order[icode - 1] < order[icode]);
+		}
+	}
+
+	morton_reorder(point, sizeof(vector_t), order, count);
+	for (size_t icode = 0; icode < count; ++icode)
+		EXPECT_VECTOREQ(point[icode], vector((real)order[icode], 0, 0, 1));
+
+	morton_sort64(code64, order, count);
+	for (size_t icode = 0; icode < count; ++icode) {
+		EXPECT_EQ(code64[icode], original64[order[icode]]);
+		if (icode)
+			EXPECT_TRUE(code64[icode - 1] <= code64[icode]);
+	}
+
+	memory_deallocate(point);
+	memory_deallocate(order);
+	memory_deallocate(original64);
+	memory_deallocate(code64);
+	memory_deallocate(original32);
+	memory_deallocate(code32);
+
+	return 0;
+}
+
+static void
+test_morton_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(morton, encode);
+	ADD_TEST(morton, hilbert);
+	ADD_TEST(morton, points);
+	ADD_TEST(morton, sort);
+}
+
+static test_suite_t test_morton_suite = {test_morton_application,
+                                         test_morton_memory_system,
+                                         test_morton_config,
+                                         test_morton_declare,
+                                         test_morton_initialize,
+                                         test_morton_finalize,
+                                         0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_morton_run(void);
+
+int
+test_morton_run(void) {
+	test_suite = test_morton_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_morton_suite;
+}
+
+#endif
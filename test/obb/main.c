@@ -0,0 +1,350 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_obb_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("OBB tests"));
+	app.short_name = string_const(STRING_CONST("test_obb"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_obb_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_obb_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_obb_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_obb_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_obb_seed;
+
+static real
+test_obb_random(real low, real high) {
+	test_obb_seed = test_obb_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_obb_seed >> 8) / (real)(1U << 24));
+}
+
+static quaternion_t
+test_obb_random_rotation(void) {
+	return quaternion_normalize(
+	    vector(test_obb_random(-1, 1), test_obb_random(-1, 1), test_obb_random(-1, 1), test_obb_random(-1, 1)));
+}
+
+static vector_t
+test_obb_random_point(real range) {
+	const real x = test_obb_random(-range, range);
+	const real y = test_obb_random(-range, range);
+	const real z = test_obb_random(-range, range);
+	return vector(x, y, z, 1);
+}
+
+static obb_t
+test_obb_random_box(real range) {
+	const vector_t center = test_obb_random_point(range);
+	const real x = test_obb_random(REAL_C(0.1), 2);
+	const real y = test_obb_random(REAL_C(0.1), 2);
+	const real z = test_obb_random(REAL_C(0.1), 2);
+	return obb(center, vector(x, y, z, 0), test_obb_random_rotation());
+}
+
+//! Box grown by a small margin to absorb rounding in containment tests
+static obb_t
+test_obb_grow(const obb_t box) {
+	return obb(box.center, vector_add(box.extent, vector_uniform(REAL_C(0.001))), box.rotation);
+}
+
+static vector_t
+test_obb_corner(const obb_t box, int corner) {
+	const vector_t local = vector((corner & 1) ? vector_x(box.extent) : -vector_x(box.extent),
+	                              (corner & 2) ? vector_y(box.extent) : -vector_y(box.extent),
+	                              (corner & 4) ? vector_z(box.extent) : -vector_z(box.extent), 1);
+	return vector_transform(local, obb_matrix(box));
+}
+
+static quaternion_t
+test_obb_axis_rotation(const vector_t axis, real angle) {
+	const real half = angle * REAL_C(0.5);
+	const vector_t v = vector_scale(axis, math_sin(half));
+	return vector(vector_x(v), vector_y(v), vector_z(v), math_cos(half));
+}
+
+DECLARE_TEST(obb, construct) {
+	const aabb_t box = aabb(vector(-1, 2, 3, 1), vector(3, 4, 7, 1));
+	const obb_t oriented = obb_from_aabb(box);
+	EXPECT_VECTOREQ(oriented.center, vector(1, 3, 5, 1));
+	EXPECT_VECTOREQ(oriented.extent, vector(2, 1, 2, 0));
+	const aabb_t bounds = obb_aabb(oriented);
+	EXPECT_VECTOREQ(bounds.min, box.min);
+	EXPECT_VECTOREQ(bounds.max, box.max);
+
+	// Corners and points mirrored in the box planes give back the same box
+	test_obb_seed = 1;
+	const obb_t source = obb(vector(3, -2, 1, 1), vector(4, 2, 1, 0), test_obb_random_rotation());
+	const matrix_t transform = obb_matrix(source);
+	vector_t points[208];
+	for (int corner = 0; corner < 8; ++corner)
+		points[corner] = test_obb_corner(source, corner);
+	for (int ipt = 8; ipt < 208; ipt += 8) {
+		const real x = test_obb_random(0, 4);
+		const real y = test_obb_random(0, 2);
+		const real z = test_obb_random(0, 1);
+		for (int mirror = 0; mirror < 8; ++mirror) {
+			const vector_t local = vector((mirror & 1) ? x : -x, (mirror & 2) ? y : -y, (mirror & 4) ? z : -z, 1);
+			points[ipt + mirror] = vector_transform(local, transform);
+		}
+	}
+	const obb_t fit = obb_from_points(points, 208);
+	EXPECT_VECTORALMOSTEQ(fit.center, source.center);
+	EXPECT_VECTORALMOSTEQ(fit.extent, source.extent);
+	const matrix_t source_axes = matrix_from_quaternion(source.rotation);
+	const matrix_t fit_axes = matrix_from_quaternion(fit.rotation);
+	for (int axis = 0; axis < 3; ++axis)
+		EXPECT_REALONE(math_abs(vector_x(vector_dot3(source_axes.row[axis], fit_axes.row[axis]))));
+	const obb_t grown = test_obb_grow(fit);
+	for (int ipt = 0; ipt < 208; ++ipt)
+		EXPECT_TRUE(obb_contains_point(grown, points[ipt]));
+	EXPECT_FALSE(obb_contains_point(grown, vector_add(source.center, vector_scale(source_axes.row[0], REAL_C(4.1)))));
+
+	const obb_t single = obb_from_points(points, 1);
+	EXPECT_VECTOREQ(single.extent, vector_zero());
+	EXPECT_VECTORALMOSTEQ(single.center, points[0]);
+
+	return 0;
+}
+
+DECLARE_TEST(obb, transform) {
+	test_obb_seed = 2;
+	for (int iter = 0; iter < 64; ++iter) {
+		const obb_t box = test_obb_random_box(10);
+		transform_t transform;
+		transform.rotation = test_obb_random_rotation();
+		transform.translation = vector(test_obb_random(-5, 5), test_obb_random(-5, 5), test_obb_random(-5, 5),
+		                               test_obb_random(REAL_C(0.5), 2));
+		const real scale = vector_w(transform.translation);
+		matrix_t m = matrix_mul(matrix_scaling(vector(scale, scale, scale, 1)),
+		                        matrix_from_quaternion(transform.rotation));
+		m.row[3] = vector_set_component(transform.translation, 3, 1);
+
+		// Corners are transformed to corners of the transformed box
+		const obb_t moved = obb_transform(box, transform);
+		const obb_t moved_matrix = obb_transform_matrix(box, m);
+		EXPECT_VECTORALMOSTEQ(moved.center, moved_matrix.center);
+		EXPECT_VECTORALMOSTEQ(moved.extent, moved_matrix.extent);
+		const obb_t grown = test_obb_grow(moved);
+		const obb_t grown_matrix = test_obb_grow(moved_matrix);
+		for (int corner = 0; corner < 8; ++corner) {
+			const vector_t point = vector_transform(test_obb_corner(box, corner), m);
+			EXPECT_TRUE(obb_contains_point(grown, point));
+			EXPECT_TRUE(obb_contains_point(grown_matrix, point));
+			EXPECT_VECTORALMOSTEQ(test_obb_corner(moved, corner), point);
+		}
+	}
+
+	// Non-uniform scale in another frame encloses the transformed corners
+	const obb_t box = obb(vector(1, 2, 3, 1), vector(1, 2, 3, 0), test_obb_random_rotation());
+	const matrix_t stretch =
+	    matrix_mul(matrix_from_quaternion(test_obb_random_rotation()), matrix_scaling(vector(3, 1, 2, 1)));
+	const obb_t grown = test_obb_grow(obb_transform_matrix(box, stretch));
+	for (int corner = 0; corner < 8; ++corner)
+		EXPECT_TRUE(obb_contains_point(grown, vector_transform(test_obb_corner(box, corner), stretch)));
+
+	return 0;
+}
+
+DECLARE_TEST(obb, overlap) {
+	const obb_t unit = obb(vector(0, 0, 0, 1), vector(1, 1, 1, 0), quaternion_identity());
+	EXPECT_TRUE(obb_overlap(unit, unit));
+	EXPECT_TRUE(obb_overlap(unit, obb(vector(2, 0, 0, 1), vector(1, 1, 1, 0), quaternion_identity())));
+	EXPECT_FALSE(obb_overlap(unit, obb(vector(REAL_C(2.01), 0, 0, 1), vector(1, 1, 1, 0), quaternion_identity())));
+
+	// Separated only by the cross product of two edges
+	const real root2 = math_sqrt(REAL_C(2.0));
+	const quaternion_t about_z = test_obb_axis_rotation(vector_zaxis(), REAL_PI / 4);
+	const obb_t edge_z = obb(vector(0, 0, 0, 1), vector(1, 1, 1, 0), about_z);
+	const quaternion_t about_y = test_obb_axis_rotation(vector_yaxis(), REAL_PI / 4);
+	const obb_t near_box = obb(vector(2 * root2 - REAL_C(0.1), 0, 0, 1), vector(1, 1, 1, 0), about_y);
+	const obb_t far_box = obb(vector(2 * root2 + REAL_C(0.1), 0, 0, 1), vector(1, 1, 1, 0), about_y);
+	EXPECT_TRUE(obb_overlap(edge_z, near_box));
+	EXPECT_FALSE(obb_overlap(edge_z, far_box));
+	EXPECT_FALSE(obb_overlap(far_box, edge_z));
+
+	// Axis aligned boxes agree with the box test, rotated boxes overlap when a corner is inside
+	test_obb_seed = 3;
+	for (int iter = 0; iter < 1024; ++iter) {
+		const vector_t corner0 = test_obb_random_point(4);
+		const vector_t corner1 = test_obb_random_point(4);
+		const vector_t corner2 = test_obb_random_point(4);
+		const vector_t corner3 = test_obb_random_point(4);
+		const aabb_t box0 = aabb(vector_min(corner0, corner1), vector_max(corner0, corner1));
+		const aabb_t box1 = aabb(vector_min(corner2, corner3), vector_max(corner2, corner3));
+		EXPECT_EQ(obb_overlap(obb_from_aabb(box0), obb_from_aabb(box1)), aabb_overlap(box0, box1));
+
+		const obb_t rotated0 = test_obb_random_box(3);
+		const obb_t rotated1 = test_obb_random_box(3);
+		const bool overlap = obb_overlap(rotated0, rotated1);
+		EXPECT_EQ(overlap, obb_overlap(rotated1, rotated0));
+		for (int corner = 0; corner < 8; ++corner) {
+			if (obb_contains_point(rotated0, test_obb_corner(rotated1, corner)))
+				EXPECT_TRUE(overlap);
+		}
+		if (!aabb_overlap(obb_aabb(rotated0), obb_aabb(rotated1)))
+			EXPECT_FALSE(overlap);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(obb, ray) {
+	const quaternion_t rotation = test_obb_axis_rotation(vector_zaxis(), REAL_PI / 4);
+	const obb_t box = obb(vector(5, 0, 0, 1), vector(1, 1, 1, 0), rotation);
+	real distance = -1;
+
+	EXPECT_TRUE(ray_intersect_obb(ray(vector(0, 0, 0, 1), vector(1, 0, 0, 0)), box, 10, &distance));
+	EXPECT_REALEQ(distance, 5 - math_sqrt(REAL_C(2.0)));
+	EXPECT_FALSE(ray_intersect_obb(ray(vector(0, 0, 0, 1), vector(1, 0, 0, 0)), box, 3, &distance));
+	EXPECT_FALSE(ray_intersect_obb(ray(vector(0, 0, 0, 1), vector(-1, 0, 0, 0)), box, 10, &distance));
+	// Passes the corner of the axis aligned bounds but misses the rotated box
+	const ray_t corner_ray = ray(vector(REAL_C(2.3), -1, 0, 1), vector(1, 1, 0, 0));
+	EXPECT_FALSE(ray_intersect_obb(corner_ray, box, 10, 0));
+	EXPECT_TRUE(ray_intersect_obb(corner_ray, obb_from_aabb(obb_aabb(box)), 10, 0));
+	EXPECT_TRUE(ray_intersect_obb(ray(vector(0, REAL_C(1.3), 0, 1), vector(1, 0, 0, 0)), box, 10, 0));
+
+	// Direction scale gives distance in units of direction length
+	EXPECT_TRUE(ray_intersect_obb(ray(vector(5, 5, 0, 1), vector(0, -2, 0, 0)), box, 10, &distance));
+	EXPECT_REALEQ(distance, (5 - math_sqrt(REAL_C(2.0))) * REAL_C(0.5));
+
+	EXPECT_TRUE(ray_intersect_obb(ray(vector(5, 0, 0, 1), vector(0, 1, 0, 0)), box, 10, &distance));
+	EXPECT_REALZERO(distance);
+
+	return 0;
+}
+
+DECLARE_TEST(obb, array) {
+	const size_t count = 1003;
+	obb_t* boxes = memory_allocate(HASH_TEST, sizeof(obb_t) * count, 16, MEMORY_PERSISTENT);
+	uint8_t* overlap = memory_allocate(HASH_TEST, count, 0, MEMORY_PERSISTENT);
+
+	test_obb_seed = 4;
+	for (size_t ibox = 0; ibox < count; ++ibox)
+		boxes[ibox] = test_obb_random_box(10);
+	const obb_t box = obb(vector(1, 2, 3, 1), vector(4, 1, 2, 0), test_obb_random_rotation());
+
+	obb_overlap_array(box, boxes, count, overlap);
+	size_t hits = 0;
+	for (size_t ibox = 0; ibox < count; ++ibox) {
+		EXPECT_UINTEQ(overlap[ibox], obb_overlap(box, boxes[ibox]) ? 1 : 0);
+		hits += overlap[ibox];
+	}
+	EXPECT_TRUE(hits > 0);
+	EXPECT_TRUE(hits < count);
+
+	memory_deallocate(boxes);
+	memory_deallocate(overlap);
+
+	return 0;
+}
+
+static void
+test_obb_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(obb, construct);
+	ADD_TEST(obb, transform);
+	ADD_TEST(obb, overlap);
+	ADD_TEST(obb, ray);
+	ADD_TEST(obb, array);
+}
+
+static test_suite_t test_obb_suite = {test_obb_application,
+                                      test_obb_memory_system,
+                                      test_obb_config,
+                                      test_obb_declare,
+                                      test_obb_initialize,
+                                      test_obb_finalize,
+                                      0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_obb_run(void);
+
+int
+test_obb_run(void) {
+	test_suite = test_obb_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_obb_suite;
+}
+
+#endif
@@ -0,0 +1,268 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_pack_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Packing tests"));
+	app.short_name = string_const(STRING_CONST("test_pack"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_pack_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_pack_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_pack_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_pack_finalize(void) {
+	vector_module_finalize();
+}
+
+#define PACK_TEST_COUNT 10003
+
+static real
+pack_test_random(uint32_t* seed) {
+	*seed = (*seed * 1664525U) + 1013904223U;
+	return (real)(*seed >> 8) / (real)(1 << 24);
+}
+
+static vector_t
+pack_test_unit(uint32_t* seed, int dimension) {
+	// Rejection sample inside unit ball for uniform directions
+	while (true) {
+		const real x = (pack_test_random(seed) * 2) - 1;
+		const real y = (pack_test_random(seed) * 2) - 1;
+		const real z = (pack_test_random(seed) * 2) - 1;
+		const real w = (dimension == 4) ? (pack_test_random(seed) * 2) - 1 : 0;
+		const real length_sqr = (x * x) + (y * y) + (z * z) + (w * w);
+		if ((length_sqr > REAL_C(0.01)) && (length_sqr <= 1)) {
+			const real scale = 1 / math_sqrt(length_sqr);
+			return vector(x * scale, y * scale, z * scale, w * scale);
+		}
+	}
+}
+
+//! Angle in degrees between unit vectors, from the chord length for precision at small angles
+static real
+pack_test_angle(const vector_t v0, const vector_t v1) {
+	const real dot = vector_x(vector_dot(v0, v1));
+	const vector_t diff = vector_sub(v1, (dot < 0) ? vector_neg(v0) : v0);
+	const real chord = vector_x(vector_length(diff));
+	return 2 * math_asin(chord * REAL_C(0.5)) * REAL_C(57.295779513082320876);
+}
+
+DECLARE_TEST(pack, smallest3) {
+	quaternion_t* q = memory_allocate(HASH_TEST, sizeof(quaternion_t) * PACK_TEST_COUNT, 16, MEMORY_PERSISTENT);
+	quaternion_t* unpacked = memory_allocate(HASH_TEST, sizeof(quaternion_t) * PACK_TEST_COUNT, 16, MEMORY_PERSISTENT);
+	uint32_t* packed32 = memory_allocate(HASH_TEST, sizeof(uint32_t) * PACK_TEST_COUNT, 0, MEMORY_PERSISTENT);
+	uint16_t* packed48 = memory_allocate(HASH_TEST, sizeof(uint16_t) * 3 * PACK_TEST_COUNT, 0, MEMORY_PERSISTENT);
+
+	uint32_t seed = 1;
+	for (size_t iquat = 0; iquat < PACK_TEST_COUNT; ++iquat)
+		q[iquat] = pack_test_unit(&seed, 4);
+	// Axis aligned and ties between components
+	q[0] = quaternion_identity();
+	q[1] = vector(0, 0, 0, -1);
+	q[2] = vector(REAL_C(0.5), REAL_C(-0.5), REAL_C(0.5), REAL_C(-0.5));
+	q[3] = vector(0, REAL_C(-0.70710678), REAL_C(0.70710678), 0);
+	q[4] = vector(-1, 0, 0, 0);
+
+	const real max_angle[2] = {REAL_C(0.2), REAL_C(0.01)};
+	for (int format = 0; format < 2; ++format) {
+		if (format == 0) {
+			quaternion_pack_smallest3_32(q, PACK_TEST_COUNT, packed32);
+			quaternion_unpack_smallest3_32(packed32, PACK_TEST_COUNT, unpacked);
+		} else {
+			quaternion_pack_smallest3_48(q, PACK_TEST_COUNT, packed48);
+			quaternion_unpack_smallest3_48(packed48, PACK_TEST_COUNT, unpacked);
+		}
+		real max_error = 0;
+		for (size_t iquat = 0; iquat < PACK_TEST_COUNT; ++iquat) {
+			// Rotation angle between q and unpacked is twice the angle between the 4D vectors
+			const real error = 2 * pack_test_angle(q[iquat], unpacked[iquat]);
+			if (error > max_error)
+				max_error = error;
+			EXPECT_REALONE(vector_x(vector_length(unpacked[iquat])));
+		}
+		EXPECT_TRUE(max_error < max_angle[format]);
+	}
+
+	// Largest component is made positive
+	quaternion_unpack_smallest3_48(packed48, 5, unpacked);
+	EXPECT_VECTOREQ(unpacked[0], quaternion_identity());
+	EXPECT_VECTOREQ(unpacked[1], quaternion_identity());
+	EXPECT_VECTOREQ(unpacked[4], vector(1, 0, 0, 0));
+	EXPECT_VECTORALMOSTEQ(unpacked[2], vector(REAL_C(0.5), REAL_C(-0.5), REAL_C(0.5), REAL_C(-0.5)));
+
+	// Partial groups give the same result as full groups
+	for (size_t count = 1; count < 8; ++count) {
+		uint32_t partial32[8] = {0};
+		uint16_t partial48[24] = {0};
+		quaternion_pack_smallest3_32(q, count, partial32);
+		quaternion_pack_smallest3_48(q, count, partial48);
+		EXPECT_EQ(memcmp(partial32, packed32, sizeof(uint32_t) * count), 0);
+		EXPECT_EQ(memcmp(partial48, packed48, sizeof(uint16_t) * 3 * count), 0);
+		EXPECT_UINTEQ(partial32[count], 0);
+		EXPECT_UINTEQ(partial48[count * 3], 0);
+		quaternion_t partial[8];
+		partial[count] = vector_zero();
+		quaternion_unpack_smallest3_48(packed48, count, partial);
+		EXPECT_EQ(memcmp(partial, unpacked, sizeof(quaternion_t) * count), 0);
+		EXPECT_VECTOREQ(partial[count], vector_zero());
+	}
+
+	memory_deallocate(packed48);
+	memory_deallocate(packed32);
+	memory_deallocate(unpacked);
+	memory_deallocate(q);
+
+	return 0;
+}
+
+DECLARE_TEST(pack, octahedral) {
+	vector_t* normal = memory_allocate(HASH_TEST, sizeof(vector_t) * PACK_TEST_COUNT, 16, MEMORY_PERSISTENT);
+	vector_t* unpacked = memory_allocate(HASH_TEST, sizeof(vector_t) * PACK_TEST_COUNT, 16, MEMORY_PERSISTENT);
+	uint16_t* packed16 = memory_allocate(HASH_TEST, sizeof(uint16_t) * PACK_TEST_COUNT, 0, MEMORY_PERSISTENT);
+	uint8_t* packed24 = memory_allocate(HASH_TEST, 3 * PACK_TEST_COUNT, 0, MEMORY_PERSISTENT);
+	uint32_t* packed32 = memory_allocate(HASH_TEST, sizeof(uint32_t) * PACK_TEST_COUNT, 0, MEMORY_PERSISTENT);
+
+	uint32_t seed = 2;
+	for (size_t ivec = 0; ivec < PACK_TEST_COUNT; ++ivec)
+		normal[ivec] = pack_test_unit(&seed, 3);
+	normal[0] = vector(0, 0, 1, 0);
+	normal[1] = vector(0, 0, -1, 0);
+	normal[2] = vector(1, 0, 0, 0);
+	normal[3] = vector(0, -1, 0, 0);
+
+	const real max_angle[3] = {REAL_C(1.0), REAL_C(0.06), REAL_C(0.004)};
+	for (int format = 0; format < 3; ++format) {
+		if (format == 0) {
+			vector_pack_octahedral16(normal, PACK_TEST_COUNT, packed16);
+			vector_unpack_octahedral16(packed16, PACK_TEST_COUNT, unpacked);
+		} else if (format == 1) {
+			vector_pack_octahedral24(normal, PACK_TEST_COUNT, packed24);
+			vector_unpack_octahedral24(packed24, PACK_TEST_COUNT, unpacked);
+		} else {
+			vector_pack_octahedral32(normal, PACK_TEST_COUNT, packed32);
+			vector_unpack_octahedral32(packed32, PACK_TEST_COUNT, unpacked);
+		}
+		real max_error = 0;
+		for (size_t ivec = 0; ivec < PACK_TEST_COUNT; ++ivec) {
+			const real error = pack_test_angle(normal[ivec], unpacked[ivec]);
+			if (error > max_error)
+				max_error = error;
+			EXPECT_REALZERO(vector_w(unpacked[ivec]));
+		}
+		EXPECT_TRUE(max_error < max_angle[format]);
+		for (size_t ivec = 0; ivec < 4; ++ivec)
+			EXPECT_VECTORALMOSTEQ(unpacked[ivec], normal[ivec]);
+	}
+
+	memory_deallocate(packed32);
+	memory_deallocate(packed24);
+	memory_deallocate(packed16);
+	memory_deallocate(unpacked);
+	memory_deallocate(normal);
+
+	return 0;
+}
+
+static void
+test_pack_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(pack, smallest3);
+	ADD_TEST(pack, octahedral);
+}
+
+static test_suite_t test_pack_suite = {test_pack_application,
+                                       test_pack_memory_system,
+                                       test_pack_config,
+                                       test_pack_declare,
+                                       test_pack_initialize,
+                                       test_pack_finalize,
+                                       0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_pack_run(void);
+
+int
+test_pack_run(void) {
+	test_suite = test_pack_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_pack_suite;
+}
+
+#endif
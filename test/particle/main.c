@@ -0,0 +1,350 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_particle_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Particle tests"));
+	app.short_name = string_const(STRING_CONST("test_particle"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_particle_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_particle_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_particle_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_particle_finalize(void) {
+	vector_module_finalize();
+}
+
+static unsigned int particle_test_seed = 1;
+
+static real
+particle_test_random(void) {
+	particle_test_seed = particle_test_seed * 1664525U + 1013904223U;
+	return (real)(particle_test_seed >> 8) / (real)(1 << 24);
+}
+
+static void
+particle_test_emit(particle_system_t* system, size_t count, real lifetime_step) {
+	for (size_t iparticle = 0; iparticle < count; ++iparticle) {
+		const real x = particle_test_random() * 10 - 5;
+		const real y = particle_test_random() * 10 - 5;
+		const real z = particle_test_random() * 10 - 5;
+		const vector_t position = vector(x, y, z, 0);
+		const vector_t velocity = vector(particle_test_random() - REAL_C(0.5), particle_test_random(), 0, 0);
+		const real lifetime = lifetime_step * (real)(iparticle % 4);
+		particle_emit(system, &position, &velocity, &lifetime, 1);
+	}
+}
+
+DECLARE_TEST(particle, emit) {
+	particle_system_t system;
+	particle_system_initialize(&system, 10);
+
+	vector_t position[8];
+	vector_t velocity[8];
+	real lifetime[8];
+	for (int iparticle = 0; iparticle < 8; ++iparticle) {
+		position[iparticle] = vector((real)iparticle, 1, 2, 0);
+		velocity[iparticle] = vector(0, (real)iparticle, 0, 0);
+		lifetime[iparticle] = (real)(iparticle + 1);
+	}
+	EXPECT_SIZEEQ(particle_emit(&system, position, velocity, lifetime, 7), 7);
+	EXPECT_SIZEEQ(system.count, 7);
+	EXPECT_SIZEEQ(particle_emit(&system, position, velocity, lifetime, 8), 3);
+	EXPECT_SIZEEQ(system.count, 10);
+	EXPECT_SIZEEQ(particle_emit(&system, position, velocity, lifetime, 1), 0);
+
+	EXPECT_REALEQ(system.position[0][6], 6);
+	EXPECT_REALEQ(system.position[2][6], 2);
+	EXPECT_REALEQ(system.velocity[1][6], 6);
+	EXPECT_REALEQ(system.lifetime[6], 7);
+	EXPECT_REALEQ(system.position[0][9], 2);
+	EXPECT_REALEQ(system.age[9], 0);
+
+	particle_system_finalize(&system);
+	return 0;
+}
+
+DECLARE_TEST(particle, update) {
+	particle_system_t system;
+	particle_system_initialize(&system, 37);
+	particle_test_emit(&system, 37, 1);
+
+	float32_t position[3][37];
+	float32_t velocity[3][37];
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		memcpy(position[icomp], system.position[icomp], sizeof(float32_t) * 37);
+		memcpy(velocity[icomp], system.velocity[icomp], sizeof(float32_t) * 37);
+	}
+
+	particle_forces_t forces;
+	memset(&forces, 0, sizeof(forces));
+	forces.gravity = vector(0, -10, 0, 0);
+	forces.drag = REAL_C(0.5);
+
+	const real dt = REAL_C(0.1);
+	for (int istep = 0; istep < 5; ++istep) {
+		particle_update(&system, &forces, dt);
+		for (int iparticle = 0; iparticle < 37; ++iparticle) {
+			for (int icomp = 0; icomp < 3; ++icomp) {
+				const real gravity = vector_component(forces.gravity, icomp);
+				const real acceleration = gravity - velocity[icomp][iparticle] * forces.drag;
+				velocity[icomp][iparticle] += acceleration * dt;
+				position[icomp][iparticle] += velocity[icomp][iparticle] * dt;
+			}
+		}
+	}
+	for (int iparticle = 0; iparticle < 37; ++iparticle) {
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			EXPECT_REALONE(math_abs(system.velocity[icomp][iparticle] - velocity[icomp][iparticle]) + 1);
+			EXPECT_REALONE(math_abs(system.position[icomp][iparticle] - position[icomp][iparticle]) + 1);
+		}
+		EXPECT_REALONE(system.age[iparticle] * 2);
+	}
+
+	particle_system_finalize(&system);
+	return 0;
+}
+
+DECLARE_TEST(particle, attractor) {
+	particle_system_t system;
+	particle_system_initialize(&system, 4);
+
+	vector_t position[4] = {vector(1, 0, 0, 0), vector(-2, 0, 0, 0), vector(0, 3, 0, 0), vector(0, 0, -1, 0)};
+	vector_t velocity[4] = {vector_zero(), vector_zero(), vector_zero(), vector_zero()};
+	real lifetime[4] = {1, 1, 1, 1};
+	particle_emit(&system, position, velocity, lifetime, 4);
+
+	const vector_t attractor = vector(0, 0, 0, 2);
+	particle_forces_t forces;
+	memset(&forces, 0, sizeof(forces));
+	forces.attractor = &attractor;
+	forces.attractor_count = 1;
+
+	particle_update(&system, &forces, 1);
+
+	// Acceleration of strength / distance^2 toward the attractor
+	EXPECT_REALEQ(system.velocity[0][0], -2);
+	EXPECT_REALEQ(system.velocity[0][1], REAL_C(0.5));
+	EXPECT_REALONE(system.velocity[1][2] * -REAL_C(4.5));
+	EXPECT_REALEQ(system.velocity[2][3], 2);
+	EXPECT_REALZERO(system.velocity[1][0]);
+	EXPECT_REALZERO(system.velocity[2][0]);
+
+	particle_system_finalize(&system);
+	return 0;
+}
+
+DECLARE_TEST(particle, field) {
+	vector_t value[2 * 3 * 4];
+	for (int icell = 0; icell < 2 * 3 * 4; ++icell)
+		value[icell] = vector((real)icell, (real)(icell * 2), 0, 0);
+
+	particle_field_t field;
+	field.bounds = aabb(vector(0, 0, 0, 0), vector(2, 3, 4, 0));
+	field.value = value;
+	field.dim[0] = 2;
+	field.dim[1] = 3;
+	field.dim[2] = 4;
+
+	particle_system_t system;
+	particle_system_initialize(&system, 5);
+	vector_t position[5] = {vector(REAL_C(0.5), REAL_C(0.5), REAL_C(0.5), 0), vector(REAL_C(1.5), REAL_C(2.5), 1, 0),
+	                        vector(REAL_C(1.5), REAL_C(1.2), REAL_C(3.9), 0), vector(-5, 10, REAL_C(2.5), 0),
+	                        vector(REAL_C(0.2), REAL_C(0.7), REAL_C(1.2), 0)};
+	vector_t velocity[5] = {vector_zero(), vector_zero(), vector_zero(), vector_zero(), vector_zero()};
+	real lifetime[5] = {1, 1, 1, 1, 1};
+	particle_emit(&system, position, velocity, lifetime, 5);
+
+	particle_forces_t forces;
+	memset(&forces, 0, sizeof(forces));
+	forces.field = &field;
+
+	particle_update(&system, &forces, 1);
+
+	// Cell index x + 2 * (y + 3 * z), positions outside the bounds clamp to the edge cells
+	EXPECT_REALEQ(system.velocity[0][0], 0);
+	EXPECT_REALEQ(system.velocity[0][1], 1 + 2 * (2 + 3 * 1));
+	EXPECT_REALEQ(system.velocity[0][2], 1 + 2 * (1 + 3 * 3));
+	EXPECT_REALEQ(system.velocity[0][3], 0 + 2 * (2 + 3 * 2));
+	EXPECT_REALEQ(system.velocity[1][3], 2 * (0 + 2 * (2 + 3 * 2)));
+	EXPECT_REALEQ(system.velocity[0][4], 0 + 2 * (0 + 3 * 1));
+
+	particle_system_finalize(&system);
+	return 0;
+}
+
+DECLARE_TEST(particle, cull) {
+	const size_t count = PARTICLE_CHUNK * 2 + 1811;
+	particle_system_t system;
+	particle_system_initialize(&system, count);
+	particle_test_emit(&system, count, REAL_C(0.1));
+
+	float32_t* expected = memory_allocate(HASH_TEST, sizeof(float32_t) * count, 0, MEMORY_PERSISTENT);
+	size_t alive = 0;
+	for (size_t iparticle = 0; iparticle < count; ++iparticle) {
+		// Particles with lifetime 0 expire on the first cull
+		if (system.lifetime[iparticle] > 0)
+			expected[alive++] = system.position[0][iparticle];
+	}
+
+	EXPECT_SIZEEQ(particle_cull(&system), count - alive);
+	EXPECT_SIZEEQ(system.count, alive);
+	for (size_t iparticle = 0; iparticle < alive; ++iparticle) {
+		EXPECT_REALEQ(system.position[0][iparticle], expected[iparticle]);
+		EXPECT_TRUE(system.lifetime[iparticle] > 0);
+	}
+	EXPECT_SIZEEQ(particle_cull(&system), 0);
+
+	particle_forces_t forces;
+	memset(&forces, 0, sizeof(forces));
+	particle_update(&system, &forces, REAL_C(0.15));
+	const size_t remain = system.count;
+	size_t expected_remain = 0;
+	for (size_t iparticle = 0; iparticle < remain; ++iparticle)
+		expected_remain += (system.lifetime[iparticle] > REAL_C(0.15)) ? 1 : 0;
+	EXPECT_SIZEEQ(particle_cull(&system), remain - expected_remain);
+	EXPECT_SIZEEQ(system.count, expected_remain);
+	for (size_t iparticle = 0; iparticle < system.count; ++iparticle)
+		EXPECT_TRUE(system.age[iparticle] < system.lifetime[iparticle]);
+
+	memory_deallocate(expected);
+	particle_system_finalize(&system);
+	return 0;
+}
+
+DECLARE_TEST(particle, bounds) {
+	particle_system_t system;
+	particle_system_initialize(&system, PARTICLE_CHUNK * 3);
+
+	aabb_t box = particle_bounds(&system);
+	EXPECT_TRUE(vector_x(box.min) > vector_x(box.max));
+
+	const size_t count = PARTICLE_CHUNK + 4093;
+	particle_test_emit(&system, count, 1);
+	box = particle_bounds(&system);
+
+	real min[3] = {REAL_MAX, REAL_MAX, REAL_MAX};
+	real max[3] = {-REAL_MAX, -REAL_MAX, -REAL_MAX};
+	for (size_t iparticle = 0; iparticle < count; ++iparticle) {
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			const real value = system.position[icomp][iparticle];
+			min[icomp] = (value < min[icomp]) ? value : min[icomp];
+			max[icomp] = (value > max[icomp]) ? value : max[icomp];
+		}
+	}
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		EXPECT_REALEQ(vector_component(box.min, icomp), min[icomp]);
+		EXPECT_REALEQ(vector_component(box.max, icomp), max[icomp]);
+	}
+
+	particle_system_finalize(&system);
+	return 0;
+}
+
+static void
+test_particle_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(particle, emit);
+	ADD_TEST(particle, update);
+	ADD_TEST(particle, attractor);
+	ADD_TEST(particle, field);
+	ADD_TEST(particle, cull);
+	ADD_TEST(particle, bounds);
+}
+
+static test_suite_t test_particle_suite = {test_particle_application,
+                                           test_particle_memory_system,
+                                           test_particle_config,
+                                           test_particle_declare,
+                                           test_particle_initialize,
+                                           test_particle_finalize,
+                                           0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_particle_run(void);
+
+int
+test_particle_run(void) {
+	test_suite = test_particle_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_particle_suite;
+}
+
+#endif
@@ -0,0 +1,294 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_pose_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Pose tests"));
+	app.short_name = string_const(STRING_CONST("test_pose"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_pose_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_pose_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_pose_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_pose_finalize(void) {
+	vector_module_finalize();
+}
+
+#define POSE_TEST_BONES 23
+
+static real
+pose_test_random(uint32_t* seed) {
+	*seed = (*seed * 1664525U) + 1013904223U;
+	return (real)(*seed >> 8) / (real)(1 << 24);
+}
+
+static void
+pose_test_random_pose(uint32_t* seed, transform_t* pose) {
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		const vector_t q = vector((pose_test_random(seed) * 2) - 1, (pose_test_random(seed) * 2) - 1,
+		                          (pose_test_random(seed) * 2) - 1, (pose_test_random(seed) * 2) - 1);
+		pose[ibone].rotation = vector_normalize(q);
+		pose[ibone].translation = vector((pose_test_random(seed) * 10) - 5, (pose_test_random(seed) * 10) - 5,
+		                                 (pose_test_random(seed) * 10) - 5, REAL_C(0.5) + pose_test_random(seed));
+	}
+}
+
+//! Scalar normalized lerp with hemisphere correction
+static quaternion_t
+pose_test_nlerp(const quaternion_t q0, const quaternion_t q1, real factor) {
+	const quaternion_t target = (vector_x(vector_dot(q0, q1)) < 0) ? quaternion_neg(q1) : q1;
+	return vector_normalize(vector_lerp(q0, target, factor));
+}
+
+//! Hamilton product q0 * q1
+static quaternion_t
+pose_test_mul(const quaternion_t q0, const quaternion_t q1) {
+	const real x0 = vector_x(q0), y0 = vector_y(q0), z0 = vector_z(q0), w0 = vector_w(q0);
+	const real x1 = vector_x(q1), y1 = vector_y(q1), z1 = vector_z(q1), w1 = vector_w(q1);
+	return vector((w0 * x1) + (x0 * w1) + (y0 * z1) - (z0 * y1), (w0 * y1) - (x0 * z1) + (y0 * w1) + (z0 * x1),
+	              (w0 * z1) + (x0 * y1) - (y0 * x1) + (z0 * w1), (w0 * w1) - (x0 * x1) - (y0 * y1) - (z0 * z1));
+}
+
+//! Rotations q and -q are equal
+static quaternion_t
+pose_test_canonical(const quaternion_t q) {
+	return (vector_w(q) < 0) ? quaternion_neg(q) : q;
+}
+
+DECLARE_TEST(pose, blend) {
+	transform_t a[POSE_TEST_BONES];
+	transform_t b[POSE_TEST_BONES];
+	transform_t out[POSE_TEST_BONES];
+	real weight[POSE_TEST_BONES];
+	uint32_t seed = 1;
+	pose_test_random_pose(&seed, a);
+	pose_test_random_pose(&seed, b);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone)
+		weight[ibone] = (ibone % 5) ? pose_test_random(&seed) : 0;
+
+	pose_blend(a, b, REAL_C(0.7), weight, POSE_TEST_BONES, out);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		const real factor = REAL_C(0.7) * weight[ibone];
+		EXPECT_VECTORALMOSTEQ(out[ibone].rotation, pose_test_nlerp(a[ibone].rotation, b[ibone].rotation, factor));
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, vector_lerp(a[ibone].translation, b[ibone].translation, factor));
+		if (!weight[ibone]) {
+			// Masked bones are exactly the first pose
+			EXPECT_VECTOREQ(out[ibone].translation, a[ibone].translation);
+			EXPECT_VECTORALMOSTEQ(out[ibone].rotation, a[ibone].rotation);
+		}
+	}
+
+	// Full blend gives second pose, in the hemisphere of the first
+	pose_blend(a, b, 1, 0, POSE_TEST_BONES, out);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		EXPECT_VECTORALMOSTEQ(pose_test_canonical(out[ibone].rotation), pose_test_canonical(b[ibone].rotation));
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, b[ibone].translation);
+		EXPECT_TRUE(vector_x(vector_dot(out[ibone].rotation, a[ibone].rotation)) >= 0);
+	}
+
+	// Output aliasing input
+	pose_blend(a, b, REAL_C(0.25), 0, POSE_TEST_BONES, out);
+	pose_blend(a, b, REAL_C(0.25), 0, POSE_TEST_BONES, a);
+	EXPECT_EQ(memcmp(a, out, sizeof(out)), 0);
+
+	return 0;
+}
+
+DECLARE_TEST(pose, blend_n) {
+	transform_t pose[3][POSE_TEST_BONES];
+	transform_t out[POSE_TEST_BONES];
+	transform_t reference[POSE_TEST_BONES];
+	uint32_t seed = 2;
+	for (int ipose = 0; ipose < 3; ++ipose)
+		pose_test_random_pose(&seed, pose[ipose]);
+	const transform_t* source[3] = {pose[0], pose[1], pose[2]};
+
+	// Single weighted pose
+	const real single[3] = {0, 2, 0};
+	pose_blend_n(source, single, 0, 3, POSE_TEST_BONES, out);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		EXPECT_VECTORALMOSTEQ(pose_test_canonical(out[ibone].rotation), pose_test_canonical(pose[1][ibone].rotation));
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, pose[1][ibone].translation);
+	}
+
+	// Two poses matches the two pose blend
+	const real pair[3] = {REAL_C(0.25), REAL_C(0.75), 0};
+	pose_blend_n(source, pair, 0, 3, POSE_TEST_BONES, out);
+	pose_blend(pose[0], pose[1], REAL_C(0.75), 0, POSE_TEST_BONES, reference);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		EXPECT_VECTORALMOSTEQ(out[ibone].rotation, reference[ibone].rotation);
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, reference[ibone].translation);
+	}
+
+	// Per-bone weights, bones without weight fall back to first pose
+	real mask[POSE_TEST_BONES];
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone)
+		mask[ibone] = (ibone & 1) ? 1 : 0;
+	const real* bone_weight[3] = {mask, mask, 0};
+	const real weight[3] = {1, 1, 0};
+	pose_blend_n(source, weight, bone_weight, 3, POSE_TEST_BONES, out);
+	pose_blend(pose[0], pose[1], REAL_C(0.5), 0, POSE_TEST_BONES, reference);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		const transform_t* expect = (ibone & 1) ? reference + ibone : pose[0] + ibone;
+		EXPECT_VECTORALMOSTEQ(out[ibone].rotation, expect->rotation);
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, expect->translation);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(pose, additive) {
+	transform_t pose[POSE_TEST_BONES];
+	transform_t reference[POSE_TEST_BONES];
+	transform_t base[POSE_TEST_BONES];
+	transform_t delta[POSE_TEST_BONES];
+	transform_t out[POSE_TEST_BONES];
+	real weight[POSE_TEST_BONES];
+	uint32_t seed = 3;
+	pose_test_random_pose(&seed, pose);
+	pose_test_random_pose(&seed, reference);
+	pose_test_random_pose(&seed, base);
+
+	pose_additive_make(pose, reference, POSE_TEST_BONES, delta);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		const quaternion_t inverse = quaternion_conjugate(reference[ibone].rotation);
+		const quaternion_t expect = pose_test_mul(inverse, pose[ibone].rotation);
+		EXPECT_VECTORALMOSTEQ(delta[ibone].rotation, expect);
+		EXPECT_REALEQ(vector_w(delta[ibone].translation),
+		              vector_w(pose[ibone].translation) / vector_w(reference[ibone].translation));
+	}
+
+	// Delta on top of the reference gives back the pose
+	pose_additive_apply(reference, delta, 1, 0, POSE_TEST_BONES, out);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		EXPECT_VECTORALMOSTEQ(pose_test_canonical(out[ibone].rotation), pose_test_canonical(pose[ibone].rotation));
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, pose[ibone].translation);
+	}
+
+	// Partial and masked layering on another pose
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone)
+		weight[ibone] = (ibone % 3) ? REAL_C(0.5) : 0;
+	pose_additive_apply(base, delta, REAL_C(0.8), weight, POSE_TEST_BONES, out);
+	for (size_t ibone = 0; ibone < POSE_TEST_BONES; ++ibone) {
+		const real factor = REAL_C(0.8) * weight[ibone];
+		const quaternion_t partial = pose_test_nlerp(quaternion_identity(), delta[ibone].rotation, factor);
+		const real scale = 1 + ((vector_w(delta[ibone].translation) - 1) * factor);
+		const vector_t translation =
+		    vector_add(base[ibone].translation, vector_scale(delta[ibone].translation, factor));
+		EXPECT_VECTORALMOSTEQ(out[ibone].rotation, pose_test_mul(base[ibone].rotation, partial));
+		EXPECT_VECTORALMOSTEQ(out[ibone].translation, vector(vector_x(translation), vector_y(translation),
+		                                                     vector_z(translation),
+		                                                     vector_w(base[ibone].translation) * scale));
+		if (!weight[ibone]) {
+			EXPECT_VECTORALMOSTEQ(out[ibone].rotation, base[ibone].rotation);
+			EXPECT_VECTORALMOSTEQ(out[ibone].translation, base[ibone].translation);
+		}
+	}
+
+	return 0;
+}
+
+static void
+test_pose_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(pose, blend);
+	ADD_TEST(pose, blend_n);
+	ADD_TEST(pose, additive);
+}
+
+static test_suite_t test_pose_suite = {test_pose_application,
+                                       test_pose_memory_system,
+                                       test_pose_config,
+                                       test_pose_declare,
+                                       test_pose_initialize,
+                                       test_pose_finalize,
+                                       0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_pose_run(void);
+
+int
+test_pose_run(void) {
+	test_suite = test_pose_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_pose_suite;
+}
+
+#endif
@@ -0,0 +1,288 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_projection_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Projection tests"));
+	app.short_name = string_const(STRING_CONST("test_projection"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_projection_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_projection_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_projection_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_projection_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_projection_seed;
+
+static real
+test_projection_random(real low, real high) {
+	test_projection_seed = test_projection_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_projection_seed >> 8) / (real)(1U << 24));
+}
+
+static bool
+test_projection_depth(const matrix_t proj, real distance, real expect) {
+	const vector_t clip = vector_transform(vector(0, 0, -distance, 1), proj);
+	const real depth = vector_z(clip) / vector_w(clip);
+	return math_abs(depth - expect) <= REAL_C(1e-5);
+}
+
+DECLARE_TEST(projection, perspective) {
+	const real fov = REAL_C(1.1);
+	const real aspect = REAL_C(16.0) / REAL_C(9.0);
+	const real znear = REAL_C(0.1);
+	const real zfar = REAL_C(1000.0);
+
+	for (unsigned int flags = 0; flags < 8; ++flags) {
+		const matrix_t proj = matrix_perspective(fov, aspect, znear, zfar, flags);
+		const real min_depth = (flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1;
+		const real near_depth = (flags & PROJECTION_REVERSED_Z) ? 1 : min_depth;
+		const real far_depth = (flags & PROJECTION_REVERSED_Z) ? min_depth : 1;
+		EXPECT_TRUE(test_projection_depth(proj, znear, near_depth));
+		if (flags & PROJECTION_INFINITE_FAR)
+			EXPECT_TRUE(test_projection_depth(proj, REAL_C(1e7), far_depth));
+		else
+			EXPECT_TRUE(test_projection_depth(proj, zfar, far_depth));
+
+		// Frustum corner at distance maps to the corner of normalized device coordinates
+		const real distance = REAL_C(25.0);
+		const real top = math_tan(fov * REAL_C(0.5)) * distance;
+		const vector_t clip = vector_transform(vector(top * aspect, top, -distance, 1), proj);
+		EXPECT_REALEQ(vector_w(clip), distance);
+		EXPECT_TRUE(math_abs(vector_x(clip) / vector_w(clip) - 1) < REAL_C(1e-5));
+		EXPECT_TRUE(math_abs(vector_y(clip) / vector_w(clip) - 1) < REAL_C(1e-5));
+	}
+
+	// Reversed depth keeps precision for distant points where standard depth saturates
+	const matrix_t reversed =
+	    matrix_perspective(fov, aspect, znear, zfar, PROJECTION_DEPTH_ZERO_TO_ONE | PROJECTION_REVERSED_Z);
+	const vector_t far0 = vector_transform(vector(0, 0, REAL_C(-900.0), 1), reversed);
+	const vector_t far1 = vector_transform(vector(0, 0, REAL_C(-901.0), 1), reversed);
+	EXPECT_TRUE(vector_z(far0) / vector_w(far0) > vector_z(far1) / vector_w(far1));
+
+	return 0;
+}
+
+DECLARE_TEST(projection, orthographic) {
+	for (unsigned int flags = 0; flags < 4; ++flags) {
+		const matrix_t proj = matrix_orthographic(-4, 2, -1, 5, REAL_C(2.0), REAL_C(50.0), flags);
+		const real min_depth = (flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1;
+		const real near_depth = (flags & PROJECTION_REVERSED_Z) ? 1 : min_depth;
+		const real far_depth = (flags & PROJECTION_REVERSED_Z) ? min_depth : 1;
+		EXPECT_VECTORALMOSTEQ(vector_transform(vector(-4, -1, -2, 1), proj), vector(-1, -1, near_depth, 1));
+		EXPECT_VECTORALMOSTEQ(vector_transform(vector(2, 5, -50, 1), proj), vector(1, 1, far_depth, 1));
+		EXPECT_VECTORALMOSTEQ(vector_transform(vector(-1, 2, -26, 1), proj),
+		                      vector(0, 0, (near_depth + far_depth) * REAL_C(0.5), 1));
+	}
+	return 0;
+}
+
+DECLARE_TEST(projection, look) {
+	const vector_t eye = vector(3, 4, 5, 1);
+	const vector_t target = vector(-1, 2, -3, 1);
+	const vector_t up = vector(0, 1, 0, 0);
+	const matrix_t view = matrix_look_at(eye, target, up);
+
+	// Eye at origin, target on negative z axis, up in the upper half of the yz plane
+	EXPECT_VECTORALMOSTEQ(vector_transform(eye, view), vector(0, 0, 0, 1));
+	const real distance = vector_x(vector_length3(vector_sub(target, eye)));
+	EXPECT_VECTORALMOSTEQ(vector_transform(target, view), vector(0, 0, -distance, 1));
+	const vector_t above = vector_transform(vector_add(eye, up), view);
+	EXPECT_REALZERO(vector_x(above));
+	EXPECT_TRUE(vector_y(above) > 0);
+
+	// Rotation part is orthonormal
+	const matrix_t rotation_product = matrix_mul(view, matrix_transpose(view));
+	EXPECT_REALONE(vector_x(rotation_product.row[0]));
+	EXPECT_REALONE(vector_y(rotation_product.row[1]));
+	EXPECT_REALONE(vector_z(rotation_product.row[2]));
+	EXPECT_REALZERO(vector_y(rotation_product.row[0]));
+	EXPECT_REALZERO(vector_z(rotation_product.row[1]));
+
+	const matrix_t view_to = matrix_look_to(eye, vector_scale(vector_sub(target, eye), REAL_C(3.0)), up);
+	for (int row = 0; row < 4; ++row)
+		EXPECT_VECTORALMOSTEQ(view_to.row[row], view.row[row]);
+
+	return 0;
+}
+
+DECLARE_TEST(projection, points) {
+	const unsigned int flags_set[] = {0, PROJECTION_DEPTH_ZERO_TO_ONE,
+	                                  PROJECTION_DEPTH_ZERO_TO_ONE | PROJECTION_REVERSED_Z,
+	                                  PROJECTION_REVERSED_Z | PROJECTION_INFINITE_FAR};
+	const vector_t viewport = vector(10, 20, 1280, 720);
+	const size_t count = 1027;
+	vector_t* point = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	vector_t* screen = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	uint8_t* clip = memory_allocate(HASH_TEST, count, 0, MEMORY_PERSISTENT);
+
+	test_projection_seed = 1;
+	for (size_t ipt = 0; ipt < count; ++ipt)
+		point[ipt] = vector(test_projection_random(-60, 60), test_projection_random(-40, 40),
+		                    test_projection_random(-120, 30), 1);
+	// Known points, center of near plane, beyond far plane, left of frustum and at the eye
+	point[0] = vector(0, 0, REAL_C(-1.0), 1);
+	point[1] = vector(0, 0, REAL_C(-200.0), 1);
+	point[2] = vector(-100, 0, REAL_C(-10.0), 1);
+	point[3] = vector(0, 0, 0, 1);
+
+	for (size_t iflags = 0; iflags < sizeof(flags_set) / sizeof(flags_set[0]); ++iflags) {
+		const unsigned int flags = flags_set[iflags];
+		const matrix_t proj = matrix_perspective(REAL_C(1.2), REAL_C(16.0) / REAL_C(9.0), 1, 100, flags);
+		const real min_depth = (flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1;
+		const real near_depth = (flags & PROJECTION_REVERSED_Z) ? 1 : min_depth;
+		memset(clip, 0xFF, count);
+		vector_project_points(proj, flags, viewport, point, count, screen, clip);
+
+		EXPECT_UINTEQ(clip[0], 0);
+		EXPECT_TRUE(math_abs(vector_x(screen[0]) - 650) < REAL_C(1e-3));
+		EXPECT_TRUE(math_abs(vector_y(screen[0]) - 380) < REAL_C(1e-3));
+		EXPECT_TRUE(math_abs(vector_z(screen[0]) - near_depth) < REAL_C(1e-5));
+		EXPECT_UINTEQ(clip[1], (flags & PROJECTION_INFINITE_FAR) ? 0 : PROJECTION_CLIP_FAR);
+		EXPECT_UINTEQ(clip[2], PROJECTION_CLIP_LEFT);
+		EXPECT_TRUE(clip[3] & PROJECTION_CLIP_NEAR);
+
+		for (size_t ipt = 0; ipt < count; ++ipt) {
+			const vector_t c = vector_transform(point[ipt], proj);
+			const real x = vector_x(c), y = vector_y(c), z = vector_z(c), w = vector_w(c);
+			unsigned int expect = 0;
+			if (x < -w)
+				expect |= PROJECTION_CLIP_LEFT;
+			if (x > w)
+				expect |= PROJECTION_CLIP_RIGHT;
+			if (y < -w)
+				expect |= PROJECTION_CLIP_BOTTOM;
+			if (y > w)
+				expect |= PROJECTION_CLIP_TOP;
+			if (z < min_depth * w)
+				expect |= (flags & PROJECTION_REVERSED_Z) ? PROJECTION_CLIP_FAR : PROJECTION_CLIP_NEAR;
+			if (z > w)
+				expect |= (flags & PROJECTION_REVERSED_Z) ? PROJECTION_CLIP_NEAR : PROJECTION_CLIP_FAR;
+			if (w <= 0)
+				expect |= PROJECTION_CLIP_NEAR;
+			EXPECT_UINTEQ(clip[ipt], expect);
+			if (w <= 0)
+				continue;
+			const real sx = 10 + (x / w + 1) * 640;
+			const real sy = 20 + (1 - y / w) * 360;
+			EXPECT_TRUE(math_abs(vector_x(screen[ipt]) - sx) < REAL_C(1e-3) * (1 + math_abs(sx)));
+			EXPECT_TRUE(math_abs(vector_y(screen[ipt]) - sy) < REAL_C(1e-3) * (1 + math_abs(sy)));
+			EXPECT_TRUE(math_abs(vector_z(screen[ipt]) - z / w) < REAL_C(1e-4) * (1 + math_abs(z / w)));
+			EXPECT_TRUE(math_abs(vector_w(screen[ipt]) * w - 1) < REAL_C(1e-5));
+		}
+	}
+
+	memory_deallocate(point);
+	memory_deallocate(screen);
+	memory_deallocate(clip);
+
+	return 0;
+}
+
+static void
+test_projection_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(projection, perspective);
+	ADD_TEST(projection, orthographic);
+	ADD_TEST(projection, look);
+	ADD_TEST(projection, points);
+}
+
+static test_suite_t test_projection_suite = {test_projection_application,
+                                             test_projection_memory_system,
+                                             test_projection_config,
+                                             test_projection_declare,
+                                             test_projection_initialize,
+                                             test_projection_finalize,
+                                             0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_projection_run(void);
+
+int
+test_projection_run(void) {
+	test_suite = test_projection_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_projection_suite;
+}
+
+#endif
@@ -104,6 +104,12 @@ DECLARE_TEST(quaternion, ops) {
 	r = quaternion_conjugate(q);
 	EXPECT_VECTOREQ(r, vector(-1, 2, -3, -4));
 
+	// Hamilton product, same order in all implementations
+	r = quaternion_mul(vector(1, 2, 3, 4), vector(5, 6, 7, 8));
+	EXPECT_VECTOREQ(r, vector(24, 48, 48, -6));
+	r = quaternion_mul(vector(5, 6, 7, 8), vector(1, 2, 3, 4));
+	EXPECT_VECTOREQ(r, vector(32, 32, 56, -6));
+
 	q = quaternion_identity();
 	r = quaternion_inverse(q);
 	EXPECT_VECTOREQ(r, q);
@@ -0,0 +1,263 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_registration_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Registration tests"));
+	app.short_name = string_const(STRING_CONST("test_registration"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_registration_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_registration_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_registration_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_registration_finalize(void) {
+	vector_module_finalize();
+}
+
+static uint32_t test_registration_seed;
+
+static real
+test_registration_random(real low, real high) {
+	test_registration_seed = test_registration_seed * 1664525U + 1013904223U;
+	return low + (high - low) * ((real)(test_registration_seed >> 8) / (real)(1U << 24));
+}
+
+static quaternion_t
+test_registration_random_rotation(void) {
+	return quaternion_normalize(vector(test_registration_random(-1, 1), test_registration_random(-1, 1),
+	                                   test_registration_random(-1, 1), test_registration_random(-1, 1)));
+}
+
+static vector_t
+test_registration_apply(const transform_t transform, const vector_t point) {
+	const vector_t rotated = vector_rotate(point, matrix_from_quaternion(transform.rotation));
+	return vector_set_component(vector_add(rotated, transform.translation), 3, 1);
+}
+
+static transform_t
+test_registration_transform(const quaternion_t rotation, const vector_t translation) {
+	transform_t transform;
+	transform.rotation = rotation;
+	transform.translation = vector_set_component(translation, 3, 1);
+	return transform;
+}
+
+DECLARE_TEST(registration, rigid) {
+	const size_t count = 10007;
+	vector_t* source = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	vector_t* target = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+
+	test_registration_seed = 1;
+	const transform_t truth = test_registration_transform(test_registration_random_rotation(), vector(3, -2, 5, 1));
+	const matrix_t truth_axes = matrix_from_quaternion(truth.rotation);
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const real x = test_registration_random(90, 110);
+		const real y = test_registration_random(-60, -40);
+		const real z = test_registration_random(15, 25);
+		source[ipt] = vector(x, y, z, 1);
+		target[ipt] = test_registration_apply(truth, source[ipt]);
+	}
+
+	// Chunked and single chunk solves recover the transform, the residual is close to zero
+	const size_t counts[2] = {count, 7};
+	for (int icount = 0; icount < 2; ++icount) {
+		real error = -1;
+		const transform_t found = registration_rigid(source, target, counts[icount], &error);
+		const matrix_t axes = matrix_from_quaternion(found.rotation);
+		EXPECT_VECTORALMOSTEQ(axes.row[0], truth_axes.row[0]);
+		EXPECT_VECTORALMOSTEQ(axes.row[1], truth_axes.row[1]);
+		EXPECT_VECTORALMOSTEQ(axes.row[2], truth_axes.row[2]);
+		EXPECT_TRUE((error >= 0) && (error < REAL_C(0.01)));
+		for (size_t ipt = 0; ipt < counts[icount]; ipt += 997)
+			EXPECT_VECTORALMOSTEQ(test_registration_apply(found, source[ipt]), target[ipt]);
+	}
+
+	// Noise shows up in the residual without disturbing the fit
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const real noise = (ipt & 1) ? REAL_C(0.05) : REAL_C(-0.05);
+		target[ipt] = vector_add(target[ipt], vector(noise, 0, 0, 0));
+	}
+	real error = 0;
+	transform_t found = registration_rigid(source, target, count, &error);
+	EXPECT_TRUE((error > REAL_C(0.04)) && (error < REAL_C(0.06)));
+	const matrix_t axes = matrix_from_quaternion(found.rotation);
+	EXPECT_VECTORALMOSTEQ(axes.row[0], truth_axes.row[0]);
+	EXPECT_VECTORALMOSTEQ(axes.row[1], truth_axes.row[1]);
+	EXPECT_VECTORALMOSTEQ(axes.row[2], truth_axes.row[2]);
+
+	// A single pair gives a pure translation, no pairs the identity
+	found = registration_rigid(source, target, 1, &error);
+	EXPECT_VECTORALMOSTEQ(found.rotation, vector(0, 0, 0, 1));
+	EXPECT_VECTORALMOSTEQ(test_registration_apply(found, source[0]), target[0]);
+	EXPECT_REALZERO(error);
+	found = registration_rigid(source, target, 0, 0);
+	EXPECT_VECTORALMOSTEQ(found.rotation, vector(0, 0, 0, 1));
+	EXPECT_VECTORALMOSTEQ(found.translation, vector(0, 0, 0, 1));
+
+	memory_deallocate(source);
+	memory_deallocate(target);
+
+	return 0;
+}
+
+DECLARE_TEST(registration, icp) {
+	// Random cloud target, source is every third point moved by the inverse of a small transform
+	const size_t count = 8000;
+	const size_t source_count = (count + 2) / 3;
+	vector_t* target = memory_allocate(HASH_TEST, sizeof(vector_t) * count, 16, MEMORY_PERSISTENT);
+	vector_t* source = memory_allocate(HASH_TEST, sizeof(vector_t) * source_count, 16, MEMORY_PERSISTENT);
+	test_registration_seed = 2;
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const real x = test_registration_random(-3, 3);
+		const real y = test_registration_random(-2, 2);
+		const real z = test_registration_random(-1, 1);
+		target[ipt] = vector(x, y, z, 1);
+	}
+	const real angle = REAL_C(0.03);
+	const vector_t axis = vector_normalize3(vector(1, 2, 3, 0));
+	const vector_t half = vector_scale(axis, math_sin(angle * REAL_C(0.5)));
+	const quaternion_t rotation = vector(vector_x(half), vector_y(half), vector_z(half), math_cos(angle * REAL_C(0.5)));
+	const vector_t offset = vector(REAL_C(0.04), REAL_C(-0.03), REAL_C(0.02), 1);
+	const transform_t truth = test_registration_transform(rotation, offset);
+	const matrix_t inverse = matrix_transpose(matrix_from_quaternion(rotation));
+	for (size_t ipt = 0; ipt < source_count; ++ipt) {
+		const vector_t local = vector_rotate(vector_sub(target[ipt * 3], truth.translation), inverse);
+		source[ipt] = vector_set_component(local, 3, 1);
+	}
+
+	hashgrid_t* grid = hashgrid_allocate(REAL_C(0.25));
+	hashgrid_build_points(grid, target, count);
+
+	transform_t transform = test_registration_transform(vector(0, 0, 0, 1), vector_zero());
+	real error = -1;
+	const unsigned int iterations =
+	    registration_icp(source, source_count, target, grid, 1, REAL_C(1e-6), 64, &transform, &error);
+	EXPECT_TRUE(iterations > 1);
+	EXPECT_TRUE(iterations <= 64);
+	EXPECT_TRUE((error >= 0) && (error < REAL_C(0.001)));
+	const matrix_t axes = matrix_from_quaternion(transform.rotation);
+	const matrix_t truth_axes = matrix_from_quaternion(truth.rotation);
+	EXPECT_VECTORALMOSTEQ(axes.row[0], truth_axes.row[0]);
+	EXPECT_VECTORALMOSTEQ(axes.row[1], truth_axes.row[1]);
+	EXPECT_VECTORALMOSTEQ(axes.row[2], truth_axes.row[2]);
+	EXPECT_VECTORALMOSTEQ(transform.translation, truth.translation);
+	for (size_t ipt = 0; ipt < source_count; ipt += 101)
+		EXPECT_VECTORALMOSTEQ(test_registration_apply(transform, source[ipt]), target[ipt * 3]);
+
+	// All pairs rejected, transform is left as is
+	const transform_t far = test_registration_transform(vector(0, 0, 0, 1), vector(50, 0, 0, 1));
+	transform = far;
+	EXPECT_UINTEQ(registration_icp(source, source_count, target, grid, 1, REAL_C(1e-6), 64, &transform, &error), 1);
+	EXPECT_TRUE(error == REAL_MAX);
+	EXPECT_VECTOREQ(transform.translation, far.translation);
+
+	hashgrid_deallocate(grid);
+	memory_deallocate(source);
+	memory_deallocate(target);
+
+	return 0;
+}
+
+static void
+test_registration_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(registration, rigid);
+	ADD_TEST(registration, icp);
+}
+
+static test_suite_t test_registration_suite = {test_registration_application,
+                                               test_registration_memory_system,
+                                               test_registration_config,
+                                               test_registration_declare,
+                                               test_registration_initialize,
+                                               test_registration_finalize,
+                                               0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_registration_run(void);
+
+int
+test_registration_run(void) {
+	test_suite = test_registration_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_registration_suite;
+}
+
+#endif
@@ -0,0 +1,248 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_rigid_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Rigid body tests"));
+	app.short_name = string_const(STRING_CONST("test_rigid"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_rigid_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_rigid_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_rigid_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_rigid_finalize(void) {
+	vector_module_finalize();
+}
+
+#define RIGID_TEST_BODIES 7
+
+static void
+rigid_test_setup(rigid_body_t* body) {
+	rigid_body_initialize(body, 10);
+	body->count = RIGID_TEST_BODIES;
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		body->position[0][ibody] = (real)ibody;
+		body->position[1][ibody] = 10;
+		body->velocity[0][ibody] = 1;
+		body->velocity[2][ibody] = -(real)ibody;
+		body->inverse_mass[ibody] = (ibody == 3) ? 0 : REAL_C(1.0) / (real)(ibody + 1);
+		body->inverse_inertia_body[0][ibody] = 1;
+		body->inverse_inertia_body[1][ibody] = REAL_C(0.5);
+		body->inverse_inertia_body[2][ibody] = REAL_C(0.25) * (real)(ibody + 1);
+	}
+}
+
+//! World space inverse inertia element (i, j) from the rotation matrix of the orientation
+static real
+rigid_test_inertia(const rigid_body_t* body, size_t ibody, int i, int j) {
+	const quaternion_t q = vector(body->orientation[0][ibody], body->orientation[1][ibody],
+	                              body->orientation[2][ibody], body->orientation[3][ibody]);
+	const matrix_t rotation = matrix_from_quaternion(q);
+	real sum = 0;
+	for (int axis = 0; axis < 3; ++axis)
+		sum += rotation.frow[axis][i] * body->inverse_inertia_body[axis][ibody] * rotation.frow[axis][j];
+	return sum;
+}
+
+DECLARE_TEST(rigid, linear) {
+	rigid_body_t body;
+	rigid_test_setup(&body);
+	const vector_t gravity = vector(0, REAL_C(-9.81), 0, 0);
+	const real dt = REAL_C(1.0) / REAL_C(60.0);
+	body.force[0][2] = 6;
+
+	// Semi-implicit Euler, velocity then position
+	real position[RIGID_TEST_BODIES][3];
+	real velocity[RIGID_TEST_BODIES][3];
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		const real inverse_mass = body.inverse_mass[ibody];
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			const real force = body.force[icomp][ibody];
+			const real acceleration = force * inverse_mass + (inverse_mass > 0 ? vector_component(gravity, icomp) : 0);
+			velocity[ibody][icomp] = body.velocity[icomp][ibody] + acceleration * dt;
+			position[ibody][icomp] = body.position[icomp][ibody] + velocity[ibody][icomp] * dt;
+		}
+	}
+	rigid_body_integrate(&body, gravity, 0, 0, dt);
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			EXPECT_REALEQ(body.velocity[icomp][ibody], velocity[ibody][icomp]);
+			EXPECT_REALEQ(body.position[icomp][ibody], position[ibody][icomp]);
+		}
+	}
+	// Force accumulators are cleared
+	EXPECT_REALZERO(body.force[0][2]);
+
+	for (int step = 1; step < 60; ++step)
+		rigid_body_integrate(&body, gravity, 0, 0, dt);
+	// After one second velocity has changed by gravity, static body keeps its velocity
+	EXPECT_REALEQ(body.velocity[1][0], REAL_C(-9.81));
+	EXPECT_REALZERO(body.velocity[1][3]);
+	EXPECT_REALEQ(body.position[1][3], 10);
+	EXPECT_TRUE(math_abs(body.position[1][0] - (10 - REAL_C(0.5) * REAL_C(9.81))) < REAL_C(0.1));
+
+	// Damping
+	rigid_body_integrate(&body, vector_zero(), 2, 0, dt);
+	EXPECT_REALEQ(body.velocity[0][0], REAL_C(1.0) / (REAL_C(1.0) + (dt * 2)));
+
+	rigid_body_finalize(&body);
+	return 0;
+}
+
+DECLARE_TEST(rigid, angular) {
+	rigid_body_t body;
+	rigid_test_setup(&body);
+	const real dt = REAL_C(1.0) / REAL_C(240.0);
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody)
+		body.angular_velocity[2][ibody] = REAL_C(0.5) * (real)ibody;
+	rigid_body_update_inertia(&body);
+	EXPECT_REALONE(body.inverse_inertia[0][0]);
+	EXPECT_REALEQ(body.inverse_inertia[1][0], REAL_C(0.5));
+	EXPECT_REALZERO(body.inverse_inertia[3][0]);
+
+	// Constant angular velocity about z for one second
+	for (int step = 0; step < 240; ++step)
+		rigid_body_integrate(&body, vector_zero(), 0, 0, dt);
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		const real angle = REAL_C(0.5) * (real)ibody;
+		EXPECT_TRUE(math_abs(body.orientation[2][ibody] - math_sin(angle * REAL_C(0.5))) < REAL_C(0.001));
+		EXPECT_TRUE(math_abs(body.orientation[3][ibody] - math_cos(angle * REAL_C(0.5))) < REAL_C(0.001));
+		EXPECT_REALZERO(body.orientation[0][ibody]);
+		const vector_t q = vector(body.orientation[0][ibody], body.orientation[1][ibody],
+		                          body.orientation[2][ibody], body.orientation[3][ibody]);
+		EXPECT_REALONE(vector_x(vector_length(q)));
+	}
+
+	// Torque on rotated bodies uses world space inertia
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		body.angular_velocity[2][ibody] = 0;
+		body.torque[0][ibody] = 1;
+		body.torque[1][ibody] = 2;
+	}
+	real angular_velocity[RIGID_TEST_BODIES][3];
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		for (int i = 0; i < 3; ++i) {
+			angular_velocity[ibody][i] = 0;
+			for (int j = 0; j < 3; ++j)
+				angular_velocity[ibody][i] += rigid_test_inertia(&body, ibody, i, j) * body.torque[j][ibody] * dt;
+		}
+	}
+	rigid_body_integrate(&body, vector_zero(), 0, 0, dt);
+	for (size_t ibody = 0; ibody < RIGID_TEST_BODIES; ++ibody) {
+		for (int icomp = 0; icomp < 3; ++icomp)
+			EXPECT_REALEQ(body.angular_velocity[icomp][ibody], angular_velocity[ibody][icomp]);
+		EXPECT_REALZERO(body.torque[0][ibody]);
+		// World inertia follows orientation
+		static const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+		for (int ielem = 0; ielem < 6; ++ielem)
+			EXPECT_REALEQ(body.inverse_inertia[ielem][ibody],
+			              rigid_test_inertia(&body, ibody, index[ielem][0], index[ielem][1]));
+	}
+
+	rigid_body_finalize(&body);
+	return 0;
+}
+
+static void
+test_rigid_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(rigid, linear);
+	ADD_TEST(rigid, angular);
+}
+
+static test_suite_t test_rigid_suite = {test_rigid_application,
+                                        test_rigid_memory_system,
+                                        test_rigid_config,
+                                        test_rigid_declare,
+                                        test_rigid_initialize,
+                                        test_rigid_finalize,
+                                        0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_rigid_run(void);
+
+int
+test_rigid_run(void) {
+	test_suite = test_rigid_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_rigid_suite;
+}
+
+#endif
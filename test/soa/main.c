@@ -0,0 +1,267 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_soa_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("SoA conversion tests"));
+	app.short_name = string_const(STRING_CONST("test_soa"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_soa_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_soa_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_soa_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_soa_finalize(void) {
+	vector_module_finalize();
+}
+
+#define SOA_TEST_COUNT 37
+
+static vector_t soa_test_vector[SOA_TEST_COUNT];
+static float32_t soa_test_float3[SOA_TEST_COUNT * 3];
+static uint32_t soa_test_index[SOA_TEST_COUNT];
+
+static void
+soa_test_setup(void) {
+	for (uint32_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec) {
+		const real base = (real)(ivec * 4);
+		soa_test_vector[ivec] = vector(base, base + 1, base + 2, base + 3);
+		soa_test_float3[(ivec * 3) + 0] = (float32_t)(ivec * 3);
+		soa_test_float3[(ivec * 3) + 1] = (float32_t)(ivec * 3 + 1);
+		soa_test_float3[(ivec * 3) + 2] = (float32_t)(ivec * 3 + 2);
+		// Permutation, 11 is coprime with the count
+		soa_test_index[ivec] = (ivec * 11) % SOA_TEST_COUNT;
+	}
+}
+
+DECLARE_TEST(soa, vector) {
+	float32_t x[SOA_TEST_COUNT + 1];
+	float32_t y[SOA_TEST_COUNT + 1];
+	float32_t z[SOA_TEST_COUNT + 1];
+	float32_t w[SOA_TEST_COUNT + 1];
+	vector_t out[SOA_TEST_COUNT + 1];
+	soa_test_setup();
+
+	// All counts to cover eight wide, four wide and remainder loops
+	for (size_t count = 0; count <= SOA_TEST_COUNT; ++count) {
+		x[count] = y[count] = z[count] = w[count] = -1;
+		out[count] = vector_uniform(-1);
+
+		soa_from_vector(soa_test_vector, count, x, y, z, w);
+		for (size_t ivec = 0; ivec < count; ++ivec) {
+			EXPECT_REALEQ(x[ivec], (real)(ivec * 4));
+			EXPECT_REALEQ(y[ivec], (real)(ivec * 4 + 1));
+			EXPECT_REALEQ(z[ivec], (real)(ivec * 4 + 2));
+			EXPECT_REALEQ(w[ivec], (real)(ivec * 4 + 3));
+		}
+		EXPECT_REALEQ(x[count], -1);
+		EXPECT_REALEQ(w[count], -1);
+
+		soa_to_vector(x, y, z, w, 0, count, out);
+		for (size_t ivec = 0; ivec < count; ++ivec)
+			EXPECT_VECTOREQ(out[ivec], soa_test_vector[ivec]);
+		EXPECT_VECTOREQ(out[count], vector_uniform(-1));
+
+		soa_to_vector(x, y, z, 0, 1, count, out);
+		for (size_t ivec = 0; ivec < count; ++ivec)
+			EXPECT_VECTOREQ(out[ivec], vector((real)(ivec * 4), (real)(ivec * 4 + 1), (real)(ivec * 4 + 2), 1));
+	}
+
+	soa_from_vector(soa_test_vector, SOA_TEST_COUNT, x, y, z, 0);
+	EXPECT_REALEQ(w[0], 3);
+
+	return 0;
+}
+
+DECLARE_TEST(soa, float3) {
+	float32_t x[SOA_TEST_COUNT + 1];
+	float32_t y[SOA_TEST_COUNT + 1];
+	float32_t z[SOA_TEST_COUNT + 1];
+	float32_t packed[(SOA_TEST_COUNT + 1) * 3];
+	vector_t out[SOA_TEST_COUNT + 1];
+	soa_test_setup();
+
+	for (size_t count = 0; count <= SOA_TEST_COUNT; ++count) {
+		x[count] = y[count] = z[count] = -1;
+		packed[count * 3] = -1;
+		out[count] = vector_uniform(-1);
+
+		soa_from_float3(soa_test_float3, count, x, y, z);
+		for (size_t ielem = 0; ielem < count; ++ielem) {
+			EXPECT_REALEQ(x[ielem], (real)(ielem * 3));
+			EXPECT_REALEQ(y[ielem], (real)(ielem * 3 + 1));
+			EXPECT_REALEQ(z[ielem], (real)(ielem * 3 + 2));
+		}
+		EXPECT_REALEQ(x[count], -1);
+
+		soa_to_float3(x, y, z, count, packed);
+		EXPECT_EQ(memcmp(packed, soa_test_float3, sizeof(float32_t) * 3 * count), 0);
+		EXPECT_REALEQ(packed[count * 3], -1);
+
+		soa_float3_to_vector(soa_test_float3, count, 1, out);
+		for (size_t ielem = 0; ielem < count; ++ielem)
+			EXPECT_VECTOREQ(out[ielem], vector((real)(ielem * 3), (real)(ielem * 3 + 1), (real)(ielem * 3 + 2), 1));
+		EXPECT_VECTOREQ(out[count], vector_uniform(-1));
+
+		packed[count * 3] = -1;
+		soa_vector_to_float3(soa_test_vector, count, packed);
+		for (size_t ielem = 0; ielem < count; ++ielem) {
+			EXPECT_REALEQ(packed[ielem * 3], (real)(ielem * 4));
+			EXPECT_REALEQ(packed[ielem * 3 + 1], (real)(ielem * 4 + 1));
+			EXPECT_REALEQ(packed[ielem * 3 + 2], (real)(ielem * 4 + 2));
+		}
+		EXPECT_REALEQ(packed[count * 3], -1);
+	}
+
+	return 0;
+}
+
+DECLARE_TEST(soa, gather) {
+	float32_t x[SOA_TEST_COUNT];
+	float32_t y[SOA_TEST_COUNT];
+	float32_t z[SOA_TEST_COUNT];
+	float32_t w[SOA_TEST_COUNT];
+	vector_t gathered[SOA_TEST_COUNT];
+	vector_t scattered[SOA_TEST_COUNT];
+	soa_test_setup();
+
+	for (size_t count = 0; count <= SOA_TEST_COUNT; ++count) {
+		soa_gather_vector(soa_test_vector, soa_test_index, count, gathered);
+		for (size_t ivec = 0; ivec < count; ++ivec)
+			EXPECT_VECTOREQ(gathered[ivec], soa_test_vector[soa_test_index[ivec]]);
+
+		soa_gather(soa_test_vector, soa_test_index, count, x, y, z, w);
+		for (size_t ivec = 0; ivec < count; ++ivec) {
+			const vector_t expect = soa_test_vector[soa_test_index[ivec]];
+			EXPECT_VECTOREQ(vector(x[ivec], y[ivec], z[ivec], w[ivec]), expect);
+		}
+	}
+
+	// Scatter with the same permutation restores the original order
+	soa_gather_vector(soa_test_vector, soa_test_index, SOA_TEST_COUNT, gathered);
+	soa_scatter_vector(gathered, soa_test_index, SOA_TEST_COUNT, scattered);
+	for (size_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec)
+		EXPECT_VECTOREQ(scattered[ivec], soa_test_vector[ivec]);
+
+	soa_gather(soa_test_vector, soa_test_index, SOA_TEST_COUNT, x, y, z, w);
+	for (size_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec)
+		scattered[ivec] = vector_zero();
+	soa_scatter(x, y, z, w, soa_test_index, SOA_TEST_COUNT, scattered);
+	for (size_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec)
+		EXPECT_VECTOREQ(scattered[ivec], soa_test_vector[ivec]);
+
+	// Without w stream the w components in the output are kept
+	for (size_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec)
+		scattered[ivec] = vector(0, 0, 0, (real)ivec);
+	soa_scatter(x, y, z, 0, soa_test_index, SOA_TEST_COUNT, scattered);
+	for (size_t ivec = 0; ivec < SOA_TEST_COUNT; ++ivec) {
+		const vector_t expect = soa_test_vector[ivec];
+		EXPECT_VECTOREQ(scattered[ivec], vector(vector_x(expect), vector_y(expect), vector_z(expect), (real)ivec));
+	}
+
+	return 0;
+}
+
+static void
+test_soa_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(soa, vector);
+	ADD_TEST(soa, float3);
+	ADD_TEST(soa, gather);
+}
+
+static test_suite_t test_soa_suite = {test_soa_application,
+                                      test_soa_memory_system,
+                                      test_soa_config,
+                                      test_soa_declare,
+                                      test_soa_initialize,
+                                      test_soa_finalize,
+                                      0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_soa_run(void);
+
+int
+test_soa_run(void) {
+	test_suite = test_soa_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_soa_suite;
+}
+
+#endif
@@ -82,3 +82,19 @@ vector_test_difference(const vector_t v0, const vector_t v1) {
 			return FAILED_TEST;                                                            \
 		}                                                                                  \
 	} while (0)
+
+#define EXPECT_VECTORIEQ(var, expect)                                                                             \
+	do {                                                                                                          \
+		vectori_t vari = (var);                                                                                   \
+		vectori_t expecti = (expect);                                                                             \
+		if ((vectori_x(vari) != vectori_x(expecti)) || (vectori_y(vari) != vectori_y(expecti)) ||                 \
+		    (vectori_z(vari) != vectori_z(expecti)) || (vectori_w(vari) != vectori_w(expecti))) {                 \
+			log_warnf(HASH_TEST, WARNING_SUSPICIOUS,                                                              \
+			          STRING_CONST("Test failed, %s != %s vector (at %s:%d): (%d, %d, %d, %d) (%d, %d, %d, %d)"), \
+			          FOUNDATION_PREPROCESSOR_TOSTRING(var), FOUNDATION_PREPROCESSOR_TOSTRING(expect),            \
+			          __FILE__, __LINE__, vectori_x(vari), vectori_y(vari), vectori_z(vari),                      \
+			          vectori_w(vari), vectori_x(expecti), vectori_y(expecti), vectori_z(expecti),                \
+			          vectori_w(expecti));                                                                        \
+			return FAILED_TEST;                                                                                   \
+		}                                                                                                         \
+	} while (0)
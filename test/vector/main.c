@@ -844,6 +844,113 @@ DECLARE_TEST(vector, equal) {
 	return 0;
 }
 
+DECLARE_TEST(vector, integer) {
+	vectori_t veci;
+
+	EXPECT_VECTORIEQ(vectori(1, -2, 3, -4), vectori(1, -2, 3, -4));
+	EXPECT_VECTORIEQ(vectori_uniform(7), vectori(7, 7, 7, 7));
+	EXPECT_VECTORIEQ(vectori_uniform(1), vectori_one());
+
+	veci = vectori_add(vectori(1, -2, 3, 0x7FFFFFFF), vectori(10, 20, -30, 1));
+	EXPECT_VECTORIEQ(veci, vectori(11, 18, -27, (int32_t)0x80000000));
+
+	veci = vectori_sub(vectori(1, -2, 3, -4), vectori(10, 20, -30, 40));
+	EXPECT_VECTORIEQ(veci, vectori(-9, -22, 33, -44));
+
+	veci = vectori_mul(vectori(3, -2, 0x10000, -70000), vectori(5, 7, 0x10001, 70000));
+	EXPECT_VECTORIEQ(veci, vectori(15, -14, 0x10000, (int32_t)(uint32_t)(-4900000000LL)));
+
+	veci = vectori_min(vectori(1, -2, 3, -4), vectori(2, -3, 3, 4));
+	EXPECT_VECTORIEQ(veci, vectori(1, -3, 3, -4));
+
+	veci = vectori_max(vectori(1, -2, 3, -4), vectori(2, -3, 3, 4));
+	EXPECT_VECTORIEQ(veci, vectori(2, -2, 3, 4));
+
+	veci = vectori_xor(vectori(0x0F, 0xFF, 0, -1), vectori(0xF0, 0x0F, 0, 0x1234));
+	EXPECT_VECTORIEQ(veci, vectori(0xFF, 0xF0, 0, ~0x1234));
+
+	veci = vectori_andnot(vectori(0x0F, 0xFF, 0, -1), vectori(0xF0, 0x0F, 0, 0x1234));
+	EXPECT_VECTORIEQ(veci, vectori(0x0F, 0xF0, 0, ~0x1234));
+
+	veci = vectori_shift_left(vectori(1, -1, 0x40000000, 3), 2);
+	EXPECT_VECTORIEQ(veci, vectori(4, -4, 0, 12));
+
+	veci = vectori_shift_right(vectori(16, -16, -1, 0x7FFFFFFF), 3);
+	EXPECT_VECTORIEQ(veci, vectori(2, -2, -1, 0x0FFFFFFF));
+
+	veci = vectori_shift_right_logical(vectori(16, -16, -1, 0x7FFFFFFF), 3);
+	EXPECT_VECTORIEQ(veci, vectori(2, 0x1FFFFFFE, 0x1FFFFFFF, 0x0FFFFFFF));
+
+	veci = vectori_equal(vectori(1, 2, 3, 4), vectori(1, -2, 3, -4));
+	EXPECT_VECTORIEQ(veci, vectori(-1, 0, -1, 0));
+
+	veci = vectori_less(vectori(1, 2, 3, -4), vectori(2, 2, -3, 4));
+	EXPECT_VECTORIEQ(veci, vectori(-1, 0, 0, -1));
+
+	veci = vectori_greater(vectori(1, 2, 3, -4), vectori(2, 2, -3, 4));
+	EXPECT_VECTORIEQ(veci, vectori(0, 0, -1, 0));
+
+	veci = vectori_select(vectori(-1, 0, -1, 0), vectori(1, 2, 3, 4), vectori(5, 6, 7, 8));
+	EXPECT_VECTORIEQ(veci, vectori(1, 6, 3, 8));
+
+	return 0;
+}
+
+DECLARE_TEST(vector, round) {
+	vector_t vec;
+	uint32_t bits[4];
+
+	vec = vector_floor(vector(1.5f, -1.5f, 2.0f, -0.25f));
+	EXPECT_VECTOREQ(vec, vector(1, -2, 2, -1));
+
+	vec = vector_ceil(vector(1.5f, -1.5f, 2.0f, -0.25f));
+	EXPECT_VECTOREQ(vec, vector(2, -1, 2, 0));
+
+	// Negative values rounded to zero keep the sign bit
+	vec = vector_ceil(vector(-0.75f, -0.25f, -0.0f, 0.25f));
+	memcpy(bits, &vec, sizeof(bits));
+	EXPECT_UINTEQ(bits[0], 0x80000000U);
+	EXPECT_UINTEQ(bits[1], 0x80000000U);
+	EXPECT_UINTEQ(bits[2], 0x80000000U);
+	EXPECT_UINTEQ(bits[3], 0x3F800000U);
+
+	vec = vector_round(vector(-0.25f, -0.5f, -0.0f, 0.25f));
+	memcpy(bits, &vec, sizeof(bits));
+	EXPECT_UINTEQ(bits[0], 0x80000000U);
+	EXPECT_UINTEQ(bits[1], 0x80000000U);
+	EXPECT_UINTEQ(bits[2], 0x80000000U);
+	EXPECT_UINTEQ(bits[3], 0);
+
+	vec = vector_floor(vector(-0.0f, 0.25f, 0, -0.25f));
+	memcpy(bits, &vec, sizeof(bits));
+	EXPECT_UINTEQ(bits[0], 0x80000000U);
+	EXPECT_UINTEQ(bits[1], 0);
+	EXPECT_UINTEQ(bits[2], 0);
+	EXPECT_UINTEQ(bits[3], 0xBF800000U);
+
+	vec = vector_round(vector(1.5f, 2.5f, -2.5f, -0.75f));
+	EXPECT_VECTOREQ(vec, vector(2, 2, -2, -1));
+
+	vec = vector_round(vector(0.49999997f, 8388607.5f, 16777216.0f, -1e20f));
+	EXPECT_VECTOREQ(vec, vector(0, 8388608.0f, 16777216.0f, -1e20f));
+
+	vec = vector_floor(vector(8388607.5f, -8388607.5f, 1e20f, 0));
+	EXPECT_VECTOREQ(vec, vector(8388607.0f, -8388608.0f, 1e20f, 0));
+
+	vec = vector_select(vectori(-1, 0, 0, -1), vector(1, 2, 3, 4), vector(5, 6, 7, 8));
+	EXPECT_VECTOREQ(vec, vector(1, 6, 7, 4));
+
+	vec = vector_select(vector_less(vector(1, 2, 3, 4), vector_uniform(2.5f)), vector_zero(), vector_one());
+	EXPECT_VECTOREQ(vec, vector(0, 0, 1, 1));
+
+	EXPECT_VECTORIEQ(vector_to_vectori(vector(1.75f, -1.75f, 0.5f, -100.25f)), vectori(1, -1, 0, -100));
+	EXPECT_VECTORIEQ(vector_to_vectori_round(vector(1.75f, -1.75f, 0.5f, -100.5f)), vectori(2, -2, 0, -100));
+	EXPECT_VECTORIEQ(vector_to_vectori_floor(vector(1.75f, -1.75f, 0.5f, -100.25f)), vectori(1, -2, 0, -101));
+	EXPECT_VECTOREQ(vectori_to_vector(vectori(1, -2, 0, 1000000)), vector(1, -2, 0, 1000000));
+
+	return 0;
+}
+
 static void
 test_vector_declare(void) {
 #if FOUNDATION_ARCH_SSE4
@@ -869,6 +976,8 @@ test_vector_declare(void) {
 	ADD_TEST(vector, minmax);
 	ADD_TEST(vector, component);
 	ADD_TEST(vector, equal);
+	ADD_TEST(vector, integer);
+	ADD_TEST(vector, round);
 }
 
 static test_suite_t test_vector_suite = {test_vector_application,
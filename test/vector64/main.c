@@ -0,0 +1,341 @@
+/* main.c  -  Vector tests  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#include <foundation/foundation.h>
+#include <test/test.h>
+
+// For testing specific implementations
+//#undef  FOUNDATION_ARCH_SSE4
+//#define FOUNDATION_ARCH_SSE4 0
+//#undef  FOUNDATION_ARCH_SSE3
+//#define FOUNDATION_ARCH_SSE3 0
+//#undef  FOUNDATION_ARCH_SSE2
+//#define FOUNDATION_ARCH_SSE2 0
+//#undef  FOUNDATION_ARCH_NEON
+//#define FOUNDATION_ARCH_NEON 0
+
+#include <vector/vector.h>
+
+#include "../test/vector.h"
+
+static application_t
+test_vector64_application(void) {
+	application_t app;
+	memset(&app, 0, sizeof(app));
+	app.name = string_const(STRING_CONST("Vector64 tests"));
+	app.short_name = string_const(STRING_CONST("test_vector64"));
+	app.company = string_const(STRING_CONST(""));
+	app.version = vector_module_version();
+	app.exception_handler = test_exception_handler;
+	app.flags = APPLICATION_UTILITY;
+	return app;
+}
+
+static memory_system_t
+test_vector64_memory_system(void) {
+	return memory_system_malloc();
+}
+
+static foundation_config_t
+test_vector64_config(void) {
+	foundation_config_t config;
+	memset(&config, 0, sizeof(config));
+	return config;
+}
+
+static int
+test_vector64_initialize(void) {
+	vector_config_t config;
+	memset(&config, 0, sizeof(config));
+	return vector_module_initialize(config);
+}
+
+static void
+test_vector64_finalize(void) {
+	vector_module_finalize();
+}
+
+static bool
+vector64_test_near(const vector64_t v, float64_t x, float64_t y, float64_t z, float64_t w) {
+	return (fabs(vector64_x(v) - x) < 1e-12) && (fabs(vector64_y(v) - y) < 1e-12) &&
+	       (fabs(vector64_z(v) - z) < 1e-12) && (fabs(vector64_w(v) - w) < 1e-12);
+}
+
+DECLARE_TEST(vector64, construct) {
+	const float64_t values[4] = {1.5, -2.25, 1e10, 4};
+	vector64_t v = vector64_unaligned(values);
+	EXPECT_TRUE(vector64_x(v) == 1.5);
+	EXPECT_TRUE(vector64_y(v) == -2.25);
+	EXPECT_TRUE(vector64_z(v) == 1e10);
+	EXPECT_TRUE(vector64_w(v) == 4);
+	EXPECT_TRUE(vector64_component(v, 2) == 1e10);
+
+	v = vector64_set_component(v, 1, 7);
+	EXPECT_TRUE(vector64_y(v) == 7);
+	EXPECT_TRUE(vector64_x(v) == 1.5);
+
+	EXPECT_VECTOREQ(vector64_to_vector(vector64(1, 2, 3, 4)), vector(1, 2, 3, 4));
+	v = vector64_from_vector(vector(REAL_C(0.5), -1, 2, 3));
+	EXPECT_TRUE(vector64_x(v) == 0.5);
+	EXPECT_TRUE(vector64_w(v) == 3);
+
+	EXPECT_TRUE(vector64_test_near(vector64_zero(), 0, 0, 0, 0));
+	EXPECT_TRUE(vector64_test_near(vector64_one(), 1, 1, 1, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_origo(), 0, 0, 0, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_uniform(3), 3, 3, 3, 3));
+	EXPECT_TRUE(vector64_test_near(vector64_half(), 0.5, 0.5, 0.5, 0.5));
+	EXPECT_TRUE(vector64_test_near(vector64_two(), 2, 2, 2, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_xaxis(), 1, 0, 0, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_yaxis(), 0, 1, 0, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_zaxis(), 0, 0, 1, 1));
+
+	FOUNDATION_ALIGN(16) const float64_t aligned[4] = {5, 6, 7, 8};
+	EXPECT_TRUE(vector64_test_near(vector64_aligned((const float64_aligned128_t*)aligned), 5, 6, 7, 8));
+	return 0;
+}
+
+DECLARE_TEST(vector64, ops) {
+	const vector64_t v0 = vector64(1, 2, 3, 4);
+	const vector64_t v1 = vector64(-5, 6, 0.5, 2);
+
+	EXPECT_TRUE(vector64_test_near(vector64_add(v0, v1), -4, 8, 3.5, 6));
+	EXPECT_TRUE(vector64_test_near(vector64_sub(v0, v1), 6, -4, 2.5, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_mul(v0, v1), -5, 12, 1.5, 8));
+	EXPECT_TRUE(vector64_test_near(vector64_div(v0, v1), -0.2, 2.0 / 6.0, 6, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_neg(v0), -1, -2, -3, -4));
+	EXPECT_TRUE(vector64_test_near(vector64_muladd(v0, v1, v0), -4, 14, 4.5, 12));
+	EXPECT_TRUE(vector64_test_near(vector64_scale(v0, 0.5), 0.5, 1, 1.5, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_lerp(v0, v1, 0.25), -0.5, 3, 2.375, 3.5));
+	EXPECT_TRUE(vector64_test_near(vector64_min(v0, v1), -5, 2, 0.5, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_max(v0, v1), 1, 6, 3, 4));
+	EXPECT_TRUE(vector64_test_near(vector64_abs(v1), 5, 6, 0.5, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_sqrt(vector64(4, 9, 0.25, 1)), 2, 3, 0.5, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_add_triple(v0, v1, v0), -3, 10, 6.5, 10));
+
+	// Fractions beyond single precision and halfway cases
+	const vector64_t frac = vector64(1e10 + 0.5, -2.5, -0.25, 3.75);
+	EXPECT_TRUE(vector64_test_near(vector64_floor(frac), 1e10, -3, -1, 3));
+	EXPECT_TRUE(vector64_test_near(vector64_ceil(frac), 1e10 + 1, -2, 0, 4));
+	EXPECT_TRUE(vector64_test_near(vector64_round(frac), 1e10, -2, 0, 4));
+	EXPECT_TRUE(signbit(vector64_z(vector64_ceil(frac))));
+	EXPECT_TRUE(vector64_test_near(vector64_round(vector64(1e17, -1e17, 1.5, 2.5)), 1e17, -1e17, 2, 2));
+
+	EXPECT_TRUE(vector64_test_near(vector64_dot(v0, v1), 16.5, 16.5, 16.5, 16.5));
+	EXPECT_TRUE(vector64_test_near(vector64_dot3(v0, v1), 8.5, 8.5, 8.5, 8.5));
+	EXPECT_TRUE(vector64_test_near(vector64_length_sqr(v0), 30, 30, 30, 30));
+	EXPECT_TRUE(vector64_test_near(vector64_length3_sqr(v0), 14, 14, 14, 14));
+	EXPECT_TRUE(fabs(vector64_x(vector64_length3(vector64(3, 4, 12, 100))) - 13) < 1e-12);
+	EXPECT_TRUE(fabs(vector64_x(vector64_length(vector64_normalize(v1))) - 1) < 1e-12);
+	EXPECT_TRUE(vector64_test_near(vector64_normalize3(vector64(0, 3, 4, 2)), 0, 0.6, 0.8, 2));
+	EXPECT_TRUE(vector64_test_near(vector64_length_fast(vector64(1, 2, 2, 4)), 5, 5, 5, 5));
+	EXPECT_TRUE(vector64_test_near(vector64_length3_fast(vector64(3, 4, 12, 100)), 13, 13, 13, 13));
+
+	EXPECT_TRUE(vector64_test_near(vector64_project(v0, vector64(0, 2, 0, 0)), 0, 2, 0, 0));
+	EXPECT_TRUE(vector64_test_near(vector64_reflect(v0, vector64(0, 2, 0, 0)), -1, 2, -3, -4));
+	EXPECT_TRUE(vector64_test_near(vector64_project3(v0, vector64(0, 0, 3, 7)), 0, 0, 3, 4));
+	EXPECT_TRUE(vector64_test_near(vector64_reflect3(v0, vector64(0, 0, 3, 7)), -1, -2, 3, 4));
+
+	EXPECT_TRUE(vector64_test_near(vector64_cross3(vector64(1, 0, 0, 5), vector64(0, 1, 0, 7)), 0, 0, 1, 0));
+	EXPECT_TRUE(vector64_test_near(vector64_cross3(v0, v1), 1 - 18, -15 - 0.5, 6 + 10, 0));
+	return 0;
+}
+
+DECLARE_TEST(vector64, quaternion) {
+	const float64_t half = 0.5 * acos(-1.0) * 0.5;
+	const quaternion64_t qz = vector64(0, 0, sin(half), cos(half));
+	const quaternion64_t qx = vector64(sin(half), 0, 0, cos(half));
+
+	// Quarter turn around z takes x axis to y axis
+	EXPECT_TRUE(vector64_test_near(quaternion64_rotate(qz, vector64(1, 0, 0, 1)), 0, 1, 0, 0));
+
+	// Product rotates by right hand side first
+	const quaternion64_t q = quaternion64_mul(qx, qz);
+	const vector64_t v = vector64(1, 2, 3, 0);
+	const vector64_t expected = quaternion64_rotate(qx, quaternion64_rotate(qz, v));
+	const vector64_t rotated = quaternion64_rotate(q, v);
+	EXPECT_TRUE(
+	    vector64_test_near(rotated, vector64_x(expected), vector64_y(expected), vector64_z(expected), 0));
+
+	// Matrix from quaternion matches rotation
+	const vector64_t mrotated = vector64_rotate(v, matrix64_from_quaternion(q));
+	EXPECT_TRUE(
+	    vector64_test_near(mrotated, vector64_x(rotated), vector64_y(rotated), vector64_z(rotated), 0));
+
+	EXPECT_TRUE(vector64_test_near(quaternion64_mul(q, quaternion64_conjugate(q)), 0, 0, 0, 1));
+	const quaternion64_t scaled = vector64_scale(q, 2);
+	EXPECT_TRUE(vector64_test_near(quaternion64_mul(quaternion64_inverse(scaled), scaled), 0, 0, 0, 1));
+
+	const quaternion64_t mid = quaternion64_slerp(quaternion64_identity(), qz, 0.5);
+	EXPECT_TRUE(vector64_test_near(mid, 0, 0, sin(half * 0.5), cos(half * 0.5)));
+	const quaternion64_t same = quaternion64_slerp(qz, qz, 0.3);
+	EXPECT_TRUE(vector64_test_near(same, vector64_x(qz), vector64_y(qz), vector64_z(qz), vector64_w(qz)));
+
+	EXPECT_TRUE(vector64_test_near(quaternion64_zero(), 0, 0, 0, 0));
+	EXPECT_TRUE(vector64_test_near(quaternion64_scalar(1, 2, 3, 4), 1, 2, 3, 4));
+	const float64_t values[4] = {vector64_x(q), vector64_y(q), vector64_z(q), vector64_w(q)};
+	EXPECT_TRUE(vector64_test_near(quaternion64_unaligned(values), values[0], values[1], values[2], values[3]));
+
+	// Matrix round trip, both the positive trace and the largest diagonal branches
+	const quaternion64_t fromm = quaternion64_from_matrix(matrix64_from_quaternion(q));
+	EXPECT_TRUE(vector64_test_near(fromm, vector64_x(q), vector64_y(q), vector64_z(q), vector64_w(q)));
+	const quaternion64_t flip = vector64(0, sin(0.49 * acos(-1.0)), 0, cos(0.49 * acos(-1.0)));
+	const quaternion64_t fromflip = quaternion64_from_matrix(matrix64_from_quaternion(flip));
+	EXPECT_TRUE(
+	    vector64_test_near(fromflip, vector64_x(flip), vector64_y(flip), vector64_z(flip), vector64_w(flip)));
+
+	const vector64_t from = vector64(1, 2, 3, 0);
+	const vector64_t to = vector64(-3, 0.5, 2, 0);
+	const vector64_t turned = quaternion64_rotate(quaternion64_rotating_vector(from, to), from);
+	const float64_t ratio = vector64_x(vector64_length3(from)) / vector64_x(vector64_length3(to));
+	EXPECT_TRUE(vector64_test_near(turned, -3 * ratio, 0.5 * ratio, 2 * ratio, 0));
+	return 0;
+}
+
+DECLARE_TEST(vector64, matrix) {
+	const float64_t values[16] = {1, 2, 3, 0, 4, 5, 6, 0, 7, 8, 10, 0, 1e8, -2e8, 3, 1};
+	const matrix64_t m = matrix64_unaligned(values);
+	const matrix64_t t = matrix64_translation(vector64(1, 2, 3, 0));
+	const matrix64_t s = matrix64_scaling(vector64(2, 3, 4, 0));
+
+	EXPECT_TRUE(vector64_test_near(vector64_transform(vector64(1, 1, 1, 1), m), 1e8 + 12, -2e8 + 15, 22, 1));
+	EXPECT_TRUE(vector64_test_near(vector64_rotate(vector64(1, 1, 1, 5), m), 12, 15, 19, 5));
+	EXPECT_TRUE(vector64_test_near(matrix64_get_translation(t), 1, 2, 3, 1));
+
+	// Scale then translate
+	const matrix64_t st = matrix64_mul(s, t);
+	EXPECT_TRUE(vector64_test_near(vector64_transform(vector64(1, 1, 1, 1), st), 3, 5, 7, 1));
+	const matrix64_t mt = matrix64_transpose(m);
+	EXPECT_TRUE(mt.frow[0][3] == 1e8);
+	EXPECT_TRUE(mt.frow[3][0] == 0);
+	EXPECT_TRUE(mt.frow[2][1] == 6);
+
+	const matrix64_t sum = matrix64_sub(matrix64_add(m, t), t);
+	for (int ielem = 0; ielem < 16; ++ielem)
+		EXPECT_TRUE(sum.arr[ielem] == m.arr[ielem]);
+
+	const matrix64_t sts = matrix64_mul(matrix64_scaling_scalar(2, 3, 4), matrix64_translation_scalar(1, 2, 3));
+	for (int ielem = 0; ielem < 16; ++ielem)
+		EXPECT_TRUE(sts.arr[ielem] == st.arr[ielem]);
+	FOUNDATION_ALIGN(16) float64_t aligned[16];
+	memcpy(aligned, values, sizeof(values));
+	const matrix64_t ma = matrix64_aligned((const float64_aligned128_t*)aligned);
+	for (int ielem = 0; ielem < 16; ++ielem)
+		EXPECT_TRUE(ma.arr[ielem] == m.arr[ielem]);
+
+	const matrix_t single = matrix64_to_matrix(matrix64_from_matrix(matrix_identity()));
+	for (int ielem = 0; ielem < 16; ++ielem)
+		EXPECT_REALEQ(single.arr[ielem], matrix_identity().arr[ielem]);
+	return 0;
+}
+
+DECLARE_TEST(vector64, rebase) {
+	// Points around 10000 km from origin, single precision spacing there is 1 meter
+	const vector64_t origin = vector64(1e7, -2e7, 5e6, 1);
+	vector64_t point[37];
+	float64_t stream_data[3][37];
+	const float64_t* stream[3] = {stream_data[0], stream_data[1], stream_data[2]};
+	for (int ipoint = 0; ipoint < 37; ++ipoint) {
+		const float64_t offset = 0.001 * ipoint;
+		point[ipoint] = vector64_add(origin, vector64(offset, -offset, 0.5 + offset, 0));
+		point[ipoint] = vector64_set_component(point[ipoint], 3, 1);
+		stream_data[0][ipoint] = vector64_x(point[ipoint]);
+		stream_data[1][ipoint] = vector64_y(point[ipoint]);
+		stream_data[2][ipoint] = vector64_z(point[ipoint]);
+	}
+
+	vector_t out[37];
+	float32_t out_data[3][37];
+	float32_t* out_stream[3] = {out_data[0], out_data[1], out_data[2]};
+	vector64_rebase(point, 37, origin, out);
+	vector64_rebase_streams(stream, 37, origin, out_stream);
+	for (int ipoint = 0; ipoint < 37; ++ipoint) {
+		const real offset = REAL_C(0.001) * (real)ipoint;
+		EXPECT_TRUE(math_abs(vector_x(out[ipoint]) - offset) < REAL_C(1e-6));
+		EXPECT_TRUE(math_abs(vector_y(out[ipoint]) + offset) < REAL_C(1e-6));
+		EXPECT_TRUE(math_abs(vector_z(out[ipoint]) - (REAL_C(0.5) + offset)) < REAL_C(1e-6));
+		EXPECT_REALONE(vector_w(out[ipoint]));
+		EXPECT_REALEQ(out_data[0][ipoint], vector_x(out[ipoint]));
+		EXPECT_REALEQ(out_data[1][ipoint], vector_y(out[ipoint]));
+		EXPECT_REALEQ(out_data[2][ipoint], vector_z(out[ipoint]));
+	}
+
+	matrix64_t m[5];
+	matrix_t out_matrix[5];
+	for (int imatrix = 0; imatrix < 5; ++imatrix) {
+		m[imatrix] = matrix64_from_quaternion(vector64(0, 0, 0.6, 0.8));
+		m[imatrix].row[3] = vector64_add(point[imatrix * 7], vector64(0, 0, 0, 0));
+	}
+	matrix64_rebase_array(m, 5, origin, out_matrix);
+	for (int imatrix = 0; imatrix < 5; ++imatrix) {
+		EXPECT_VECTOREQ(out_matrix[imatrix].row[0], vector64_to_vector(m[imatrix].row[0]));
+		EXPECT_VECTOREQ(out_matrix[imatrix].row[2], vector64_to_vector(m[imatrix].row[2]));
+		EXPECT_VECTOREQ(out_matrix[imatrix].row[3], out[imatrix * 7]);
+	}
+	return 0;
+}
+
+static void
+test_vector64_declare(void) {
+#if FOUNDATION_ARCH_SSE4
+	log_info(HASH_TEST, STRING_CONST("Using SSE4 implementation"));
+#elif FOUNDATION_ARCH_SSE3
+	log_info(HASH_TEST, STRING_CONST("Using SSE3 implementation"));
+#elif FOUNDATION_ARCH_SSE2
+	log_info(HASH_TEST, STRING_CONST("Using SSE2 implementation"));
+#elif FOUNDATION_ARCH_NEON
+	log_info(HASH_TEST, STRING_CONST("Using NEON implementation"));
+#else
+	log_info(HASH_TEST, STRING_CONST("Using fallback implementation"));
+#endif
+
+	ADD_TEST(vector64, construct);
+	ADD_TEST(vector64, ops);
+	ADD_TEST(vector64, quaternion);
+	ADD_TEST(vector64, matrix);
+	ADD_TEST(vector64, rebase);
+}
+
+static test_suite_t test_vector64_suite = {test_vector64_application,
+                                           test_vector64_memory_system,
+                                           test_vector64_config,
+                                           test_vector64_declare,
+                                           test_vector64_initialize,
+                                           test_vector64_finalize,
+                                           0};
+
+#if BUILD_MONOLITHIC
+
+int
+test_vector64_run(void);
+
+int
+test_vector64_run(void) {
+	test_suite = test_vector64_suite;
+	return test_run_all();
+}
+
+#else
+
+test_suite_t
+test_suite_define(void);
+
+test_suite_t
+test_suite_define(void) {
+	return test_vector64_suite;
+}
+
+#endif
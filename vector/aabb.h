@@ -0,0 +1,127 @@
+/* aabb.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file aabb.h
+    Axis aligned bounding box */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Construct from min and max points
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb(const vector_t min, const vector_t max);
+
+//! Empty (inverted) box, adding a point yields a box containing only that point
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_empty(void);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_add_point(const aabb_t box, const vector_t point);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_merge(const aabb_t box0, const aabb_t box1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL aabb_t
+aabb_from_points(const vector_t* points, size_t count);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_from_triangle(const vector_t v0, const vector_t v1, const vector_t v2);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+aabb_center(const aabb_t box);
+
+//! Full size along each axis
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+aabb_size(const aabb_t box);
+
+//! Surface area, zero for empty boxes
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+aabb_surface_area(const aabb_t box);
+
+//! Test if boxes overlap, touching boxes are considered overlapping
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+aabb_overlap(const aabb_t box0, const aabb_t box1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+aabb_contains_point(const aabb_t box, const vector_t point);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb(const vector_t min, const vector_t max) {
+	aabb_t box;
+	box.min = min;
+	box.max = max;
+	return box;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_empty(void) {
+	return aabb(vector_uniform(REAL_MAX), vector_uniform(-REAL_MAX));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_add_point(const aabb_t box, const vector_t point) {
+	return aabb(vector_min(box.min, point), vector_max(box.max, point));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_merge(const aabb_t box0, const aabb_t box1) {
+	return aabb(vector_min(box0.min, box1.min), vector_max(box0.max, box1.max));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL aabb_t
+aabb_from_points(const vector_t* points, size_t count) {
+	aabb_t box = aabb_empty();
+	for (size_t ipt = 0; ipt < count; ++ipt)
+		box = aabb_add_point(box, points[ipt]);
+	return box;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+aabb_from_triangle(const vector_t v0, const vector_t v1, const vector_t v2) {
+	return aabb(vector_min(vector_min(v0, v1), v2), vector_max(vector_max(v0, v1), v2));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+aabb_center(const aabb_t box) {
+	return vector_mul(vector_add(box.min, box.max), vector_half());
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+aabb_size(const aabb_t box) {
+	return vector_sub(box.max, box.min);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+aabb_surface_area(const aabb_t box) {
+	const vector_t size = vector_max(aabb_size(box), vector_zero());
+	const vector_t size_yzx = vector_shuffle(size, VECTOR_MASK_YZXW);
+	return REAL_C(2.0) * vector_x(vector_dot3(size, size_yzx));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+aabb_overlap(const aabb_t box0, const aabb_t box1) {
+	const vectori_t inside = vectori_and(vector_lequal(box0.min, box1.max), vector_lequal(box1.min, box0.max));
+	return vectori_x(inside) && vectori_y(inside) && vectori_z(inside);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+aabb_contains_point(const aabb_t box, const vector_t point) {
+	const vectori_t inside = vectori_and(vector_lequal(box.min, point), vector_lequal(point, box.max));
+	return vectori_x(inside) && vectori_y(inside) && vectori_z(inside);
+}
@@ -0,0 +1,375 @@
+/* animation.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/animation.h>
+#include <vector/quaternion.h>
+#include <vector/pack.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+//! Number of bones sampled per step, rotation keys are unpacked together
+#define ANIMATION_BLOCK 64
+#define ANIMATION_QUANTIZE_MAX 65535
+
+static FOUNDATION_FORCEINLINE quaternion_t
+animation_nlerp(const quaternion_t q0, const quaternion_t q1, real factor) {
+	// Interpolate towards q1 or -q1, whichever is in the same hemisphere as q0
+	const real sign = (vector_x(vector_dot(q0, q1)) < 0) ? REAL_C(-1.0) : REAL_C(1.0);
+	return vector_normalize(vector_lerp(q0, vector_scale(q1, sign), factor));
+}
+
+//! Error of rotation q compared to reference, approximated as twice the chord length
+static real
+animation_rotation_error(const quaternion_t q, const quaternion_t reference) {
+	const real sign = (vector_x(vector_dot(q, reference)) < 0) ? REAL_C(-1.0) : REAL_C(1.0);
+	return 2 * vector_x(vector_length(vector_sub(vector_scale(q, sign), reference)));
+}
+
+static real
+animation_translation_error(const vector_t v, const vector_t reference) {
+	const vector_t diff = vector_sub(v, reference);
+	return vector_x(vector_length(diff));
+}
+
+//! Check if frames between begin and end are within tolerance of interpolating the end frames
+static bool
+animation_segment_fits(const vector_t* value, uint32_t begin, uint32_t end, unsigned int channel, real tolerance) {
+	const real inv_length = REAL_C(1.0) / (real)(end - begin);
+	for (uint32_t iframe = begin + 1; iframe < end; ++iframe) {
+		const real factor = (real)(iframe - begin) * inv_length;
+		real error;
+		if (channel == ANIMATION_ROTATION)
+			error = animation_rotation_error(animation_nlerp(value[begin], value[end], factor), value[iframe]);
+		else
+			error = animation_translation_error(vector_lerp(value[begin], value[end], factor), value[iframe]);
+		if (error > tolerance)
+			return false;
+	}
+	return true;
+}
+
+//! Greedy key reduction, extending each segment as far as interpolation stays within tolerance.
+//! \return Number of keys stored in key
+static uint32_t
+animation_reduce(const vector_t* value, uint32_t frame_count, unsigned int channel, real tolerance, uint16_t* key) {
+	const uint32_t last = frame_count - 1;
+	bool constant = true;
+	for (uint32_t iframe = 1; constant && (iframe < frame_count); ++iframe) {
+		const real error = (channel == ANIMATION_ROTATION) ? animation_rotation_error(value[iframe], value[0]) :
+		                                                      animation_translation_error(value[iframe], value[0]);
+		constant = (error <= tolerance);
+	}
+	key[0] = 0;
+	if (constant)
+		return 1;
+
+	uint32_t count = 1;
+	uint32_t begin = 0;
+	while (begin < last) {
+		uint32_t end = begin + 1;
+		while ((end < last) && animation_segment_fits(value, begin, end + 1, channel, tolerance))
+			++end;
+		key[count++] = (uint16_t)end;
+		begin = end;
+	}
+	return count;
+}
+
+static uint16_t
+animation_quantize(real value, real offset, real extent) {
+	if (extent <= 0)
+		return 0;
+	real quantized = ((value - offset) / extent) * ANIMATION_QUANTIZE_MAX;
+	quantized = (quantized < 0) ? 0 : ((quantized > ANIMATION_QUANTIZE_MAX) ? ANIMATION_QUANTIZE_MAX : quantized);
+	return (uint16_t)(quantized + REAL_C(0.5));
+}
+
+void
+animation_clip_initialize(animation_clip_t* clip, const transform_t* frames, size_t frame_count, size_t bone_count,
+                          real frame_rate, real rotation_tolerance, real translation_tolerance) {
+	FOUNDATION_ASSERT((frame_count > 0) && (frame_count <= 65536));
+	memset(clip, 0, sizeof(animation_clip_t));
+	clip->bone_count = (uint32_t)bone_count;
+	clip->frame_count = (uint32_t)frame_count;
+	clip->frame_rate = frame_rate;
+	clip->duration = (real)(frame_count - 1) / frame_rate;
+	if (!bone_count)
+		return;
+
+	const size_t max_keys = frame_count * bone_count;
+	clip->track = memory_allocate(HASH_VECTOR, sizeof(animation_track_t) * bone_count, 16, MEMORY_PERSISTENT);
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	uint16_t* frame[3];
+	for (unsigned int channel = 0; channel < 3; ++channel)
+		frame[channel] = vector_arena_allocate(arena, sizeof(uint16_t) * max_keys, 0);
+	uint16_t* rotation = vector_arena_allocate(arena, sizeof(uint16_t) * 3 * max_keys, 0);
+	uint16_t* translation = vector_arena_allocate(arena, sizeof(uint16_t) * 3 * max_keys, 0);
+	uint16_t* scale = vector_arena_allocate(arena, sizeof(uint16_t) * max_keys, 0);
+	vector_t* value = vector_arena_allocate(arena, sizeof(vector_t) * frame_count, 0);
+	quaternion_t* key_rotation = vector_arena_allocate(arena, sizeof(quaternion_t) * frame_count, 0);
+
+	uint32_t total[3] = {0, 0, 0};
+	for (uint32_t ibone = 0; ibone < bone_count; ++ibone) {
+		animation_track_t* track = clip->track + ibone;
+
+		// Rotations made continuous so interpolation error is measured along the shortest arc
+		for (uint32_t iframe = 0; iframe < frame_count; ++iframe) {
+			quaternion_t q = frames[(iframe * bone_count) + ibone].rotation;
+			if (iframe && (vector_x(vector_dot(q, value[iframe - 1])) < 0))
+				q = quaternion_neg(q);
+			value[iframe] = q;
+		}
+		uint16_t* key = frame[ANIMATION_ROTATION] + total[ANIMATION_ROTATION];
+		uint32_t count = animation_reduce(value, (uint32_t)frame_count, ANIMATION_ROTATION, rotation_tolerance, key);
+		for (uint32_t ikey = 0; ikey < count; ++ikey)
+			key_rotation[ikey] = value[key[ikey]];
+		quaternion_pack_smallest3_48(key_rotation, count, rotation + (total[ANIMATION_ROTATION] * 3));
+		track->key[ANIMATION_ROTATION] = total[ANIMATION_ROTATION];
+		track->key_count[ANIMATION_ROTATION] = count;
+		total[ANIMATION_ROTATION] += count;
+
+		// Quantization range of translation and scale
+		vector_t min = frames[ibone].translation;
+		vector_t max = min;
+		for (uint32_t iframe = 1; iframe < frame_count; ++iframe) {
+			const vector_t translation_scale = frames[(iframe * bone_count) + ibone].translation;
+			min = vector_min(min, translation_scale);
+			max = vector_max(max, translation_scale);
+		}
+		track->offset = min;
+		track->extent = vector_sub(max, min);
+		const real offset[4] = {vector_x(min), vector_y(min), vector_z(min), vector_w(min)};
+		const real extent[4] = {vector_x(track->extent), vector_y(track->extent), vector_z(track->extent),
+		                        vector_w(track->extent)};
+
+		for (uint32_t iframe = 0; iframe < frame_count; ++iframe) {
+			const vector_t translation_scale = frames[(iframe * bone_count) + ibone].translation;
+			value[iframe] = vector(vector_x(translation_scale), vector_y(translation_scale),
+			                       vector_z(translation_scale), 0);
+		}
+		key = frame[ANIMATION_TRANSLATION] + total[ANIMATION_TRANSLATION];
+		count = animation_reduce(value, (uint32_t)frame_count, ANIMATION_TRANSLATION, translation_tolerance, key);
+		for (uint32_t ikey = 0; ikey < count; ++ikey) {
+			uint16_t* dst = translation + ((total[ANIMATION_TRANSLATION] + ikey) * 3);
+			const vector_t source = value[key[ikey]];
+			dst[0] = animation_quantize(vector_x(source), offset[0], extent[0]);
+			dst[1] = animation_quantize(vector_y(source), offset[1], extent[1]);
+			dst[2] = animation_quantize(vector_z(source), offset[2], extent[2]);
+		}
+		track->key[ANIMATION_TRANSLATION] = total[ANIMATION_TRANSLATION];
+		track->key_count[ANIMATION_TRANSLATION] = count;
+		total[ANIMATION_TRANSLATION] += count;
+
+		for (uint32_t iframe = 0; iframe < frame_count; ++iframe)
+			value[iframe] = vector(vector_w(frames[(iframe * bone_count) + ibone].translation), 0, 0, 0);
+		key = frame[ANIMATION_SCALE] + total[ANIMATION_SCALE];
+		count = animation_reduce(value, (uint32_t)frame_count, ANIMATION_SCALE, translation_tolerance, key);
+		for (uint32_t ikey = 0; ikey < count; ++ikey)
+			scale[total[ANIMATION_SCALE] + ikey] = animation_quantize(vector_x(value[key[ikey]]), offset[3], extent[3]);
+		track->key[ANIMATION_SCALE] = total[ANIMATION_SCALE];
+		track->key_count[ANIMATION_SCALE] = count;
+		total[ANIMATION_SCALE] += count;
+	}
+
+	// Copy the reduced keys to tightly sized arrays
+	for (unsigned int channel = 0; channel < 3; ++channel) {
+		clip->frame[channel] = memory_allocate(HASH_VECTOR, sizeof(uint16_t) * total[channel], 0, MEMORY_PERSISTENT);
+		memcpy(clip->frame[channel], frame[channel], sizeof(uint16_t) * total[channel]);
+	}
+	const size_t rotation_size = sizeof(uint16_t) * 3 * total[ANIMATION_ROTATION];
+	const size_t translation_size = sizeof(uint16_t) * 3 * total[ANIMATION_TRANSLATION];
+	const size_t scale_size = sizeof(uint16_t) * total[ANIMATION_SCALE];
+	clip->rotation = memory_allocate(HASH_VECTOR, rotation_size, 0, MEMORY_PERSISTENT);
+	clip->translation = memory_allocate(HASH_VECTOR, translation_size, 0, MEMORY_PERSISTENT);
+	clip->scale = memory_allocate(HASH_VECTOR, scale_size, 0, MEMORY_PERSISTENT);
+	memcpy(clip->rotation, rotation, rotation_size);
+	memcpy(clip->translation, translation, translation_size);
+	memcpy(clip->scale, scale, scale_size);
+
+	vector_arena_rewind(arena, mark);
+}
+
+void
+animation_clip_finalize(animation_clip_t* clip) {
+	for (unsigned int channel = 0; channel < 3; ++channel)
+		memory_deallocate(clip->frame[channel]);
+	memory_deallocate(clip->rotation);
+	memory_deallocate(clip->translation);
+	memory_deallocate(clip->scale);
+	memory_deallocate(clip->track);
+	memset(clip, 0, sizeof(animation_clip_t));
+}
+
+size_t
+animation_clip_key_count(const animation_clip_t* clip) {
+	size_t count = 0;
+	for (uint32_t ibone = 0; ibone < clip->bone_count; ++ibone) {
+		const animation_track_t* track = clip->track + ibone;
+		count += track->key_count[0] + track->key_count[1] + track->key_count[2];
+	}
+	return count;
+}
+
+//! Find key starting the segment containing position, relative to first key of channel
+static FOUNDATION_FORCEINLINE uint32_t
+animation_find_key(const uint16_t* frame, uint32_t count, real position, uint32_t* cursor) {
+	if (count < 2)
+		return 0;
+	const uint32_t last = count - 2;
+	uint32_t key = cursor ? *cursor : 0;
+	if ((key <= last) && ((real)frame[key] <= position)) {
+		// Playing forward advances at most a few keys per sample
+		while ((key < last) && ((real)frame[key + 1] <= position))
+			++key;
+	} else {
+		uint32_t low = 0;
+		uint32_t high = last;
+		while (low < high) {
+			const uint32_t mid = (low + high + 1) / 2;
+			if ((real)frame[mid] <= position)
+				low = mid;
+			else
+				high = mid - 1;
+		}
+		key = low;
+	}
+	if (cursor)
+		*cursor = key;
+	return key;
+}
+
+static FOUNDATION_FORCEINLINE real
+animation_factor(const uint16_t* frame, uint32_t key, uint32_t count, real position) {
+	if (count < 2)
+		return 0;
+	const real begin = frame[key];
+	const real factor = (position - begin) / ((real)frame[key + 1] - begin);
+	return (factor < 0) ? 0 : ((factor > 1) ? 1 : factor);
+}
+
+//! Translation and uniform scale of quantized keys, scale in the w component
+static FOUNDATION_FORCEINLINE vector_t
+animation_dequantize(const uint16_t* translation, uint16_t scale, const vector_t offset, const vector_t step) {
+	const vector_t value = vector((real)translation[0], (real)translation[1], (real)translation[2], (real)scale);
+	return vector_muladd(value, step, offset);
+}
+
+//! Load the key pairs of up to four bones as component vectors, missing bones are fill
+static FOUNDATION_FORCEINLINE void
+animation_load(const vector_t* pair, uint32_t remain, const vector_t fill, vector_t* from, vector_t* to) {
+	vector_t row_from[4];
+	vector_t row_to[4];
+	for (uint32_t ibone = 0; ibone < 4; ++ibone) {
+		row_from[ibone] = (ibone < remain) ? pair[ibone * 2] : fill;
+		row_to[ibone] = (ibone < remain) ? pair[(ibone * 2) + 1] : fill;
+	}
+	vector_transpose4(row_from[0], row_from[1], row_from[2], row_from[3], from);
+	vector_transpose4(row_to[0], row_to[1], row_to[2], row_to[3], to);
+}
+
+static FOUNDATION_FORCEINLINE vector_t
+animation_load_factor(const real* factor, uint32_t remain) {
+	real value[4] = {0, 0, 0, 0};
+	for (uint32_t ibone = 0; (ibone < 4) && (ibone < remain); ++ibone)
+		value[ibone] = factor[ibone];
+	return vector(value[0], value[1], value[2], value[3]);
+}
+
+void
+animation_clip_sample(const animation_clip_t* clip, animation_cursor_t* cursor, real time, transform_t* pose) {
+	FOUNDATION_ASSERT(!cursor || (cursor->bone_count == clip->bone_count));
+	real position = time * clip->frame_rate;
+	const real last_frame = (real)(clip->frame_count - 1);
+	position = (position < 0) ? 0 : ((position > last_frame) ? last_frame : position);
+	const real inv_max = REAL_C(1.0) / (real)ANIMATION_QUANTIZE_MAX;
+
+	uint16_t packed[ANIMATION_BLOCK * 2 * 3];
+	quaternion_t rotation[ANIMATION_BLOCK * 2];
+	vector_t translation[ANIMATION_BLOCK * 2];
+	real factor[3][ANIMATION_BLOCK];
+	for (uint32_t block = 0; block < clip->bone_count; block += ANIMATION_BLOCK) {
+		const uint32_t block_count =
+		    (clip->bone_count - block < ANIMATION_BLOCK) ? (clip->bone_count - block) : ANIMATION_BLOCK;
+
+		// Collect the key pairs of the block, rotations are unpacked together
+		for (uint32_t ibone = 0; ibone < block_count; ++ibone) {
+			const animation_track_t* track = clip->track + block + ibone;
+			uint32_t* key_cursor = cursor ? cursor->key + ((block + ibone) * 3) : 0;
+			uint32_t key[3];
+			for (unsigned int channel = 0; channel < 3; ++channel) {
+				const uint32_t count = track->key_count[channel];
+				const uint16_t* frame = clip->frame[channel] + track->key[channel];
+				key[channel] = animation_find_key(frame, count, position, key_cursor ? key_cursor + channel : 0);
+				factor[channel][ibone] = animation_factor(frame, key[channel], count, position);
+			}
+
+			const uint16_t* src = clip->rotation + ((track->key[ANIMATION_ROTATION] + key[ANIMATION_ROTATION]) * 3);
+			uint32_t next = (track->key_count[ANIMATION_ROTATION] > 1) ? 3 : 0;
+			memcpy(packed + (ibone * 6), src, sizeof(uint16_t) * 3);
+			memcpy(packed + (ibone * 6) + 3, src + next, sizeof(uint16_t) * 3);
+
+			const vector_t step = vector_scale(track->extent, inv_max);
+			src = clip->translation + ((track->key[ANIMATION_TRANSLATION] + key[ANIMATION_TRANSLATION]) * 3);
+			next = (track->key_count[ANIMATION_TRANSLATION] > 1) ? 3 : 0;
+			const uint16_t* scale = clip->scale + track->key[ANIMATION_SCALE] + key[ANIMATION_SCALE];
+			const uint32_t next_scale = (track->key_count[ANIMATION_SCALE] > 1) ? 1 : 0;
+			translation[ibone * 2] = animation_dequantize(src, scale[0], track->offset, step);
+			translation[(ibone * 2) + 1] = animation_dequantize(src + next, scale[next_scale], track->offset, step);
+		}
+		quaternion_unpack_smallest3_48(packed, block_count * 2, rotation);
+
+		// Blend four bones at a time as component vectors
+		for (uint32_t ibone = 0; ibone < block_count; ibone += 4) {
+			const uint32_t remain = block_count - ibone;
+			vector_t from[4];
+			vector_t to[4];
+			vector_t row[4];
+			transform_t* transform = pose + block + ibone;
+
+			animation_load(rotation + (ibone * 2), remain, quaternion_identity(), from, to);
+			quaternion_soa_nlerp(from, to, animation_load_factor(factor[ANIMATION_ROTATION] + ibone, remain), from);
+			vector_transpose4(from[0], from[1], from[2], from[3], row);
+			for (uint32_t ilane = 0; (ilane < 4) && (ilane < remain); ++ilane)
+				transform[ilane].rotation = row[ilane];
+
+			// Translation and scale have separate key times
+			animation_load(translation + (ibone * 2), remain, vector(0, 0, 0, 1), from, to);
+			const vector_t scale_factor = animation_load_factor(factor[ANIMATION_SCALE] + ibone, remain);
+			const vector_t scale = vector_muladd(vector_sub(to[3], from[3]), scale_factor, from[3]);
+			vector_soa_lerp(from, to, animation_load_factor(factor[ANIMATION_TRANSLATION] + ibone, remain), from);
+			vector_transpose4(from[0], from[1], from[2], scale, row);
+			for (uint32_t ilane = 0; (ilane < 4) && (ilane < remain); ++ilane)
+				transform[ilane].translation = row[ilane];
+		}
+	}
+}
+
+void
+animation_cursor_initialize(animation_cursor_t* cursor, const animation_clip_t* clip) {
+	cursor->bone_count = clip->bone_count;
+	cursor->key = memory_allocate(HASH_VECTOR, sizeof(uint32_t) * 3 * (clip->bone_count ? clip->bone_count : 1), 0,
+	                              MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+}
+
+void
+animation_cursor_finalize(animation_cursor_t* cursor) {
+	memory_deallocate(cursor->key);
+	cursor->key = 0;
+	cursor->bone_count = 0;
+}
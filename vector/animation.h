@@ -0,0 +1,77 @@
+/* animation.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file animation.h
+    Keyframe animation clips. Clips are built from uniformly sampled bone transforms by removing
+    keys that can be reconstructed by interpolating neighbouring keys within a tolerance, and
+    quantizing the remaining keys. Rotations are stored as 48 bit smallest three quaternions,
+    translation and scale as 16 bit values in the range of each bone. Each channel holds its
+    keys sorted by time with a frame index per key. Keys are not interleaved by time across
+    tracks, clips are expected to be resident in memory rather than streamed, and the cursor
+    already reaches the keys of each channel in constant time.
+
+    Sampling interpolates between the two keys around the sample time, with normalized lerp for
+    rotations. Key pairs are gathered for blocks of bones and blended four bones at a time as
+    component vectors. A cursor per playing instance caches the current key of each channel so
+    playback moving forward in time finds the keys in constant time per channel. Sampling clips
+    for many instances can be split across threads, each instance only reads the shared clip. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Channel index of rotation keys
+#define ANIMATION_ROTATION 0
+//! Channel index of translation keys
+#define ANIMATION_TRANSLATION 1
+//! Channel index of scale keys
+#define ANIMATION_SCALE 2
+
+//! Build clip from uniformly sampled transforms
+//! \param clip Clip
+//! \param frames Transforms, bone_count transforms per frame
+//! \param frame_count Number of frames, at most 65536
+//! \param bone_count Number of bones
+//! \param frame_rate Frames per second
+//! \param rotation_tolerance Max rotation error in radians from removing keys
+//! \param translation_tolerance Max translation and scale error from removing keys
+VECTOR_API void
+animation_clip_initialize(animation_clip_t* clip, const transform_t* frames, size_t frame_count, size_t bone_count,
+                          real frame_rate, real rotation_tolerance, real translation_tolerance);
+
+VECTOR_API void
+animation_clip_finalize(animation_clip_t* clip);
+
+//! Total number of keys stored in clip
+VECTOR_API size_t
+animation_clip_key_count(const animation_clip_t* clip);
+
+//! Sample all bones of clip. Time is clamped to clip duration
+//! \param clip Clip
+//! \param cursor Cursor of the playing instance, can be null
+//! \param time Time in seconds
+//! \param pose Output transforms, clip->bone_count elements
+VECTOR_API void
+animation_clip_sample(const animation_clip_t* clip, animation_cursor_t* cursor, real time, transform_t* pose);
+
+//! Initialize cursor for playing clip from the start
+VECTOR_API void
+animation_cursor_initialize(animation_cursor_t* cursor, const animation_clip_t* clip);
+
+VECTOR_API void
+animation_cursor_finalize(animation_cursor_t* cursor);
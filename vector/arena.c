@@ -0,0 +1,252 @@
+/* arena.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+#include <foundation/atomic.h>
+#include <foundation/thread.h>
+
+#define VECTOR_ARENA_DEFAULT_SIZE (256 * 1024)
+#define VECTOR_ARENA_GRANULARITY 4096
+#define VECTOR_POOL_MIN_SHIFT 8
+#define VECTOR_POOL_CLASS_COUNT 13
+
+typedef struct vector_arena_overflow_t vector_arena_overflow_t;
+typedef struct vector_pool_class_t vector_pool_class_t;
+
+//! Header of overflow block, allocation follows at VECTOR_ARENA_MAX_ALIGNMENT offset
+struct vector_arena_overflow_t {
+	vector_arena_overflow_t* next;
+	//! Arena offset of the allocation, overflow blocks continue the offset range past capacity
+	size_t offset;
+};
+
+//! Free list of one pool size class, on its own cache line to avoid contention between classes
+FOUNDATION_ALIGNED_STRUCT(vector_pool_class_t, 64) {
+	atomic32_t lock;
+	void* free;
+	char padding[64 - sizeof(atomic32_t) - sizeof(void*)];
+};
+
+static size_t vector_arena_default_size = VECTOR_ARENA_DEFAULT_SIZE;
+static vector_arena_t* vector_arena_list;
+static atomic32_t vector_arena_lock;
+//! Incremented on finalize so threads do not reuse arenas of a previous initialization
+static atomic32_t vector_arena_generation;
+static vector_pool_class_t vector_pool_class[VECTOR_POOL_CLASS_COUNT];
+
+FOUNDATION_DECLARE_THREAD_LOCAL(vector_arena_t*, vector_arena, 0)
+FOUNDATION_DECLARE_THREAD_LOCAL(int32_t, vector_arena_thread_generation, -1)
+
+static void
+vector_spin_lock(atomic32_t* lock) {
+	while (!atomic_cas32(lock, 1, 0, memory_order_acquire, memory_order_relaxed))
+		thread_yield();
+}
+
+static void
+vector_spin_unlock(atomic32_t* lock) {
+	atomic_store32(lock, 0, memory_order_release);
+}
+
+void
+vector_arena_initialize(vector_arena_t* arena, size_t capacity) {
+	capacity = (capacity + (VECTOR_ARENA_MAX_ALIGNMENT - 1)) & ~(size_t)(VECTOR_ARENA_MAX_ALIGNMENT - 1);
+	arena->buffer = 0;
+	if (capacity)
+		arena->buffer = memory_allocate(HASH_VECTOR, capacity, VECTOR_ARENA_MAX_ALIGNMENT, MEMORY_PERSISTENT);
+	arena->capacity = capacity;
+	arena->offset = 0;
+	arena->peak = 0;
+	arena->overflow = 0;
+	arena->next = 0;
+}
+
+void
+vector_arena_finalize(vector_arena_t* arena) {
+	vector_arena_rewind(arena, 0);
+	memory_deallocate(arena->buffer);
+	arena->buffer = 0;
+	arena->capacity = 0;
+	arena->peak = 0;
+}
+
+void*
+vector_arena_allocate(vector_arena_t* arena, size_t size, size_t align) {
+	if (!align)
+		align = VECTOR_ALIGNMENT;
+	FOUNDATION_ASSERT(!(align & (align - 1)) && (align <= VECTOR_ARENA_MAX_ALIGNMENT));
+
+	size_t offset = (arena->offset + (align - 1)) & ~(align - 1);
+	void* block;
+	if (offset + size <= arena->capacity) {
+		block = arena->buffer + offset;
+	} else {
+		// Overflow blocks are ordered by offset in the range past capacity so a rewind can
+		// release everything allocated after the mark
+		offset = (arena->offset > arena->capacity) ? arena->offset : arena->capacity;
+		vector_arena_overflow_t* overflow = memory_allocate(HASH_VECTOR, VECTOR_ARENA_MAX_ALIGNMENT + size,
+		                                                    VECTOR_ARENA_MAX_ALIGNMENT, MEMORY_TEMPORARY);
+		overflow->next = arena->overflow;
+		overflow->offset = offset;
+		arena->overflow = overflow;
+		block = pointer_offset(overflow, VECTOR_ARENA_MAX_ALIGNMENT);
+	}
+	arena->offset = offset + size;
+	if (arena->offset > arena->peak)
+		arena->peak = arena->offset;
+	return block;
+}
+
+size_t
+vector_arena_mark(const vector_arena_t* arena) {
+	return arena->offset;
+}
+
+void
+vector_arena_rewind(vector_arena_t* arena, size_t mark) {
+	FOUNDATION_ASSERT(mark <= arena->offset);
+	vector_arena_overflow_t* overflow = arena->overflow;
+	while (overflow && (overflow->offset >= mark)) {
+		vector_arena_overflow_t* next = overflow->next;
+		memory_deallocate(overflow);
+		overflow = next;
+	}
+	arena->overflow = overflow;
+	arena->offset = mark;
+}
+
+void
+vector_arena_reset(vector_arena_t* arena) {
+	vector_arena_rewind(arena, 0);
+	if (arena->peak > arena->capacity) {
+		// Grow to fit the peak usage so the next frame does not need overflow blocks
+		const size_t capacity =
+		    (arena->peak + (VECTOR_ARENA_GRANULARITY - 1)) & ~(size_t)(VECTOR_ARENA_GRANULARITY - 1);
+		memory_deallocate(arena->buffer);
+		arena->buffer = memory_allocate(HASH_VECTOR, capacity, VECTOR_ARENA_MAX_ALIGNMENT, MEMORY_PERSISTENT);
+		arena->capacity = capacity;
+	}
+	arena->peak = 0;
+}
+
+vector_arena_t*
+vector_arena_thread(void) {
+	vector_arena_t* arena = get_thread_vector_arena();
+	const int32_t generation = atomic_load32(&vector_arena_generation, memory_order_acquire);
+	if (arena && (get_thread_vector_arena_thread_generation() == generation))
+		return arena;
+
+	arena = memory_allocate(HASH_VECTOR, sizeof(vector_arena_t), 0, MEMORY_PERSISTENT);
+	vector_arena_initialize(arena, vector_arena_default_size);
+
+	vector_spin_lock(&vector_arena_lock);
+	arena->next = vector_arena_list;
+	vector_arena_list = arena;
+	vector_spin_unlock(&vector_arena_lock);
+
+	set_thread_vector_arena(arena);
+	set_thread_vector_arena_thread_generation(generation);
+	return arena;
+}
+
+void
+vector_arena_frame_reset(void) {
+	vector_spin_lock(&vector_arena_lock);
+	for (vector_arena_t* arena = vector_arena_list; arena; arena = arena->next)
+		vector_arena_reset(arena);
+	vector_spin_unlock(&vector_arena_lock);
+}
+
+static size_t
+vector_pool_class_index(size_t size) {
+	size_t shift = VECTOR_POOL_MIN_SHIFT;
+	while (((size_t)1 << shift) < size)
+		++shift;
+	return shift - VECTOR_POOL_MIN_SHIFT;
+}
+
+void*
+vector_pool_allocate(size_t size) {
+	const size_t index = vector_pool_class_index(size);
+	if (index >= VECTOR_POOL_CLASS_COUNT)
+		return memory_allocate(HASH_VECTOR, size, VECTOR_ARENA_MAX_ALIGNMENT, MEMORY_PERSISTENT);
+
+	vector_pool_class_t* pool = vector_pool_class + index;
+	vector_spin_lock(&pool->lock);
+	void* block = pool->free;
+	if (block)
+		pool->free = *(void**)block;
+	vector_spin_unlock(&pool->lock);
+
+	if (!block)
+		block = memory_allocate(HASH_VECTOR, (size_t)1 << (index + VECTOR_POOL_MIN_SHIFT), VECTOR_ARENA_MAX_ALIGNMENT,
+		                        MEMORY_PERSISTENT);
+	return block;
+}
+
+void
+vector_pool_deallocate(void* block, size_t size) {
+	if (!block)
+		return;
+	const size_t index = vector_pool_class_index(size);
+	if (index >= VECTOR_POOL_CLASS_COUNT) {
+		memory_deallocate(block);
+		return;
+	}
+
+	vector_pool_class_t* pool = vector_pool_class + index;
+	vector_spin_lock(&pool->lock);
+	*(void**)block = pool->free;
+	pool->free = block;
+	vector_spin_unlock(&pool->lock);
+}
+
+int
+vector_arena_module_initialize(const vector_config_t config) {
+	vector_arena_default_size = config.arena_size ? config.arena_size : VECTOR_ARENA_DEFAULT_SIZE;
+	return 0;
+}
+
+void
+vector_arena_module_finalize(void) {
+	vector_spin_lock(&vector_arena_lock);
+	vector_arena_t* arena = vector_arena_list;
+	while (arena) {
+		vector_arena_t* next = arena->next;
+		vector_arena_finalize(arena);
+		memory_deallocate(arena);
+		arena = next;
+	}
+	vector_arena_list = 0;
+	atomic_incr32(&vector_arena_generation, memory_order_release);
+	vector_spin_unlock(&vector_arena_lock);
+
+	for (size_t index = 0; index < VECTOR_POOL_CLASS_COUNT; ++index) {
+		vector_pool_class_t* pool = vector_pool_class + index;
+		vector_spin_lock(&pool->lock);
+		void* block = pool->free;
+		while (block) {
+			void* next = *(void**)block;
+			memory_deallocate(block);
+			block = next;
+		}
+		pool->free = 0;
+		vector_spin_unlock(&pool->lock);
+	}
+}
@@ -0,0 +1,102 @@
+/* arena.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file arena.h
+    Temporary and pooled memory for vector and matrix arrays. Each thread has a linear arena for
+    scratch arrays, allocated with a mark and rewind pattern and reset once per frame. When an
+    arena is full, allocations fall back to overflow blocks and the arena grows to the peak usage
+    on the next reset, so a steady state frame does not call the general allocator. Longer lived
+    arrays like matrix palettes can be allocated from a pool of power of two sized blocks. */
+
+#include <vector/types.h>
+
+//! Largest alignment supported by arena and pool allocations
+#define VECTOR_ARENA_MAX_ALIGNMENT 64
+
+//! Get temporary memory arena of the calling thread, created on first use. Arenas of all
+//! threads are released by vector_module_finalize
+VECTOR_API vector_arena_t*
+vector_arena_thread(void);
+
+//! Initialize arena
+//! \param arena Arena
+//! \param capacity Initial capacity in bytes, can be zero
+VECTOR_API void
+vector_arena_initialize(vector_arena_t* arena, size_t capacity);
+
+VECTOR_API void
+vector_arena_finalize(vector_arena_t* arena);
+
+//! Allocate memory from arena
+//! \param arena Arena
+//! \param size Size in bytes
+//! \param align Alignment, power of two at most VECTOR_ARENA_MAX_ALIGNMENT, zero for VECTOR_ALIGNMENT
+//! \return Memory valid until arena is rewound past it or reset
+VECTOR_API void*
+vector_arena_allocate(vector_arena_t* arena, size_t size, size_t align);
+
+//! Get current position in arena to rewind to later
+VECTOR_API size_t
+vector_arena_mark(const vector_arena_t* arena);
+
+//! Release all allocations made after mark was taken
+//! \param arena Arena
+//! \param mark Mark from vector_arena_mark
+VECTOR_API void
+vector_arena_rewind(vector_arena_t* arena, size_t mark);
+
+//! Release all allocations, growing the arena if overflow blocks were needed
+VECTOR_API void
+vector_arena_reset(vector_arena_t* arena);
+
+//! Reset arenas of all threads at a frame boundary. No other thread can use its arena during the call
+VECTOR_API void
+vector_arena_frame_reset(void);
+
+//! Allocate block from pool, aligned to VECTOR_ARENA_MAX_ALIGNMENT. Sizes are rounded up to a
+//! power of two, sizes above one megabyte are not pooled
+//! \param size Size in bytes
+VECTOR_API void*
+vector_pool_allocate(size_t size);
+
+//! Return block to pool
+//! \param block Block from vector_pool_allocate
+//! \param size Size in bytes as given when allocated
+VECTOR_API void
+vector_pool_deallocate(void* block, size_t size);
+
+static FOUNDATION_FORCEINLINE matrix_t*
+vector_pool_allocate_matrix(size_t count) {
+	return (matrix_t*)vector_pool_allocate(sizeof(matrix_t) * count);
+}
+
+static FOUNDATION_FORCEINLINE void
+vector_pool_deallocate_matrix(matrix_t* matrix, size_t count) {
+	vector_pool_deallocate(matrix, sizeof(matrix_t) * count);
+}
+
+static FOUNDATION_FORCEINLINE transform_t*
+vector_pool_allocate_transform(size_t count) {
+	return (transform_t*)vector_pool_allocate(sizeof(transform_t) * count);
+}
+
+static FOUNDATION_FORCEINLINE void
+vector_pool_deallocate_transform(transform_t* transform, size_t count) {
+	vector_pool_deallocate(transform, sizeof(transform_t) * count);
+}
@@ -0,0 +1,143 @@
+/* batch.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/batch.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+#include <foundation/atomic.h>
+
+typedef struct batch_transform_t batch_transform_t;
+typedef struct batch_palette_t batch_palette_t;
+typedef struct batch_cull_t batch_cull_t;
+
+VECTOR_ALIGNED_STRUCT(batch_transform_t) {
+	matrix_t transform;
+	const vector_t* point;
+	vector_t* out;
+};
+
+struct batch_palette_t {
+	const matrix_t* inverse_bind;
+	const matrix_t* pose;
+	matrix_t* palette;
+};
+
+//! Planes transposed in groups of four, one vector per component
+VECTOR_ALIGNED_STRUCT(batch_cull_t) {
+	vector_t normal_x[BATCH_CULL_MAX_PLANES / 4];
+	vector_t normal_y[BATCH_CULL_MAX_PLANES / 4];
+	vector_t normal_z[BATCH_CULL_MAX_PLANES / 4];
+	vector_t distance[BATCH_CULL_MAX_PLANES / 4];
+	size_t group_count;
+	const aabb_t* bounds;
+	uint8_t* visible;
+	atomic32_t visible_count;
+};
+
+static void
+batch_transform_points_range(void* context, size_t begin, size_t end) {
+	const batch_transform_t* batch = context;
+	const matrix_t transform = batch->transform;
+	for (size_t ipt = begin; ipt < end; ++ipt)
+		batch->out[ipt] = vector_transform(batch->point[ipt], transform);
+}
+
+void
+batch_transform_points(const matrix_t transform, const vector_t* point, vector_t* out, size_t count) {
+	batch_transform_t batch;
+	batch.transform = transform;
+	batch.point = point;
+	batch.out = out;
+	vector_parallel_for(STRING_CONST("batch_transform_points"), batch_transform_points_range, &batch, count, 0);
+}
+
+static void
+batch_matrix_palette_range(void* context, size_t begin, size_t end) {
+	const batch_palette_t* batch = context;
+	for (size_t imat = begin; imat < end; ++imat)
+		batch->palette[imat] = matrix_mul(batch->inverse_bind[imat], batch->pose[imat]);
+}
+
+void
+batch_matrix_palette(const matrix_t* inverse_bind, const matrix_t* pose, matrix_t* palette, size_t count) {
+	batch_palette_t batch;
+	batch.inverse_bind = inverse_bind;
+	batch.pose = pose;
+	batch.palette = palette;
+	vector_parallel_for(STRING_CONST("batch_matrix_palette"), batch_matrix_palette_range, &batch, count, 0);
+}
+
+static void
+batch_cull_aabb_range(void* context, size_t begin, size_t end) {
+	batch_cull_t* batch = context;
+	const vector_t half = vector_half();
+	int32_t visible_count = 0;
+	for (size_t ibox = begin; ibox < end; ++ibox) {
+		const aabb_t box = batch->bounds[ibox];
+		const vector_t center = vector_mul(vector_add(box.min, box.max), half);
+		const vector_t extent = vector_mul(vector_sub(box.max, box.min), half);
+		const vector_t center_x = vector_shuffle(center, VECTOR_MASK_XXXX);
+		const vector_t center_y = vector_shuffle(center, VECTOR_MASK_YYYY);
+		const vector_t center_z = vector_shuffle(center, VECTOR_MASK_ZZZZ);
+		const vector_t extent_x = vector_shuffle(extent, VECTOR_MASK_XXXX);
+		const vector_t extent_y = vector_shuffle(extent, VECTOR_MASK_YYYY);
+		const vector_t extent_z = vector_shuffle(extent, VECTOR_MASK_ZZZZ);
+		// Signed distance of box center and projected box radius for four planes at a time
+		vectori_t outside = vectori_zero();
+		for (size_t igroup = 0; igroup < batch->group_count; ++igroup) {
+			const vector_t distance =
+			    vector_muladd(batch->normal_x[igroup], center_x,
+			                  vector_muladd(batch->normal_y[igroup], center_y,
+			                                vector_muladd(batch->normal_z[igroup], center_z, batch->distance[igroup])));
+			const vector_t radius = vector_muladd(
+			    vector_abs(batch->normal_x[igroup]), extent_x,
+			    vector_muladd(vector_abs(batch->normal_y[igroup]), extent_y,
+			                  vector_mul(vector_abs(batch->normal_z[igroup]), extent_z)));
+			outside = vectori_or(outside, vector_less(vector_add(distance, radius), vector_zero()));
+		}
+		const int32_t lane[4] = {vectori_x(outside), vectori_y(outside), vectori_z(outside), vectori_w(outside)};
+		const uint8_t is_visible = (lane[0] | lane[1] | lane[2] | lane[3]) ? 0 : 1;
+		batch->visible[ibox] = is_visible;
+		visible_count += is_visible;
+	}
+	atomic_add32(&batch->visible_count, visible_count, memory_order_relaxed);
+}
+
+size_t
+batch_cull_aabb(const vector_t* plane, size_t plane_count, const aabb_t* bounds, size_t count, uint8_t* visible) {
+	FOUNDATION_ASSERT(plane_count <= BATCH_CULL_MAX_PLANES);
+	batch_cull_t batch;
+	// Pad last group with planes that have every point inside
+	vector_t padded[BATCH_CULL_MAX_PLANES];
+	for (size_t iplane = 0; iplane < BATCH_CULL_MAX_PLANES; ++iplane)
+		padded[iplane] = (iplane < plane_count) ? plane[iplane] : vector(0, 0, 0, 1);
+	batch.group_count = (plane_count + 3) / 4;
+	for (size_t igroup = 0; igroup < batch.group_count; ++igroup) {
+		const vector_t* group = padded + (igroup * 4);
+		vector_t comp[4];
+		vector_transpose4(group[0], group[1], group[2], group[3], comp);
+		batch.normal_x[igroup] = comp[0];
+		batch.normal_y[igroup] = comp[1];
+		batch.normal_z[igroup] = comp[2];
+		batch.distance[igroup] = comp[3];
+	}
+	batch.bounds = bounds;
+	batch.visible = visible;
+	atomic_store32(&batch.visible_count, 0, memory_order_relaxed);
+	vector_parallel_for(STRING_CONST("batch_cull_aabb"), batch_cull_aabb_range, &batch, count, 0);
+	return (size_t)atomic_load32(&batch.visible_count, memory_order_relaxed);
+}
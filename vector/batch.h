@@ -0,0 +1,57 @@
+/* batch.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file batch.h
+    Array kernels split across the job threads with vector_parallel_for. Each job range writes
+    only its own part of the output arrays. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+#include <vector/aabb.h>
+
+//! Maximum number of planes for culling
+#define BATCH_CULL_MAX_PLANES 16
+
+//! Transform points by matrix, out[i] = vector_transform(point[i], transform)
+//! \param transform Transform matrix
+//! \param point Input points
+//! \param out Output points, can be the same as input
+//! \param count Number of points
+VECTOR_API void
+batch_transform_points(const matrix_t transform, const vector_t* point, vector_t* out, size_t count);
+
+//! Calculate skinning matrix palette, palette[i] = matrix_mul(inverse_bind[i], pose[i])
+//! \param inverse_bind Inverse bind pose matrices
+//! \param pose Current pose matrices in model space
+//! \param palette Output matrices
+//! \param count Number of matrices
+VECTOR_API void
+batch_matrix_palette(const matrix_t* inverse_bind, const matrix_t* pose, matrix_t* palette, size_t count);
+
+//! Cull boxes against a set of planes. A plane (x, y, z, w) has the inside where
+//! dot(xyz, point) + w >= 0, a box is visible unless it is entirely outside any plane
+//! \param plane Planes with inward facing normals
+//! \param plane_count Number of planes, at most BATCH_CULL_MAX_PLANES
+//! \param bounds Boxes
+//! \param count Number of boxes
+//! \param visible Output flags, one if box is visible and zero if culled
+//! \return Number of visible boxes
+VECTOR_API size_t
+batch_cull_aabb(const vector_t* plane, size_t plane_count, const aabb_t* bounds, size_t count, uint8_t* visible);
@@ -0,0 +1,302 @@
+/* broadphase.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/broadphase.h>
+#include <vector/morton.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+//! Number of sweep list entries in each parallel pair generation chunk
+#define BROADPHASE_CHUNK_SIZE 256
+
+//! Max number of appended entries placed by the insertion sort alone, more are presorted
+//! with a radix sort since each may have to move across the whole list
+#define BROADPHASE_INSERTION_LIMIT 32
+
+typedef struct broadphase_pairs_t broadphase_pairs_t;
+
+struct broadphase_pairs_t {
+	const broadphase_entry_t* entry;
+	size_t count;
+	//! Pair count per chunk, replaced by output offsets before the write pass
+	size_t* chunk_pairs;
+	broadphase_pair_t* pair;
+	size_t capacity;
+};
+
+broadphase_t*
+broadphase_allocate(unsigned int axis) {
+	broadphase_t* broadphase = memory_allocate(HASH_VECTOR, sizeof(broadphase_t), 0, MEMORY_PERSISTENT);
+	broadphase_initialize(broadphase, axis);
+	return broadphase;
+}
+
+void
+broadphase_initialize(broadphase_t* broadphase, unsigned int axis) {
+	FOUNDATION_ASSERT(axis < 3);
+	memset(broadphase, 0, sizeof(broadphase_t));
+	broadphase->axis = axis;
+}
+
+void
+broadphase_finalize(broadphase_t* broadphase) {
+	memory_deallocate(broadphase->min);
+	memory_deallocate(broadphase->max);
+	memory_deallocate(broadphase->active);
+	memory_deallocate(broadphase->free);
+	memory_deallocate(broadphase->removed);
+	memory_deallocate(broadphase->entry);
+	memory_deallocate(broadphase->chunk_pairs);
+	broadphase_initialize(broadphase, broadphase->axis);
+}
+
+void
+broadphase_deallocate(broadphase_t* broadphase) {
+	if (broadphase)
+		broadphase_finalize(broadphase);
+	memory_deallocate(broadphase);
+}
+
+static void*
+broadphase_grow_array(void* array, size_t size, size_t count, size_t capacity, unsigned int align) {
+	void* grown = memory_allocate(HASH_VECTOR, size * capacity, align, MEMORY_PERSISTENT);
+	if (count)
+		memcpy(grown, array, size * count);
+	memory_deallocate(array);
+	return grown;
+}
+
+//! Double handle capacity. The sweep list never holds more entries than there are handles
+static void
+broadphase_grow(broadphase_t* broadphase) {
+	const uint32_t count = broadphase->handle_count;
+	const uint32_t capacity = broadphase->handle_capacity ? broadphase->handle_capacity * 2 : 64;
+	broadphase->min = broadphase_grow_array(broadphase->min, sizeof(vector_t), count, capacity, 16);
+	broadphase->max = broadphase_grow_array(broadphase->max, sizeof(vector_t), count, capacity, 16);
+	broadphase->active = broadphase_grow_array(broadphase->active, sizeof(uint8_t), count, capacity, 0);
+	broadphase->free =
+	    broadphase_grow_array(broadphase->free, sizeof(uint32_t), broadphase->free_count, capacity, 0);
+	broadphase->removed =
+	    broadphase_grow_array(broadphase->removed, sizeof(uint32_t), broadphase->removed_count, capacity, 0);
+	broadphase->entry = broadphase_grow_array(broadphase->entry, sizeof(broadphase_entry_t),
+	                                          broadphase->entry_count, capacity, 16);
+	broadphase->handle_capacity = capacity;
+}
+
+uint32_t
+broadphase_add(broadphase_t* broadphase, const aabb_t box) {
+	uint32_t handle;
+	if (broadphase->free_count) {
+		handle = broadphase->free[--broadphase->free_count];
+	} else {
+		FOUNDATION_ASSERT(broadphase->handle_count < BROADPHASE_INVALID_HANDLE);
+		if (broadphase->handle_count == broadphase->handle_capacity)
+			broadphase_grow(broadphase);
+		handle = broadphase->handle_count++;
+	}
+	broadphase->min[handle] = box.min;
+	broadphase->max[handle] = box.max;
+	broadphase->active[handle] = 1;
+	broadphase->entry[broadphase->entry_count++].handle = handle;
+	++broadphase->unsorted_count;
+	return handle;
+}
+
+void
+broadphase_remove(broadphase_t* broadphase, uint32_t handle) {
+	FOUNDATION_ASSERT(handle < broadphase->handle_count);
+	FOUNDATION_ASSERT(broadphase->active[handle]);
+	broadphase->active[handle] = 0;
+	broadphase->removed[broadphase->removed_count++] = handle;
+}
+
+void
+broadphase_update(broadphase_t* broadphase, uint32_t handle, const aabb_t box) {
+	FOUNDATION_ASSERT(handle < broadphase->handle_count);
+	broadphase->min[handle] = box.min;
+	broadphase->max[handle] = box.max;
+}
+
+void
+broadphase_update_array(broadphase_t* broadphase, const uint32_t* handle, const aabb_t* box, size_t count) {
+	for (size_t ibox = 0; ibox < count; ++ibox) {
+		FOUNDATION_ASSERT(handle[ibox] < broadphase->handle_count);
+		broadphase->min[handle[ibox]] = box[ibox].min;
+		broadphase->max[handle[ibox]] = box[ibox].max;
+	}
+}
+
+aabb_t
+broadphase_bounds(const broadphase_t* broadphase, uint32_t handle) {
+	FOUNDATION_ASSERT(handle < broadphase->handle_count);
+	return aabb(broadphase->min[handle], broadphase->max[handle]);
+}
+
+//! Rotate components so the sweep axis is in x
+static FOUNDATION_FORCEINLINE vector_t
+broadphase_swizzle(const vector_t v, unsigned int axis) {
+	if (axis == 1)
+		return vector_shuffle(v, VECTOR_MASK_YZXW);
+	if (axis == 2)
+		return vector_shuffle(v, VECTOR_MASK_ZXYW);
+	return v;
+}
+
+//! Map float to unsigned integer with the same order
+static FOUNDATION_FORCEINLINE uint32_t
+broadphase_radix_key(real value) {
+	const float32_t narrow = (float32_t)value;
+	uint32_t bits;
+	memcpy(&bits, &narrow, sizeof(bits));
+	return (bits & 0x80000000U) ? ~bits : (bits | 0x80000000U);
+}
+
+//! Drop removed entries, copy current bounds into the sweep list and restore the sort order
+static void
+broadphase_sort(broadphase_t* broadphase) {
+	broadphase_entry_t* entry = broadphase->entry;
+	const unsigned int axis = broadphase->axis;
+	uint32_t count = 0;
+	for (uint32_t ientry = 0; ientry < broadphase->entry_count; ++ientry) {
+		const uint32_t handle = entry[ientry].handle;
+		if (!broadphase->active[handle])
+			continue;
+		entry[count].min = broadphase_swizzle(broadphase->min[handle], axis);
+		entry[count].max = broadphase_swizzle(broadphase->max[handle], axis);
+		entry[count].handle = handle;
+		++count;
+	}
+	broadphase->entry_count = count;
+
+	// Entries of removed handles are gone, handles can be reused
+	if (broadphase->removed_count) {
+		memcpy(broadphase->free + broadphase->free_count, broadphase->removed,
+		       sizeof(uint32_t) * broadphase->removed_count);
+		broadphase->free_count += broadphase->removed_count;
+		broadphase->removed_count = 0;
+	}
+
+	if (broadphase->unsorted_count > BROADPHASE_INSERTION_LIMIT) {
+		uint32_t* code = memory_allocate(HASH_VECTOR, sizeof(uint32_t) * count * 2, 0, MEMORY_TEMPORARY);
+		uint32_t* order = code + count;
+		for (uint32_t ientry = 0; ientry < count; ++ientry)
+			code[ientry] = broadphase_radix_key(vector_x(entry[ientry].min));
+		morton_sort32(code, order, count);
+		morton_reorder(entry, sizeof(broadphase_entry_t), order, count);
+		memory_deallocate(code);
+	}
+	broadphase->unsorted_count = 0;
+
+	// Insertion sort, linear in the number of entries for the nearly sorted list of a moving set.
+	// Also corrects any order differences from the narrowed radix keys
+	for (uint32_t ientry = 1; ientry < count; ++ientry) {
+		const real key = vector_x(entry[ientry].min);
+		if (!(key < vector_x(entry[ientry - 1].min)))
+			continue;
+		const broadphase_entry_t moved = entry[ientry];
+		uint32_t slot = ientry;
+		do {
+			entry[slot] = entry[slot - 1];
+			--slot;
+		} while (slot && (key < vector_x(entry[slot - 1].min)));
+		entry[slot] = moved;
+	}
+}
+
+static FOUNDATION_FORCEINLINE bool
+broadphase_overlap_yz(const broadphase_entry_t* entry0, const broadphase_entry_t* entry1) {
+	// Sweep axis in x overlaps by construction of the scan, only the other two lanes are checked
+	const vectori_t inside =
+	    vectori_and(vector_lequal(entry0->min, entry1->max), vector_lequal(entry1->min, entry0->max));
+	return vectori_y(inside) && vectori_z(inside);
+}
+
+//! Scan entries of one chunk for pairs, writing pairs from the given output offset while inside
+//! the output buffer capacity
+//! \return Number of pairs found
+static size_t
+broadphase_scan_chunk(const broadphase_pairs_t* pairs, size_t chunk, size_t offset, size_t capacity) {
+	const broadphase_entry_t* entry = pairs->entry;
+	const size_t first = chunk * BROADPHASE_CHUNK_SIZE;
+	const size_t last = (first + BROADPHASE_CHUNK_SIZE < pairs->count) ? first + BROADPHASE_CHUNK_SIZE : pairs->count;
+	size_t found = 0;
+	for (size_t ientry = first; ientry < last; ++ientry) {
+		const broadphase_entry_t* current = entry + ientry;
+		const real sweep_max = vector_x(current->max);
+		for (size_t iother = ientry + 1; (iother < pairs->count) && (vector_x(entry[iother].min) <= sweep_max);
+		     ++iother) {
+			if (!broadphase_overlap_yz(current, entry + iother))
+				continue;
+			if (offset + found < capacity) {
+				const uint32_t handle0 = current->handle;
+				const uint32_t handle1 = entry[iother].handle;
+				pairs->pair[offset + found].first = (handle0 < handle1) ? handle0 : handle1;
+				pairs->pair[offset + found].second = (handle0 < handle1) ? handle1 : handle0;
+			}
+			++found;
+		}
+	}
+	return found;
+}
+
+static void
+broadphase_count_range(void* context, size_t begin, size_t end) {
+	broadphase_pairs_t* pairs = context;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk)
+		pairs->chunk_pairs[ichunk] = broadphase_scan_chunk(pairs, ichunk, 0, 0);
+}
+
+static void
+broadphase_write_range(void* context, size_t begin, size_t end) {
+	broadphase_pairs_t* pairs = context;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		if (pairs->chunk_pairs[ichunk] < pairs->capacity)
+			broadphase_scan_chunk(pairs, ichunk, pairs->chunk_pairs[ichunk], pairs->capacity);
+	}
+}
+
+size_t
+broadphase_find_pairs(broadphase_t* broadphase, broadphase_pair_t* pair, size_t capacity) {
+	broadphase_sort(broadphase);
+
+	const size_t chunk_count = (broadphase->entry_count + (BROADPHASE_CHUNK_SIZE - 1)) / BROADPHASE_CHUNK_SIZE;
+	if (broadphase->chunk_capacity < chunk_count) {
+		memory_deallocate(broadphase->chunk_pairs);
+		broadphase->chunk_pairs = memory_allocate(HASH_VECTOR, sizeof(size_t) * chunk_count, 0, MEMORY_PERSISTENT);
+		broadphase->chunk_capacity = (uint32_t)chunk_count;
+	}
+
+	broadphase_pairs_t pairs;
+	pairs.entry = broadphase->entry;
+	pairs.count = broadphase->entry_count;
+	pairs.chunk_pairs = broadphase->chunk_pairs;
+	pairs.pair = pair;
+	pairs.capacity = capacity;
+	vector_parallel_for(STRING_CONST("broadphase_count_pairs"), broadphase_count_range, &pairs, chunk_count, 1);
+
+	size_t total = 0;
+	for (size_t ichunk = 0; ichunk < chunk_count; ++ichunk) {
+		const size_t found = pairs.chunk_pairs[ichunk];
+		pairs.chunk_pairs[ichunk] = total;
+		total += found;
+	}
+
+	if (capacity && total)
+		vector_parallel_for(STRING_CONST("broadphase_write_pairs"), broadphase_write_range, &pairs, chunk_count, 1);
+	return total;
+}
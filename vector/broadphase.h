@@ -0,0 +1,93 @@
+/* broadphase.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file broadphase.h
+    Incremental sweep and prune broadphase. Boxes are identified by handles and kept in a sweep
+    list sorted by box min on the sweep axis. Since objects move little between frames the list
+    stays nearly sorted and is restored with an insertion sort, while large numbers of added boxes
+    are first placed with a radix sort. Pairs are found by scanning forward from each entry while
+    the entry min is inside the box max on the sweep axis, testing the full boxes as one vector
+    compare. The list is split in chunks processed in parallel with vector_parallel_for, pairs are
+    counted in a first pass so each chunk writes a disjoint output range and the pair order does
+    not depend on the number of threads. Pick the sweep axis with the largest spread of objects. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+
+//! Sentinel for invalid handles
+#define BROADPHASE_INVALID_HANDLE 0xFFFFFFFFU
+
+//! Allocate and initialize broadphase
+//! \param axis Sweep axis index, 0-2
+VECTOR_API broadphase_t*
+broadphase_allocate(unsigned int axis);
+
+//! Initialize broadphase
+//! \param broadphase Broadphase
+//! \param axis Sweep axis index, 0-2
+VECTOR_API void
+broadphase_initialize(broadphase_t* broadphase, unsigned int axis);
+
+VECTOR_API void
+broadphase_finalize(broadphase_t* broadphase);
+
+VECTOR_API void
+broadphase_deallocate(broadphase_t* broadphase);
+
+//! Add box, handles of removed boxes are reused
+//! \param broadphase Broadphase
+//! \param box Box bounds
+//! \return Handle
+VECTOR_API uint32_t
+broadphase_add(broadphase_t* broadphase, const aabb_t box);
+
+//! Remove box. The handle is reused once the next pair query has dropped it from the sweep list
+//! \param broadphase Broadphase
+//! \param handle Handle
+VECTOR_API void
+broadphase_remove(broadphase_t* broadphase, uint32_t handle);
+
+//! Set new bounds of box, the sweep list is updated by the next pair query
+//! \param broadphase Broadphase
+//! \param handle Handle
+//! \param box Box bounds
+VECTOR_API void
+broadphase_update(broadphase_t* broadphase, uint32_t handle, const aabb_t box);
+
+//! Set new bounds for many boxes
+//! \param broadphase Broadphase
+//! \param handle Handles
+//! \param box Box bounds for each handle
+//! \param count Number of handles
+VECTOR_API void
+broadphase_update_array(broadphase_t* broadphase, const uint32_t* handle, const aabb_t* box, size_t count);
+
+//! Get current bounds of box
+VECTOR_API aabb_t
+broadphase_bounds(const broadphase_t* broadphase, uint32_t handle);
+
+//! Sort the sweep list and collect all pairs of overlapping boxes. Touching boxes are considered
+//! overlapping
+//! \param broadphase Broadphase
+//! \param pair Pair output buffer
+//! \param capacity Capacity of output buffer
+//! \return Total number of pairs found, can be larger than capacity
+VECTOR_API size_t
+broadphase_find_pairs(broadphase_t* broadphase, broadphase_pair_t* pair, size_t capacity);
@@ -70,3 +70,15 @@
 #undef VECTOR_IMPLEMENTATION_NEON
 #define VECTOR_IMPLEMENTATION_NEON 1
 #endif
+
+/*! Deterministic mode, set to 1 for bit identical results across all implementations at some
+    cost in speed. Disables fused multiply-add, fixes the order of operations in horizontal sums
+    and uses library approximations of trigonometric functions instead of the platform math
+    library. Must be set the same for the library and all code including the library headers.
+    The compiler must not contract or reassociate floating point operations in any of that code,
+    build with -ffp-contract=off and without -ffast-math for GCC and Clang, and with /fp:precise
+    for MSVC. The vector_deterministic library target is built this way. Results are bit identical
+    only for normal numbers, 32-bit ARM NEON flushes subnormal inputs and results to zero. */
+#ifndef VECTOR_DETERMINISTIC
+#define VECTOR_DETERMINISTIC 0
+#endif
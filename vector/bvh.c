@@ -0,0 +1,712 @@
+/* bvh.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/bvh.h>
+#include <vector/job.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+#include <foundation/atomic.h>
+
+#define BVH_BIN_COUNT 16
+//! Node depth after which splits fall back to object median, bounding traversal stack depth
+#define BVH_MAX_SAH_DEPTH 32
+//! Max number of interior node levels. Below BVH_MAX_SAH_DEPTH each level splits at the object
+//! median twice, quartering the primitive count, so less than 2^31 primitives reach leaf size
+//! within 16 more levels
+#define BVH_MAX_DEPTH (BVH_MAX_SAH_DEPTH + 16)
+//! Depth first traversal pops one node and pushes at most four children, leaving at most three
+//! siblings on the stack for each level above the current node
+#define BVH_STACK_SIZE (3 * BVH_MAX_DEPTH + 1)
+//! Subtrees are built depth first with the same bound as traversal
+#define BVH_TASK_CAPACITY BVH_STACK_SIZE
+//! Number of subtrees the top of the tree is split into for the parallel build
+#define BVH_PARALLEL_TASKS 64
+//! Ranges with fewer primitives are built as one subtree
+#define BVH_PARALLEL_MIN_PRIMITIVES 512
+
+typedef struct bvh_range_t bvh_range_t;
+typedef struct bvh_task_t bvh_task_t;
+typedef struct bvh_builder_t bvh_builder_t;
+typedef struct bvh_ray_t bvh_ray_t;
+
+struct bvh_range_t {
+	uint32_t begin;
+	uint32_t end;
+	aabb_t bounds;
+	aabb_t centroid_bounds;
+};
+
+struct bvh_task_t {
+	bvh_range_t range;
+	int32_t node;
+	uint32_t depth;
+};
+
+struct bvh_builder_t {
+	bvh_t* bvh;
+	//! Primitive bounds and centroids in original primitive order
+	const aabb_t* bounds;
+	vector_t* centroid;
+	//! Root tasks of the subtrees built in parallel
+	const bvh_task_t* subtree;
+	atomic32_t node_count;
+};
+
+//! Ray splatted to structure-of-arrays form for four-wide node tests
+struct bvh_ray_t {
+	vector_t origin_x;
+	vector_t origin_y;
+	vector_t origin_z;
+	vector_t inv_x;
+	vector_t inv_y;
+	vector_t inv_z;
+	bool negative[3];
+};
+
+bvh_t*
+bvh_allocate(void) {
+	bvh_t* bvh = memory_allocate(HASH_VECTOR, sizeof(bvh_t), 0, MEMORY_PERSISTENT);
+	bvh_initialize(bvh);
+	return bvh;
+}
+
+void
+bvh_initialize(bvh_t* bvh) {
+	memset(bvh, 0, sizeof(bvh_t));
+}
+
+void
+bvh_finalize(bvh_t* bvh) {
+	memory_deallocate(bvh->node);
+	memory_deallocate(bvh->primitive);
+	memory_deallocate(bvh->bounds);
+	bvh_initialize(bvh);
+}
+
+void
+bvh_deallocate(bvh_t* bvh) {
+	if (bvh)
+		bvh_finalize(bvh);
+	memory_deallocate(bvh);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+bvh_reduce_min(const vector_t v) {
+	const vector_t m = vector_min(v, vector_shuffle(v, VECTOR_MASK_YXWZ));
+	return vector_min(m, vector_shuffle(m, VECTOR_MASK_ZWXY));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+bvh_reduce_max(const vector_t v) {
+	const vector_t m = vector_max(v, vector_shuffle(v, VECTOR_MASK_YXWZ));
+	return vector_max(m, vector_shuffle(m, VECTOR_MASK_ZWXY));
+}
+
+static aabb_t
+bvh_node_bounds(const bvh_node_t* node) {
+	return aabb(vector(vector_x(bvh_reduce_min(node->min_x)), vector_x(bvh_reduce_min(node->min_y)),
+	                   vector_x(bvh_reduce_min(node->min_z)), 0),
+	            vector(vector_x(bvh_reduce_max(node->max_x)), vector_x(bvh_reduce_max(node->max_y)),
+	                   vector_x(bvh_reduce_max(node->max_z)), 0));
+}
+
+static void
+bvh_node_clear(bvh_node_t* node) {
+	node->min_x = node->min_y = node->min_z = vector_uniform(REAL_MAX);
+	node->max_x = node->max_y = node->max_z = vector_uniform(-REAL_MAX);
+	for (int lane = 0; lane < 4; ++lane) {
+		node->child[lane] = -1;
+		node->count[lane] = 0;
+	}
+}
+
+static void
+bvh_node_set_bounds(bvh_node_t* node, int lane, const aabb_t bounds) {
+	node->min_x = vector_set_component(node->min_x, lane, vector_x(bounds.min));
+	node->min_y = vector_set_component(node->min_y, lane, vector_y(bounds.min));
+	node->min_z = vector_set_component(node->min_z, lane, vector_z(bounds.min));
+	node->max_x = vector_set_component(node->max_x, lane, vector_x(bounds.max));
+	node->max_y = vector_set_component(node->max_y, lane, vector_y(bounds.max));
+	node->max_z = vector_set_component(node->max_z, lane, vector_z(bounds.max));
+}
+
+static void
+bvh_range_compute_bounds(const bvh_builder_t* builder, bvh_range_t* range) {
+	const uint32_t* primitive = builder->bvh->primitive;
+	aabb_t bounds = aabb_empty();
+	aabb_t centroid_bounds = aabb_empty();
+	for (uint32_t islot = range->begin; islot < range->end; ++islot) {
+		const uint32_t iprim = primitive[islot];
+		bounds = aabb_merge(bounds, builder->bounds[iprim]);
+		centroid_bounds = aabb_add_point(centroid_bounds, builder->centroid[iprim]);
+	}
+	range->bounds = bounds;
+	range->centroid_bounds = centroid_bounds;
+}
+
+static int
+bvh_range_longest_axis(const bvh_range_t* range) {
+	const vector_t size = aabb_size(range->centroid_bounds);
+	int axis = 0;
+	if (vector_y(size) > vector_component(size, axis))
+		axis = 1;
+	if (vector_z(size) > vector_component(size, axis))
+		axis = 2;
+	return axis;
+}
+
+//! Quickselect primitive slots so slot nth holds the primitive with nth smallest centroid along axis
+static void
+bvh_select(const bvh_builder_t* builder, uint32_t begin, uint32_t end, uint32_t nth, int axis) {
+	uint32_t* primitive = builder->bvh->primitive;
+	while (end - begin > 1) {
+		const real pivot = vector_component(builder->centroid[primitive[begin + (end - begin) / 2]], axis);
+		uint32_t left = begin;
+		uint32_t right = end - 1;
+		while (left <= right) {
+			while (vector_component(builder->centroid[primitive[left]], axis) < pivot)
+				++left;
+			while (vector_component(builder->centroid[primitive[right]], axis) > pivot)
+				--right;
+			if (left <= right) {
+				const uint32_t swap = primitive[left];
+				primitive[left++] = primitive[right];
+				primitive[right] = swap;
+				if (!right)
+					break;
+				--right;
+			}
+		}
+		if (nth <= right)
+			end = right + 1;
+		else if (nth >= left)
+			begin = left;
+		else
+			break;
+	}
+}
+
+//! Find split position with lowest surface area cost using binned centroids
+static uint32_t
+bvh_split_sah(const bvh_builder_t* builder, const bvh_range_t* range) {
+	uint32_t* primitive = builder->bvh->primitive;
+	real best_cost = REAL_MAX;
+	int best_axis = -1;
+	int best_bin = 0;
+
+	for (int axis = 0; axis < 3; ++axis) {
+		const real centroid_min = vector_component(range->centroid_bounds.min, axis);
+		const real extent = vector_component(range->centroid_bounds.max, axis) - centroid_min;
+		if (extent <= 0)
+			continue;
+		const real scale = (real)BVH_BIN_COUNT / extent;
+
+		aabb_t bin_bounds[BVH_BIN_COUNT];
+		uint32_t bin_count[BVH_BIN_COUNT];
+		for (int ibin = 0; ibin < BVH_BIN_COUNT; ++ibin) {
+			bin_bounds[ibin] = aabb_empty();
+			bin_count[ibin] = 0;
+		}
+		for (uint32_t islot = range->begin; islot < range->end; ++islot) {
+			const uint32_t iprim = primitive[islot];
+			int ibin = (int)((vector_component(builder->centroid[iprim], axis) - centroid_min) * scale);
+			ibin = (ibin < BVH_BIN_COUNT) ? ibin : (BVH_BIN_COUNT - 1);
+			bin_bounds[ibin] = aabb_merge(bin_bounds[ibin], builder->bounds[iprim]);
+			++bin_count[ibin];
+		}
+
+		// Sweep from right to store cost of right side for split after each bin
+		real right_cost[BVH_BIN_COUNT];
+		aabb_t accumulated = aabb_empty();
+		uint32_t accumulated_count = 0;
+		for (int ibin = BVH_BIN_COUNT - 1; ibin > 0; --ibin) {
+			accumulated = aabb_merge(accumulated, bin_bounds[ibin]);
+			accumulated_count += bin_count[ibin];
+			right_cost[ibin - 1] = accumulated_count ? aabb_surface_area(accumulated) * (real)accumulated_count : -1;
+		}
+
+		accumulated = aabb_empty();
+		accumulated_count = 0;
+		for (int ibin = 0; ibin < BVH_BIN_COUNT - 1; ++ibin) {
+			accumulated = aabb_merge(accumulated, bin_bounds[ibin]);
+			accumulated_count += bin_count[ibin];
+			if (!accumulated_count || (right_cost[ibin] < 0))
+				continue;
+			const real cost = aabb_surface_area(accumulated) * (real)accumulated_count + right_cost[ibin];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = ibin;
+			}
+		}
+	}
+
+	if (best_axis < 0) {
+		// All centroids coincide, any split is as good as the other
+		return range->begin + (range->end - range->begin) / 2;
+	}
+
+	const real centroid_min = vector_component(range->centroid_bounds.min, best_axis);
+	const real extent = vector_component(range->centroid_bounds.max, best_axis) - centroid_min;
+	const real scale = (real)BVH_BIN_COUNT / extent;
+	uint32_t left = range->begin;
+	uint32_t right = range->end;
+	while (left < right) {
+		int ibin = (int)((vector_component(builder->centroid[primitive[left]], best_axis) - centroid_min) * scale);
+		ibin = (ibin < BVH_BIN_COUNT) ? ibin : (BVH_BIN_COUNT - 1);
+		if (ibin <= best_bin) {
+			++left;
+		} else {
+			const uint32_t swap = primitive[left];
+			primitive[left] = primitive[--right];
+			primitive[right] = swap;
+		}
+	}
+	return left;
+}
+
+static void
+bvh_split(const bvh_builder_t* builder, const bvh_range_t* range, uint32_t depth, bvh_range_t* left,
+          bvh_range_t* right) {
+	uint32_t split;
+	if (depth < BVH_MAX_SAH_DEPTH) {
+		split = bvh_split_sah(builder, range);
+	} else {
+		split = range->begin + (range->end - range->begin) / 2;
+		bvh_select(builder, range->begin, range->end, split, bvh_range_longest_axis(range));
+	}
+	FOUNDATION_ASSERT((split > range->begin) && (split < range->end));
+
+	left->begin = range->begin;
+	left->end = split;
+	right->begin = split;
+	right->end = range->end;
+	bvh_range_compute_bounds(builder, left);
+	bvh_range_compute_bounds(builder, right);
+}
+
+//! Build a single node from the task range, storing tasks for interior children in the pending list.
+//! Only touches primitive slots in the task range and newly allocated nodes
+static void
+bvh_build_node(bvh_builder_t* builder, const bvh_task_t* task, bvh_task_t* pending, uint32_t* pending_count) {
+	bvh_range_t half[2];
+	bvh_range_t child[4];
+	uint32_t child_count = 0;
+
+	bvh_split(builder, &task->range, task->depth, &half[0], &half[1]);
+	for (int ihalf = 0; ihalf < 2; ++ihalf) {
+		if (half[ihalf].end - half[ihalf].begin > BVH_LEAF_SIZE) {
+			bvh_split(builder, &half[ihalf], task->depth, &child[child_count], &child[child_count + 1]);
+			child_count += 2;
+		} else {
+			child[child_count++] = half[ihalf];
+		}
+	}
+
+	bvh_node_t* node = builder->bvh->node + task->node;
+	bvh_node_clear(node);
+	for (uint32_t ichild = 0; ichild < child_count; ++ichild) {
+		const bvh_range_t* range = child + ichild;
+		const uint32_t count = range->end - range->begin;
+		bvh_node_set_bounds(node, (int)ichild, range->bounds);
+		if (count > BVH_LEAF_SIZE) {
+			const int32_t inode = atomic_incr32(&builder->node_count, memory_order_relaxed) - 1;
+			FOUNDATION_ASSERT((uint32_t)inode < builder->bvh->node_capacity);
+			FOUNDATION_ASSERT(*pending_count < BVH_TASK_CAPACITY);
+			node->child[ichild] = inode;
+			node->count[ichild] = 0;
+			bvh_task_t* subtask = pending + (*pending_count)++;
+			subtask->range = *range;
+			subtask->node = inode;
+			subtask->depth = task->depth + 1;
+		} else {
+			node->child[ichild] = (int32_t)range->begin;
+			node->count[ichild] = count;
+		}
+	}
+}
+
+static void
+bvh_build_subtree_range(void* context, size_t begin, size_t end) {
+	bvh_builder_t* builder = context;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	bvh_task_t* pending = vector_arena_allocate(arena, sizeof(bvh_task_t) * BVH_TASK_CAPACITY, 0);
+	for (size_t isubtree = begin; isubtree < end; ++isubtree) {
+		uint32_t pending_count = 0;
+		pending[pending_count++] = builder->subtree[isubtree];
+		while (pending_count) {
+			bvh_task_t task = pending[--pending_count];
+			bvh_build_node(builder, &task, pending, &pending_count);
+		}
+	}
+	vector_arena_rewind(arena, mark);
+}
+
+static void
+bvh_build(bvh_t* bvh, const aabb_t* bounds, size_t count) {
+	FOUNDATION_ASSERT(count < 0x7FFFFFFF);
+	const uint32_t primitive_count = (uint32_t)count;
+	// Each interior node has at least two children, so node count is bounded by leaf count
+	const uint32_t node_capacity = (primitive_count > 1) ? primitive_count : 1;
+
+	if (bvh->node_capacity < node_capacity) {
+		memory_deallocate(bvh->node);
+		bvh->node = memory_allocate(HASH_VECTOR, sizeof(bvh_node_t) * node_capacity, 16, MEMORY_PERSISTENT);
+		bvh->node_capacity = node_capacity;
+	}
+	if (bvh->primitive_capacity < primitive_count) {
+		memory_deallocate(bvh->primitive);
+		memory_deallocate(bvh->bounds);
+		bvh->primitive = memory_allocate(HASH_VECTOR, sizeof(uint32_t) * primitive_count, 0, MEMORY_PERSISTENT);
+		bvh->bounds = memory_allocate(HASH_VECTOR, sizeof(aabb_t) * primitive_count, 16, MEMORY_PERSISTENT);
+		bvh->primitive_capacity = primitive_count;
+	}
+	bvh->primitive_count = primitive_count;
+	bvh->node_count = 0;
+	if (!primitive_count)
+		return;
+
+	bvh_builder_t builder;
+	builder.bvh = bvh;
+	builder.bounds = bounds;
+	builder.centroid = memory_allocate(HASH_VECTOR, sizeof(vector_t) * primitive_count, 16, MEMORY_TEMPORARY);
+	atomic_store32(&builder.node_count, 1, memory_order_relaxed);
+	for (uint32_t iprim = 0; iprim < primitive_count; ++iprim) {
+		bvh->primitive[iprim] = iprim;
+		builder.centroid[iprim] = aabb_center(bounds[iprim]);
+	}
+
+	bvh_task_t* pending = memory_allocate(HASH_VECTOR, sizeof(bvh_task_t) * BVH_TASK_CAPACITY, 16, MEMORY_TEMPORARY);
+	uint32_t pending_count = 0;
+
+	bvh_task_t* root = pending + pending_count++;
+	root->range.begin = 0;
+	root->range.end = primitive_count;
+	root->node = 0;
+	root->depth = 0;
+	bvh_range_compute_bounds(&builder, &root->range);
+
+	if (primitive_count <= BVH_LEAF_SIZE) {
+		bvh_node_clear(bvh->node);
+		bvh_node_set_bounds(bvh->node, 0, root->range.bounds);
+		bvh->node->child[0] = 0;
+		bvh->node->count[0] = primitive_count;
+		pending_count = 0;
+	}
+
+	// Split the largest range until there are enough subtrees to build in parallel. Each split
+	// replaces one task with at most four, staying within the task capacity
+	FOUNDATION_STATIC_ASSERT(BVH_PARALLEL_TASKS + 3 <= BVH_TASK_CAPACITY, "bvh task capacity");
+	while (pending_count && (pending_count < BVH_PARALLEL_TASKS)) {
+		uint32_t largest = 0;
+		for (uint32_t itask = 1; itask < pending_count; ++itask) {
+			if (pending[itask].range.end - pending[itask].range.begin >
+			    pending[largest].range.end - pending[largest].range.begin)
+				largest = itask;
+		}
+		if (pending[largest].range.end - pending[largest].range.begin < BVH_PARALLEL_MIN_PRIMITIVES)
+			break;
+		bvh_task_t task = pending[largest];
+		pending[largest] = pending[--pending_count];
+		bvh_build_node(&builder, &task, pending, &pending_count);
+	}
+
+	builder.subtree = pending;
+	vector_parallel_for(STRING_CONST("bvh_build"), bvh_build_subtree_range, &builder, pending_count, 1);
+
+	bvh->node_count = (uint32_t)atomic_load32(&builder.node_count, memory_order_acquire);
+	for (uint32_t islot = 0; islot < primitive_count; ++islot)
+		bvh->bounds[islot] = bounds[bvh->primitive[islot]];
+
+	memory_deallocate(pending);
+	memory_deallocate(builder.centroid);
+}
+
+static FOUNDATION_FORCEINLINE aabb_t
+bvh_triangle_bounds(const vector_t* vertex, const uint32_t* index, uint32_t triangle) {
+	const uint32_t* corner = index + (triangle * 3);
+	return aabb_from_triangle(vertex[corner[0]], vertex[corner[1]], vertex[corner[2]]);
+}
+
+void
+bvh_build_aabb(bvh_t* bvh, const aabb_t* bounds, size_t count) {
+	bvh->type = BVH_PRIMITIVE_AABB;
+	bvh->vertex = 0;
+	bvh->index = 0;
+	bvh_build(bvh, bounds, count);
+}
+
+void
+bvh_build_triangles(bvh_t* bvh, const vector_t* vertex, const uint32_t* index, size_t triangle_count) {
+	aabb_t* bounds = memory_allocate(HASH_VECTOR, sizeof(aabb_t) * (triangle_count ? triangle_count : 1), 16,
+	                                 MEMORY_TEMPORARY);
+	for (uint32_t itri = 0; itri < (uint32_t)triangle_count; ++itri)
+		bounds[itri] = bvh_triangle_bounds(vertex, index, itri);
+
+	bvh->type = BVH_PRIMITIVE_TRIANGLE;
+	bvh->vertex = vertex;
+	bvh->index = index;
+	bvh_build(bvh, bounds, triangle_count);
+
+	memory_deallocate(bounds);
+}
+
+//! Recompute node bounds bottom-up from primitive bounds in slot order. Children always have
+//! higher node index than their parent, so a reverse pass sees children before parents
+static void
+bvh_refit(bvh_t* bvh) {
+	for (uint32_t inode = bvh->node_count; inode > 0; --inode) {
+		bvh_node_t* node = bvh->node + (inode - 1);
+		for (int lane = 0; lane < 4; ++lane) {
+			const int32_t child = node->child[lane];
+			if (child < 0)
+				continue;
+			aabb_t bounds;
+			if (node->count[lane]) {
+				bounds = aabb_empty();
+				for (uint32_t islot = 0, count = node->count[lane]; islot < count; ++islot)
+					bounds = aabb_merge(bounds, bvh->bounds[(uint32_t)child + islot]);
+			} else {
+				bounds = bvh_node_bounds(bvh->node + child);
+			}
+			bvh_node_set_bounds(node, lane, bounds);
+		}
+	}
+}
+
+void
+bvh_refit_aabb(bvh_t* bvh, const aabb_t* bounds) {
+	FOUNDATION_ASSERT(bvh->type == BVH_PRIMITIVE_AABB);
+	for (uint32_t islot = 0; islot < bvh->primitive_count; ++islot)
+		bvh->bounds[islot] = bounds[bvh->primitive[islot]];
+	bvh_refit(bvh);
+}
+
+void
+bvh_refit_triangles(bvh_t* bvh, const vector_t* vertex) {
+	FOUNDATION_ASSERT(bvh->type == BVH_PRIMITIVE_TRIANGLE);
+	bvh->vertex = vertex;
+	for (uint32_t islot = 0; islot < bvh->primitive_count; ++islot)
+		bvh->bounds[islot] = bvh_triangle_bounds(vertex, bvh->index, bvh->primitive[islot]);
+	bvh_refit(bvh);
+}
+
+aabb_t
+bvh_bounds(const bvh_t* bvh) {
+	if (!bvh->node_count)
+		return aabb_empty();
+	return bvh_node_bounds(bvh->node);
+}
+
+static bvh_ray_t
+bvh_ray(const ray_t r) {
+	bvh_ray_t sray;
+	const vector_t inv = ray_inverse_direction(r);
+	sray.origin_x = vector_shuffle(r.origin, VECTOR_MASK_XXXX);
+	sray.origin_y = vector_shuffle(r.origin, VECTOR_MASK_YYYY);
+	sray.origin_z = vector_shuffle(r.origin, VECTOR_MASK_ZZZZ);
+	sray.inv_x = vector_shuffle(inv, VECTOR_MASK_XXXX);
+	sray.inv_y = vector_shuffle(inv, VECTOR_MASK_YYYY);
+	sray.inv_z = vector_shuffle(inv, VECTOR_MASK_ZZZZ);
+	sray.negative[0] = vector_x(inv) < 0;
+	sray.negative[1] = vector_y(inv) < 0;
+	sray.negative[2] = vector_z(inv) < 0;
+	return sray;
+}
+
+//! Slab test of ray against all four children of a node, selecting near and far planes by
+//! ray direction sign so unused lanes with inverted bounds never report a hit
+static FOUNDATION_FORCEINLINE vectori_t
+bvh_node_intersect_ray(const bvh_node_t* node, const bvh_ray_t* sray, const vector_t tmax, vector_t* tnear) {
+	const vector_t near_x = sray->negative[0] ? node->max_x : node->min_x;
+	const vector_t far_x = sray->negative[0] ? node->min_x : node->max_x;
+	const vector_t near_y = sray->negative[1] ? node->max_y : node->min_y;
+	const vector_t far_y = sray->negative[1] ? node->min_y : node->max_y;
+	const vector_t near_z = sray->negative[2] ? node->max_z : node->min_z;
+	const vector_t far_z = sray->negative[2] ? node->min_z : node->max_z;
+
+	const vector_t tnear_x = vector_mul(vector_sub(near_x, sray->origin_x), sray->inv_x);
+	const vector_t tnear_y = vector_mul(vector_sub(near_y, sray->origin_y), sray->inv_y);
+	const vector_t tnear_z = vector_mul(vector_sub(near_z, sray->origin_z), sray->inv_z);
+	const vector_t tfar_x = vector_mul(vector_sub(far_x, sray->origin_x), sray->inv_x);
+	const vector_t tfar_y = vector_mul(vector_sub(far_y, sray->origin_y), sray->inv_y);
+	const vector_t tfar_z = vector_mul(vector_sub(far_z, sray->origin_z), sray->inv_z);
+
+	const vector_t enter = vector_max(vector_max(tnear_x, tnear_y), vector_max(tnear_z, vector_zero()));
+	const vector_t leave = vector_min(vector_min(tfar_x, tfar_y), vector_min(tfar_z, tmax));
+	*tnear = enter;
+	return vector_lequal(enter, leave);
+}
+
+static FOUNDATION_FORCEINLINE bool
+bvh_primitive_intersect_ray(const bvh_t* bvh, uint32_t slot, const ray_t r, const vector_t inv_direction,
+                            real tmax, bvh_hit_t* hit) {
+	if (bvh->type == BVH_PRIMITIVE_TRIANGLE) {
+		const uint32_t* corner = bvh->index + (bvh->primitive[slot] * 3);
+		return ray_intersect_triangle(r, bvh->vertex[corner[0]], bvh->vertex[corner[1]], bvh->vertex[corner[2]],
+		                              tmax, &hit->distance, &hit->u, &hit->v);
+	}
+	hit->u = hit->v = 0;
+	return ray_intersect_aabb(r, inv_direction, bvh->bounds[slot], tmax, &hit->distance);
+}
+
+bool
+bvh_query_ray(const bvh_t* bvh, const ray_t r, real tmax, bvh_hit_t* hit) {
+	if (!bvh->node_count)
+		return false;
+
+	const bvh_ray_t sray = bvh_ray(r);
+	const vector_t inv_direction = ray_inverse_direction(r);
+	int32_t stack[BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+	bool found = false;
+	real closest = tmax;
+
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const bvh_node_t* node = bvh->node + stack[--stack_size];
+		vector_t tnear;
+		const vectori_t mask = bvh_node_intersect_ray(node, &sray, vector_uniform(closest), &tnear);
+		const int32_t lane_hit[4] = {vectori_x(mask), vectori_y(mask), vectori_z(mask), vectori_w(mask)};
+
+		int32_t near_child[4];
+		real near_distance[4];
+		uint32_t near_count = 0;
+		for (int lane = 0; lane < 4; ++lane) {
+			const int32_t child = node->child[lane];
+			if (!lane_hit[lane] || (child < 0))
+				continue;
+			if (node->count[lane]) {
+				for (uint32_t islot = (uint32_t)child, send = islot + node->count[lane]; islot < send; ++islot) {
+					bvh_hit_t candidate;
+					if (bvh_primitive_intersect_ray(bvh, islot, r, inv_direction, closest, &candidate)) {
+						candidate.primitive = bvh->primitive[islot];
+						closest = candidate.distance;
+						*hit = candidate;
+						found = true;
+					}
+				}
+			} else {
+				// Insertion sort on descending distance so nearest child is popped first
+				const real distance = vector_component(tnear, lane);
+				uint32_t insert = near_count++;
+				while (insert && (near_distance[insert - 1] < distance)) {
+					near_distance[insert] = near_distance[insert - 1];
+					near_child[insert] = near_child[insert - 1];
+					--insert;
+				}
+				near_distance[insert] = distance;
+				near_child[insert] = child;
+			}
+		}
+
+		FOUNDATION_ASSERT(stack_size + near_count <= BVH_STACK_SIZE);
+		for (uint32_t ichild = 0; ichild < near_count; ++ichild) {
+			if (near_distance[ichild] <= closest)
+				stack[stack_size++] = near_child[ichild];
+		}
+	}
+
+	return found;
+}
+
+bool
+bvh_query_ray_any(const bvh_t* bvh, const ray_t r, real tmax) {
+	if (!bvh->node_count)
+		return false;
+
+	const bvh_ray_t sray = bvh_ray(r);
+	const vector_t inv_direction = ray_inverse_direction(r);
+	const vector_t vtmax = vector_uniform(tmax);
+	int32_t stack[BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const bvh_node_t* node = bvh->node + stack[--stack_size];
+		vector_t tnear;
+		const vectori_t mask = bvh_node_intersect_ray(node, &sray, vtmax, &tnear);
+		const int32_t lane_hit[4] = {vectori_x(mask), vectori_y(mask), vectori_z(mask), vectori_w(mask)};
+		for (int lane = 0; lane < 4; ++lane) {
+			const int32_t child = node->child[lane];
+			if (!lane_hit[lane] || (child < 0))
+				continue;
+			if (node->count[lane]) {
+				for (uint32_t islot = (uint32_t)child, send = islot + node->count[lane]; islot < send; ++islot) {
+					bvh_hit_t candidate;
+					if (bvh_primitive_intersect_ray(bvh, islot, r, inv_direction, tmax, &candidate))
+						return true;
+				}
+			} else {
+				FOUNDATION_ASSERT(stack_size < BVH_STACK_SIZE);
+				stack[stack_size++] = child;
+			}
+		}
+	}
+
+	return false;
+}
+
+size_t
+bvh_query_aabb(const bvh_t* bvh, const aabb_t box, uint32_t* primitive, size_t capacity) {
+	if (!bvh->node_count)
+		return 0;
+
+	const vector_t box_min_x = vector_shuffle(box.min, VECTOR_MASK_XXXX);
+	const vector_t box_min_y = vector_shuffle(box.min, VECTOR_MASK_YYYY);
+	const vector_t box_min_z = vector_shuffle(box.min, VECTOR_MASK_ZZZZ);
+	const vector_t box_max_x = vector_shuffle(box.max, VECTOR_MASK_XXXX);
+	const vector_t box_max_y = vector_shuffle(box.max, VECTOR_MASK_YYYY);
+	const vector_t box_max_z = vector_shuffle(box.max, VECTOR_MASK_ZZZZ);
+	int32_t stack[BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+	size_t count = 0;
+
+	stack[stack_size++] = 0;
+	while (stack_size) {
+		const bvh_node_t* node = bvh->node + stack[--stack_size];
+		const vectori_t overlap_x =
+		    vectori_and(vector_lequal(node->min_x, box_max_x), vector_gequal(node->max_x, box_min_x));
+		const vectori_t overlap_y =
+		    vectori_and(vector_lequal(node->min_y, box_max_y), vector_gequal(node->max_y, box_min_y));
+		const vectori_t overlap_z =
+		    vectori_and(vector_lequal(node->min_z, box_max_z), vector_gequal(node->max_z, box_min_z));
+		const vectori_t mask = vectori_and(vectori_and(overlap_x, overlap_y), overlap_z);
+		const int32_t lane_hit[4] = {vectori_x(mask), vectori_y(mask), vectori_z(mask), vectori_w(mask)};
+		for (int lane = 0; lane < 4; ++lane) {
+			const int32_t child = node->child[lane];
+			if (!lane_hit[lane] || (child < 0))
+				continue;
+			if (node->count[lane]) {
+				for (uint32_t islot = (uint32_t)child, send = islot + node->count[lane]; islot < send; ++islot) {
+					if (aabb_overlap(bvh->bounds[islot], box)) {
+						if (count < capacity)
+							primitive[count] = bvh->primitive[islot];
+						++count;
+					}
+				}
+			} else {
+				FOUNDATION_ASSERT(stack_size < BVH_STACK_SIZE);
+				stack[stack_size++] = child;
+			}
+		}
+	}
+
+	return count;
+}
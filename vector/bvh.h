@@ -0,0 +1,107 @@
+/* bvh.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file bvh.h
+    Bounding volume hierarchy with four-wide nodes, built with a binned surface area heuristic.
+    Each build task splits a primitive range into up to four child ranges, and child subtrees
+    only touch their own primitive range and nodes, so subtrees can be built independently.
+    The top levels are split serially and the resulting subtrees are built in parallel jobs.
+    Node slots are allocated through an atomic counter and always have a higher index than
+    their parent, which lets refit walk the node array backwards in a single pass. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+#include <vector/ray.h>
+
+//! Maximum number of primitives in a leaf
+#define BVH_LEAF_SIZE 4
+
+VECTOR_API bvh_t*
+bvh_allocate(void);
+
+VECTOR_API void
+bvh_initialize(bvh_t* bvh);
+
+VECTOR_API void
+bvh_finalize(bvh_t* bvh);
+
+VECTOR_API void
+bvh_deallocate(bvh_t* bvh);
+
+//! Build hierarchy over boxes. The bounds are copied, primitive indices reported by
+//! queries are indices into the given array
+//! \param bvh Hierarchy
+//! \param bounds Primitive bounds
+//! \param count Number of primitives
+VECTOR_API void
+bvh_build_aabb(bvh_t* bvh, const aabb_t* bounds, size_t count);
+
+//! Build hierarchy over indexed triangles. Vertex and index data is referenced, not copied,
+//! and must remain valid for the lifetime of the hierarchy or until next refit. Primitive
+//! indices reported by queries are triangle indices
+//! \param bvh Hierarchy
+//! \param vertex Vertex positions (w component ignored)
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_count Number of triangles
+VECTOR_API void
+bvh_build_triangles(bvh_t* bvh, const vector_t* vertex, const uint32_t* index, size_t triangle_count);
+
+//! Update node bounds for new primitive bounds without rebuilding the tree structure
+//! \param bvh Hierarchy built with bvh_build_aabb
+//! \param bounds New primitive bounds, same count and order as given at build time
+VECTOR_API void
+bvh_refit_aabb(bvh_t* bvh, const aabb_t* bounds);
+
+//! Update node bounds for new vertex positions without rebuilding the tree structure,
+//! typically after vertex animation. Triangle indices must be unchanged
+//! \param bvh Hierarchy built with bvh_build_triangles
+//! \param vertex New vertex positions
+VECTOR_API void
+bvh_refit_triangles(bvh_t* bvh, const vector_t* vertex);
+
+//! Find closest primitive hit by ray in range [0, tmax]
+//! \param bvh Hierarchy
+//! \param r Ray
+//! \param tmax Max distance
+//! \param hit Hit output
+//! \return true if a primitive was hit, false if not
+VECTOR_API bool
+bvh_query_ray(const bvh_t* bvh, const ray_t r, real tmax, bvh_hit_t* hit);
+
+//! Test if ray hits any primitive in range [0, tmax], terminating on first hit
+//! \param bvh Hierarchy
+//! \param r Ray
+//! \param tmax Max distance
+//! \return true if a primitive was hit, false if not
+VECTOR_API bool
+bvh_query_ray_any(const bvh_t* bvh, const ray_t r, real tmax);
+
+//! Collect primitives whose bounds overlap the given box
+//! \param bvh Hierarchy
+//! \param box Query box
+//! \param primitive Primitive index output buffer
+//! \param capacity Capacity of output buffer
+//! \return Total number of overlapping primitives, can be larger than capacity
+VECTOR_API size_t
+bvh_query_aabb(const bvh_t* bvh, const aabb_t box, uint32_t* primitive, size_t capacity);
+
+//! Bounds of entire hierarchy
+VECTOR_API aabb_t
+bvh_bounds(const bvh_t* bvh);
@@ -0,0 +1,335 @@
+/* constant.hpp  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file constant.hpp
+    Compile time construction of vectors, matrices and quaternions with C++14 constexpr functions
+    in namespace vectorlib::constant. Results are 16 byte aligned arrays which can be declared as
+    static constexpr data and loaded with a single aligned load per row, like
+
+        static constexpr ConstMat4 rig = constant::matrix_mul(constant::matrix_from_quaternion(
+            constant::euler_angles_to_quaternion(0, REAL_HALFPI, 0, EULER_XYZs)),
+            constant::matrix_translation(0, 2, 10));
+        matrix_t m = rig.load();
+
+    Matrices use the same row major layout and row vector convention as matrix.h. Intermediate
+    values are computed in double precision and rounded once when stored, so results can differ
+    from the runtime functions in the last bits. Trigonometric functions are polynomial
+    approximations accurate to double precision for arguments of moderate magnitude. */
+
+#include <vector/vector.hpp>
+
+#ifdef __cplusplus
+
+namespace vectorlib {
+
+struct alignas(16) ConstVec4 {
+	float32_t v[4];
+
+	FOUNDATION_FORCEINLINE vector_t
+	load() const {
+		return vector_aligned(v);
+	}
+};
+
+struct alignas(16) ConstQuat {
+	float32_t q[4];
+
+	FOUNDATION_FORCEINLINE quaternion_t
+	load() const {
+		return quaternion_aligned(q);
+	}
+};
+
+struct alignas(16) ConstMat4 {
+	float32_t m[16];
+
+	FOUNDATION_FORCEINLINE matrix_t
+	load() const {
+		return matrix_aligned(m);
+	}
+};
+
+namespace constant {
+
+constexpr float64_t
+scalar_abs(float64_t x) {
+	return (x < 0) ? -x : x;
+}
+
+//! Newton iteration until the estimate stops changing, argument must be non-negative
+constexpr float64_t
+scalar_sqrt(float64_t x) {
+	if (x <= 0)
+		return 0;
+	float64_t est = (x > 1) ? x : 1;
+	for (int iter = 0; iter < 128; ++iter) {
+		const float64_t next = 0.5 * (est + x / est);
+		if (next >= est)
+			break;
+		est = next;
+	}
+	return est;
+}
+
+//! Sine by Taylor series after reduction to [-pi/2, pi/2]
+constexpr float64_t
+scalar_sin(float64_t x) {
+	const float64_t periods = x * 0.15915494309189533577;
+	const float64_t k = (float64_t)(int64_t)((periods >= 0) ? periods + 0.5 : periods - 0.5);
+	float64_t r = x - k * 6.28318530717958647693;
+	if (r > 1.57079632679489661923)
+		r = 3.14159265358979323846 - r;
+	else if (r < -1.57079632679489661923)
+		r = -3.14159265358979323846 - r;
+	const float64_t r2 = r * r;
+	float64_t term = r;
+	float64_t sum = r;
+	for (int n = 2; n < 24; n += 2) {
+		term = -term * r2 / (float64_t)(n * (n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+constexpr float64_t
+scalar_cos(float64_t x) {
+	return scalar_sin(x + 1.57079632679489661923);
+}
+
+constexpr ConstVec4
+vector(real x, real y, real z, real w) {
+	return ConstVec4{{(float32_t)x, (float32_t)y, (float32_t)z, (float32_t)w}};
+}
+
+constexpr ConstQuat
+quaternion(real x, real y, real z, real w) {
+	return ConstQuat{{(float32_t)x, (float32_t)y, (float32_t)z, (float32_t)w}};
+}
+
+constexpr ConstQuat
+quaternion_identity() {
+	return quaternion(0, 0, 0, 1);
+}
+
+constexpr ConstQuat
+quaternion_normalize(const ConstQuat q) {
+	const float64_t x = q.q[0];
+	const float64_t y = q.q[1];
+	const float64_t z = q.q[2];
+	const float64_t w = q.q[3];
+	const float64_t len = scalar_sqrt(x * x + y * y + z * z + w * w);
+	if (len <= 0)
+		return q;
+	return ConstQuat{{(float32_t)(x / len), (float32_t)(y / len), (float32_t)(z / len), (float32_t)(w / len)}};
+}
+
+//! Hamilton product q0 * q1, same as quaternion_mul
+constexpr ConstQuat
+quaternion_mul(const ConstQuat q0, const ConstQuat q1) {
+	const float64_t x0 = q0.q[0], y0 = q0.q[1], z0 = q0.q[2], w0 = q0.q[3];
+	const float64_t x1 = q1.q[0], y1 = q1.q[1], z1 = q1.q[2], w1 = q1.q[3];
+	return ConstQuat{{(float32_t)(w0 * x1 + x0 * w1 + y0 * z1 - z0 * y1),
+	                  (float32_t)(w0 * y1 + y0 * w1 + z0 * x1 - x0 * z1),
+	                  (float32_t)(w0 * z1 + z0 * w1 + x0 * y1 - y0 * x1),
+	                  (float32_t)(w0 * w1 - x0 * x1 - y0 * y1 - z0 * z1)}};
+}
+
+//! Same as euler_angles_to_quaternion(euler_angles(rx, ry, rz, order))
+constexpr ConstQuat
+euler_angles_to_quaternion(real rx, real ry, real rz, euler_angles_order_t order) {
+	// Same algorithm as euler.c, see the reference there
+	const unsigned int safe[] = {0, 1, 2, 0};
+	const unsigned int next[] = {1, 2, 0, 1};
+	unsigned int bits = (unsigned int)order;
+	const unsigned int f = bits & 0x1;
+	bits >>= 1;
+	const unsigned int s = bits & 0x1;
+	bits >>= 1;
+	const unsigned int n = bits & 0x1;
+	bits >>= 1;
+	const unsigned int i = safe[bits & 0x3];
+	const unsigned int j = next[(i + n) & 0x3];
+	const unsigned int k = next[(i + 1 - n) & 0x3];
+
+	float64_t angle[3] = {rx, ry, rz};
+	if (f == VECTOR_EULER_ROTATEFRAME) {
+		const float64_t t = angle[0];
+		angle[0] = angle[2];
+		angle[2] = t;
+	}
+	if (n == VECTOR_EULER_ODD)
+		angle[1] = -angle[1];
+
+	const float64_t ci = scalar_cos(angle[0] * 0.5);
+	const float64_t cj = scalar_cos(angle[1] * 0.5);
+	const float64_t ch = scalar_cos(angle[2] * 0.5);
+	const float64_t si = scalar_sin(angle[0] * 0.5);
+	const float64_t sj = scalar_sin(angle[1] * 0.5);
+	const float64_t sh = scalar_sin(angle[2] * 0.5);
+	const float64_t cc = ci * ch;
+	const float64_t cs = ci * sh;
+	const float64_t sc = si * ch;
+	const float64_t ss = si * sh;
+
+	float64_t q[4] = {0, 0, 0, 0};
+	if (s == VECTOR_EULER_REPEAT) {
+		q[i] = cj * (cs + sc);
+		q[j] = sj * (cc + ss);
+		q[k] = sj * (cs - sc);
+		q[3] = cj * (cc - ss);
+	} else {
+		q[i] = cj * sc - sj * cs;
+		q[j] = cj * ss + sj * cc;
+		q[k] = cj * cs - sj * sc;
+		q[3] = cj * cc + sj * ss;
+	}
+	if (n == VECTOR_EULER_ODD)
+		q[j] = -q[j];
+
+	const float64_t len = scalar_sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+	return ConstQuat{{(float32_t)(q[0] / len), (float32_t)(q[1] / len), (float32_t)(q[2] / len),
+	                  (float32_t)(q[3] / len)}};
+}
+
+constexpr ConstMat4
+matrix_zero() {
+	return ConstMat4{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+}
+
+constexpr ConstMat4
+matrix_identity() {
+	return ConstMat4{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1}};
+}
+
+constexpr ConstMat4
+matrix_scaling(real x, real y, real z) {
+	return ConstMat4{{(float32_t)x, 0, 0, 0, 0, (float32_t)y, 0, 0, 0, 0, (float32_t)z, 0, 0, 0, 0, 1}};
+}
+
+constexpr ConstMat4
+matrix_translation(real x, real y, real z) {
+	return ConstMat4{{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, (float32_t)x, (float32_t)y, (float32_t)z, 1}};
+}
+
+//! Rotation matrix of unit quaternion, same as matrix_from_quaternion
+constexpr ConstMat4
+matrix_from_quaternion(const ConstQuat q) {
+	const float64_t x = q.q[0];
+	const float64_t y = q.q[1];
+	const float64_t z = q.q[2];
+	const float64_t w = q.q[3];
+	const float64_t tx = 2.0 * x;
+	const float64_t ty = 2.0 * y;
+	const float64_t tz = 2.0 * z;
+	const float64_t tsx = tx * w;
+	const float64_t tsy = ty * w;
+	const float64_t tsz = tz * w;
+	const float64_t txx = tx * x;
+	const float64_t txy = ty * x;
+	const float64_t txz = tz * x;
+	const float64_t tyy = ty * y;
+	const float64_t tyz = tz * y;
+	const float64_t tzz = tz * z;
+	return ConstMat4{{(float32_t)(1.0 - (tyy + tzz)), (float32_t)(txy + tsz), (float32_t)(txz - tsy), 0,
+	                  (float32_t)(txy - tsz), (float32_t)(1.0 - (txx + tzz)), (float32_t)(tyz + tsx), 0,
+	                  (float32_t)(txz + tsy), (float32_t)(tyz - tsx), (float32_t)(1.0 - (txx + tyy)), 0,
+	                  0, 0, 0, 1}};
+}
+
+constexpr ConstMat4
+matrix_transpose(const ConstMat4 m) {
+	ConstMat4 r = matrix_zero();
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col)
+			r.m[row * 4 + col] = m.m[col * 4 + row];
+	}
+	return r;
+}
+
+//! Product m0 * m1, the transform of m0 followed by the transform of m1
+constexpr ConstMat4
+matrix_mul(const ConstMat4 m0, const ConstMat4 m1) {
+	ConstMat4 r = matrix_zero();
+	for (int row = 0; row < 4; ++row) {
+		for (int col = 0; col < 4; ++col) {
+			float64_t sum = 0;
+			for (int elem = 0; elem < 4; ++elem)
+				sum += (float64_t)m0.m[row * 4 + elem] * (float64_t)m1.m[elem * 4 + col];
+			r.m[row * 4 + col] = (float32_t)sum;
+		}
+	}
+	return r;
+}
+
+//! Depth of near and far plane in normalized device coordinates, same as projection_depth_range
+constexpr void
+projection_depth_range(unsigned int flags, float64_t& near_depth, float64_t& far_depth) {
+	const float64_t min_depth = (flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1;
+	near_depth = (flags & PROJECTION_REVERSED_Z) ? 1 : min_depth;
+	far_depth = (flags & PROJECTION_REVERSED_Z) ? min_depth : 1;
+}
+
+//! Same as matrix_perspective
+constexpr ConstMat4
+matrix_perspective(real fov_y, real aspect, real znear, real zfar, unsigned int flags) {
+	const float64_t half = (float64_t)fov_y * 0.5;
+	const float64_t ys = scalar_cos(half) / scalar_sin(half);
+	const float64_t xs = ys / (float64_t)aspect;
+	const float64_t n = znear;
+	const float64_t f = zfar;
+	float64_t near_depth = 0, far_depth = 0;
+	projection_depth_range(flags, near_depth, far_depth);
+	float64_t scale = -far_depth;
+	float64_t offset = (near_depth - far_depth) * n;
+	if (!(flags & PROJECTION_INFINITE_FAR)) {
+		scale = (near_depth * n - far_depth * f) / (f - n);
+		offset = (near_depth - far_depth) * n * f / (f - n);
+	}
+	ConstMat4 r = matrix_zero();
+	r.m[0] = (float32_t)xs;
+	r.m[5] = (float32_t)ys;
+	r.m[10] = (float32_t)scale;
+	r.m[11] = -1;
+	r.m[14] = (float32_t)offset;
+	return r;
+}
+
+//! Same as matrix_orthographic
+constexpr ConstMat4
+matrix_orthographic(real left, real right, real bottom, real top, real znear, real zfar, unsigned int flags) {
+	const float64_t width = (float64_t)right - (float64_t)left;
+	const float64_t height = (float64_t)top - (float64_t)bottom;
+	const float64_t range = (float64_t)zfar - (float64_t)znear;
+	float64_t near_depth = 0, far_depth = 0;
+	projection_depth_range(flags, near_depth, far_depth);
+	ConstMat4 r = matrix_identity();
+	r.m[0] = (float32_t)(2.0 / width);
+	r.m[5] = (float32_t)(2.0 / height);
+	r.m[10] = (float32_t)((near_depth - far_depth) / range);
+	r.m[12] = (float32_t)(-((float64_t)right + (float64_t)left) / width);
+	r.m[13] = (float32_t)(-((float64_t)top + (float64_t)bottom) / height);
+	r.m[14] = (float32_t)((near_depth * (float64_t)zfar - far_depth * (float64_t)znear) / range);
+	return r;
+}
+
+}  // namespace constant
+
+}  // namespace vectorlib
+
+#endif
@@ -0,0 +1,694 @@
+/* convex.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/convex.h>
+#include <vector/internal.h>
+
+//! Max number of GJK iterations, polyhedra normally converge in less than twenty
+#define CONVEX_GJK_MAX_ITERATIONS 64
+//! GJK stops when the squared distance improves by less than this fraction
+#define CONVEX_GJK_TOLERANCE REAL_C(1e-6)
+//! Cores closer than this fraction of the Minkowski difference size are overlapping
+#define CONVEX_OVERLAP_TOLERANCE REAL_C(1e-5)
+//! EPA stops when the closest face is within this fraction of the Minkowski difference size
+//! from the boundary
+#define CONVEX_EPA_TOLERANCE REAL_C(1e-4)
+#define CONVEX_EPA_MAX_ITERATIONS 64
+#define CONVEX_EPA_MAX_VERTICES 64
+//! Each added vertex adds two faces, leaving room for the initial tetrahedron
+#define CONVEX_EPA_MAX_FACES (CONVEX_EPA_MAX_VERTICES * 2)
+
+typedef struct convex_pair_t convex_pair_t;
+typedef struct convex_simplex_t convex_simplex_t;
+typedef struct convex_feature_t convex_feature_t;
+typedef struct convex_face_t convex_face_t;
+typedef struct convex_edge_t convex_edge_t;
+
+//! Shapes of a query with the world to local rotations cached
+VECTOR_ALIGNED_STRUCT(convex_pair_t) {
+	matrix_t inverse[2];
+	const convex_t* shape[2];
+	//! Largest squared length of Minkowski difference support points seen
+	real scale_sqr;
+};
+
+//! Vertices of the Minkowski difference, w = a - b, with the support points a and b on the cores
+VECTOR_ALIGNED_STRUCT(convex_simplex_t) {
+	vector_t w[4];
+	vector_t a[4];
+	vector_t b[4];
+	//! Barycentric coordinates of the point closest to the origin
+	real lambda[4];
+	int count;
+};
+
+//! Sub-simplex of up to three vertices with barycentric coordinates
+struct convex_feature_t {
+	int count;
+	int index[3];
+	real lambda[3];
+};
+
+//! Polytope face with outward unit normal and distance from origin
+VECTOR_ALIGNED_STRUCT(convex_face_t) {
+	vector_t normal;
+	real distance;
+	int index[3];
+};
+
+struct convex_edge_t {
+	int index[2];
+};
+
+static FOUNDATION_FORCEINLINE real
+convex_dot(const vector_t v0, const vector_t v1) {
+	return vector_x(vector_dot3(v0, v1));
+}
+
+size_t
+convex_support_index(const vector_t* point, size_t count, const vector_t direction) {
+	const vector_t dx = vector_shuffle(direction, VECTOR_MASK_XXXX);
+	const vector_t dy = vector_shuffle(direction, VECTOR_MASK_YYYY);
+	const vector_t dz = vector_shuffle(direction, VECTOR_MASK_ZZZZ);
+	const vectori_t step = vectori_uniform(4);
+	vector_t best = vector_uniform(-REAL_MAX);
+	vectori_t best_index = vectori_zero();
+	vectori_t index = vectori(0, 1, 2, 3);
+	size_t ipt = 0;
+	for (; ipt + 4 <= count; ipt += 4) {
+		vector_t comp[4];
+		vector_transpose4(point[ipt], point[ipt + 1], point[ipt + 2], point[ipt + 3], comp);
+		const vector_t dot = vector_muladd(comp[2], dz, vector_muladd(comp[1], dy, vector_mul(comp[0], dx)));
+		const vectori_t greater = vector_greater(dot, best);
+		best = vector_select(greater, dot, best);
+		best_index = vectori_select(greater, index, best_index);
+		index = vectori_add(index, step);
+	}
+
+	// Reduce lanes, lowest index wins ties so the result does not depend on the lane layout
+	const real lane_dot[4] = {vector_x(best), vector_y(best), vector_z(best), vector_w(best)};
+	const int32_t lane_index[4] = {vectori_x(best_index), vectori_y(best_index), vectori_z(best_index),
+	                               vectori_w(best_index)};
+	size_t best_point = 0;
+	real best_dot = -REAL_MAX;
+	for (int lane = 0; lane < 4; ++lane) {
+		if ((lane_dot[lane] > best_dot) || ((lane_dot[lane] == best_dot) && ((size_t)lane_index[lane] < best_point))) {
+			best_dot = lane_dot[lane];
+			best_point = (size_t)lane_index[lane];
+		}
+	}
+	for (; ipt < count; ++ipt) {
+		const real dot = convex_dot(point[ipt], direction);
+		if (dot > best_dot) {
+			best_dot = dot;
+			best_point = ipt;
+		}
+	}
+	return best_point;
+}
+
+//! Support point of core in local space
+static vector_t
+convex_support_local(const convex_t* shape, const vector_t direction) {
+	switch (shape->type) {
+		case CONVEX_CAPSULE:
+			return (convex_dot(direction, shape->extent) >= 0) ? shape->extent : vector_neg(shape->extent);
+		case CONVEX_BOX:
+			return vector_select(vector_less(direction, vector_zero()), vector_neg(shape->extent), shape->extent);
+		case CONVEX_HULL:
+			return shape->point[convex_support_index(shape->point, shape->point_count, direction)];
+		case CONVEX_CUSTOM:
+			return shape->support(shape->data, direction);
+		case CONVEX_SPHERE:
+		default:
+			return vector_zero();
+	}
+}
+
+//! Support point of core in world space
+static FOUNDATION_FORCEINLINE vector_t
+convex_support_core(const convex_t* shape, const matrix_t inverse, const vector_t direction) {
+	const vector_t local = convex_support_local(shape, vector_set_component(vector_rotate(direction, inverse), 3, 0));
+	return vector_transform(vector_set_component(local, 3, 1), shape->transform);
+}
+
+vector_t
+convex_support(const convex_t* shape, const vector_t direction) {
+	const vector_t core = convex_support_core(shape, matrix_transpose(shape->transform), direction);
+	const real length = vector_x(vector_length3(direction));
+	if ((shape->radius <= 0) || (length <= 0))
+		return core;
+	return vector_set_component(vector_muladd(direction, vector_uniform(shape->radius / length), core), 3, 1);
+}
+
+static void
+convex_pair_initialize(convex_pair_t* pair, const convex_t* shape0, const convex_t* shape1) {
+	pair->shape[0] = shape0;
+	pair->shape[1] = shape1;
+	pair->inverse[0] = matrix_transpose(shape0->transform);
+	pair->inverse[1] = matrix_transpose(shape1->transform);
+	pair->scale_sqr = 0;
+}
+
+//! Support point of the Minkowski difference of the cores, shape0 - shape1
+static FOUNDATION_FORCEINLINE vector_t
+convex_pair_support(convex_pair_t* pair, const vector_t direction, vector_t* a, vector_t* b) {
+	*a = convex_support_core(pair->shape[0], pair->inverse[0], direction);
+	*b = convex_support_core(pair->shape[1], pair->inverse[1], vector_neg(direction));
+	const vector_t w = vector_set_component(vector_sub(*a, *b), 3, 0);
+	const real length_sqr = convex_dot(w, w);
+	if (length_sqr > pair->scale_sqr)
+		pair->scale_sqr = length_sqr;
+	return w;
+}
+
+static FOUNDATION_FORCEINLINE void
+convex_feature_edge(convex_feature_t* feature, int i0, int i1, real t) {
+	feature->count = 2;
+	feature->index[0] = i0;
+	feature->index[1] = i1;
+	feature->lambda[0] = 1 - t;
+	feature->lambda[1] = t;
+}
+
+static FOUNDATION_FORCEINLINE void
+convex_feature_vertex(convex_feature_t* feature, int i0) {
+	feature->count = 1;
+	feature->index[0] = i0;
+	feature->lambda[0] = 1;
+}
+
+static FOUNDATION_FORCEINLINE vector_t
+convex_feature_point(const vector_t* w, const convex_feature_t* feature) {
+	vector_t point = vector_zero();
+	for (int i = 0; i < feature->count; ++i)
+		point = vector_muladd(w[feature->index[i]], vector_uniform(feature->lambda[i]), point);
+	return point;
+}
+
+static void
+convex_closest_segment(const vector_t* w, int i0, int i1, convex_feature_t* feature) {
+	const vector_t edge = vector_sub(w[i1], w[i0]);
+	const real length_sqr = convex_dot(edge, edge);
+	const real t = (length_sqr > 0) ? -convex_dot(w[i0], edge) / length_sqr : 0;
+	if (t <= 0)
+		convex_feature_vertex(feature, i0);
+	else if (t >= 1)
+		convex_feature_vertex(feature, i1);
+	else
+		convex_feature_edge(feature, i0, i1, t);
+}
+
+//! Closest point of triangle to origin by Voronoi regions, see Ericson, Real-Time Collision
+//! Detection, 5.1.5
+static void
+convex_closest_triangle(const vector_t* w, int i0, int i1, int i2, convex_feature_t* feature) {
+	const vector_t a = w[i0];
+	const vector_t ab = vector_sub(w[i1], a);
+	const vector_t ac = vector_sub(w[i2], a);
+	const real d1 = -convex_dot(ab, a);
+	const real d2 = -convex_dot(ac, a);
+	if ((d1 <= 0) && (d2 <= 0)) {
+		convex_feature_vertex(feature, i0);
+		return;
+	}
+	const real d3 = -convex_dot(ab, w[i1]);
+	const real d4 = -convex_dot(ac, w[i1]);
+	if ((d3 >= 0) && (d4 <= d3)) {
+		convex_feature_vertex(feature, i1);
+		return;
+	}
+	const real vc = d1 * d4 - d3 * d2;
+	if ((vc <= 0) && (d1 >= 0) && (d3 <= 0)) {
+		convex_feature_edge(feature, i0, i1, d1 / (d1 - d3));
+		return;
+	}
+	const real d5 = -convex_dot(ab, w[i2]);
+	const real d6 = -convex_dot(ac, w[i2]);
+	if ((d6 >= 0) && (d5 <= d6)) {
+		convex_feature_vertex(feature, i2);
+		return;
+	}
+	const real vb = d5 * d2 - d1 * d6;
+	if ((vb <= 0) && (d2 >= 0) && (d6 <= 0)) {
+		convex_feature_edge(feature, i0, i2, d2 / (d2 - d6));
+		return;
+	}
+	const real va = d3 * d6 - d5 * d4;
+	if ((va <= 0) && ((d4 - d3) >= 0) && ((d5 - d6) >= 0)) {
+		convex_feature_edge(feature, i1, i2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+		return;
+	}
+	const real sum = va + vb + vc;
+	if (sum <= 0) {
+		// Degenerate triangle, closest of the edges
+		convex_feature_t edge;
+		real best = REAL_MAX;
+		const int pair[3][2] = {{i0, i1}, {i0, i2}, {i1, i2}};
+		for (int iedge = 0; iedge < 3; ++iedge) {
+			convex_closest_segment(w, pair[iedge][0], pair[iedge][1], &edge);
+			const vector_t point = convex_feature_point(w, &edge);
+			const real dist_sqr = convex_dot(point, point);
+			if (dist_sqr < best) {
+				best = dist_sqr;
+				*feature = edge;
+			}
+		}
+		return;
+	}
+	const real v = vb / sum;
+	const real t = vc / sum;
+	feature->count = 3;
+	feature->index[0] = i0;
+	feature->index[1] = i1;
+	feature->index[2] = i2;
+	feature->lambda[0] = 1 - v - t;
+	feature->lambda[1] = v;
+	feature->lambda[2] = t;
+}
+
+//! Reduce simplex to the sub-simplex holding the point closest to the origin
+//! \return true if the origin is inside the tetrahedron, the simplex is left unchanged
+static bool
+convex_simplex_reduce(convex_simplex_t* simplex, vector_t* closest) {
+	convex_feature_t feature;
+	if (simplex->count == 1) {
+		convex_feature_vertex(&feature, 0);
+	} else if (simplex->count == 2) {
+		convex_closest_segment(simplex->w, 0, 1, &feature);
+	} else if (simplex->count == 3) {
+		convex_closest_triangle(simplex->w, 0, 1, 2, &feature);
+	} else {
+		static const int face[4][4] = {{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2}, {1, 3, 2, 0}};
+		const vector_t* w = simplex->w;
+		real best = REAL_MAX;
+		bool inside = true;
+		for (int iface = 0; iface < 4; ++iface) {
+			const int* f = face[iface];
+			const vector_t normal = vector_cross3(vector_sub(w[f[1]], w[f[0]]), vector_sub(w[f[2]], w[f[0]]));
+			const real side_origin = -convex_dot(normal, w[f[0]]);
+			const real side_opposite = convex_dot(normal, vector_sub(w[f[3]], w[f[0]]));
+			// Flat tetrahedra have no inside, all faces are tested
+			const bool outside = (side_opposite > 0) ? (side_origin < 0) :
+			                     ((side_opposite < 0) ? (side_origin > 0) : true);
+			if (!outside)
+				continue;
+			inside = false;
+			convex_feature_t face_feature;
+			convex_closest_triangle(w, f[0], f[1], f[2], &face_feature);
+			const vector_t point = convex_feature_point(w, &face_feature);
+			const real dist_sqr = convex_dot(point, point);
+			if (dist_sqr < best) {
+				best = dist_sqr;
+				feature = face_feature;
+			}
+		}
+		if (inside) {
+			*closest = vector_zero();
+			return true;
+		}
+	}
+
+	convex_simplex_t reduced;
+	for (int i = 0; i < feature.count; ++i) {
+		reduced.w[i] = simplex->w[feature.index[i]];
+		reduced.a[i] = simplex->a[feature.index[i]];
+		reduced.b[i] = simplex->b[feature.index[i]];
+		reduced.lambda[i] = feature.lambda[i];
+	}
+	reduced.count = feature.count;
+	*simplex = reduced;
+	for (int i = 0; i < feature.count; ++i)
+		feature.index[i] = i;
+	*closest = convex_feature_point(simplex->w, &feature);
+	return false;
+}
+
+//! Run GJK on the cores
+//! \param pair Shape pair
+//! \param simplex Output final simplex, contains the origin if the cores overlap
+//! \param closest Output point of the Minkowski difference closest to the origin
+//! \param margin Stop early with a separation once a separating plane further than this from
+//!               the origin is found, negative to run to convergence
+//! \return true if cores overlap
+static bool
+convex_gjk(convex_pair_t* pair, convex_simplex_t* simplex, vector_t* closest, real margin) {
+	vector_t direction = vector_sub(pair->shape[0]->transform.row[3], pair->shape[1]->transform.row[3]);
+	direction = vector_set_component(direction, 3, 0);
+	if (convex_dot(direction, direction) <= 0)
+		direction = vector_xaxis();
+
+	simplex->count = 1;
+	simplex->lambda[0] = 1;
+	simplex->w[0] = convex_pair_support(pair, direction, simplex->a, simplex->b);
+	vector_t v = simplex->w[0];
+
+	for (int iter = 0; iter < CONVEX_GJK_MAX_ITERATIONS; ++iter) {
+		const real vv = convex_dot(v, v);
+		if (vv <= pair->scale_sqr * (CONVEX_OVERLAP_TOLERANCE * CONVEX_OVERLAP_TOLERANCE)) {
+			*closest = v;
+			return true;
+		}
+
+		vector_t a, b;
+		const vector_t w = convex_pair_support(pair, vector_neg(v), &a, &b);
+		const real vw = convex_dot(v, w);
+		if ((margin >= 0) && (vw > 0) && (vw * vw > margin * margin * vv))
+			break;
+		if (vv - vw <= vv * CONVEX_GJK_TOLERANCE)
+			break;
+		bool duplicate = false;
+		for (int i = 0; i < simplex->count; ++i) {
+			const vectori_t equal = vector_equal(simplex->w[i], w);
+			duplicate = duplicate || (vectori_x(equal) && vectori_y(equal) && vectori_z(equal));
+		}
+		if (duplicate)
+			break;
+
+		simplex->w[simplex->count] = w;
+		simplex->a[simplex->count] = a;
+		simplex->b[simplex->count] = b;
+		++simplex->count;
+		vector_t next;
+		if (convex_simplex_reduce(simplex, &next)) {
+			*closest = next;
+			return true;
+		}
+		v = next;
+		if (convex_dot(next, next) >= vv)
+			break;
+	}
+
+	*closest = v;
+	return false;
+}
+
+//! Closest points of the cores from the simplex barycentric coordinates
+static void
+convex_simplex_points(const convex_simplex_t* simplex, vector_t* a, vector_t* b) {
+	vector_t pa = vector_zero();
+	vector_t pb = vector_zero();
+	for (int i = 0; i < simplex->count; ++i) {
+		pa = vector_muladd(simplex->a[i], vector_uniform(simplex->lambda[i]), pa);
+		pb = vector_muladd(simplex->b[i], vector_uniform(simplex->lambda[i]), pb);
+	}
+	*a = vector_set_component(pa, 3, 1);
+	*b = vector_set_component(pb, 3, 1);
+}
+
+static void
+convex_make_contact(const convex_pair_t* pair, const vector_t a, const vector_t b, const vector_t normal,
+                    real core_distance, convex_contact_t* contact) {
+	const real radius0 = pair->shape[0]->radius;
+	const real radius1 = pair->shape[1]->radius;
+	contact->normal = normal;
+	contact->point0 = vector_muladd(normal, vector_uniform(radius0), a);
+	contact->point1 = vector_muladd(normal, vector_uniform(-radius1), b);
+	contact->distance = core_distance - radius0 - radius1;
+}
+
+//! Any unit vector perpendicular to the given vector
+static vector_t
+convex_perpendicular(const vector_t v) {
+	const real ax = math_abs(vector_x(v));
+	const real ay = math_abs(vector_y(v));
+	const real az = math_abs(vector_z(v));
+	vector_t axis = vector_zaxis();
+	if ((ax <= ay) && (ax <= az))
+		axis = vector_xaxis();
+	else if (ay <= az)
+		axis = vector_yaxis();
+	return vector_set_component(vector_normalize3(vector_cross3(v, axis)), 3, 0);
+}
+
+//! Grow the simplex of overlapping cores to a tetrahedron
+//! \return true if successful, false if the Minkowski difference is flat in which case normal is
+//!         set to a direction perpendicular to it and the simplex may have grown by vertices
+//!         without barycentric coordinates
+static bool
+convex_epa_expand(convex_pair_t* pair, convex_simplex_t* simplex, vector_t* normal) {
+	const real epsilon = math_sqrt(pair->scale_sqr) * CONVEX_OVERLAP_TOLERANCE;
+	vector_t* w = simplex->w;
+	if (simplex->count == 1) {
+		static const real axis[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+		for (int iaxis = 0; (iaxis < 6) && (simplex->count == 1); ++iaxis) {
+			const vector_t direction = vector(axis[iaxis][0], axis[iaxis][1], axis[iaxis][2], 0);
+			w[1] = convex_pair_support(pair, direction, simplex->a + 1, simplex->b + 1);
+			const vector_t delta = vector_sub(w[1], w[0]);
+			if (convex_dot(delta, delta) > epsilon * epsilon)
+				simplex->count = 2;
+		}
+		if (simplex->count == 1) {
+			*normal = vector_xaxis();
+			return false;
+		}
+	}
+	if (simplex->count == 2) {
+		const vector_t edge = vector_sub(w[1], w[0]);
+		const vector_t edge_unit = vector_normalize3(edge);
+		const vector_t p = convex_perpendicular(edge);
+		const vector_t q = vector_cross3(edge_unit, p);
+		const vector_t direction[4] = {p, vector_neg(p), q, vector_neg(q)};
+		for (int idir = 0; (idir < 4) && (simplex->count == 2); ++idir) {
+			w[2] = convex_pair_support(pair, direction[idir], simplex->a + 2, simplex->b + 2);
+			const vector_t offset = vector_cross3(vector_sub(w[2], w[0]), edge_unit);
+			if (convex_dot(offset, offset) > epsilon * epsilon)
+				simplex->count = 3;
+		}
+		if (simplex->count == 2) {
+			*normal = p;
+			return false;
+		}
+	}
+	if (simplex->count == 3) {
+		const vector_t n = vector_normalize3(vector_cross3(vector_sub(w[1], w[0]), vector_sub(w[2], w[0])));
+		const vector_t direction[2] = {n, vector_neg(n)};
+		for (int idir = 0; (idir < 2) && (simplex->count == 3); ++idir) {
+			w[3] = convex_pair_support(pair, direction[idir], simplex->a + 3, simplex->b + 3);
+			if (math_abs(convex_dot(vector_sub(w[3], w[0]), n)) > epsilon)
+				simplex->count = 4;
+		}
+		if (simplex->count == 3) {
+			*normal = vector_set_component(n, 3, 0);
+			return false;
+		}
+	}
+	return true;
+}
+
+//! Set face indices, unit normal and distance from origin, faces are wound counter clockwise seen
+//! from outside. Degenerate faces get a distance that is never the closest
+static bool
+convex_epa_face(convex_face_t* face, const vector_t* w, int i0, int i1, int i2) {
+	face->index[0] = i0;
+	face->index[1] = i1;
+	face->index[2] = i2;
+	const vector_t normal = vector_cross3(vector_sub(w[i1], w[i0]), vector_sub(w[i2], w[i0]));
+	const real length = vector_x(vector_length3(normal));
+	if (length <= 0) {
+		face->normal = vector_zero();
+		face->distance = REAL_MAX;
+		return false;
+	}
+	face->normal = vector_set_component(vector_scale(normal, 1 / length), 3, 0);
+	face->distance = convex_dot(face->normal, w[i0]);
+	return true;
+}
+
+//! Add edge of a removed face to the horizon, edges shared by two removed faces cancel out
+static void
+convex_epa_edge(convex_edge_t* edge, int* edge_count, int i0, int i1) {
+	for (int iedge = 0; iedge < *edge_count; ++iedge) {
+		if ((edge[iedge].index[0] == i1) && (edge[iedge].index[1] == i0)) {
+			edge[iedge] = edge[--(*edge_count)];
+			return;
+		}
+	}
+	edge[*edge_count].index[0] = i0;
+	edge[*edge_count].index[1] = i1;
+	++(*edge_count);
+}
+
+//! Expanding polytope algorithm, simplex must be a tetrahedron containing the origin
+static void
+convex_epa(convex_pair_t* pair, const convex_simplex_t* simplex, convex_contact_t* contact) {
+	vector_t w[CONVEX_EPA_MAX_VERTICES];
+	vector_t a[CONVEX_EPA_MAX_VERTICES];
+	vector_t b[CONVEX_EPA_MAX_VERTICES];
+	convex_face_t face[CONVEX_EPA_MAX_FACES];
+	convex_edge_t edge[CONVEX_EPA_MAX_FACES * 3];
+	uint8_t visible[CONVEX_EPA_MAX_FACES];
+	int vertex_count = 4;
+	int face_count = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		w[i] = simplex->w[i];
+		a[i] = simplex->a[i];
+		b[i] = simplex->b[i];
+	}
+	// Orient initial faces outward, the tetrahedron is not degenerate after expansion
+	if (convex_dot(vector_cross3(vector_sub(w[1], w[0]), vector_sub(w[2], w[0])), vector_sub(w[3], w[0])) > 0) {
+		vector_t swap = w[1];
+		w[1] = w[2];
+		w[2] = swap;
+		swap = a[1];
+		a[1] = a[2];
+		a[2] = swap;
+		swap = b[1];
+		b[1] = b[2];
+		b[2] = swap;
+	}
+	convex_epa_face(face + face_count++, w, 0, 1, 2);
+	convex_epa_face(face + face_count++, w, 0, 3, 1);
+	convex_epa_face(face + face_count++, w, 0, 2, 3);
+	convex_epa_face(face + face_count++, w, 1, 3, 2);
+
+	const real tolerance = math_sqrt(pair->scale_sqr) * CONVEX_EPA_TOLERANCE;
+	int closest = 0;
+	for (int iface = 1; iface < face_count; ++iface) {
+		if (face[iface].distance < face[closest].distance)
+			closest = iface;
+	}
+	for (int iter = 0; iter < CONVEX_EPA_MAX_ITERATIONS; ++iter) {
+		if ((face[closest].distance == REAL_MAX) || (vertex_count == CONVEX_EPA_MAX_VERTICES))
+			break;
+
+		const vector_t normal = face[closest].normal;
+		vector_t support_a, support_b;
+		const vector_t support = convex_pair_support(pair, normal, &support_a, &support_b);
+		if (convex_dot(support, normal) - face[closest].distance <= tolerance)
+			break;
+
+		// Faces seen from the new vertex are removed, the horizon edges around them are joined to
+		// the new vertex. Bail out before changing anything if the new faces would not fit
+		int edge_count = 0;
+		int visible_count = 0;
+		for (int iface = 0; iface < face_count; ++iface) {
+			const int* index = face[iface].index;
+			visible[iface] = (convex_dot(face[iface].normal, vector_sub(support, w[index[0]])) > 0) ? 1 : 0;
+			if (!visible[iface])
+				continue;
+			++visible_count;
+			convex_epa_edge(edge, &edge_count, index[0], index[1]);
+			convex_epa_edge(edge, &edge_count, index[1], index[2]);
+			convex_epa_edge(edge, &edge_count, index[2], index[0]);
+		}
+		if (face_count - visible_count + edge_count > CONVEX_EPA_MAX_FACES)
+			break;
+
+		const int vertex = vertex_count++;
+		w[vertex] = support;
+		a[vertex] = support_a;
+		b[vertex] = support_b;
+		int kept = 0;
+		for (int iface = 0; iface < face_count; ++iface) {
+			if (!visible[iface])
+				face[kept++] = face[iface];
+		}
+		face_count = kept;
+		for (int iedge = 0; iedge < edge_count; ++iedge)
+			convex_epa_face(face + face_count++, w, edge[iedge].index[0], edge[iedge].index[1], vertex);
+		closest = 0;
+		for (int iface = 1; iface < face_count; ++iface) {
+			if (face[iface].distance < face[closest].distance)
+				closest = iface;
+		}
+	}
+
+	// Deepest points from the projection of the origin onto the closest face
+	const convex_face_t* best = face + closest;
+	convex_feature_t feature;
+	convex_closest_triangle(w, best->index[0], best->index[1], best->index[2], &feature);
+	vector_t pa = vector_zero();
+	vector_t pb = vector_zero();
+	for (int i = 0; i < feature.count; ++i) {
+		pa = vector_muladd(a[feature.index[i]], vector_uniform(feature.lambda[i]), pa);
+		pb = vector_muladd(b[feature.index[i]], vector_uniform(feature.lambda[i]), pb);
+	}
+	const real depth = (best->distance > 0) ? best->distance : 0;
+	convex_make_contact(pair, vector_set_component(pa, 3, 1), vector_set_component(pb, 3, 1), best->normal,
+	                    -depth, contact);
+}
+
+bool
+convex_overlap(const convex_t* shape0, const convex_t* shape1) {
+	convex_pair_t pair;
+	convex_pair_initialize(&pair, shape0, shape1);
+	convex_simplex_t simplex;
+	vector_t closest;
+	const real margin = shape0->radius + shape1->radius;
+	if (convex_gjk(&pair, &simplex, &closest, margin))
+		return true;
+	return convex_dot(closest, closest) <= margin * margin;
+}
+
+//! Contact from the GJK result of the cores, penetration from EPA if the cores overlap
+static void
+convex_contact_pair(convex_pair_t* pair, convex_contact_t* contact) {
+	convex_simplex_t simplex;
+	vector_t closest;
+	vector_t a, b;
+	if (!convex_gjk(pair, &simplex, &closest, -1)) {
+		// Cores are separated, v = a - b points from the second core to the first
+		const real core_distance = vector_x(vector_length3(closest));
+		convex_simplex_points(&simplex, &a, &b);
+		const vector_t normal = vector_set_component(vector_scale(closest, -1 / core_distance), 3, 0);
+		convex_make_contact(pair, a, b, normal, core_distance, contact);
+		return;
+	}
+	// Expand a copy, a failed expansion can leave added vertices without barycentric coordinates
+	convex_simplex_t expanded = simplex;
+	vector_t normal;
+	if (!convex_epa_expand(pair, &expanded, &normal)) {
+		// Flat Minkowski difference containing the origin, the cores touch with zero core depth.
+		// The GJK simplex holds the origin with valid barycentric coordinates
+		convex_simplex_points(&simplex, &a, &b);
+		convex_make_contact(pair, a, b, normal, 0, contact);
+		return;
+	}
+	convex_epa(pair, &expanded, contact);
+}
+
+bool
+convex_distance(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact) {
+	convex_pair_t pair;
+	convex_pair_initialize(&pair, shape0, shape1);
+	convex_contact_t result;
+	convex_contact_pair(&pair, &result);
+	if (result.distance <= 0)
+		return false;
+	*contact = result;
+	return true;
+}
+
+bool
+convex_penetration(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact) {
+	convex_pair_t pair;
+	convex_pair_initialize(&pair, shape0, shape1);
+	convex_contact_t result;
+	convex_contact_pair(&pair, &result);
+	if (result.distance > 0)
+		return false;
+	*contact = result;
+	return true;
+}
+
+void
+convex_contact(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact) {
+	convex_pair_t pair;
+	convex_pair_initialize(&pair, shape0, shape1);
+	convex_contact_pair(&pair, contact);
+}
@@ -0,0 +1,161 @@
+/* convex.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file convex.h
+    Distance and penetration queries between convex shapes given by support mappings. A shape is
+    a core (point, segment, box, point cloud hull or custom support function) in local space,
+    placed in the world by a rigid transform and expanded by a radius. GJK and EPA run on the cores
+    only and the radii are added analytically, which keeps spheres and capsules exact and lets
+    shapes with a small radius margin stay separated cores in the common resting contact case.
+    Boxes and hulls are rounded by setting the radius after construction.
+
+    GJK finds the distance and closest points of separated cores with Johnson style sub-simplex
+    reduction. For overlapping cores EPA expands the final GJK simplex into a polytope of the
+    Minkowski difference until the face closest to the origin is within tolerance of the
+    boundary, which gives penetration depth and normal. Hull support points are found with a
+    four wide max dot product search over the point cloud. Tolerances are relative to the size of
+    the shapes, results are accurate to around 1e-4 of the shape size in single precision. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+#include <vector/quaternion.h>
+
+//! Sphere
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_sphere(const vector_t center, real radius);
+
+//! Capsule, segment between p0 and p1 expanded by radius
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_capsule(const vector_t p0, const vector_t p1, real radius);
+
+//! Box with half extents along the local axes given by rotation
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_box(const vector_t center, const vector_t extent, const quaternion_t rotation);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_from_obb(const obb_t box);
+
+//! Convex hull of a point cloud. Points are not copied and must stay valid while the shape is used
+//! \param point Points in local space, w component is ignored
+//! \param count Number of points, must be nonzero
+//! \param transform Local to world matrix, rows 0-2 must be orthonormal
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_hull(const vector_t* point, size_t count, const matrix_t transform);
+
+//! Shape with core given by support function
+//! \param support Support function in local space
+//! \param data Data passed to support function
+//! \param transform Local to world matrix, rows 0-2 must be orthonormal
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_custom(convex_support_fn support, const void* data, const matrix_t transform);
+
+//! Index of the point with the largest dot product with direction, the first one for ties
+//! \param point Points, w component is ignored
+//! \param count Number of points, must be nonzero
+//! \param direction Direction, need not be normalized
+VECTOR_API size_t
+convex_support_index(const vector_t* point, size_t count, const vector_t direction);
+
+//! Point of shape furthest along direction in world space, including radius
+VECTOR_API vector_t
+convex_support(const convex_t* shape, const vector_t direction);
+
+//! Test if shapes overlap, touching shapes are considered overlapping
+VECTOR_API bool
+convex_overlap(const convex_t* shape0, const convex_t* shape1);
+
+//! Distance and closest points of separated shapes
+//! \param shape0 First shape
+//! \param shape1 Second shape
+//! \param contact Output closest points, normal and positive distance. Not written if shapes
+//!                overlap
+//! \return true if shapes are separated, false if they overlap
+VECTOR_API bool
+convex_distance(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact);
+
+//! Penetration depth, normal and deepest points of overlapping shapes
+//! \param shape0 First shape
+//! \param shape1 Second shape
+//! \param contact Output deepest points, normal and negative distance. Not written if shapes
+//!                are separated
+//! \return true if shapes overlap, false if they are separated
+VECTOR_API bool
+convex_penetration(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact);
+
+//! Closest points for separated shapes and deepest points for overlapping shapes, the sign of the
+//! distance tells which case applies
+VECTOR_API void
+convex_contact(const convex_t* shape0, const convex_t* shape1, convex_contact_t* contact);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_shape(convex_type_t type, const matrix_t transform, const vector_t extent, real radius) {
+	convex_t shape;
+	shape.transform = transform;
+	shape.extent = vector_set_component(extent, 3, 0);
+	shape.type = type;
+	shape.radius = radius;
+	shape.point = 0;
+	shape.point_count = 0;
+	shape.support = 0;
+	shape.data = 0;
+	return shape;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_sphere(const vector_t center, real radius) {
+	matrix_t transform = matrix_identity();
+	transform.row[3] = vector_set_component(center, 3, 1);
+	return convex_shape(CONVEX_SPHERE, transform, vector_zero(), radius);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_capsule(const vector_t p0, const vector_t p1, real radius) {
+	matrix_t transform = matrix_identity();
+	transform.row[3] = vector_set_component(vector_mul(vector_add(p0, p1), vector_half()), 3, 1);
+	return convex_shape(CONVEX_CAPSULE, transform, vector_mul(vector_sub(p1, p0), vector_half()), radius);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_box(const vector_t center, const vector_t extent, const quaternion_t rotation) {
+	matrix_t transform = matrix_from_quaternion(rotation);
+	transform.row[3] = vector_set_component(center, 3, 1);
+	return convex_shape(CONVEX_BOX, transform, extent, 0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_from_obb(const obb_t box) {
+	return convex_box(box.center, box.extent, box.rotation);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_hull(const vector_t* point, size_t count, const matrix_t transform) {
+	convex_t shape = convex_shape(CONVEX_HULL, transform, vector_zero(), 0);
+	shape.point = point;
+	shape.point_count = count;
+	return shape;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL convex_t
+convex_custom(convex_support_fn support, const void* data, const matrix_t transform) {
+	convex_t shape = convex_shape(CONVEX_CUSTOM, transform, vector_zero(), 0);
+	shape.support = support;
+	shape.data = data;
+	return shape;
+}
@@ -0,0 +1,288 @@
+/* decompose.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/decompose.h>
+#include <vector/quaternion.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+//! Max number of Jacobi sweeps, 3x3 and 4x4 matrices normally converge in four to six
+#define MATRIX_JACOBI_MAX_SWEEPS 16
+
+typedef struct matrix_decompose_batch_t matrix_decompose_batch_t;
+
+struct matrix_decompose_batch_t {
+	const matrix_t* m;
+	vector_t* eigenvalues;
+	matrix_t* eigenvectors;
+	matrix_t* rotation;
+	matrix_t* stretch;
+	transform_t* transform;
+	vector_t* scale;
+	uint8_t* flags;
+};
+
+//! Upper left 3x3 part with zero w components and last row [0, 0, 0, 1]
+static FOUNDATION_FORCEINLINE matrix_t
+matrix_linear_part(const matrix_t m) {
+	matrix_t lin;
+	lin.row[0] = vector_set_component(m.row[0], 3, 0);
+	lin.row[1] = vector_set_component(m.row[1], 3, 0);
+	lin.row[2] = vector_set_component(m.row[2], 3, 0);
+	lin.row[3] = vector(0, 0, 0, 1);
+	return lin;
+}
+
+//! Rotate rows p and q, [p, q] = [c * p - s * q, s * p + c * q]
+static FOUNDATION_FORCEINLINE void
+matrix_jacobi_rotate(matrix_t* m, int p, int q, real c, real s) {
+	const vector_t rp = m->row[p];
+	const vector_t rq = m->row[q];
+	m->row[p] = vector_sub(vector_scale(rp, c), vector_scale(rq, s));
+	m->row[q] = vector_add(vector_scale(rp, s), vector_scale(rq, c));
+}
+
+static FOUNDATION_FORCEINLINE real
+matrix_determinant3(const matrix_t m) {
+	return vector_x(vector_dot3(vector_cross3(m.row[0], m.row[1]), m.row[2]));
+}
+
+//! Unit vector perpendicular to the given unit vector
+static FOUNDATION_FORCEINLINE vector_t
+matrix_perpendicular(const vector_t v) {
+	// Cross with the axis least aligned with v
+	const real ax = math_abs(vector_x(v));
+	const real ay = math_abs(vector_y(v));
+	const real az = math_abs(vector_z(v));
+	vector_t axis = vector_zaxis();
+	if ((ax <= ay) && (ax <= az))
+		axis = vector_xaxis();
+	else if (ay <= az)
+		axis = vector_yaxis();
+	return vector_set_component(vector_normalize3(vector_cross3(v, axis)), 3, 0);
+}
+
+void
+matrix_jacobi_symmetric(const matrix_t m, int dim, vector_t* eigenvalues, matrix_t* eigenvectors) {
+	matrix_t a = m;
+	matrix_t v = matrix_identity();
+
+	for (int sweep = 0; sweep < MATRIX_JACOBI_MAX_SWEEPS; ++sweep) {
+		real off = 0;
+		real diag = 0;
+		for (int p = 0; p < dim; ++p) {
+			for (int q = p + 1; q < dim; ++q)
+				off += a.frow[p][q] * a.frow[p][q];
+			diag += a.frow[p][p] * a.frow[p][p];
+		}
+		if (off <= diag * REAL_C(1e-14))
+			break;
+		for (int p = 0; p < dim; ++p) {
+			for (int q = p + 1; q < dim; ++q) {
+				const real apq = a.frow[p][q];
+				if (apq == 0)
+					continue;
+				// Rotation angle zeroing the off diagonal element, tangent of the smaller root. For
+				// huge ratios the square would overflow and the tangent is 1 / (2 * theta)
+				const real theta = (a.frow[q][q] - a.frow[p][p]) / (2 * apq);
+				const real abs_theta = math_abs(theta);
+				const real t = (abs_theta > REAL_C(1e10)) ?
+				                   REAL_C(0.5) / theta :
+				                   ((theta < 0) ? -1 : 1) / (abs_theta + math_sqrt(theta * theta + 1));
+				const real c = 1 / math_sqrt(t * t + 1);
+				const real s = t * c;
+				// a = g * a * transpose(g), the row rotation of the transpose equals the column
+				// rotation since the result is symmetric
+				matrix_jacobi_rotate(&a, p, q, c, s);
+				a = matrix_transpose(a);
+				matrix_jacobi_rotate(&a, p, q, c, s);
+				a.frow[p][q] = 0;
+				a.frow[q][p] = 0;
+				matrix_jacobi_rotate(&v, p, q, c, s);
+			}
+		}
+	}
+
+	real value[4] = {0, 0, 0, 0};
+	for (int i = 0; i < dim; ++i)
+		value[i] = a.frow[i][i];
+	*eigenvalues = vector(value[0], value[1], value[2], value[3]);
+	*eigenvectors = v;
+}
+
+void
+matrix_eigen_symmetric(const matrix_t m, vector_t* eigenvalues, matrix_t* eigenvectors) {
+	vector_t lambda;
+	matrix_t v;
+	matrix_jacobi_symmetric(matrix_linear_part(m), 3, &lambda, &v);
+
+	// Sort descending, then flip the last eigenvector if needed to make the rows a proper rotation
+	real value[3] = {vector_x(lambda), vector_y(lambda), vector_z(lambda)};
+	int order[3] = {0, 1, 2};
+	for (int i = 0; i < 2; ++i) {
+		for (int j = i + 1; j < 3; ++j) {
+			if (value[order[j]] > value[order[i]]) {
+				const int swap = order[i];
+				order[i] = order[j];
+				order[j] = swap;
+			}
+		}
+	}
+	matrix_t sorted;
+	sorted.row[0] = v.row[order[0]];
+	sorted.row[1] = v.row[order[1]];
+	sorted.row[2] = v.row[order[2]];
+	sorted.row[3] = v.row[3];
+	if (matrix_determinant3(sorted) < 0)
+		sorted.row[2] = vector_neg(sorted.row[2]);
+
+	*eigenvalues = vector(value[order[0]], value[order[1]], value[order[2]], 0);
+	*eigenvectors = sorted;
+}
+
+void
+matrix_polar_decompose(const matrix_t m, matrix_t* rotation, matrix_t* stretch) {
+	const matrix_t lin = matrix_linear_part(m);
+	vector_t lambda;
+	matrix_t e;
+	matrix_eigen_symmetric(matrix_mul(lin, matrix_transpose(lin)), &lambda, &e);
+
+	// Rows of e * m are orthogonal with lengths equal to the singular values. Their directions
+	// are the rows of the rotation in the eigenvector frame, orthonormalized to absorb rounding
+	// and completed from the other axes for rank deficient matrices
+	const vector_t image[3] = {vector_rotate(e.row[0], lin), vector_rotate(e.row[1], lin),
+	                           vector_rotate(e.row[2], lin)};
+	const real largest = vector_x(vector_length3(image[0]));
+	if (largest <= 0) {
+		*rotation = matrix_identity();
+		*stretch = matrix_zero();
+		stretch->row[3] = vector(0, 0, 0, 1);
+		return;
+	}
+	matrix_t w;
+	w.row[0] = vector_set_component(vector_scale(image[0], 1 / largest), 3, 0);
+	const vector_t ortho = vector_sub(image[1], vector_scale(w.row[0], vector_x(vector_dot3(image[1], w.row[0]))));
+	const real ortho_length = vector_x(vector_length3(ortho));
+	if (ortho_length > largest * REAL_C(1e-6))
+		w.row[1] = vector_set_component(vector_scale(ortho, 1 / ortho_length), 3, 0);
+	else
+		w.row[1] = matrix_perpendicular(w.row[0]);
+	w.row[2] = vector_set_component(vector_cross3(w.row[0], w.row[1]), 3, 0);
+	w.row[3] = vector(0, 0, 0, 1);
+
+	// Signed singular values, the last is negative for reflections since both frames are proper
+	matrix_t scaled;
+	scaled.row[0] = vector_scale(e.row[0], largest);
+	scaled.row[1] = vector_scale(e.row[1], vector_x(vector_dot3(image[1], w.row[1])));
+	scaled.row[2] = vector_scale(e.row[2], vector_x(vector_dot3(image[2], w.row[2])));
+	scaled.row[3] = vector(0, 0, 0, 1);
+
+	const matrix_t et = matrix_transpose(e);
+	*rotation = matrix_mul(et, w);
+	*stretch = matrix_mul(et, scaled);
+}
+
+unsigned int
+matrix_decompose(const matrix_t m, transform_t* transform, vector_t* scale) {
+	matrix_t rotation, stretch;
+	matrix_polar_decompose(m, &rotation, &stretch);
+
+	const real sx = stretch.frow[0][0];
+	const real sy = stretch.frow[1][1];
+	const real sz = stretch.frow[2][2];
+	const real uniform = (sx + sy + sz) / 3;
+	const real ax = math_abs(sx);
+	const real ay = math_abs(sy);
+	const real az = math_abs(sz);
+	const real largest = (ax > ay) ? ((ax > az) ? ax : az) : ((ay > az) ? ay : az);
+	const real tolerance = largest * MATRIX_DECOMPOSE_TOLERANCE;
+
+	unsigned int flags = 0;
+	if ((math_abs(sx - uniform) > tolerance) || (math_abs(sy - uniform) > tolerance) ||
+	    (math_abs(sz - uniform) > tolerance))
+		flags |= MATRIX_DECOMPOSE_NONUNIFORM_SCALE;
+	if ((math_abs(stretch.frow[0][1]) > tolerance) || (math_abs(stretch.frow[0][2]) > tolerance) ||
+	    (math_abs(stretch.frow[1][2]) > tolerance))
+		flags |= MATRIX_DECOMPOSE_SHEAR;
+	if (matrix_determinant3(matrix_linear_part(m)) < 0)
+		flags |= MATRIX_DECOMPOSE_REFLECTION;
+
+	transform->rotation = quaternion_from_matrix(rotation);
+	transform->translation = vector_set_component(m.row[3], 3, uniform);
+	if (scale)
+		*scale = vector(sx, sy, sz, 0);
+	return flags;
+}
+
+static void
+matrix_eigen_symmetric_range(void* context, size_t begin, size_t end) {
+	const matrix_decompose_batch_t* batch = context;
+	for (size_t imat = begin; imat < end; ++imat)
+		matrix_eigen_symmetric(batch->m[imat], batch->eigenvalues + imat, batch->eigenvectors + imat);
+}
+
+void
+matrix_eigen_symmetric_array(const matrix_t* m, size_t count, vector_t* eigenvalues, matrix_t* eigenvectors) {
+	matrix_decompose_batch_t batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.m = m;
+	batch.eigenvalues = eigenvalues;
+	batch.eigenvectors = eigenvectors;
+	vector_parallel_for(STRING_CONST("matrix_eigen_symmetric_array"), matrix_eigen_symmetric_range, &batch, count,
+	                    0);
+}
+
+static void
+matrix_polar_decompose_range(void* context, size_t begin, size_t end) {
+	const matrix_decompose_batch_t* batch = context;
+	for (size_t imat = begin; imat < end; ++imat)
+		matrix_polar_decompose(batch->m[imat], batch->rotation + imat, batch->stretch + imat);
+}
+
+void
+matrix_polar_decompose_array(const matrix_t* m, size_t count, matrix_t* rotation, matrix_t* stretch) {
+	matrix_decompose_batch_t batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.m = m;
+	batch.rotation = rotation;
+	batch.stretch = stretch;
+	vector_parallel_for(STRING_CONST("matrix_polar_decompose_array"), matrix_polar_decompose_range, &batch, count,
+	                    0);
+}
+
+static void
+matrix_decompose_range(void* context, size_t begin, size_t end) {
+	const matrix_decompose_batch_t* batch = context;
+	for (size_t imat = begin; imat < end; ++imat) {
+		vector_t scale;
+		const unsigned int flags = matrix_decompose(batch->m[imat], batch->transform + imat, &scale);
+		if (batch->scale)
+			batch->scale[imat] = scale;
+		if (batch->flags)
+			batch->flags[imat] = (uint8_t)flags;
+	}
+}
+
+void
+matrix_decompose_array(const matrix_t* m, size_t count, transform_t* transform, vector_t* scale, uint8_t* flags) {
+	matrix_decompose_batch_t batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.m = m;
+	batch.transform = transform;
+	batch.scale = scale;
+	batch.flags = flags;
+	vector_parallel_for(STRING_CONST("matrix_decompose_array"), matrix_decompose_range, &batch, count, 0);
+}
@@ -0,0 +1,74 @@
+/* decompose.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file decompose.h
+    Eigen decomposition of symmetric 3x3 matrices and polar decomposition of linear transforms.
+    All functions use the upper left 3x3 part of the matrix and ignore translation, except
+    matrix_decompose which also extracts the translation. The eigen solver is cyclic Jacobi with
+    the rotations applied to whole matrix rows as vector operations.
+
+    Polar decomposition factors m = stretch * rotation, in the row vector convention of matrix.h
+    the stretch is applied first in the local frame followed by the rotation. Stretch is the
+    symmetric square root of m * transpose(m), computed from its eigen decomposition, which
+    halves the number of significant digits for badly conditioned matrices. Rank deficient
+    matrices give a rotation completed from the remaining axes. Array variants are split across
+    the job threads with vector_parallel_for. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+
+//! Relative tolerance for detecting non-uniform scale and shear in matrix_decompose
+#define MATRIX_DECOMPOSE_TOLERANCE REAL_C(1e-4)
+
+//! Eigen decomposition of symmetric matrix, m = transpose(eigenvectors) * diag(eigenvalues) *
+//! eigenvectors
+//! \param m Symmetric matrix, only the upper left 3x3 part is used
+//! \param eigenvalues Output eigenvalues in descending order in xyz, w is zero
+//! \param eigenvectors Output unit eigenvectors, one per row in the order of the eigenvalues. The
+//!                     rows form a proper rotation. Last row is [0, 0, 0, 1]
+VECTOR_API void
+matrix_eigen_symmetric(const matrix_t m, vector_t* eigenvalues, matrix_t* eigenvectors);
+
+//! Polar decomposition, m = stretch * rotation
+//! \param m Matrix, only the upper left 3x3 part is used
+//! \param rotation Output proper rotation, determinant is one
+//! \param stretch Output symmetric stretch, negative determinant for reflections
+VECTOR_API void
+matrix_polar_decompose(const matrix_t m, matrix_t* rotation, matrix_t* stretch);
+
+//! Decompose affine matrix into rotation, translation and uniform scale, the mean of the stretch
+//! diagonal. The transform reproduces the matrix only if the returned flags are zero
+//! \param m Affine matrix
+//! \param transform Output transform
+//! \param scale Output per axis scale, diagonal of the stretch. Can be null
+//! \return Decomposition flags, see matrix_decompose_flag_t
+VECTOR_API unsigned int
+matrix_decompose(const matrix_t m, transform_t* transform, vector_t* scale);
+
+VECTOR_API void
+matrix_eigen_symmetric_array(const matrix_t* m, size_t count, vector_t* eigenvalues, matrix_t* eigenvectors);
+
+VECTOR_API void
+matrix_polar_decompose_array(const matrix_t* m, size_t count, matrix_t* rotation, matrix_t* stretch);
+
+//! \param scale Output per axis scale, can be null
+//! \param flags Output decomposition flags, can be null
+VECTOR_API void
+matrix_decompose_array(const matrix_t* m, size_t count, transform_t* transform, vector_t* scale, uint8_t* flags);
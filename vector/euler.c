@@ -69,12 +69,12 @@ euler_angles_to_quaternion(const euler_angles_t angles) {
 	tj = angle[1] * 0.5f;
 	th = angle[2] * 0.5f;
 
-	ci = math_cos(ti);
-	cj = math_cos(tj);
-	ch = math_cos(th);
-	si = math_sin(ti);
-	sj = math_sin(tj);
-	sh = math_sin(th);
+	ci = vector_scalar_cos(ti);
+	cj = vector_scalar_cos(tj);
+	ch = vector_scalar_cos(th);
+	si = vector_scalar_sin(ti);
+	sj = vector_scalar_sin(tj);
+	sh = vector_scalar_sin(th);
 
 	cc = ci * ch;
 	cs = ci * sh;
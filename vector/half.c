@@ -0,0 +1,50 @@
+/* half.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/half.h>
+#include <vector/internal.h>
+
+void
+vector_to_half4_array(const vector_t* in, size_t count, uint16_t* out) {
+	for (size_t ivec = 0; ivec < count; ++ivec)
+		vector_to_half4(in[ivec], out + (ivec * 4));
+}
+
+void
+vector_from_half4_array(const uint16_t* in, size_t count, vector_t* out) {
+	for (size_t ivec = 0; ivec < count; ++ivec)
+		out[ivec] = vector_from_half4(in + (ivec * 4));
+}
+
+void
+half_from_float_array(const float32_t* in, size_t count, uint16_t* out) {
+	size_t ival = 0;
+	for (; ival + 4 <= count; ival += 4)
+		vector_to_half4(vector_unaligned(in + ival), out + ival);
+	for (; ival < count; ++ival)
+		out[ival] = half_from_float(in[ival]);
+}
+
+void
+half_to_float_array(const uint16_t* in, size_t count, float32_t* out) {
+	size_t ival = 0;
+	for (; ival + 4 <= count; ival += 4) {
+		const vector_t v = vector_from_half4(in + ival);
+		memcpy(out + ival, &v, sizeof(vector_t));
+	}
+	for (; ival < count; ++ival)
+		out[ival] = half_to_float(in[ival]);
+}
@@ -0,0 +1,182 @@
+/* half.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file half.h
+    Conversion between single precision and IEEE 754 half precision values stored as 16 bit
+    integers. Conversion to half rounds to nearest even, handles subnormals, and converts
+    values that round past the largest half to infinity. NaN keeps the sign and upper payload
+    bits and is always quiet. Uses F16C or NEON conversion instructions when available, the
+    portable implementation gives bit identical results. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+#if VECTOR_IMPLEMENTATION_SSE4 && (defined(__F16C__) || (FOUNDATION_COMPILER_MSVC && defined(__AVX2__)))
+#include <immintrin.h>
+#define VECTOR_HALF_F16C 1
+#define VECTOR_HALF_NEON 0
+#elif VECTOR_IMPLEMENTATION_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#define VECTOR_HALF_F16C 0
+#define VECTOR_HALF_NEON 1
+#else
+#define VECTOR_HALF_F16C 0
+#define VECTOR_HALF_NEON 0
+#endif
+
+//! Convert float to half, rounding to nearest even
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint16_t
+half_from_float(float32_t value);
+
+//! Convert half to float, exact
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float32_t
+half_to_float(uint16_t value);
+
+//! Convert vector to four halves
+//! \param v Vector
+//! \param out Output, four halves
+static FOUNDATION_FORCEINLINE void
+vector_to_half4(const vector_t v, uint16_t* out);
+
+//! Load vector from four halves
+//! \param in Input, four halves
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector_t
+vector_from_half4(const uint16_t* in);
+
+//! Convert vectors to halves
+//! \param in Input vectors
+//! \param count Number of vectors
+//! \param out Output, four halves per vector
+VECTOR_API void
+vector_to_half4_array(const vector_t* in, size_t count, uint16_t* out);
+
+//! Load vectors from halves
+//! \param in Input, four halves per vector
+//! \param count Number of vectors
+//! \param out Output vectors
+VECTOR_API void
+vector_from_half4_array(const uint16_t* in, size_t count, vector_t* out);
+
+//! Convert floats to halves, for packed data like two component texture coordinates
+//! \param in Input floats
+//! \param count Number of floats
+//! \param out Output halves
+VECTOR_API void
+half_from_float_array(const float32_t* in, size_t count, uint16_t* out);
+
+//! Convert halves to floats
+//! \param in Input halves
+//! \param count Number of halves
+//! \param out Output floats
+VECTOR_API void
+half_to_float_array(const uint16_t* in, size_t count, float32_t* out);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint16_t
+half_from_float(float32_t value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t abs = bits & 0x7FFFFFFF;
+	if (abs >= 0x7F800000) {
+		// Infinity, or NaN with quiet bit set and payload truncated
+		const uint32_t nan = (abs > 0x7F800000) ? (0x200 | ((abs >> 13) & 0x3FF)) : 0;
+		return (uint16_t)(sign | 0x7C00 | nan);
+	}
+	if (abs >= 0x477FF000) {
+		// At or above midpoint between largest half 65504 and 65536
+		return (uint16_t)(sign | 0x7C00);
+	}
+	uint32_t result;
+	uint32_t remainder;
+	uint32_t halfway;
+	if (abs >= 0x38800000) {
+		// Normal, rebias exponent from 127 to 15. Rounding may carry into the exponent
+		result = (abs - 0x38000000) >> 13;
+		remainder = abs & 0x1FFF;
+		halfway = 0x1000;
+	} else if (abs > 0x33000000) {
+		// Subnormal, shift in the implicit bit. Rounding may give the smallest normal
+		const uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+		const uint32_t shift = 126 - (abs >> 23);
+		result = mantissa >> shift;
+		remainder = mantissa & ((1U << shift) - 1);
+		halfway = 1U << (shift - 1);
+	} else {
+		// At most half the smallest subnormal, ties round to even zero
+		return (uint16_t)sign;
+	}
+	if ((remainder > halfway) || ((remainder == halfway) && (result & 1)))
+		++result;
+	return (uint16_t)(sign | result);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float32_t
+half_to_float(uint16_t value) {
+	const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+	const uint32_t exponent = (value >> 10) & 0x1F;
+	uint32_t mantissa = value & 0x3FF;
+	uint32_t bits;
+	if (exponent == 0x1F) {
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	} else if (exponent) {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	} else if (mantissa) {
+		// Subnormal, normalize to implicit bit
+		uint32_t normal_exponent = 113;
+		while (!(mantissa & 0x400)) {
+			mantissa <<= 1;
+			--normal_exponent;
+		}
+		bits = sign | (normal_exponent << 23) | ((mantissa & 0x3FF) << 13);
+	} else {
+		bits = sign;
+	}
+	float32_t result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+static FOUNDATION_FORCEINLINE void
+vector_to_half4(const vector_t v, uint16_t* out) {
+#if VECTOR_HALF_F16C
+	_mm_storel_epi64((__m128i*)out, _mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+#elif VECTOR_HALF_NEON
+	vst1_u16(out, vreinterpret_u16_f16(vcvt_f16_f32(v)));
+#else
+	float32_t component[4];
+	memcpy(component, &v, sizeof(component));
+	out[0] = half_from_float(component[0]);
+	out[1] = half_from_float(component[1]);
+	out[2] = half_from_float(component[2]);
+	out[3] = half_from_float(component[3]);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector_t
+vector_from_half4(const uint16_t* in) {
+#if VECTOR_HALF_F16C
+	return _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)in));
+#elif VECTOR_HALF_NEON
+	return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in)));
+#else
+	return vector(half_to_float(in[0]), half_to_float(in[1]), half_to_float(in[2]), half_to_float(in[3]));
+#endif
+}
+
+#undef VECTOR_HALF_F16C
+#undef VECTOR_HALF_NEON
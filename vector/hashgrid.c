@@ -0,0 +1,413 @@
+/* hashgrid.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/hashgrid.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+#define HASHGRID_EMPTY_KEY 0xFFFFFFFFFFFFFFFFULL
+#define HASHGRID_KEY_MASK 0x1FFFFFU
+
+hashgrid_t*
+hashgrid_allocate(real cell_size) {
+	hashgrid_t* grid = memory_allocate(HASH_VECTOR, sizeof(hashgrid_t), 16, MEMORY_PERSISTENT);
+	hashgrid_initialize(grid, cell_size);
+	return grid;
+}
+
+void
+hashgrid_initialize(hashgrid_t* grid, real cell_size) {
+	FOUNDATION_ASSERT(cell_size > 0);
+	memset(grid, 0, sizeof(hashgrid_t));
+	grid->cell_size = cell_size;
+	grid->cell_size_inv = REAL_C(1.0) / cell_size;
+	grid->cell_min = vectori_zero();
+	grid->cell_max = vectori_uniform(-1);
+}
+
+void
+hashgrid_finalize(hashgrid_t* grid) {
+	memory_deallocate(grid->cell);
+	memory_deallocate(grid->item);
+	memory_deallocate(grid->point);
+	memory_deallocate(grid->bounds);
+	hashgrid_initialize(grid, grid->cell_size);
+}
+
+void
+hashgrid_deallocate(hashgrid_t* grid) {
+	if (grid)
+		hashgrid_finalize(grid);
+	memory_deallocate(grid);
+}
+
+static FOUNDATION_FORCEINLINE vectori_t
+hashgrid_cell_coordinate(const hashgrid_t* grid, const vector_t point) {
+	return vector_to_vectori_floor(vector_mul(point, vector_uniform(grid->cell_size_inv)));
+}
+
+static FOUNDATION_FORCEINLINE uint64_t
+hashgrid_key(int32_t x, int32_t y, int32_t z) {
+	return (uint64_t)((uint32_t)x & HASHGRID_KEY_MASK) | ((uint64_t)((uint32_t)y & HASHGRID_KEY_MASK) << 21) |
+	       ((uint64_t)((uint32_t)z & HASHGRID_KEY_MASK) << 42);
+}
+
+static FOUNDATION_FORCEINLINE uint32_t
+hashgrid_slot(uint64_t key, uint32_t mask) {
+	return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+static FOUNDATION_FORCEINLINE const hashgrid_cell_t*
+hashgrid_find(const hashgrid_t* grid, uint64_t key) {
+	const uint32_t mask = grid->cell_capacity - 1;
+	uint32_t slot = hashgrid_slot(key, mask);
+	while (true) {
+		const hashgrid_cell_t* cell = grid->cell + slot;
+		if (cell->key == key)
+			return cell;
+		if (cell->key == HASHGRID_EMPTY_KEY)
+			return 0;
+		slot = (slot + 1) & mask;
+	}
+}
+
+//! Find or insert cell and increment its entry count, returning slot index
+static FOUNDATION_FORCEINLINE uint32_t
+hashgrid_insert(hashgrid_t* grid, uint64_t key) {
+	const uint32_t mask = grid->cell_capacity - 1;
+	uint32_t slot = hashgrid_slot(key, mask);
+	while (true) {
+		hashgrid_cell_t* cell = grid->cell + slot;
+		if (cell->key == key) {
+			++cell->count;
+			return slot;
+		}
+		if (cell->key == HASHGRID_EMPTY_KEY) {
+			cell->key = key;
+			cell->count = 1;
+			++grid->cell_count;
+			return slot;
+		}
+		slot = (slot + 1) & mask;
+	}
+}
+
+//! Prepare storage for given number of entries and clear cell table. Table is kept at most
+//! half full so probe sequences stay short
+static void
+hashgrid_reserve(hashgrid_t* grid, uint32_t entry_count) {
+	uint32_t cell_capacity = 16;
+	while (cell_capacity < entry_count * 2)
+		cell_capacity <<= 1;
+	if (grid->cell_capacity < cell_capacity) {
+		memory_deallocate(grid->cell);
+		grid->cell = memory_allocate(HASH_VECTOR, sizeof(hashgrid_cell_t) * cell_capacity, 0, MEMORY_PERSISTENT);
+		grid->cell_capacity = cell_capacity;
+	}
+	for (uint32_t islot = 0; islot < grid->cell_capacity; ++islot)
+		grid->cell[islot].key = HASHGRID_EMPTY_KEY;
+	grid->cell_count = 0;
+
+	if (grid->entry_capacity < entry_count) {
+		memory_deallocate(grid->item);
+		memory_deallocate(grid->point);
+		memory_deallocate(grid->bounds);
+		grid->item = memory_allocate(HASH_VECTOR, sizeof(uint32_t) * entry_count, 0, MEMORY_PERSISTENT);
+		grid->point = 0;
+		grid->bounds = 0;
+		grid->entry_capacity = entry_count;
+	}
+	grid->entry_count = entry_count;
+}
+
+//! Convert cell counts to begin offsets, and reset counts to use as scatter cursors
+static void
+hashgrid_prefix_sum(hashgrid_t* grid) {
+	uint32_t sum = 0;
+	for (uint32_t islot = 0; islot < grid->cell_capacity; ++islot) {
+		hashgrid_cell_t* cell = grid->cell + islot;
+		if (cell->key == HASHGRID_EMPTY_KEY)
+			continue;
+		cell->begin = sum;
+		sum += cell->count;
+		cell->count = 0;
+	}
+}
+
+void
+hashgrid_build_points(hashgrid_t* grid, const vector_t* point, size_t count) {
+	FOUNDATION_ASSERT(count < 0x7FFFFFFF);
+	grid->type = HASHGRID_ITEM_POINT;
+	grid->count = (uint32_t)count;
+	hashgrid_reserve(grid, grid->count);
+	if (!grid->point && grid->entry_capacity)
+		grid->point = memory_allocate(HASH_VECTOR, sizeof(vector_t) * grid->entry_capacity, 16, MEMORY_PERSISTENT);
+
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	uint32_t* slot = vector_arena_allocate(arena, sizeof(uint32_t) * count, 0);
+	vectori_t cell_min = vectori_uniform(0x7FFFFFFF);
+	vectori_t cell_max = vectori_uniform(-0x7FFFFFFF);
+	for (uint32_t ipt = 0; ipt < grid->count; ++ipt) {
+		const vectori_t coord = hashgrid_cell_coordinate(grid, point[ipt]);
+		cell_min = vectori_min(cell_min, coord);
+		cell_max = vectori_max(cell_max, coord);
+		slot[ipt] = hashgrid_insert(grid, hashgrid_key(vectori_x(coord), vectori_y(coord), vectori_z(coord)));
+	}
+	grid->cell_min = cell_min;
+	grid->cell_max = cell_max;
+
+	hashgrid_prefix_sum(grid);
+	for (uint32_t ipt = 0; ipt < grid->count; ++ipt) {
+		hashgrid_cell_t* cell = grid->cell + slot[ipt];
+		const uint32_t entry = cell->begin + cell->count++;
+		grid->item[entry] = ipt;
+		grid->point[entry] = point[ipt];
+	}
+
+	vector_arena_rewind(arena, mark);
+}
+
+void
+hashgrid_build_aabb(hashgrid_t* grid, const aabb_t* bounds, size_t count) {
+	FOUNDATION_ASSERT(count < 0x7FFFFFFF);
+	grid->type = HASHGRID_ITEM_AABB;
+	grid->count = (uint32_t)count;
+
+	// Cell ranges are needed twice, once to size the tables and count entries and once to scatter
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	vectori_t* range = vector_arena_allocate(arena, sizeof(vectori_t) * 2 * count, 0);
+	vectori_t cell_min = vectori_uniform(0x7FFFFFFF);
+	vectori_t cell_max = vectori_uniform(-0x7FFFFFFF);
+	uint64_t entry_count = 0;
+	for (uint32_t ibox = 0; ibox < grid->count; ++ibox) {
+		const vectori_t box_min = hashgrid_cell_coordinate(grid, bounds[ibox].min);
+		const vectori_t box_max = hashgrid_cell_coordinate(grid, bounds[ibox].max);
+		const vectori_t span = vectori_add(vectori_sub(box_max, box_min), vectori_one());
+		range[ibox * 2] = box_min;
+		range[ibox * 2 + 1] = box_max;
+		cell_min = vectori_min(cell_min, box_min);
+		cell_max = vectori_max(cell_max, box_max);
+		entry_count += (uint64_t)vectori_x(span) * (uint64_t)vectori_y(span) * (uint64_t)vectori_z(span);
+	}
+	FOUNDATION_ASSERT(entry_count < 0x7FFFFFFF);
+	grid->cell_min = cell_min;
+	grid->cell_max = cell_max;
+
+	hashgrid_reserve(grid, (uint32_t)entry_count);
+	if (!grid->bounds && grid->entry_capacity)
+		grid->bounds = memory_allocate(HASH_VECTOR, sizeof(aabb_t) * grid->entry_capacity, 16, MEMORY_PERSISTENT);
+
+	for (uint32_t ibox = 0; ibox < grid->count; ++ibox) {
+		const vectori_t box_min = range[ibox * 2];
+		const vectori_t box_max = range[ibox * 2 + 1];
+		for (int32_t z = vectori_z(box_min); z <= vectori_z(box_max); ++z) {
+			for (int32_t y = vectori_y(box_min); y <= vectori_y(box_max); ++y) {
+				for (int32_t x = vectori_x(box_min); x <= vectori_x(box_max); ++x)
+					hashgrid_insert(grid, hashgrid_key(x, y, z));
+			}
+		}
+	}
+
+	hashgrid_prefix_sum(grid);
+	for (uint32_t ibox = 0; ibox < grid->count; ++ibox) {
+		const vectori_t box_min = range[ibox * 2];
+		const vectori_t box_max = range[ibox * 2 + 1];
+		for (int32_t z = vectori_z(box_min); z <= vectori_z(box_max); ++z) {
+			for (int32_t y = vectori_y(box_min); y <= vectori_y(box_max); ++y) {
+				for (int32_t x = vectori_x(box_min); x <= vectori_x(box_max); ++x) {
+					hashgrid_cell_t* cell = (hashgrid_cell_t*)hashgrid_find(grid, hashgrid_key(x, y, z));
+					const uint32_t entry = cell->begin + cell->count++;
+					grid->item[entry] = ibox;
+					grid->bounds[entry] = bounds[ibox];
+				}
+			}
+		}
+	}
+
+	vector_arena_rewind(arena, mark);
+}
+
+static FOUNDATION_FORCEINLINE real
+hashgrid_distance_sqr_aabb(const vector_t point, const aabb_t box) {
+	const vector_t outside =
+	    vector_max(vector_max(vector_sub(box.min, point), vector_sub(point, box.max)), vector_zero());
+	return vector_x(vector_length3_sqr(outside));
+}
+
+//! Test if entry is reported from this cell. Boxes spanning several cells are only reported
+//! from the first cell of the overlap between box and query cell ranges
+static FOUNDATION_FORCEINLINE bool
+hashgrid_is_first_cell(const hashgrid_t* grid, const aabb_t box, const vectori_t query_min, int32_t x, int32_t y,
+                       int32_t z) {
+	const vectori_t first = vectori_max(hashgrid_cell_coordinate(grid, box.min), query_min);
+	return (vectori_x(first) == x) && (vectori_y(first) == y) && (vectori_z(first) == z);
+}
+
+//! Visit entries of all occupied cells overlapping box, clamped to occupied cell range
+#define HASHGRID_FOREACH_CELL(grid, box_min, box_max, query_min, cell)                                      \
+	const vectori_t query_min = vectori_max(hashgrid_cell_coordinate(grid, box_min), (grid)->cell_min);     \
+	const vectori_t query_max = vectori_min(hashgrid_cell_coordinate(grid, box_max), (grid)->cell_max);     \
+	for (int32_t z = vectori_z(query_min); z <= vectori_z(query_max); ++z)                                  \
+		for (int32_t y = vectori_y(query_min); y <= vectori_y(query_max); ++y)                              \
+			for (int32_t x = vectori_x(query_min); x <= vectori_x(query_max); ++x)                          \
+				for (const hashgrid_cell_t* cell = hashgrid_find(grid, hashgrid_key(x, y, z)); cell; cell = 0)
+
+size_t
+hashgrid_query_radius(const hashgrid_t* grid, const vector_t center, real radius, uint32_t* item, size_t capacity) {
+	if (!grid->count)
+		return 0;
+
+	const vector_t extent = vector_uniform(radius);
+	const real radius_sqr = radius * radius;
+	size_t found = 0;
+	HASHGRID_FOREACH_CELL(grid, vector_sub(center, extent), vector_add(center, extent), query_min, cell) {
+		for (uint32_t ientry = cell->begin, end = cell->begin + cell->count; ientry < end; ++ientry) {
+			bool inside;
+			if (grid->type == HASHGRID_ITEM_POINT) {
+				inside = vector_x(vector_length3_sqr(vector_sub(grid->point[ientry], center))) <= radius_sqr;
+			} else {
+				inside = (hashgrid_distance_sqr_aabb(center, grid->bounds[ientry]) <= radius_sqr) &&
+				         hashgrid_is_first_cell(grid, grid->bounds[ientry], query_min, x, y, z);
+			}
+			if (inside) {
+				if (found < capacity)
+					item[found] = grid->item[ientry];
+				++found;
+			}
+		}
+	}
+	return found;
+}
+
+size_t
+hashgrid_query_aabb(const hashgrid_t* grid, const aabb_t box, uint32_t* item, size_t capacity) {
+	if (!grid->count)
+		return 0;
+
+	size_t found = 0;
+	HASHGRID_FOREACH_CELL(grid, box.min, box.max, query_min, cell) {
+		for (uint32_t ientry = cell->begin, end = cell->begin + cell->count; ientry < end; ++ientry) {
+			bool inside;
+			if (grid->type == HASHGRID_ITEM_POINT) {
+				inside = aabb_contains_point(box, grid->point[ientry]);
+			} else {
+				inside = aabb_overlap(box, grid->bounds[ientry]) &&
+				         hashgrid_is_first_cell(grid, grid->bounds[ientry], query_min, x, y, z);
+			}
+			if (inside) {
+				if (found < capacity)
+					item[found] = grid->item[ientry];
+				++found;
+			}
+		}
+	}
+	return found;
+}
+
+#undef HASHGRID_FOREACH_CELL
+
+//! Insert candidate in list sorted by increasing distance, dropping the farthest if full
+static FOUNDATION_FORCEINLINE void
+hashgrid_nearest_insert(uint32_t candidate, real distance_sqr, size_t k, uint32_t* item, real* distance,
+                        size_t* found) {
+	if ((*found == k) && (distance_sqr >= distance[k - 1]))
+		return;
+	for (size_t ifound = 0; ifound < *found; ++ifound) {
+		if (item[ifound] == candidate)
+			return;
+	}
+	size_t insert = (*found < k) ? (*found)++ : (k - 1);
+	while (insert && (distance[insert - 1] > distance_sqr)) {
+		distance[insert] = distance[insert - 1];
+		item[insert] = item[insert - 1];
+		--insert;
+	}
+	distance[insert] = distance_sqr;
+	item[insert] = candidate;
+}
+
+size_t
+hashgrid_query_nearest(const hashgrid_t* grid, const vector_t point, size_t k, uint32_t* item, real* distance_sqr) {
+	if (!grid->count || !k)
+		return 0;
+
+	real local_distance[16];
+	real* distance = distance_sqr;
+	if (!distance) {
+		distance = (k <= 16) ? local_distance :
+		                       memory_allocate(HASH_VECTOR, sizeof(real) * k, 0, MEMORY_TEMPORARY);
+	}
+
+	// Visit shells of cells at increasing Chebyshev distance from the query cell. After visiting
+	// shell n, any item in an unvisited cell is farther away than n cell sizes
+	const vectori_t center = hashgrid_cell_coordinate(grid, point);
+	const int32_t center_x = vectori_x(center);
+	const int32_t center_y = vectori_y(center);
+	const int32_t center_z = vectori_z(center);
+	// Shells not reaching the occupied cell range are empty and skipped
+	const vectori_t gap = vectori_max(vectori_sub(grid->cell_min, center), vectori_sub(center, grid->cell_max));
+	int32_t shell = vectori_x(gap);
+	if (vectori_y(gap) > shell)
+		shell = vectori_y(gap);
+	if (vectori_z(gap) > shell)
+		shell = vectori_z(gap);
+	if (shell < 0)
+		shell = 0;
+	size_t found = 0;
+	for (;; ++shell) {
+		const vectori_t shell_min = vectori_max(vectori_sub(center, vectori_uniform(shell)), grid->cell_min);
+		const vectori_t shell_max = vectori_min(vectori_add(center, vectori_uniform(shell)), grid->cell_max);
+		for (int32_t z = vectori_z(shell_min); z <= vectori_z(shell_max); ++z) {
+			const bool z_inner = (z != center_z - shell) && (z != center_z + shell);
+			for (int32_t y = vectori_y(shell_min); y <= vectori_y(shell_max); ++y) {
+				const bool inner = z_inner && (y != center_y - shell) && (y != center_y + shell);
+				// Inside the shell on y and z, only the two x faces belong to the shell
+				int32_t x = inner ? center_x - shell : vectori_x(shell_min);
+				const int32_t step = (inner && shell) ? 2 * shell : 1;
+				for (; x <= vectori_x(shell_max); x += step) {
+					if (x < vectori_x(shell_min))
+						continue;
+					const hashgrid_cell_t* cell = hashgrid_find(grid, hashgrid_key(x, y, z));
+					if (!cell)
+						continue;
+					for (uint32_t ientry = cell->begin, end = cell->begin + cell->count; ientry < end; ++ientry) {
+						const real candidate_distance =
+						    (grid->type == HASHGRID_ITEM_POINT) ?
+						        vector_x(vector_length3_sqr(vector_sub(grid->point[ientry], point))) :
+						        hashgrid_distance_sqr_aabb(point, grid->bounds[ientry]);
+						hashgrid_nearest_insert(grid->item[ientry], candidate_distance, k, item, distance, &found);
+					}
+				}
+			}
+		}
+
+		const real shell_distance = (real)shell * grid->cell_size;
+		if ((found == k) && (distance[k - 1] <= shell_distance * shell_distance))
+			break;
+		const vectori_t covered =
+		    vectori_and(vectori_equal(shell_min, grid->cell_min), vectori_equal(shell_max, grid->cell_max));
+		if (vectori_x(covered) && vectori_y(covered) && vectori_z(covered))
+			break;
+	}
+
+	if (distance != distance_sqr && distance != local_distance)
+		memory_deallocate(distance);
+	return found;
+}
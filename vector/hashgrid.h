@@ -0,0 +1,92 @@
+/* hashgrid.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file hashgrid.h
+    Uniform spatial hash grid for neighbour queries. Occupied cells are stored in an open
+    addressing hash table, and items are stored grouped by cell in contiguous arrays built
+    with a counting sort, so a query reads each visited cell as one linear run of memory.
+    The grid is rebuilt from scratch each time the items move, which for fully dynamic sets
+    like particles is cheaper than incremental updates. Cell coordinates wrap at 2^21 cells
+    per axis, wrapped cells only add candidates that are rejected by the exact item tests. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+
+//! Allocate and initialize grid
+//! \param cell_size Cell size, typically about the size of the query radius
+VECTOR_API hashgrid_t*
+hashgrid_allocate(real cell_size);
+
+//! Initialize grid
+//! \param grid Grid
+//! \param cell_size Cell size, typically about the size of the query radius
+VECTOR_API void
+hashgrid_initialize(hashgrid_t* grid, real cell_size);
+
+VECTOR_API void
+hashgrid_finalize(hashgrid_t* grid);
+
+VECTOR_API void
+hashgrid_deallocate(hashgrid_t* grid);
+
+//! Rebuild grid with point items, replacing any previous items. Memory is reused
+//! \param grid Grid
+//! \param point Item positions (w component ignored)
+//! \param count Number of items
+VECTOR_API void
+hashgrid_build_points(hashgrid_t* grid, const vector_t* point, size_t count);
+
+//! Rebuild grid with box items, replacing any previous items. Each box is stored in every
+//! cell it overlaps, so boxes should not be much larger than cell size. Memory is reused
+//! \param grid Grid
+//! \param bounds Item bounds
+//! \param count Number of items
+VECTOR_API void
+hashgrid_build_aabb(hashgrid_t* grid, const aabb_t* bounds, size_t count);
+
+//! Collect items within radius of a point. For box items, boxes overlapping the sphere
+//! \param grid Grid
+//! \param center Query center
+//! \param radius Query radius
+//! \param item Item index output buffer
+//! \param capacity Capacity of output buffer
+//! \return Total number of items found, can be larger than capacity
+VECTOR_API size_t
+hashgrid_query_radius(const hashgrid_t* grid, const vector_t center, real radius, uint32_t* item, size_t capacity);
+
+//! Collect items inside or overlapping a box
+//! \param grid Grid
+//! \param box Query box
+//! \param item Item index output buffer
+//! \param capacity Capacity of output buffer
+//! \return Total number of items found, can be larger than capacity
+VECTOR_API size_t
+hashgrid_query_aabb(const hashgrid_t* grid, const aabb_t box, uint32_t* item, size_t capacity);
+
+//! Find nearest items to a point, sorted by increasing distance. Distance to box items is
+//! the distance to the closest point of the box
+//! \param grid Grid
+//! \param point Query point
+//! \param k Maximum number of items to find
+//! \param item Item index output buffer, k elements
+//! \param distance_sqr Squared distance output buffer, k elements, can be null
+//! \return Number of items found, less than k only if grid holds fewer items
+VECTOR_API size_t
+hashgrid_query_nearest(const hashgrid_t* grid, const vector_t point, size_t k, uint32_t* item, real* distance_sqr);
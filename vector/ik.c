@@ -0,0 +1,337 @@
+/* ik.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/ik.h>
+#include <vector/quaternion.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+//! Relative threshold for degenerate directions
+#define IK_EPSILON REAL_C(1e-6)
+//! Margin of reach as fraction of chain length, keeping the middle joint off a straight line
+#define IK_REACH_MARGIN REAL_C(1e-4)
+
+//! Load up to four positions as component vectors, missing elements repeat the first
+static FOUNDATION_FORCEINLINE void
+ik_load(const vector_t* v, size_t remain, vector_t* out) {
+	vector_t row[4];
+	for (size_t ielem = 0; ielem < 4; ++ielem)
+		row[ielem] = v[(ielem < remain) ? ielem : 0];
+	vector_transpose4(row[0], row[1], row[2], row[3], out);
+}
+
+static FOUNDATION_FORCEINLINE void
+ik_store(const vector_t* q, size_t remain, quaternion_t* out) {
+	vector_t row[4];
+	vector_transpose4(q[0], q[1], q[2], q[3], row);
+	for (size_t ielem = 0; (ielem < 4) && (ielem < remain); ++ielem)
+		out[ielem] = row[ielem];
+}
+
+static FOUNDATION_FORCEINLINE void
+ik_sub3(const vector_t* v0, const vector_t* v1, vector_t* out) {
+	out[0] = vector_sub(v0[0], v1[0]);
+	out[1] = vector_sub(v0[1], v1[1]);
+	out[2] = vector_sub(v0[2], v1[2]);
+}
+
+static FOUNDATION_FORCEINLINE void
+ik_cross3(const vector_t* v0, const vector_t* v1, vector_t* out) {
+	const vector_t x = vector_sub(vector_mul(v0[1], v1[2]), vector_mul(v0[2], v1[1]));
+	const vector_t y = vector_sub(vector_mul(v0[2], v1[0]), vector_mul(v0[0], v1[2]));
+	const vector_t z = vector_sub(vector_mul(v0[0], v1[1]), vector_mul(v0[1], v1[0]));
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+}
+
+static FOUNDATION_FORCEINLINE void
+ik_scale3(vector_t* v, const vector_t scale) {
+	v[0] = vector_mul(v[0], scale);
+	v[1] = vector_mul(v[1], scale);
+	v[2] = vector_mul(v[2], scale);
+}
+
+//! Direction perpendicular to v, from the cross product with the x axis or the y axis
+static FOUNDATION_FORCEINLINE void
+ik_perpendicular(const vector_t* v, vector_t* out) {
+	const vector_t zero = vector_zero();
+	const vector_t yz_sqr = vector_muladd(v[1], v[1], vector_mul(v[2], v[2]));
+	const vectori_t use_y = vector_lequal(yz_sqr, vector_mul(vector_soa_dot3(v, v), vector_uniform(IK_EPSILON)));
+	out[0] = vector_select(use_y, vector_neg(v[2]), zero);
+	out[1] = vector_select(use_y, zero, v[2]);
+	out[2] = vector_select(use_y, v[0], vector_neg(v[1]));
+}
+
+//! Shortest arc rotation from one direction to another, half a turn for opposite directions
+static FOUNDATION_FORCEINLINE void
+ik_rotating(const vector_t* from, const vector_t* to, vector_t* q) {
+	const vector_t zero = vector_zero();
+	const vector_t scale = vector_sqrt(vector_mul(vector_soa_dot3(from, from), vector_soa_dot3(to, to)));
+	const vector_t w = vector_add(scale, vector_soa_dot3(from, to));
+	const vectori_t opposite = vector_lequal(w, vector_mul(scale, vector_uniform(IK_EPSILON)));
+	vector_t axis[3];
+	vector_t perpendicular[3];
+	ik_cross3(from, to, axis);
+	ik_perpendicular(from, perpendicular);
+	q[0] = vector_select(opposite, perpendicular[0], axis[0]);
+	q[1] = vector_select(opposite, perpendicular[1], axis[1]);
+	q[2] = vector_select(opposite, perpendicular[2], axis[2]);
+	q[3] = vector_select(opposite, zero, w);
+	quaternion_soa_normalize(q);
+}
+
+//! Rotate v by q, v + w * t + cross(q, t) where t = 2 * cross(q, v)
+static FOUNDATION_FORCEINLINE void
+ik_rotate(const vector_t* q, const vector_t* v, vector_t* out) {
+	vector_t t[3];
+	vector_t c[3];
+	ik_cross3(q, v, t);
+	ik_scale3(t, vector_two());
+	ik_cross3(q, t, c);
+	out[0] = vector_add(vector_muladd(q[3], t[0], v[0]), c[0]);
+	out[1] = vector_add(vector_muladd(q[3], t[1], v[1]), c[1]);
+	out[2] = vector_add(vector_muladd(q[3], t[2], v[2]), c[2]);
+}
+
+//! Component of v perpendicular to unit direction, normalized. Lanes where the component is
+//! too short keep the fallback direction
+static FOUNDATION_FORCEINLINE void
+ik_bend_direction(const vector_t* v, const vector_t* direction, vector_t* bend) {
+	const vector_t along = vector_soa_dot3(v, direction);
+	vector_t perpendicular[3];
+	perpendicular[0] = vector_sub(v[0], vector_mul(direction[0], along));
+	perpendicular[1] = vector_sub(v[1], vector_mul(direction[1], along));
+	perpendicular[2] = vector_sub(v[2], vector_mul(direction[2], along));
+	const vector_t length_sqr = vector_soa_dot3(perpendicular, perpendicular);
+	const vectori_t valid = vector_greater(length_sqr, vector_mul(vector_soa_dot3(v, v), vector_uniform(IK_EPSILON)));
+	ik_scale3(perpendicular, vector_div(vector_one(), vector_sqrt(vector_select(valid, length_sqr, vector_one()))));
+	bend[0] = vector_select(valid, perpendicular[0], bend[0]);
+	bend[1] = vector_select(valid, perpendicular[1], bend[1]);
+	bend[2] = vector_select(valid, perpendicular[2], bend[2]);
+}
+
+void
+ik_two_bone(const vector_t* root, const vector_t* mid, const vector_t* end, const vector_t* target,
+            const vector_t* pole, size_t count, quaternion_t* root_rotation, quaternion_t* mid_rotation) {
+	const vector_t one = vector_one();
+	for (size_t ichain = 0; ichain < count; ichain += 4) {
+		const size_t remain = count - ichain;
+		vector_t r[4];
+		vector_t m[4];
+		vector_t e[4];
+		vector_t t[4];
+		vector_t p[4];
+		ik_load(root + ichain, remain, r);
+		ik_load(mid + ichain, remain, m);
+		ik_load(end + ichain, remain, e);
+		ik_load(target + ichain, remain, t);
+		ik_load(pole + ichain, remain, p);
+
+		vector_t ab[3];
+		vector_t bc[3];
+		vector_t at[3];
+		ik_sub3(m, r, ab);
+		ik_sub3(e, m, bc);
+		ik_sub3(t, r, at);
+		const vector_t a_sqr = vector_soa_dot3(ab, ab);
+		const vector_t b_sqr = vector_soa_dot3(bc, bc);
+		const vector_t a = vector_sqrt(a_sqr);
+		const vector_t b = vector_sqrt(b_sqr);
+		const vector_t reach = vector_add(a, b);
+		const vector_t margin = vector_mul(reach, vector_uniform(IK_REACH_MARGIN));
+		const vector_t target_distance = vector_sqrt(vector_soa_dot3(at, at));
+		const vector_t min_distance = vector_add(vector_abs(vector_sub(a, b)), margin);
+		const vector_t c = vector_min(vector_max(target_distance, min_distance), vector_sub(reach, margin));
+
+		// Direction to target, or along the first bone for targets at the root
+		const vectori_t at_root = vector_lequal(target_distance, margin);
+		vector_t direction[3];
+		direction[0] = vector_select(at_root, ab[0], at[0]);
+		direction[1] = vector_select(at_root, ab[1], at[1]);
+		direction[2] = vector_select(at_root, ab[2], at[2]);
+		ik_scale3(direction, vector_div(one, vector_sqrt(vector_soa_dot3(direction, direction))));
+
+		// Bend towards pole, falling back to the current middle joint and then any perpendicular
+		vector_t bend[3];
+		ik_perpendicular(direction, bend);
+		ik_scale3(bend, vector_div(one, vector_sqrt(vector_soa_dot3(bend, bend))));
+		ik_bend_direction(ab, direction, bend);
+		ik_bend_direction(p, direction, bend);
+
+		// Law of cosines for the angle between the first bone and the target direction
+		vector_t cos_angle = vector_div(vector_sub(vector_add(a_sqr, vector_mul(c, c)), b_sqr),
+		                                vector_mul(vector_two(), vector_mul(a, c)));
+		cos_angle = vector_min(vector_max(cos_angle, vector_neg(one)), one);
+		const vector_t sin_angle = vector_sqrt(vector_max(vector_sub(one, vector_mul(cos_angle, cos_angle)),
+		                                                  vector_zero()));
+		const vector_t along = vector_mul(a, cos_angle);
+		const vector_t across = vector_mul(a, sin_angle);
+		vector_t new_ab[3];
+		vector_t new_bc[3];
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			new_ab[icomp] = vector_muladd(direction[icomp], along, vector_mul(bend[icomp], across));
+			new_bc[icomp] = vector_sub(vector_mul(direction[icomp], c), new_ab[icomp]);
+		}
+
+		// Rotate first bone into place, then the second bone as moved by the first rotation
+		vector_t q0[4];
+		vector_t q1[4];
+		vector_t rotated_bc[3];
+		ik_rotating(ab, new_ab, q0);
+		ik_rotate(q0, bc, rotated_bc);
+		ik_rotating(rotated_bc, new_bc, q1);
+		quaternion_soa_mul(q1, q0, q1);
+		ik_store(q0, remain, root_rotation + ichain);
+		ik_store(q1, remain, mid_rotation + ichain);
+	}
+}
+
+static FOUNDATION_FORCEINLINE vector_t
+ik_point(const vector_t v) {
+	return vector(vector_x(v), vector_y(v), vector_z(v), 0);
+}
+
+static FOUNDATION_FORCEINLINE real
+ik_distance(const vector_t v0, const vector_t v1) {
+	return vector_x(vector_length3(vector_sub(v0, v1)));
+}
+
+//! Hamilton product q0 * q1, rotating by q1 then q0
+static FOUNDATION_FORCEINLINE quaternion_t
+ik_quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
+	return quaternion_normalize(quaternion_mul(q0, q1));
+}
+
+//! Rotate position around pivot by q
+static FOUNDATION_FORCEINLINE vector_t
+ik_rotate_around(const quaternion_t q, const vector_t pivot, const vector_t position) {
+	const vector_t r = quaternion_rotate(q, ik_point(vector_sub(position, pivot)));
+	return vector(vector_x(pivot) + vector_x(r), vector_y(pivot) + vector_y(r), vector_z(pivot) + vector_z(r),
+	              vector_w(position));
+}
+
+//! Shortest arc rotation, half a turn for opposite directions
+static quaternion_t
+ik_rotation(const vector_t from, const vector_t to) {
+	const real scale = math_sqrt(vector_x(vector_length3_sqr(from)) * vector_x(vector_length3_sqr(to)));
+	if (scale + vector_x(vector_dot3(from, to)) > scale * IK_EPSILON)
+		return quaternion_rotating_vector(from, to);
+	// Axis perpendicular to from, from the cross product with the x axis or the y axis
+	const real x = vector_x(from);
+	const real y = vector_y(from);
+	const real z = vector_z(from);
+	if (y * y + z * z <= vector_x(vector_length3_sqr(from)) * IK_EPSILON)
+		return quaternion_normalize(vector(-z, 0, x, 0));
+	return quaternion_normalize(vector(0, z, -y, 0));
+}
+
+//! Move joints to solved positions, rotating each joint by the change of direction of its bone
+static void
+ik_update(transform_t* joint, const vector_t* position, size_t joint_count) {
+	quaternion_t delta = quaternion_identity();
+	for (size_t ijoint = 0; ijoint < joint_count; ++ijoint) {
+		if (ijoint + 1 < joint_count) {
+			const vector_t from = vector_sub(joint[ijoint + 1].translation, joint[ijoint].translation);
+			delta = ik_rotation(ik_point(from), vector_sub(position[ijoint + 1], position[ijoint]));
+		}
+		joint[ijoint].rotation = ik_quaternion_mul(delta, joint[ijoint].rotation);
+		joint[ijoint].translation = vector(vector_x(position[ijoint]), vector_y(position[ijoint]),
+		                                   vector_z(position[ijoint]), vector_w(joint[ijoint].translation));
+	}
+}
+
+//! Point at distance from anchor in the direction of toward
+static FOUNDATION_FORCEINLINE vector_t
+ik_reach(const vector_t anchor, const vector_t toward, real distance) {
+	const vector_t direction = vector_sub(toward, anchor);
+	const real length = vector_x(vector_length3(direction));
+	if (length <= 0)
+		return toward;
+	return vector_add(anchor, vector_scale(direction, distance / length));
+}
+
+unsigned int
+ik_fabrik(transform_t* joint, size_t joint_count, const vector_t target, real tolerance,
+          unsigned int max_iterations) {
+	if ((joint_count < 2) || !max_iterations)
+		return 0;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	vector_t* position = vector_arena_allocate(arena, sizeof(vector_t) * joint_count, 0);
+	real* length = vector_arena_allocate(arena, sizeof(real) * joint_count, 0);
+
+	const size_t last = joint_count - 1;
+	real total_length = 0;
+	for (size_t ijoint = 0; ijoint < joint_count; ++ijoint)
+		position[ijoint] = ik_point(joint[ijoint].translation);
+	for (size_t ijoint = 0; ijoint < last; ++ijoint) {
+		length[ijoint] = ik_distance(position[ijoint + 1], position[ijoint]);
+		total_length += length[ijoint];
+	}
+
+	const vector_t root = position[0];
+	const vector_t goal = ik_point(target);
+	unsigned int iteration = 0;
+	if (ik_distance(goal, root) >= total_length) {
+		// Unreachable, stretch the chain towards the target
+		for (size_t ijoint = 0; ijoint < last; ++ijoint)
+			position[ijoint + 1] = ik_reach(position[ijoint], goal, length[ijoint]);
+		iteration = 1;
+	} else {
+		while ((iteration < max_iterations) && (ik_distance(position[last], goal) > tolerance)) {
+			++iteration;
+			// Backward from the target, then forward from the root
+			position[last] = goal;
+			for (size_t ijoint = last; ijoint > 0; --ijoint)
+				position[ijoint - 1] = ik_reach(position[ijoint], position[ijoint - 1], length[ijoint - 1]);
+			position[0] = root;
+			for (size_t ijoint = 1; ijoint <= last; ++ijoint)
+				position[ijoint] = ik_reach(position[ijoint - 1], position[ijoint], length[ijoint - 1]);
+		}
+	}
+
+	ik_update(joint, position, joint_count);
+	vector_arena_rewind(arena, mark);
+	return iteration;
+}
+
+unsigned int
+ik_ccd(transform_t* joint, size_t joint_count, const vector_t target, real tolerance, unsigned int max_iterations) {
+	if (joint_count < 2)
+		return 0;
+	const size_t last = joint_count - 1;
+	const vector_t goal = ik_point(target);
+	unsigned int iteration = 0;
+	while ((iteration < max_iterations) && (ik_distance(joint[last].translation, goal) > tolerance)) {
+		++iteration;
+		for (size_t ijoint = last; ijoint-- > 0;) {
+			const vector_t pivot = ik_point(joint[ijoint].translation);
+			const vector_t to_end = vector_sub(ik_point(joint[last].translation), pivot);
+			const vector_t to_goal = vector_sub(goal, pivot);
+			const real length_sqr = vector_x(vector_length3_sqr(to_end)) * vector_x(vector_length3_sqr(to_goal));
+			if (length_sqr <= 0)
+				continue;
+			const quaternion_t delta = ik_rotation(to_end, to_goal);
+			joint[ijoint].rotation = ik_quaternion_mul(delta, joint[ijoint].rotation);
+			for (size_t ichild = ijoint + 1; ichild <= last; ++ichild) {
+				joint[ichild].rotation = ik_quaternion_mul(delta, joint[ichild].rotation);
+				joint[ichild].translation = ik_rotate_around(delta, pivot, joint[ichild].translation);
+			}
+		}
+	}
+	return iteration;
+}
@@ -0,0 +1,71 @@
+/* ik.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file ik.h
+    Inverse kinematics solvers. All positions and rotations are in a common space, usually model
+    space, and resulting rotations are deltas to multiply onto the current rotation of each joint
+    with the Hamilton product delta * rotation.
+
+    The two bone solver is analytic and solves four chains at a time, bending the middle joint
+    towards a pole vector. FABRIK and CCD solve one chain of any length iteratively, where joint
+    chains are transforms with the joint position in translation. Both stop when the end joint
+    is within tolerance of the target or after the maximum number of iterations. Unreachable
+    targets give a chain stretched towards the target. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Solve two bone chains analytically. Bone lengths are kept, the end joint is placed at the
+//! target clamped to the reach of the chain, and the middle joint bends in the plane of the
+//! target direction and the pole vector. Middle joint rotation includes the root rotation
+//! \param root Root joint positions
+//! \param mid Middle joint positions
+//! \param end End joint positions
+//! \param target Target positions
+//! \param pole Pole vectors, direction to bend the middle joint towards
+//! \param count Number of chains
+//! \param root_rotation Output rotation deltas of root joints
+//! \param mid_rotation Output rotation deltas of middle joints
+VECTOR_API void
+ik_two_bone(const vector_t* root, const vector_t* mid, const vector_t* end, const vector_t* target,
+            const vector_t* pole, size_t count, quaternion_t* root_rotation, quaternion_t* mid_rotation);
+
+//! Solve chain with forward and backward reaching, FABRIK. Joint positions and rotations are
+//! updated in place, the root joint does not move
+//! \param joint Joint transforms from root to end joint
+//! \param joint_count Number of joints
+//! \param target Target position
+//! \param tolerance Max distance from end joint to target
+//! \param max_iterations Max number of iterations, zero leaves the chain unchanged
+//! \return Number of iterations used, one for an unreachable target
+VECTOR_API unsigned int
+ik_fabrik(transform_t* joint, size_t joint_count, const vector_t target, real tolerance,
+          unsigned int max_iterations);
+
+//! Solve chain with cyclic coordinate descent, CCD. Each iteration rotates every joint from the
+//! end towards the root to point the end joint at the target. Joint positions and rotations are
+//! updated in place, the root joint does not move
+//! \param joint Joint transforms from root to end joint
+//! \param joint_count Number of joints
+//! \param target Target position
+//! \param tolerance Max distance from end joint to target
+//! \param max_iterations Max number of iterations
+//! \return Number of iterations used
+VECTOR_API unsigned int
+ik_ccd(transform_t* joint, size_t joint_count, const vector_t target, real tolerance, unsigned int max_iterations);
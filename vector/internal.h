@@ -25,4 +25,98 @@
 #include <foundation/internal.h>
 
 #include <vector/types.h>
+#include <vector/vector.h>
 #include <vector/hashstrings.h>
+
+//! Start worker threads for parallel jobs as configured
+int
+vector_job_initialize(const vector_config_t config);
+
+//! Stop worker threads
+void
+vector_job_finalize(void);
+
+//! Set default size of thread arenas as configured
+int
+vector_arena_module_initialize(const vector_config_t config);
+
+//! Release thread arenas and pooled blocks
+void
+vector_arena_module_finalize(void);
+
+//! Cyclic Jacobi eigen decomposition of the upper left dim x dim part of a symmetric matrix
+//! \param m Symmetric matrix
+//! \param dim Dimension, 2 to 4
+//! \param eigenvalues Output eigenvalues in the first dim components, unsorted, others zero
+//! \param eigenvectors Output unit eigenvectors, row i for eigenvalue i. Rows past dim are identity
+void
+matrix_jacobi_symmetric(const matrix_t m, int dim, vector_t* eigenvalues, matrix_t* eigenvectors);
+
+//! Transpose 4x4, rows in and columns out. The transpose is its own inverse
+static FOUNDATION_FORCEINLINE void
+vector_transpose4(const vector_t v0, const vector_t v1, const vector_t v2, const vector_t v3, vector_t* col) {
+	const vector_t xy01 = vector_shuffle2(v0, v1, VECTOR_MASK(0, 1, 0, 1));
+	const vector_t xy23 = vector_shuffle2(v2, v3, VECTOR_MASK(0, 1, 0, 1));
+	const vector_t zw01 = vector_shuffle2(v0, v1, VECTOR_MASK(2, 3, 2, 3));
+	const vector_t zw23 = vector_shuffle2(v2, v3, VECTOR_MASK(2, 3, 2, 3));
+	col[0] = vector_shuffle2(xy01, xy23, VECTOR_MASK(0, 2, 0, 2));
+	col[1] = vector_shuffle2(xy01, xy23, VECTOR_MASK(1, 3, 1, 3));
+	col[2] = vector_shuffle2(zw01, zw23, VECTOR_MASK(0, 2, 0, 2));
+	col[3] = vector_shuffle2(zw01, zw23, VECTOR_MASK(1, 3, 1, 3));
+}
+
+//! Dot product of three component vectors, four elements per lane
+static FOUNDATION_FORCEINLINE vector_t
+vector_soa_dot3(const vector_t* v0, const vector_t* v1) {
+	return vector_muladd(v0[2], v1[2], vector_muladd(v0[1], v1[1], vector_mul(v0[0], v1[0])));
+}
+
+//! Dot product of quaternions stored as four component vectors, one quaternion per lane
+static FOUNDATION_FORCEINLINE vector_t
+quaternion_soa_dot(const vector_t* q0, const vector_t* q1) {
+	return vector_muladd(q0[3], q1[3], vector_soa_dot3(q0, q1));
+}
+
+static FOUNDATION_FORCEINLINE void
+quaternion_soa_normalize(vector_t* q) {
+	const vector_t inv_length = vector_div(vector_one(), vector_sqrt(quaternion_soa_dot(q, q)));
+	q[0] = vector_mul(q[0], inv_length);
+	q[1] = vector_mul(q[1], inv_length);
+	q[2] = vector_mul(q[2], inv_length);
+	q[3] = vector_mul(q[3], inv_length);
+}
+
+//! Hamilton product q0 * q1 of component vectors, rotating by q1 then q0. Output may alias input
+static FOUNDATION_FORCEINLINE void
+quaternion_soa_mul(const vector_t* q0, const vector_t* q1, vector_t* out) {
+	const vector_t x = vector_sub(vector_muladd(q0[3], q1[0], vector_muladd(q0[0], q1[3], vector_mul(q0[1], q1[2]))),
+	                              vector_mul(q0[2], q1[1]));
+	const vector_t y = vector_sub(vector_muladd(q0[3], q1[1], vector_muladd(q0[1], q1[3], vector_mul(q0[2], q1[0]))),
+	                              vector_mul(q0[0], q1[2]));
+	const vector_t z = vector_sub(vector_muladd(q0[3], q1[2], vector_muladd(q0[2], q1[3], vector_mul(q0[0], q1[1]))),
+	                              vector_mul(q0[1], q1[0]));
+	const vector_t w = vector_sub(vector_mul(q0[3], q1[3]), vector_soa_dot3(q0, q1));
+	out[0] = x;
+	out[1] = y;
+	out[2] = z;
+	out[3] = w;
+}
+
+//! Normalized lerp of component vectors with q1 negated in lanes where it is in the opposite
+//! hemisphere of q0. Output may alias input
+static FOUNDATION_FORCEINLINE void
+quaternion_soa_nlerp(const vector_t* q0, const vector_t* q1, const vector_t factor, vector_t* out) {
+	const vectori_t opposite = vector_less(quaternion_soa_dot(q0, q1), vector_zero());
+	for (int icomp = 0; icomp < 4; ++icomp) {
+		const vector_t target = vector_select(opposite, vector_neg(q1[icomp]), q1[icomp]);
+		out[icomp] = vector_muladd(vector_sub(target, q0[icomp]), factor, q0[icomp]);
+	}
+	quaternion_soa_normalize(out);
+}
+
+//! Lerp of four component vectors. Output may alias input
+static FOUNDATION_FORCEINLINE void
+vector_soa_lerp(const vector_t* v0, const vector_t* v1, const vector_t factor, vector_t* out) {
+	for (int icomp = 0; icomp < 4; ++icomp)
+		out[icomp] = vector_muladd(vector_sub(v1[icomp], v0[icomp]), factor, v0[icomp]);
+}
@@ -0,0 +1,306 @@
+/* job.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/job.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+#include <foundation/atomic.h>
+#include <foundation/thread.h>
+#include <foundation/semaphore.h>
+#include <foundation/time.h>
+
+#define VECTOR_JOB_MAX_THREADS 64
+#define VECTOR_JOB_DEFAULT_GRAIN 1024
+#define VECTOR_JOB_DEQUE_SIZE 256
+#define VECTOR_JOB_DEQUE_MASK (VECTOR_JOB_DEQUE_SIZE - 1)
+#define VECTOR_JOB_SPIN_COUNT 64
+
+typedef struct vector_job_t vector_job_t;
+typedef struct vector_job_deque_t vector_job_deque_t;
+
+//! Job being executed, lives on the stack of the submitting thread
+struct vector_job_t {
+	vector_job_fn fn;
+	void* context;
+	size_t grain;
+	bool timed;
+	//! Number of items not yet processed, job is done when this reaches zero
+	atomic64_t remaining;
+	atomic64_t busy;
+	atomic32_t ranges;
+	atomic32_t stolen;
+};
+
+//! Fixed capacity Chase-Lev deque of packed ranges. The owning thread pushes and pops at
+//! the bottom, other threads steal from the top. Top and bottom are kept on separate cache
+//! lines as they are written by different threads
+FOUNDATION_ALIGNED_STRUCT(vector_job_deque_t, 64) {
+	atomic64_t top;
+	char top_padding[64 - sizeof(atomic64_t)];
+	atomic64_t bottom;
+	char bottom_padding[64 - sizeof(atomic64_t)];
+	atomic64_t slot[VECTOR_JOB_DEQUE_SIZE];
+};
+
+//! Deque per thread, index zero used by the thread currently submitting a job
+static vector_job_deque_t* vector_job_deque;
+static thread_t* vector_job_thread;
+static unsigned int vector_job_thread_total = 1;
+static size_t vector_job_grain = VECTOR_JOB_DEFAULT_GRAIN;
+static vector_job_timing_fn vector_job_timing;
+static atomicptr_t vector_job_current;
+static atomic32_t vector_job_submitting;
+static atomic32_t vector_job_sleeping;
+static atomic32_t vector_job_terminate;
+static semaphore_t vector_job_wakeup;
+
+//! Deque index of worker threads, zero for all other threads
+FOUNDATION_DECLARE_THREAD_LOCAL(unsigned int, vector_job_index, 0)
+
+static FOUNDATION_FORCEINLINE uint64_t
+vector_job_pack(size_t begin, size_t end) {
+	return ((uint64_t)begin << 32) | (uint64_t)end;
+}
+
+static bool
+vector_job_push(vector_job_deque_t* deque, uint64_t range) {
+	const int64_t bottom = atomic_load64(&deque->bottom, memory_order_relaxed);
+	const int64_t top = atomic_load64(&deque->top, memory_order_acquire);
+	if (bottom - top >= VECTOR_JOB_DEQUE_SIZE)
+		return false;
+	atomic_store64(&deque->slot[bottom & VECTOR_JOB_DEQUE_MASK], (int64_t)range, memory_order_relaxed);
+	atomic_store64(&deque->bottom, bottom + 1, memory_order_release);
+	return true;
+}
+
+static bool
+vector_job_pop(vector_job_deque_t* deque, uint64_t* range) {
+	const int64_t bottom = atomic_load64(&deque->bottom, memory_order_relaxed) - 1;
+	atomic_store64(&deque->bottom, bottom, memory_order_relaxed);
+	atomic_thread_fence_sequentially_consistent();
+	const int64_t top = atomic_load64(&deque->top, memory_order_relaxed);
+	if (top > bottom) {
+		atomic_store64(&deque->bottom, bottom + 1, memory_order_relaxed);
+		return false;
+	}
+	*range = (uint64_t)atomic_load64(&deque->slot[bottom & VECTOR_JOB_DEQUE_MASK], memory_order_relaxed);
+	if (top < bottom)
+		return true;
+	// Last range, race against thieves for it
+	const bool acquired = atomic_cas64(&deque->top, top + 1, top, memory_order_seq_cst, memory_order_relaxed);
+	atomic_store64(&deque->bottom, bottom + 1, memory_order_relaxed);
+	return acquired;
+}
+
+static bool
+vector_job_steal(vector_job_deque_t* deque, uint64_t* range) {
+	const int64_t top = atomic_load64(&deque->top, memory_order_acquire);
+	atomic_thread_fence_sequentially_consistent();
+	const int64_t bottom = atomic_load64(&deque->bottom, memory_order_acquire);
+	if (top >= bottom)
+		return false;
+	// Slot cannot be overwritten while top is unchanged, since pushes never wrap past top
+	*range = (uint64_t)atomic_load64(&deque->slot[top & VECTOR_JOB_DEQUE_MASK], memory_order_relaxed);
+	return atomic_cas64(&deque->top, top + 1, top, memory_order_seq_cst, memory_order_relaxed);
+}
+
+//! Take a range from own deque, or steal one from another thread starting at a random victim
+static bool
+vector_job_find(unsigned int index, uint32_t* seed, uint64_t* range) {
+	if (vector_job_pop(vector_job_deque + index, range))
+		return true;
+	*seed = (*seed * 1664525U) + 1013904223U;
+	const unsigned int first = (*seed >> 16) % vector_job_thread_total;
+	for (unsigned int ivictim = 0; ivictim < vector_job_thread_total; ++ivictim) {
+		const unsigned int victim = (first + ivictim) % vector_job_thread_total;
+		if ((victim != index) && vector_job_steal(vector_job_deque + victim, range))
+			return true;
+	}
+	return false;
+}
+
+static void
+vector_job_wake(void) {
+	atomic_thread_fence_sequentially_consistent();
+	if (atomic_load32(&vector_job_sleeping, memory_order_relaxed) > 0)
+		semaphore_post(&vector_job_wakeup);
+}
+
+static void
+vector_job_execute(vector_job_t* job, unsigned int index, uint64_t range) {
+	const size_t begin = (size_t)(range >> 32);
+	size_t end = (size_t)(range & 0xFFFFFFFFULL);
+	// Split off upper halves for other threads to steal, keep working on the lower half
+	while ((end - begin) > job->grain) {
+		const size_t mid = begin + ((end - begin) / 2);
+		if (!vector_job_push(vector_job_deque + index, vector_job_pack(mid, end)))
+			break;
+		end = mid;
+		vector_job_wake();
+	}
+
+	if (job->timed) {
+		const tick_t start = time_current();
+		job->fn(job->context, begin, end);
+		atomic_add64(&job->busy, time_elapsed_ticks(start), memory_order_relaxed);
+		atomic_incr32(&job->ranges, memory_order_relaxed);
+		if (index)
+			atomic_incr32(&job->stolen, memory_order_relaxed);
+	} else {
+		job->fn(job->context, begin, end);
+	}
+	// Job is owned by the submitting thread and must not be accessed after this
+	atomic_add64(&job->remaining, -(int64_t)(end - begin), memory_order_release);
+}
+
+static void*
+vector_job_worker(void* arg) {
+	const unsigned int index = (unsigned int)(uintptr_t)arg;
+	set_thread_vector_job_index(index);
+	uint32_t seed = index;
+	unsigned int idle = 0;
+	while (!atomic_load32(&vector_job_terminate, memory_order_acquire)) {
+		uint64_t range;
+		bool found = vector_job_find(index, &seed, &range);
+		if (!found) {
+			if (++idle < VECTOR_JOB_SPIN_COUNT) {
+				thread_yield();
+				continue;
+			}
+			// Check again after announcing sleep so a concurrent wake is not missed
+			atomic_incr32(&vector_job_sleeping, memory_order_seq_cst);
+			found = vector_job_find(index, &seed, &range);
+			if (!found)
+				semaphore_wait(&vector_job_wakeup);
+			atomic_decr32(&vector_job_sleeping, memory_order_seq_cst);
+		}
+		idle = 0;
+		if (found) {
+			// Job cannot complete while this range is held, so the current job is the one it belongs to
+			vector_job_t* job = atomic_loadptr(&vector_job_current, memory_order_acquire);
+			vector_job_execute(job, index, range);
+		}
+	}
+	return 0;
+}
+
+int
+vector_job_initialize(const vector_config_t config) {
+	vector_job_thread_total = config.thread_count ? config.thread_count : 1;
+	if (vector_job_thread_total > VECTOR_JOB_MAX_THREADS)
+		vector_job_thread_total = VECTOR_JOB_MAX_THREADS;
+	vector_job_grain = config.grain_size ? config.grain_size : VECTOR_JOB_DEFAULT_GRAIN;
+	vector_job_timing = config.job_timing;
+	atomic_storeptr(&vector_job_current, 0, memory_order_relaxed);
+	atomic_store32(&vector_job_submitting, 0, memory_order_relaxed);
+	atomic_store32(&vector_job_sleeping, 0, memory_order_relaxed);
+	atomic_store32(&vector_job_terminate, 0, memory_order_relaxed);
+	if (vector_job_thread_total < 2)
+		return 0;
+
+	vector_job_deque = memory_allocate(HASH_VECTOR, sizeof(vector_job_deque_t) * vector_job_thread_total, 64,
+	                                   MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	vector_job_thread = memory_allocate(HASH_VECTOR, sizeof(thread_t) * vector_job_thread_total, 0,
+	                                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	semaphore_initialize(&vector_job_wakeup, 0);
+	for (unsigned int ithread = 1; ithread < vector_job_thread_total; ++ithread) {
+		thread_initialize(vector_job_thread + ithread, vector_job_worker, (void*)(uintptr_t)ithread,
+		                  STRING_CONST("vector_job"), THREAD_PRIORITY_NORMAL, 0);
+		if (!thread_start(vector_job_thread + ithread)) {
+			thread_finalize(vector_job_thread + ithread);
+			vector_job_thread_total = ithread;
+			break;
+		}
+	}
+	return 0;
+}
+
+void
+vector_job_finalize(void) {
+	if (vector_job_thread_total > 1) {
+		atomic_store32(&vector_job_terminate, 1, memory_order_release);
+		for (unsigned int ithread = 1; ithread < vector_job_thread_total; ++ithread)
+			semaphore_post(&vector_job_wakeup);
+		for (unsigned int ithread = 1; ithread < vector_job_thread_total; ++ithread) {
+			thread_join(vector_job_thread + ithread);
+			thread_finalize(vector_job_thread + ithread);
+		}
+		semaphore_finalize(&vector_job_wakeup);
+		memory_deallocate(vector_job_thread);
+		memory_deallocate(vector_job_deque);
+	}
+	vector_job_thread = 0;
+	vector_job_deque = 0;
+	vector_job_thread_total = 1;
+	vector_job_grain = VECTOR_JOB_DEFAULT_GRAIN;
+	vector_job_timing = 0;
+}
+
+void
+vector_parallel_for(const char* name, size_t length, vector_job_fn fn, void* context, size_t count, size_t grain) {
+	if (!count)
+		return;
+	FOUNDATION_ASSERT(count <= 0xFFFFFFFFULL);
+
+	vector_job_t job;
+	job.fn = fn;
+	job.context = context;
+	job.grain = grain ? grain : vector_job_grain;
+	job.timed = (vector_job_timing != 0);
+	atomic_store64(&job.remaining, (int64_t)count, memory_order_relaxed);
+	atomic_store64(&job.busy, 0, memory_order_relaxed);
+	atomic_store32(&job.ranges, 0, memory_order_relaxed);
+	atomic_store32(&job.stolen, 0, memory_order_relaxed);
+	const tick_t start = job.timed ? time_current() : 0;
+
+	if ((vector_job_thread_total > 1) && (count > job.grain) && !get_thread_vector_job_index() &&
+	    atomic_cas32(&vector_job_submitting, 1, 0, memory_order_acquire, memory_order_relaxed)) {
+		atomic_storeptr(&vector_job_current, &job, memory_order_release);
+		vector_job_push(vector_job_deque, vector_job_pack(0, count));
+		uint32_t seed = 0;
+		while (atomic_load64(&job.remaining, memory_order_acquire) > 0) {
+			uint64_t range;
+			if (vector_job_find(0, &seed, &range))
+				vector_job_execute(&job, 0, range);
+			else
+				thread_yield();
+		}
+		atomic_storeptr(&vector_job_current, 0, memory_order_relaxed);
+		atomic_store32(&vector_job_submitting, 0, memory_order_release);
+	} else {
+		fn(context, 0, count);
+		if (job.timed) {
+			atomic_store64(&job.busy, time_elapsed_ticks(start), memory_order_relaxed);
+			atomic_store32(&job.ranges, 1, memory_order_relaxed);
+		}
+	}
+
+	if (job.timed) {
+		vector_job_timing_t timing;
+		timing.elapsed = time_elapsed_ticks(start);
+		timing.busy = atomic_load64(&job.busy, memory_order_relaxed);
+		timing.count = count;
+		timing.ranges = (uint32_t)atomic_load32(&job.ranges, memory_order_relaxed);
+		timing.stolen = (uint32_t)atomic_load32(&job.stolen, memory_order_relaxed);
+		vector_job_timing(name, length, &timing);
+	}
+}
+
+unsigned int
+vector_job_thread_count(void) {
+	return vector_job_thread_total;
+}
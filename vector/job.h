@@ -0,0 +1,45 @@
+/* job.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file job.h
+    Parallel for loops over item ranges for batch kernels. Worker threads are started by
+    vector_module_initialize when the configured thread count is larger than one. Each thread owns
+    a lock free work stealing deque. A range is split in halves until reaching the grain size, the
+    owning thread keeps working on the lower half while idle threads steal the upper halves from
+    the opposite end of the deque. The submitting thread participates in the work and the call
+    returns when all items are processed. Only one thread at a time can distribute work to the
+    workers, parallel for calls made while a job is running, including nested calls from inside
+    job functions, run directly on the calling thread. */
+
+#include <vector/types.h>
+
+//! Process items [0, count) by calling function on disjoint ranges, possibly in parallel
+//! \param name Job name passed to the timing callback
+//! \param length Length of name
+//! \param fn Range function
+//! \param context Context passed to range function
+//! \param count Number of items, must be less than 2^32
+//! \param grain Range size not split further, zero for configured default
+VECTOR_API void
+vector_parallel_for(const char* name, size_t length, vector_job_fn fn, void* context, size_t count, size_t grain);
+
+//! Get number of threads processing parallel jobs including the submitting thread
+//! \return Number of threads, one if parallel jobs are disabled
+VECTOR_API unsigned int
+vector_job_thread_count(void);
@@ -0,0 +1,257 @@
+/* matrix64.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file matrix64.h
+    Double precision matrix math, same row major layout and row vector convention as matrix.h */
+
+#include <vector/types.h>
+#include <vector/vector64.h>
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_zero(void);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_identity(void);
+
+//! Load unaligned
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL matrix64_t
+matrix64_unaligned(const float64_t* FOUNDATION_RESTRICT m);
+
+//! Load aligned (16-byte alignment)
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL matrix64_t
+matrix64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT m);
+
+//! Widen single precision matrix
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_from_matrix(const matrix_t m);
+
+//! Narrow to single precision matrix
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix64_to_matrix(const matrix64_t m);
+
+//! Rotation matrix of unit quaternion, same as matrix_from_quaternion
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_from_quaternion(const quaternion64_t q);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_scaling(const vector64_t scale);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_scaling_scalar(float64_t x, float64_t y, float64_t z);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_translation(const vector64_t translation);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_translation_scalar(float64_t x, float64_t y, float64_t z);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_transpose(const matrix64_t m);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_mul(const matrix64_t m0, const matrix64_t m1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_add(const matrix64_t m0, const matrix64_t m1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_sub(const matrix64_t m0, const matrix64_t m1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+matrix64_get_translation(const matrix64_t m);
+
+//! Single precision matrix with translation relative to origin. Rotation and scale rows are
+//! narrowed as is, the translation is subtracted in double precision before narrowing
+//! \param m Double precision matrix
+//! \param origin Double precision origin
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix64_rebase(const matrix64_t m, const vector64_t origin);
+
+//! Rebase array of matrices with matrix64_rebase, split across the job threads for large arrays
+//! \param m Double precision matrices
+//! \param count Number of matrices
+//! \param origin Double precision origin
+//! \param out Single precision matrices
+VECTOR_API void
+matrix64_rebase_array(const matrix64_t* m, size_t count, const vector64_t origin, matrix_t* out);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_zero(void) {
+	matrix64_t m;
+	m.row[0] = vector64_zero();
+	m.row[1] = m.row[0];
+	m.row[2] = m.row[0];
+	m.row[3] = m.row[0];
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_identity(void) {
+	matrix64_t m;
+	m.row[0] = vector64(1, 0, 0, 0);
+	m.row[1] = vector64(0, 1, 0, 0);
+	m.row[2] = vector64(0, 0, 1, 0);
+	m.row[3] = vector64(0, 0, 0, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL matrix64_t
+matrix64_unaligned(const float64_t* FOUNDATION_RESTRICT m) {
+	matrix64_t mtx;
+	mtx.row[0] = vector64_unaligned(m);
+	mtx.row[1] = vector64_unaligned(m + 4);
+	mtx.row[2] = vector64_unaligned(m + 8);
+	mtx.row[3] = vector64_unaligned(m + 12);
+	return mtx;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL matrix64_t
+matrix64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT m) {
+	return *(const matrix64_t*)m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_from_matrix(const matrix_t m) {
+	matrix64_t mtx;
+	mtx.row[0] = vector64_from_vector(m.row[0]);
+	mtx.row[1] = vector64_from_vector(m.row[1]);
+	mtx.row[2] = vector64_from_vector(m.row[2]);
+	mtx.row[3] = vector64_from_vector(m.row[3]);
+	return mtx;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix64_to_matrix(const matrix64_t m) {
+	matrix_t mtx;
+	mtx.row[0] = vector64_to_vector(m.row[0]);
+	mtx.row[1] = vector64_to_vector(m.row[1]);
+	mtx.row[2] = vector64_to_vector(m.row[2]);
+	mtx.row[3] = vector64_to_vector(m.row[3]);
+	return mtx;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_from_quaternion(const quaternion64_t q) {
+	const float64_t x = vector64_x(q);
+	const float64_t y = vector64_y(q);
+	const float64_t z = vector64_z(q);
+	const float64_t w = vector64_w(q);
+	const float64_t tx = 2.0 * x;
+	const float64_t ty = 2.0 * y;
+	const float64_t tz = 2.0 * z;
+	const float64_t tsx = tx * w;
+	const float64_t tsy = ty * w;
+	const float64_t tsz = tz * w;
+	const float64_t txx = tx * x;
+	const float64_t txy = ty * x;
+	const float64_t txz = tz * x;
+	const float64_t tyy = ty * y;
+	const float64_t tyz = tz * y;
+	const float64_t tzz = tz * z;
+
+	matrix64_t mat;
+	mat.row[0] = vector64(1.0 - (tyy + tzz), txy + tsz, txz - tsy, 0);
+	mat.row[1] = vector64(txy - tsz, 1.0 - (txx + tzz), tyz + tsx, 0);
+	mat.row[2] = vector64(txz + tsy, tyz - tsx, 1.0 - (txx + tyy), 0);
+	mat.row[3] = vector64(0, 0, 0, 1);
+	return mat;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_scaling(const vector64_t scale) {
+	return matrix64_scaling_scalar(vector64_x(scale), vector64_y(scale), vector64_z(scale));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_scaling_scalar(float64_t x, float64_t y, float64_t z) {
+	matrix64_t m;
+	m.row[0] = vector64(x, 0, 0, 0);
+	m.row[1] = vector64(0, y, 0, 0);
+	m.row[2] = vector64(0, 0, z, 0);
+	m.row[3] = vector64(0, 0, 0, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_translation(const vector64_t translation) {
+	matrix64_t m = matrix64_identity();
+	m.row[3] = vector64_set_component(translation, 3, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_translation_scalar(float64_t x, float64_t y, float64_t z) {
+	matrix64_t m = matrix64_identity();
+	m.row[3] = vector64(x, y, z, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_transpose(const matrix64_t m) {
+	matrix64_t r;
+	for (int row = 0; row < 4; ++row)
+		r.row[row] = vector64(m.frow[0][row], m.frow[1][row], m.frow[2][row], m.frow[3][row]);
+	return r;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_mul(const matrix64_t m0, const matrix64_t m1) {
+	// Each row of the product is the row of m0 transformed by m1
+	matrix64_t r;
+	r.row[0] = vector64_transform(m0.row[0], m1);
+	r.row[1] = vector64_transform(m0.row[1], m1);
+	r.row[2] = vector64_transform(m0.row[2], m1);
+	r.row[3] = vector64_transform(m0.row[3], m1);
+	return r;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_add(const matrix64_t m0, const matrix64_t m1) {
+	matrix64_t r;
+	r.row[0] = vector64_add(m0.row[0], m1.row[0]);
+	r.row[1] = vector64_add(m0.row[1], m1.row[1]);
+	r.row[2] = vector64_add(m0.row[2], m1.row[2]);
+	r.row[3] = vector64_add(m0.row[3], m1.row[3]);
+	return r;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix64_t
+matrix64_sub(const matrix64_t m0, const matrix64_t m1) {
+	matrix64_t r;
+	r.row[0] = vector64_sub(m0.row[0], m1.row[0]);
+	r.row[1] = vector64_sub(m0.row[1], m1.row[1]);
+	r.row[2] = vector64_sub(m0.row[2], m1.row[2]);
+	r.row[3] = vector64_sub(m0.row[3], m1.row[3]);
+	return r;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+matrix64_get_translation(const matrix64_t m) {
+	return m.row[3];
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix64_rebase(const matrix64_t m, const vector64_t origin) {
+	matrix_t mtx;
+	mtx.row[0] = vector64_to_vector(m.row[0]);
+	mtx.row[1] = vector64_to_vector(m.row[1]);
+	mtx.row[2] = vector64_to_vector(m.row[2]);
+	mtx.row[3] = vector64_to_vector(vector64_sub(m.row[3], vector64_set_component(origin, 3, 0)));
+	return mtx;
+}
@@ -0,0 +1,288 @@
+/* mesh.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/mesh.h>
+#include <vector/arena.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+//! Normalize xyz of four vectors at once. The vectors are transposed into component vectors
+//! so all four share a single square root and division. Zero vectors are kept as zero and
+//! w is cleared
+static FOUNDATION_FORCEINLINE void
+mesh_normalize4(vector_t* v, const vectori_t xyz_mask) {
+	vector_t comp[4];
+	vector_transpose4(v[0], v[1], v[2], v[3], comp);
+	const vector_t length_sqr =
+	    vector_muladd(comp[0], comp[0], vector_muladd(comp[1], comp[1], vector_mul(comp[2], comp[2])));
+	const vector_t scale = vector_select(vector_greater(length_sqr, vector_zero()),
+	                                     vector_div(vector_one(), vector_sqrt(length_sqr)), vector_zero());
+	v[0] = vector_select(xyz_mask, vector_mul(v[0], vector_shuffle(scale, VECTOR_MASK_XXXX)), vector_zero());
+	v[1] = vector_select(xyz_mask, vector_mul(v[1], vector_shuffle(scale, VECTOR_MASK_YYYY)), vector_zero());
+	v[2] = vector_select(xyz_mask, vector_mul(v[2], vector_shuffle(scale, VECTOR_MASK_ZZZZ)), vector_zero());
+	v[3] = vector_select(xyz_mask, vector_mul(v[3], vector_shuffle(scale, VECTOR_MASK_WWWW)), vector_zero());
+}
+
+static void
+mesh_normalize_array(vector_t* v, size_t count) {
+	const vectori_t xyz_mask = vectori(-1, -1, -1, 0);
+	size_t ivec = 0;
+	for (; ivec + 4 <= count; ivec += 4)
+		mesh_normalize4(v + ivec, xyz_mask);
+	if (ivec < count) {
+		vector_t tail[4] = {vector_zero(), vector_zero(), vector_zero(), vector_zero()};
+		for (size_t itail = 0; ivec + itail < count; ++itail)
+			tail[itail] = v[ivec + itail];
+		mesh_normalize4(tail, xyz_mask);
+		for (size_t itail = 0; ivec + itail < count; ++itail)
+			v[ivec + itail] = tail[itail];
+	}
+}
+
+static FOUNDATION_FORCEINLINE vector_t
+mesh_face_normal(const vector_t v0, const vector_t v1, const vector_t v2) {
+	return vector_cross3(vector_sub(v1, v0), vector_sub(v2, v0));
+}
+
+void
+mesh_calculate_normals(const vector_t* position, size_t vertex_count, const uint32_t* index, size_t triangle_count,
+                       vector_t* normal) {
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert)
+		normal[ivert] = vector_zero();
+	for (size_t itri = 0; itri < triangle_count; ++itri) {
+		const uint32_t* corner = index + (itri * 3);
+		const vector_t face_normal = mesh_face_normal(position[corner[0]], position[corner[1]], position[corner[2]]);
+		normal[corner[0]] = vector_add(normal[corner[0]], face_normal);
+		normal[corner[1]] = vector_add(normal[corner[1]], face_normal);
+		normal[corner[2]] = vector_add(normal[corner[2]], face_normal);
+	}
+	mesh_normalize_array(normal, vertex_count);
+}
+
+void
+mesh_calculate_normals_float3(const float32_t* position, size_t vertex_count, const uint32_t* index,
+                              size_t triangle_count, float32_t* normal) {
+	if (!vertex_count)
+		return;
+	// Positions are widened once so each vertex is only loaded from packed format one time
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	vector_t* temp = vector_arena_allocate(arena, sizeof(vector_t) * vertex_count * 2, 0);
+	vector_t* temp_position = temp;
+	vector_t* temp_normal = temp + vertex_count;
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert) {
+		const float32_t* src = position + (ivert * 3);
+		temp_position[ivert] = vector(src[0], src[1], src[2], 0);
+	}
+	mesh_calculate_normals(temp_position, vertex_count, index, triangle_count, temp_normal);
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert) {
+		float32_t* dst = normal + (ivert * 3);
+		dst[0] = (float32_t)vector_x(temp_normal[ivert]);
+		dst[1] = (float32_t)vector_y(temp_normal[ivert]);
+		dst[2] = (float32_t)vector_z(temp_normal[ivert]);
+	}
+	vector_arena_rewind(arena, mark);
+}
+
+void
+mesh_adjacency_initialize(mesh_adjacency_t* adjacency, const uint32_t* index, size_t triangle_count,
+                          size_t vertex_count) {
+	FOUNDATION_ASSERT(triangle_count * 3 < 0xFFFFFFFF);
+	FOUNDATION_ASSERT(vertex_count < 0xFFFFFFFF);
+	const size_t corner_count = triangle_count * 3;
+	adjacency->vertex_count = (uint32_t)vertex_count;
+	adjacency->triangle_count = (uint32_t)triangle_count;
+	adjacency->offset = memory_allocate(HASH_VECTOR, sizeof(uint32_t) * (vertex_count + 1), 0,
+	                                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	adjacency->corner =
+	    memory_allocate(HASH_VECTOR, sizeof(uint32_t) * (corner_count ? corner_count : 1), 0, MEMORY_PERSISTENT);
+
+	// Counting sort of corners by vertex, keeping corners of each vertex in increasing order
+	uint32_t* offset = adjacency->offset;
+	for (size_t icorner = 0; icorner < corner_count; ++icorner)
+		++offset[index[icorner] + 1];
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert)
+		offset[ivert + 1] += offset[ivert];
+	for (size_t icorner = 0; icorner < corner_count; ++icorner)
+		adjacency->corner[offset[index[icorner]]++] = (uint32_t)icorner;
+	// Scatter advanced each offset to the start of the next vertex, shift back
+	for (size_t ivert = vertex_count; ivert > 0; --ivert)
+		offset[ivert] = offset[ivert - 1];
+	offset[0] = 0;
+}
+
+void
+mesh_adjacency_finalize(mesh_adjacency_t* adjacency) {
+	memory_deallocate(adjacency->offset);
+	memory_deallocate(adjacency->corner);
+	adjacency->offset = 0;
+	adjacency->corner = 0;
+	adjacency->vertex_count = 0;
+	adjacency->triangle_count = 0;
+}
+
+void
+mesh_face_normals(const vector_t* position, const uint32_t* index, size_t triangle_begin, size_t triangle_end,
+                  vector_t* face_normal) {
+	for (size_t itri = triangle_begin; itri < triangle_end; ++itri) {
+		const uint32_t* corner = index + (itri * 3);
+		face_normal[itri] = mesh_face_normal(position[corner[0]], position[corner[1]], position[corner[2]]);
+	}
+}
+
+void
+mesh_vertex_normals(const mesh_adjacency_t* adjacency, const vector_t* face_normal, size_t vertex_begin,
+                    size_t vertex_end, vector_t* normal) {
+	FOUNDATION_ASSERT(vertex_end <= adjacency->vertex_count);
+	const uint32_t* offset = adjacency->offset;
+	for (size_t ivert = vertex_begin; ivert < vertex_end; ++ivert) {
+		vector_t sum = vector_zero();
+		for (uint32_t icorner = offset[ivert]; icorner < offset[ivert + 1]; ++icorner)
+			sum = vector_add(sum, face_normal[adjacency->corner[icorner] / 3]);
+		normal[ivert] = sum;
+	}
+	if (vertex_end > vertex_begin)
+		mesh_normalize_array(normal + vertex_begin, vertex_end - vertex_begin);
+}
+
+typedef struct mesh_normals_job_t mesh_normals_job_t;
+
+struct mesh_normals_job_t {
+	const mesh_adjacency_t* adjacency;
+	const vector_t* position;
+	const uint32_t* index;
+	vector_t* face_normal;
+	vector_t* normal;
+};
+
+//! Job ranges are in blocks of four elements, so no two ranges write to the same cache line
+static void
+mesh_face_normals_range(void* context, size_t begin, size_t end) {
+	const mesh_normals_job_t* job = context;
+	const size_t triangle_count = job->adjacency->triangle_count;
+	const size_t triangle_end = (end * 4 < triangle_count) ? end * 4 : triangle_count;
+	mesh_face_normals(job->position, job->index, begin * 4, triangle_end, job->face_normal);
+}
+
+static void
+mesh_vertex_normals_range(void* context, size_t begin, size_t end) {
+	const mesh_normals_job_t* job = context;
+	const size_t vertex_count = job->adjacency->vertex_count;
+	const size_t vertex_end = (end * 4 < vertex_count) ? end * 4 : vertex_count;
+	mesh_vertex_normals(job->adjacency, job->face_normal, begin * 4, vertex_end, job->normal);
+}
+
+void
+mesh_calculate_normals_parallel(const mesh_adjacency_t* adjacency, const vector_t* position, const uint32_t* index,
+                                vector_t* face_normal, vector_t* normal) {
+	mesh_normals_job_t job;
+	job.adjacency = adjacency;
+	job.position = position;
+	job.index = index;
+	job.face_normal = face_normal;
+	job.normal = normal;
+	vector_parallel_for(STRING_CONST("mesh_face_normals"), mesh_face_normals_range, &job,
+	                    (adjacency->triangle_count + 3) / 4, 0);
+	vector_parallel_for(STRING_CONST("mesh_vertex_normals"), mesh_vertex_normals_range, &job,
+	                    (adjacency->vertex_count + 3) / 4, 0);
+}
+
+//! Remove component along normal
+static FOUNDATION_FORCEINLINE vector_t
+mesh_project_plane(const vector_t v, const vector_t normal) {
+	return vector_sub(v, vector_mul(normal, vector_uniform(vector_x(vector_dot3(normal, v)))));
+}
+
+//! Angle between two vectors projected in the plane of the normal, as weighted in MikkTSpace
+static FOUNDATION_FORCEINLINE real
+mesh_corner_angle(const vector_t edge0, const vector_t edge1, const vector_t normal) {
+	const vector_t dir0 = mesh_project_plane(edge0, normal);
+	const vector_t dir1 = mesh_project_plane(edge1, normal);
+	const real length_sqr = vector_x(vector_dot3(dir0, dir0)) * vector_x(vector_dot3(dir1, dir1));
+	if (length_sqr <= 0)
+		return 0;
+	real cos_angle = vector_x(vector_dot3(dir0, dir1)) / math_sqrt(length_sqr);
+	cos_angle = (cos_angle < -1) ? -1 : ((cos_angle > 1) ? 1 : cos_angle);
+	return vector_scalar_acos(cos_angle);
+}
+
+void
+mesh_calculate_tangents(const vector_t* position, const vector_t* normal, const float32_t* texcoord,
+                        size_t vertex_count, const uint32_t* index, size_t triangle_count, vector_t* tangent) {
+	if (!vertex_count)
+		return;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	real* handedness = vector_arena_allocate(arena, sizeof(real) * vertex_count, 0);
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert) {
+		tangent[ivert] = vector_zero();
+		handedness[ivert] = 0;
+	}
+
+	for (size_t itri = 0; itri < triangle_count; ++itri) {
+		const uint32_t* corner = index + (itri * 3);
+		const vector_t edge1 = vector_sub(position[corner[1]], position[corner[0]]);
+		const vector_t edge2 = vector_sub(position[corner[2]], position[corner[0]]);
+		const float32_t* uv0 = texcoord + (corner[0] * 2);
+		const float32_t* uv1 = texcoord + (corner[1] * 2);
+		const float32_t* uv2 = texcoord + (corner[2] * 2);
+		const real s1 = uv1[0] - uv0[0];
+		const real t1 = uv1[1] - uv0[1];
+		const real s2 = uv2[0] - uv0[0];
+		const real t2 = uv2[1] - uv0[1];
+		// Faces degenerate in texture space do not contribute, as in MikkTSpace
+		const real signed_area = (s1 * t2) - (s2 * t1);
+		if (math_abs(signed_area) <= REAL_C(1e-20))
+			continue;
+		// Direction of increasing u scaled by signed area, face sign makes it point along +u
+		const vector_t face_tangent = vector_sub(vector_scale(edge1, t2), vector_scale(edge2, t1));
+		const real face_sign = (signed_area > 0) ? REAL_C(1.0) : REAL_C(-1.0);
+
+		const vector_t corner_edge[3][2] = {{edge1, edge2},
+		                                    {vector_neg(edge1), vector_sub(edge2, edge1)},
+		                                    {vector_neg(edge2), vector_sub(edge1, edge2)}};
+		for (int icorner = 0; icorner < 3; ++icorner) {
+			const uint32_t vertex = corner[icorner];
+			const vector_t vertex_normal = normal[vertex];
+			const vector_t projected = mesh_project_plane(face_tangent, vertex_normal);
+			const real length_sqr = vector_x(vector_dot3(projected, projected));
+			if (length_sqr <= 0)
+				continue;
+			const real angle = mesh_corner_angle(corner_edge[icorner][0], corner_edge[icorner][1], vertex_normal);
+			const real weight = angle / math_sqrt(length_sqr);
+			tangent[vertex] = vector_add(tangent[vertex], vector_scale(projected, weight * face_sign));
+			handedness[vertex] += weight * face_sign;
+		}
+	}
+
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert) {
+		const vector_t vertex_normal = normal[ivert];
+		vector_t accum = mesh_project_plane(tangent[ivert], vertex_normal);
+		if (vector_x(vector_dot3(accum, accum)) <= REAL_C(1e-20)) {
+			// No contribution, pick any direction perpendicular to normal
+			const vector_t axis = (math_abs(vector_x(vertex_normal)) < REAL_C(0.9)) ? vector_xaxis() : vector_yaxis();
+			accum = mesh_project_plane(axis, vertex_normal);
+		}
+		tangent[ivert] = accum;
+	}
+	mesh_normalize_array(tangent, vertex_count);
+	for (size_t ivert = 0; ivert < vertex_count; ++ivert)
+		tangent[ivert] = vector_set_component(tangent[ivert], 3, (handedness[ivert] < 0) ? REAL_C(-1.0) : REAL_C(1.0));
+
+	vector_arena_rewind(arena, mark);
+}
@@ -0,0 +1,109 @@
+/* mesh.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file mesh.h
+    Vertex normal and tangent generation for indexed triangle meshes. Normals are area weighted
+    sums of face normals. For parallel processing of deformed meshes, face normals are computed
+    over triangle ranges and then gathered per vertex over vertex ranges using a precomputed
+    adjacency, so each thread only writes its own output range and results do not depend on how
+    the work is split. Keep vertex ranges a multiple of four to avoid threads writing to the
+    same cache line. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Calculate area weighted vertex normals with w component zero. Vertices not referenced
+//! by any triangle, or only by degenerate triangles, get a zero normal
+//! \param position Vertex positions
+//! \param vertex_count Number of vertices
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_count Number of triangles
+//! \param normal Normal output, vertex_count elements
+VECTOR_API void
+mesh_calculate_normals(const vector_t* position, size_t vertex_count, const uint32_t* index, size_t triangle_count,
+                       vector_t* normal);
+
+//! Calculate area weighted vertex normals for tightly packed three component positions
+//! \param position Vertex positions, three floats per vertex
+//! \param vertex_count Number of vertices
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_count Number of triangles
+//! \param normal Normal output, three floats per vertex
+VECTOR_API void
+mesh_calculate_normals_float3(const float32_t* position, size_t vertex_count, const uint32_t* index,
+                              size_t triangle_count, float32_t* normal);
+
+//! Build vertex to triangle corner adjacency. Only depends on mesh topology and can be
+//! reused for all frames of a deforming mesh
+//! \param adjacency Adjacency
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_count Number of triangles
+//! \param vertex_count Number of vertices
+VECTOR_API void
+mesh_adjacency_initialize(mesh_adjacency_t* adjacency, const uint32_t* index, size_t triangle_count,
+                          size_t vertex_count);
+
+VECTOR_API void
+mesh_adjacency_finalize(mesh_adjacency_t* adjacency);
+
+//! Calculate unnormalized face normals with length equal to twice the triangle area
+//! \param position Vertex positions
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_begin First triangle
+//! \param triangle_end One past last triangle
+//! \param face_normal Face normal output, indexed by triangle
+VECTOR_API void
+mesh_face_normals(const vector_t* position, const uint32_t* index, size_t triangle_begin, size_t triangle_end,
+                  vector_t* face_normal);
+
+//! Gather face normals into normalized vertex normals with w component zero
+//! \param adjacency Mesh adjacency
+//! \param face_normal Face normals from mesh_face_normals
+//! \param vertex_begin First vertex
+//! \param vertex_end One past last vertex
+//! \param normal Normal output, indexed by vertex
+VECTOR_API void
+mesh_vertex_normals(const mesh_adjacency_t* adjacency, const vector_t* face_normal, size_t vertex_begin,
+                    size_t vertex_end, vector_t* normal);
+
+//! Calculate area weighted vertex normals with the face and vertex passes split across the
+//! job threads with vector_parallel_for. Ranges are aligned to four vertices
+//! \param adjacency Mesh adjacency
+//! \param position Vertex positions
+//! \param index Triangle vertex indices, three per triangle
+//! \param face_normal Face normal scratch buffer, adjacency->triangle_count elements
+//! \param normal Normal output, adjacency->vertex_count elements
+VECTOR_API void
+mesh_calculate_normals_parallel(const mesh_adjacency_t* adjacency, const vector_t* position, const uint32_t* index,
+                                vector_t* face_normal, vector_t* normal);
+
+//! Calculate tangents following MikkTSpace conventions. Per face tangents are projected into
+//! the plane of the vertex normal and weighted by corner angle. The w component holds the
+//! handedness, bitangent = cross(normal, tangent) * w. Vertices are not split, so meshes must
+//! already have separate vertices along texture seams and mirrored texture regions
+//! \param position Vertex positions
+//! \param normal Normalized vertex normals
+//! \param texcoord Texture coordinates, two floats per vertex
+//! \param vertex_count Number of vertices
+//! \param index Triangle vertex indices, three per triangle
+//! \param triangle_count Number of triangles
+//! \param tangent Tangent output, vertex_count elements
+VECTOR_API void
+mesh_calculate_tangents(const vector_t* position, const vector_t* normal, const float32_t* texcoord,
+                        size_t vertex_count, const uint32_t* index, size_t triangle_count, vector_t* tangent);
@@ -0,0 +1,137 @@
+/* morton.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/morton.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+#define MORTON_RADIX_BITS 8
+#define MORTON_RADIX_SIZE (1 << MORTON_RADIX_BITS)
+#define MORTON_RADIX_MASK (MORTON_RADIX_SIZE - 1)
+
+void
+morton_encode_points30(const vector_t* point, size_t count, const aabb_t bounds, uint32_t* code) {
+	const real cells = REAL_C(1024.0);
+	const vector_t scale = morton_scale(bounds, cells);
+	const vector_t max = vector_uniform(cells - 1);
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		// Spread all three axes at once, then merge the interleaved lanes
+		const vectori_t cell = vector_to_vectori(morton_quantize(point[ipt], bounds.min, scale, max));
+		const vectori_t spread = morton_spread10_vector(cell);
+		code[ipt] =
+		    (uint32_t)vectori_x(spread) | ((uint32_t)vectori_y(spread) << 1) | ((uint32_t)vectori_z(spread) << 2);
+	}
+}
+
+void
+morton_encode_points63(const vector_t* point, size_t count, const aabb_t bounds, uint64_t* code) {
+	const real cells = REAL_C(2097152.0);
+	const vector_t scale = morton_scale(bounds, cells);
+	const vector_t max = vector_uniform(cells - 1);
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const vector_t cell = morton_quantize(point[ipt], bounds.min, scale, max);
+		code[ipt] = morton_encode63((uint32_t)vector_x(cell), (uint32_t)vector_y(cell), (uint32_t)vector_z(cell));
+	}
+}
+
+void
+hilbert_encode_points(const vector_t* point, size_t count, const aabb_t bounds, uint64_t* code) {
+	const real cells = REAL_C(2097152.0);
+	const vector_t scale = morton_scale(bounds, cells);
+	const vector_t max = vector_uniform(cells - 1);
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const vector_t cell = morton_quantize(point[ipt], bounds.min, scale, max);
+		code[ipt] =
+		    hilbert_encode((uint32_t)vector_x(cell), (uint32_t)vector_y(cell), (uint32_t)vector_z(cell), 21);
+	}
+}
+
+//! LSD radix sort with all digit histograms gathered in a single pass. Passes where every
+//! code has the same digit are skipped, which for codes from tight bounds is common for
+//! the upper digits
+#define MORTON_RADIX_SORT(code_type, digits)                                                                \
+	const size_t code_size = sizeof(code_type) * count;                                                     \
+	const size_t order_size = sizeof(uint32_t) * count;                                                     \
+	code_type* code_temp = memory_allocate(HASH_VECTOR, code_size + order_size, 0, MEMORY_TEMPORARY);       \
+	uint32_t* order_temp = (uint32_t*)(code_temp + count);                                                  \
+	uint32_t histogram[digits][MORTON_RADIX_SIZE];                                                          \
+	memset(histogram, 0, sizeof(histogram));                                                                \
+	for (size_t icode = 0; icode < count; ++icode) {                                                        \
+		order[icode] = (uint32_t)icode;                                                                     \
+		for (unsigned int idigit = 0; idigit < (digits); ++idigit)                                          \
+			++histogram[idigit][(code[icode] >> (idigit * MORTON_RADIX_BITS)) & MORTON_RADIX_MASK];         \
+	}                                                                                                       \
+	code_type* code_src = code;                                                                             \
+	code_type* code_dst = code_temp;                                                                        \
+	uint32_t* order_src = order;                                                                            \
+	uint32_t* order_dst = order_temp;                                                                       \
+	for (unsigned int idigit = 0; idigit < (digits); ++idigit) {                                            \
+		uint32_t* offset = histogram[idigit];                                                               \
+		const unsigned int shift = idigit * MORTON_RADIX_BITS;                                              \
+		if (offset[(code_src[0] >> shift) & MORTON_RADIX_MASK] == count)                                    \
+			continue;                                                                                       \
+		uint32_t sum = 0;                                                                                   \
+		for (unsigned int ibucket = 0; ibucket < MORTON_RADIX_SIZE; ++ibucket) {                            \
+			const uint32_t bucket_count = offset[ibucket];                                                  \
+			offset[ibucket] = sum;                                                                          \
+			sum += bucket_count;                                                                            \
+		}                                                                                                   \
+		for (size_t icode = 0; icode < count; ++icode) {                                                    \
+			const uint32_t dst = offset[(code_src[icode] >> shift) & MORTON_RADIX_MASK]++;                  \
+			code_dst[dst] = code_src[icode];                                                                \
+			order_dst[dst] = order_src[icode];                                                              \
+		}                                                                                                   \
+		code_type* code_swap = code_src;                                                                    \
+		code_src = code_dst;                                                                                \
+		code_dst = code_swap;                                                                               \
+		uint32_t* order_swap = order_src;                                                                   \
+		order_src = order_dst;                                                                              \
+		order_dst = order_swap;                                                                             \
+	}                                                                                                       \
+	if (code_src != code) {                                                                                 \
+		memcpy(code, code_src, code_size);                                                                  \
+		memcpy(order, order_src, order_size);                                                               \
+	}                                                                                                       \
+	memory_deallocate(code_temp)
+
+void
+morton_sort32(uint32_t* code, uint32_t* order, size_t count) {
+	if (!count)
+		return;
+	FOUNDATION_ASSERT(count <= 0xFFFFFFFF);
+	MORTON_RADIX_SORT(uint32_t, 4);
+}
+
+void
+morton_sort64(uint64_t* code, uint32_t* order, size_t count) {
+	if (!count)
+		return;
+	FOUNDATION_ASSERT(count <= 0xFFFFFFFF);
+	MORTON_RADIX_SORT(uint64_t, 8);
+}
+
+void
+morton_reorder(void* data, size_t size, const uint32_t* order, size_t count) {
+	if (!count)
+		return;
+	char* temp = memory_allocate(HASH_VECTOR, size * count, 16, MEMORY_TEMPORARY);
+	const char* src = data;
+	for (size_t ielem = 0; ielem < count; ++ielem)
+		memcpy(temp + (size * ielem), src + (size * order[ielem]), size);
+	memcpy(data, temp, size * count);
+	memory_deallocate(temp);
+}
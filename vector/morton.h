@@ -0,0 +1,211 @@
+/* morton.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file morton.h
+    Morton (Z-order) and Hilbert codes for spatial sorting. Points are quantized into a grid
+    spanning given bounds, 10 bits per axis for 30-bit codes and 21 bits per axis for 63-bit codes.
+    Sorting arrays by code places spatially close elements close in memory, improving cache
+    utilization of later passes over the data. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+
+#if (FOUNDATION_ARCH_X86 || FOUNDATION_ARCH_X86_64) && defined(__BMI2__)
+#include <immintrin.h>
+#define VECTOR_MORTON_PDEP 1
+#else
+#define VECTOR_MORTON_PDEP 0
+#endif
+
+//! Spread low 10 bits of value so each bit is followed by two zero bits
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint32_t
+morton_spread10(uint32_t value);
+
+//! Spread low 10 bits of each component so each bit is followed by two zero bits
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+morton_spread10_vector(const vectori_t value);
+
+//! Spread low 21 bits of value so each bit is followed by two zero bits
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+morton_spread21(uint64_t value);
+
+//! Interleave low 10 bits of each coordinate, x in least significant bit
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint32_t
+morton_encode30(uint32_t x, uint32_t y, uint32_t z);
+
+//! Interleave low 21 bits of each coordinate, x in least significant bit
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+morton_encode63(uint32_t x, uint32_t y, uint32_t z);
+
+//! Hilbert curve index of grid cell, bits per axis in range [1, 21]
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+hilbert_encode(uint32_t x, uint32_t y, uint32_t z, unsigned int bits);
+
+//! Quantize point into grid cell coordinates, clamped to [0, max]
+//! \param point Point
+//! \param offset Grid origin, minimum corner of bounds
+//! \param scale Cells per unit along each axis
+//! \param max Maximum cell coordinate
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+morton_quantize(const vector_t point, const vector_t offset, const vector_t scale, const vector_t max);
+
+//! Calculate scale factor mapping bounds onto a grid with given number of cells per axis
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+morton_scale(const aabb_t bounds, real cells);
+
+//! Calculate 30-bit Morton codes for points quantized in bounds
+//! \param point Points
+//! \param count Number of points
+//! \param bounds Quantization bounds, points outside are clamped
+//! \param code Code output, count elements
+VECTOR_API void
+morton_encode_points30(const vector_t* point, size_t count, const aabb_t bounds, uint32_t* code);
+
+//! Calculate 63-bit Morton codes for points quantized in bounds
+//! \param point Points
+//! \param count Number of points
+//! \param bounds Quantization bounds, points outside are clamped
+//! \param code Code output, count elements
+VECTOR_API void
+morton_encode_points63(const vector_t* point, size_t count, const aabb_t bounds, uint64_t* code);
+
+//! Calculate 63-bit Hilbert codes for points quantized in bounds. Hilbert order has no
+//! jumps between neighbouring codes, at a slightly higher encoding cost than Morton order
+//! \param point Points
+//! \param count Number of points
+//! \param bounds Quantization bounds, points outside are clamped
+//! \param code Code output, count elements
+VECTOR_API void
+hilbert_encode_points(const vector_t* point, size_t count, const aabb_t bounds, uint64_t* code);
+
+//! Stable radix sort of codes in place
+//! \param code Codes to sort
+//! \param order Output permutation, order[i] is the original index of the code now at index i
+//! \param count Number of codes
+VECTOR_API void
+morton_sort32(uint32_t* code, uint32_t* order, size_t count);
+
+//! Stable radix sort of codes in place
+//! \param code Codes to sort
+//! \param order Output permutation, order[i] is the original index of the code now at index i
+//! \param count Number of codes
+VECTOR_API void
+morton_sort64(uint64_t* code, uint32_t* order, size_t count);
+
+//! Reorder array of elements by permutation from sort, element i is replaced by element order[i]
+//! \param data Elements, for example vector_t points or transform_t instances
+//! \param size Size of a single element in bytes
+//! \param order Permutation
+//! \param count Number of elements
+VECTOR_API void
+morton_reorder(void* data, size_t size, const uint32_t* order, size_t count);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint32_t
+morton_spread10(uint32_t value) {
+#if VECTOR_MORTON_PDEP
+	return _pdep_u32(value, 0x09249249U);
+#else
+	value &= 0x000003FFU;
+	value = (value | (value << 16)) & 0xFF0000FFU;
+	value = (value | (value << 8)) & 0x0300F00FU;
+	value = (value | (value << 4)) & 0x030C30C3U;
+	value = (value | (value << 2)) & 0x09249249U;
+	return value;
+#endif
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+morton_spread10_vector(const vectori_t value) {
+	vectori_t spread = vectori_and(value, vectori_uniform(0x000003FF));
+	spread = vectori_and(vectori_or(spread, vectori_shift_left(spread, 16)), vectori_uniform((int32_t)0xFF0000FF));
+	spread = vectori_and(vectori_or(spread, vectori_shift_left(spread, 8)), vectori_uniform(0x0300F00F));
+	spread = vectori_and(vectori_or(spread, vectori_shift_left(spread, 4)), vectori_uniform(0x030C30C3));
+	spread = vectori_and(vectori_or(spread, vectori_shift_left(spread, 2)), vectori_uniform(0x09249249));
+	return spread;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+morton_spread21(uint64_t value) {
+#if VECTOR_MORTON_PDEP && FOUNDATION_ARCH_X86_64
+	return _pdep_u64(value, 0x1249249249249249ULL);
+#else
+	value &= 0x00000000001FFFFFULL;
+	value = (value | (value << 32)) & 0x001F00000000FFFFULL;
+	value = (value | (value << 16)) & 0x001F0000FF0000FFULL;
+	value = (value | (value << 8)) & 0x100F00F00F00F00FULL;
+	value = (value | (value << 4)) & 0x10C30C30C30C30C3ULL;
+	value = (value | (value << 2)) & 0x1249249249249249ULL;
+	return value;
+#endif
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint32_t
+morton_encode30(uint32_t x, uint32_t y, uint32_t z) {
+	return morton_spread10(x) | (morton_spread10(y) << 1) | (morton_spread10(z) << 2);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+morton_encode63(uint32_t x, uint32_t y, uint32_t z) {
+	return morton_spread21(x) | (morton_spread21(y) << 1) | (morton_spread21(z) << 2);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL uint64_t
+hilbert_encode(uint32_t x, uint32_t y, uint32_t z, unsigned int bits) {
+	// Skilling's transform of axes to transposed Hilbert index, "Programming the Hilbert curve" (2004)
+	uint32_t axis[3] = {x, y, z};
+	const uint32_t top = 1U << (bits - 1);
+	for (uint32_t q = top; q > 1; q >>= 1) {
+		const uint32_t p = q - 1;
+		for (int i = 0; i < 3; ++i) {
+			if (axis[i] & q) {
+				axis[0] ^= p;
+			} else {
+				const uint32_t swap = (axis[0] ^ axis[i]) & p;
+				axis[0] ^= swap;
+				axis[i] ^= swap;
+			}
+		}
+	}
+	axis[1] ^= axis[0];
+	axis[2] ^= axis[1];
+	uint32_t gray = 0;
+	for (uint32_t q = top; q > 1; q >>= 1) {
+		if (axis[2] & q)
+			gray ^= q - 1;
+	}
+	// First axis holds the most significant bit of each transposed triplet
+	return morton_encode63(axis[2] ^ gray, axis[1] ^ gray, axis[0] ^ gray);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+morton_quantize(const vector_t point, const vector_t offset, const vector_t scale, const vector_t max) {
+	return vector_min(vector_max(vector_mul(vector_sub(point, offset), scale), vector_zero()), max);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+morton_scale(const aabb_t bounds, real cells) {
+	const vector_t size = aabb_size(bounds);
+	const vector_t valid = vector_max(size, vector_uniform(REAL_C(1e-20)));
+	// Degenerate axes map every point to cell zero
+	return vector_mul(vector_div(vector_uniform(cells), valid),
+	                  vector(vector_x(size) > 0 ? 1 : 0, vector_y(size) > 0 ? 1 : 0, vector_z(size) > 0 ? 1 : 0, 0));
+}
+
+#undef VECTOR_MORTON_PDEP
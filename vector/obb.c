@@ -0,0 +1,178 @@
+/* obb.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/obb.h>
+#include <vector/decompose.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+//! Added to the absolute axis dot products so the near zero edge cross products of parallel edges
+//! cannot report a false separation
+#define OBB_PARALLEL_EPSILON REAL_C(1e-6)
+
+typedef struct obb_overlap_batch_t obb_overlap_batch_t;
+
+VECTOR_ALIGNED_STRUCT(obb_overlap_batch_t) {
+	matrix_t axes;
+	obb_t box;
+	const obb_t* boxes;
+	uint8_t* overlap;
+};
+
+static FOUNDATION_FORCEINLINE bool
+obb_separated(const vectori_t outside) {
+	return vectori_x(outside) || vectori_y(outside) || vectori_z(outside);
+}
+
+//! Separating axis test with the axes of the first box given as matrix rows
+static bool
+obb_overlap_axes(const matrix_t axes0, const obb_t box0, const obb_t box1) {
+	const matrix_t axes1 = matrix_from_quaternion(box1.rotation);
+	// Row i holds the dot products of axis i of box0 with the three axes of box1
+	const matrix_t rot = matrix_mul(axes0, matrix_transpose(axes1));
+	const vector_t epsilon = vector_uniform(OBB_PARALLEL_EPSILON);
+	matrix_t abs_rot;
+	abs_rot.row[0] = vector_add(vector_abs(rot.row[0]), epsilon);
+	abs_rot.row[1] = vector_add(vector_abs(rot.row[1]), epsilon);
+	abs_rot.row[2] = vector_add(vector_abs(rot.row[2]), epsilon);
+	abs_rot.row[3] = vector_zero();
+	const vector_t a = box0.extent;
+	const vector_t b = box1.extent;
+	// Center offset in the frame of box0
+	const vector_t t = vector_rotate(vector_sub(box1.center, box0.center), matrix_transpose(axes0));
+
+	// Face axes of box0
+	const vector_t radius_a0 = vector_add(a, vector_rotate(b, matrix_transpose(abs_rot)));
+	if (obb_separated(vector_greater(vector_abs(t), radius_a0)))
+		return false;
+
+	// Face axes of box1
+	const vector_t radius_b1 = vector_add(vector_rotate(a, abs_rot), b);
+	if (obb_separated(vector_greater(vector_abs(vector_rotate(t, rot)), radius_b1)))
+		return false;
+
+	// Edge cross products axis0[i] x axis1[j], the three j in the vector lanes
+	const vector_t b_yzx = vector_shuffle(b, VECTOR_MASK_YZXW);
+	const vector_t b_zxy = vector_shuffle(b, VECTOR_MASK_ZXYW);
+	for (int i = 0; i < 3; ++i) {
+		const int i1 = (i + 1) % 3;
+		const int i2 = (i + 2) % 3;
+		const vector_t radius_a = vector_muladd(vector_uniform(vector_component(a, i1)), abs_rot.row[i2],
+		                                        vector_mul(vector_uniform(vector_component(a, i2)), abs_rot.row[i1]));
+		const vector_t radius_b = vector_muladd(b_yzx, vector_shuffle(abs_rot.row[i], VECTOR_MASK_ZXYW),
+		                                        vector_mul(b_zxy, vector_shuffle(abs_rot.row[i], VECTOR_MASK_YZXW)));
+		const vector_t dist = vector_sub(vector_mul(vector_uniform(vector_component(t, i2)), rot.row[i1]),
+		                                 vector_mul(vector_uniform(vector_component(t, i1)), rot.row[i2]));
+		if (obb_separated(vector_greater(vector_abs(dist), vector_add(radius_a, radius_b))))
+			return false;
+	}
+
+	return true;
+}
+
+obb_t
+obb_from_points(const vector_t* points, size_t count) {
+	if (!count)
+		return obb(vector(0, 0, 0, 1), vector_zero(), quaternion_identity());
+
+	vector_t sum = vector_zero();
+	for (size_t ipt = 0; ipt < count; ++ipt)
+		sum = vector_add(sum, vector_set_component(points[ipt], 3, 0));
+	const vector_t mean = vector_scale(sum, REAL_C(1.0) / (real)count);
+
+	// Covariance rows accumulated as d * d.x, d * d.y and d * d.z
+	matrix_t covariance = matrix_zero();
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const vector_t d = vector_set_component(vector_sub(points[ipt], mean), 3, 0);
+		covariance.row[0] = vector_muladd(d, vector_shuffle(d, VECTOR_MASK_XXXX), covariance.row[0]);
+		covariance.row[1] = vector_muladd(d, vector_shuffle(d, VECTOR_MASK_YYYY), covariance.row[1]);
+		covariance.row[2] = vector_muladd(d, vector_shuffle(d, VECTOR_MASK_ZZZZ), covariance.row[2]);
+	}
+
+	vector_t variance;
+	matrix_t axes;
+	matrix_eigen_symmetric(covariance, &variance, &axes);
+
+	const matrix_t inverse = matrix_transpose(axes);
+	vector_t local_min = vector_uniform(REAL_MAX);
+	vector_t local_max = vector_uniform(-REAL_MAX);
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		const vector_t local = vector_rotate(vector_sub(points[ipt], mean), inverse);
+		local_min = vector_min(local_min, local);
+		local_max = vector_max(local_max, local);
+	}
+
+	const vector_t local_center = vector_mul(vector_add(local_min, local_max), vector_half());
+	const vector_t center = vector_add(mean, vector_rotate(local_center, axes));
+	const vector_t extent = vector_mul(vector_sub(local_max, local_min), vector_half());
+	return obb(vector_set_component(center, 3, 1), vector_set_component(extent, 3, 0),
+	           quaternion_from_matrix(axes));
+}
+
+obb_t
+obb_transform(const obb_t box, const transform_t transform) {
+	const real scale = vector_w(transform.translation);
+	const matrix_t rotation = matrix_from_quaternion(transform.rotation);
+	const vector_t center =
+	    vector_muladd(vector_rotate(box.center, rotation), vector_uniform(scale), transform.translation);
+	const matrix_t axes = matrix_mul(matrix_from_quaternion(box.rotation), rotation);
+	return obb(vector_set_component(center, 3, 1), vector_scale(box.extent, math_abs(scale)),
+	           quaternion_from_matrix(axes));
+}
+
+obb_t
+obb_transform_matrix(const obb_t box, const matrix_t transform) {
+	// Rows are the transformed half size edge vectors of the box
+	const matrix_t axes = matrix_from_quaternion(box.rotation);
+	matrix_t edge;
+	edge.row[0] = vector_rotate(vector_scale(axes.row[0], vector_x(box.extent)), transform);
+	edge.row[1] = vector_rotate(vector_scale(axes.row[1], vector_y(box.extent)), transform);
+	edge.row[2] = vector_rotate(vector_scale(axes.row[2], vector_z(box.extent)), transform);
+	edge.row[3] = vector(0, 0, 0, 1);
+
+	matrix_t rotation, stretch;
+	matrix_polar_decompose(edge, &rotation, &stretch);
+
+	// Extent along each new axis is the sum of the absolute edge projections, exact when the
+	// transformed edges are orthogonal
+	const matrix_t project = matrix_mul(edge, matrix_transpose(rotation));
+	const vector_t extent =
+	    vector_add(vector_add(vector_abs(project.row[0]), vector_abs(project.row[1])), vector_abs(project.row[2]));
+	const vector_t center = vector_transform(vector_set_component(box.center, 3, 1), transform);
+	return obb(center, vector_set_component(extent, 3, 0), quaternion_from_matrix(rotation));
+}
+
+bool
+obb_overlap(const obb_t box0, const obb_t box1) {
+	return obb_overlap_axes(matrix_from_quaternion(box0.rotation), box0, box1);
+}
+
+static void
+obb_overlap_range(void* context, size_t begin, size_t end) {
+	const obb_overlap_batch_t* batch = context;
+	for (size_t ibox = begin; ibox < end; ++ibox)
+		batch->overlap[ibox] = obb_overlap_axes(batch->axes, batch->box, batch->boxes[ibox]) ? 1 : 0;
+}
+
+void
+obb_overlap_array(const obb_t box, const obb_t* boxes, size_t count, uint8_t* overlap) {
+	obb_overlap_batch_t batch;
+	batch.axes = matrix_from_quaternion(box.rotation);
+	batch.box = box;
+	batch.boxes = boxes;
+	batch.overlap = overlap;
+	vector_parallel_for(STRING_CONST("obb_overlap_array"), obb_overlap_range, &batch, count, 0);
+}
@@ -0,0 +1,140 @@
+/* obb.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file obb.h
+    Oriented bounding box. A point p in box local space maps to
+    center + p * matrix_from_quaternion(rotation) in the row vector convention of matrix.h, so the
+    rows of the rotation matrix are the box axes. Overlap tests use the separating axis theorem over
+    the three face axes of each box and the nine edge cross products, evaluated three axes at a
+    time as vector operations. Array variants are split across the job threads with
+    vector_parallel_for. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+#include <vector/quaternion.h>
+#include <vector/aabb.h>
+#include <vector/ray.h>
+
+//! Construct from center, half extents and rotation
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL obb_t
+obb(const vector_t center, const vector_t extent, const quaternion_t rotation);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL obb_t
+obb_from_aabb(const aabb_t box);
+
+//! Local to world matrix, rows 0-2 are the unit box axes and row 3 is the center
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+obb_matrix(const obb_t box);
+
+//! Smallest axis aligned box containing the oriented box
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+obb_aabb(const obb_t box);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+obb_contains_point(const obb_t box, const vector_t point);
+
+//! Slab test of ray against oriented box in range [0, tmax], done in box local space. Returns entry
+//! distance in distance, which is zero if ray origin is inside the box
+//! \param r Ray
+//! \param box Box
+//! \param tmax Max distance
+//! \param distance Entry distance output, can be null
+//! \return true if ray hits box, false if not
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_obb(const ray_t r, const obb_t box, real tmax, real* distance);
+
+//! Fit box to points. Axes are the eigenvectors of the point covariance, ordered by decreasing
+//! variance, and extents are the min and max projections onto the axes
+//! \param points Points, w component is ignored
+//! \param count Number of points, zero gives a zero box at origin
+VECTOR_API obb_t
+obb_from_points(const vector_t* points, size_t count);
+
+//! Transform box by rotation, translation and uniform scale (w component of translation)
+VECTOR_API obb_t
+obb_transform(const obb_t box, const transform_t transform);
+
+//! Transform box by affine matrix. For matrices with shear or scale that is not aligned with the
+//! box axes the result is not a box, the returned box is oriented by the rotation from the polar
+//! decomposition of the transformed axes and encloses the transformed box
+VECTOR_API obb_t
+obb_transform_matrix(const obb_t box, const matrix_t transform);
+
+//! Test if boxes overlap, touching boxes are considered overlapping
+VECTOR_API bool
+obb_overlap(const obb_t box0, const obb_t box1);
+
+//! Test one box against many
+//! \param box Box to test
+//! \param boxes Boxes to test against
+//! \param count Number of boxes
+//! \param overlap Output, 1 for boxes overlapping box and 0 for the others
+VECTOR_API void
+obb_overlap_array(const obb_t box, const obb_t* boxes, size_t count, uint8_t* overlap);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL obb_t
+obb(const vector_t center, const vector_t extent, const quaternion_t rotation) {
+	obb_t box;
+	box.center = center;
+	box.extent = extent;
+	box.rotation = rotation;
+	return box;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL obb_t
+obb_from_aabb(const aabb_t box) {
+	// Identity rotation, quaternion.h may not be fully declared yet when included through it
+	return obb(aabb_center(box), vector_mul(aabb_size(box), vector_half()), vector(0, 0, 0, 1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+obb_matrix(const obb_t box) {
+	matrix_t m = matrix_from_quaternion(box.rotation);
+	m.row[3] = vector_set_component(box.center, 3, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL aabb_t
+obb_aabb(const obb_t box) {
+	const matrix_t axes = matrix_from_quaternion(box.rotation);
+	const vector_t half = vector_muladd(
+	    vector_abs(axes.row[2]), vector_shuffle(box.extent, VECTOR_MASK_ZZZZ),
+	    vector_muladd(vector_abs(axes.row[1]), vector_shuffle(box.extent, VECTOR_MASK_YYYY),
+	                  vector_mul(vector_abs(axes.row[0]), vector_shuffle(box.extent, VECTOR_MASK_XXXX))));
+	return aabb(vector_sub(box.center, half), vector_add(box.center, half));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL bool
+obb_contains_point(const obb_t box, const vector_t point) {
+	const matrix_t inverse = matrix_transpose(matrix_from_quaternion(box.rotation));
+	const vector_t local = vector_abs(vector_rotate(vector_sub(point, box.center), inverse));
+	const vectori_t inside = vector_lequal(local, box.extent);
+	return vectori_x(inside) && vectori_y(inside) && vectori_z(inside);
+}
+
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_obb(const ray_t r, const obb_t box, real tmax, real* distance) {
+	// Rotation preserves lengths, so distances in local space are the same as in world space
+	const matrix_t inverse = matrix_transpose(matrix_from_quaternion(box.rotation));
+	const vector_t origin = vector_rotate(vector_sub(r.origin, box.center), inverse);
+	const ray_t local = ray(origin, vector_rotate(r.direction, inverse));
+	return ray_intersect_aabb(local, ray_inverse_direction(local), aabb(vector_neg(box.extent), box.extent), tmax,
+	                          distance);
+}
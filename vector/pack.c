@@ -0,0 +1,375 @@
+/* pack.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/pack.h>
+#include <vector/quaternion.h>
+#include <vector/internal.h>
+
+#define PACK_HALF_SQRT2 REAL_C(0.70710678118654752440)
+
+static FOUNDATION_FORCEINLINE vectori_t
+pack_load(const int32_t* in) {
+	return vectori(in[0], in[1], in[2], in[3]);
+}
+
+static FOUNDATION_FORCEINLINE void
+pack_store(const vectori_t v, int32_t* out) {
+	out[0] = vectori_x(v);
+	out[1] = vectori_y(v);
+	out[2] = vectori_z(v);
+	out[3] = vectori_w(v);
+}
+
+//! Quantize three smallest components of four quaternions to [0, 2^bits - 2], so zero is exact
+static FOUNDATION_FORCEINLINE vectori_t
+pack_smallest3(const quaternion_t* q, unsigned int bits, vectori_t* component) {
+	vector_t col[4];
+	vector_transpose4(q[0], q[1], q[2], q[3], col);
+	const vector_t zero = vector_zero();
+	const vector_t abs_x = vector_abs(col[0]);
+	const vector_t abs_y = vector_abs(col[1]);
+	const vector_t abs_z = vector_abs(col[2]);
+	const vector_t abs_w = vector_abs(col[3]);
+	const vector_t largest = vector_max(vector_max(abs_x, abs_y), vector_max(abs_z, abs_w));
+
+	// Lowest index of the largest component
+	vectori_t index = vectori_uniform(3);
+	index = vectori_select(vector_equal(abs_z, largest), vectori_uniform(2), index);
+	index = vectori_select(vector_equal(abs_y, largest), vectori_one(), index);
+	index = vectori_select(vector_equal(abs_x, largest), vectori_zero(), index);
+	const vectori_t is0 = vectori_equal(index, vectori_zero());
+	const vectori_t is1 = vectori_equal(index, vectori_one());
+	const vectori_t is2 = vectori_equal(index, vectori_uniform(2));
+	const vectori_t below2 = vectori_or(is0, is1);
+	const vectori_t below3 = vectori_or(below2, is2);
+
+	// Negate quaternion if needed to make the largest component positive
+	const vector_t value = vector_select(is0, col[0], vector_select(is1, col[1], vector_select(is2, col[2], col[3])));
+	const vector_t sign = vector_select(vector_less(value, zero), vector_uniform(-1), vector_one());
+
+	const real range = (real)((1U << (bits - 1)) - 1);
+	const vector_t half_max = vector_uniform(range);
+	const vector_t scale = vector_scale(sign, range / PACK_HALF_SQRT2);
+	const vector_t limit = vector_uniform(range * 2);
+	const vector_t remain[3] = {vector_select(is0, col[1], col[0]), vector_select(below2, col[2], col[1]),
+	                            vector_select(below3, col[3], col[2])};
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		const vector_t quantized = vector_muladd(remain[icomp], scale, half_max);
+		component[icomp] = vector_to_vectori_round(vector_min(vector_max(quantized, zero), limit));
+	}
+	return index;
+}
+
+//! Reconstruct four quaternions from index of largest component and the quantized others
+static FOUNDATION_FORCEINLINE void
+pack_unsmallest3(const vectori_t index, const vectori_t* component, unsigned int bits, quaternion_t* q) {
+	const real range = (real)((1U << (bits - 1)) - 1);
+	const vector_t half_max = vector_uniform(range);
+	const vector_t scale = vector_uniform(PACK_HALF_SQRT2 / range);
+	vector_t remain[3];
+	for (int icomp = 0; icomp < 3; ++icomp)
+		remain[icomp] = vector_mul(vector_sub(vectori_to_vector(component[icomp]), half_max), scale);
+	const vector_t sum =
+	    vector_muladd(remain[0], remain[0], vector_muladd(remain[1], remain[1], vector_mul(remain[2], remain[2])));
+	const vector_t largest = vector_sqrt(vector_max(vector_sub(vector_one(), sum), vector_zero()));
+
+	const vectori_t is0 = vectori_equal(index, vectori_zero());
+	const vectori_t is1 = vectori_equal(index, vectori_one());
+	const vectori_t is2 = vectori_equal(index, vectori_uniform(2));
+	const vectori_t is3 = vectori_equal(index, vectori_uniform(3));
+	const vectori_t below2 = vectori_or(is0, is1);
+	vector_t col[4];
+	col[0] = vector_select(is0, largest, remain[0]);
+	col[1] = vector_select(is0, remain[0], vector_select(is1, largest, remain[1]));
+	col[2] = vector_select(below2, remain[1], vector_select(is2, largest, remain[2]));
+	col[3] = vector_select(is3, largest, remain[2]);
+
+	// Normalize to remove the quantization error in length
+	const vector_t length_sqr = vector_muladd(
+	    col[0], col[0], vector_muladd(col[1], col[1], vector_muladd(col[2], col[2], vector_mul(col[3], col[3]))));
+	const vector_t inv_length = vector_div(vector_one(), vector_sqrt(length_sqr));
+	for (int icomp = 0; icomp < 4; ++icomp)
+		col[icomp] = vector_mul(col[icomp], inv_length);
+	vector_transpose4(col[0], col[1], col[2], col[3], q);
+}
+
+static void
+pack_smallest3_32(const quaternion_t* q, uint32_t* out) {
+	vectori_t component[3];
+	const vectori_t index = pack_smallest3(q, 10, component);
+	const vectori_t packed =
+	    vectori_or(vectori_or(vectori_shift_left(index, 30), vectori_shift_left(component[0], 20)),
+	               vectori_or(vectori_shift_left(component[1], 10), component[2]));
+	pack_store(packed, (int32_t*)out);
+}
+
+static void
+pack_unsmallest3_32(const uint32_t* in, quaternion_t* q) {
+	const vectori_t packed = pack_load((const int32_t*)in);
+	const vectori_t mask = vectori_uniform(0x3FF);
+	vectori_t component[3];
+	component[0] = vectori_and(vectori_shift_right_logical(packed, 20), mask);
+	component[1] = vectori_and(vectori_shift_right_logical(packed, 10), mask);
+	component[2] = vectori_and(packed, mask);
+	pack_unsmallest3(vectori_shift_right_logical(packed, 30), component, 10, q);
+}
+
+static void
+pack_smallest3_48(const quaternion_t* q, uint16_t* out) {
+	// Index bits are stored in the top bit of the first two values
+	vectori_t component[3];
+	const vectori_t index = pack_smallest3(q, 15, component);
+	const vectori_t low = vectori_shift_left(vectori_and(index, vectori_one()), 15);
+	const vectori_t high = vectori_shift_left(vectori_shift_right_logical(index, 1), 15);
+	int32_t value[3][4];
+	pack_store(vectori_or(component[0], low), value[0]);
+	pack_store(vectori_or(component[1], high), value[1]);
+	pack_store(component[2], value[2]);
+	for (int iquat = 0; iquat < 4; ++iquat) {
+		out[(iquat * 3) + 0] = (uint16_t)value[0][iquat];
+		out[(iquat * 3) + 1] = (uint16_t)value[1][iquat];
+		out[(iquat * 3) + 2] = (uint16_t)value[2][iquat];
+	}
+}
+
+static void
+pack_unsmallest3_48(const uint16_t* in, quaternion_t* q) {
+	const vectori_t value[3] = {vectori(in[0], in[3], in[6], in[9]), vectori(in[1], in[4], in[7], in[10]),
+	                            vectori(in[2], in[5], in[8], in[11])};
+	const vectori_t mask = vectori_uniform(0x7FFF);
+	const vectori_t high = vectori_shift_right_logical(value[1], 15);
+	const vectori_t index = vectori_or(vectori_shift_right_logical(value[0], 15), vectori_shift_left(high, 1));
+	vectori_t component[3];
+	component[0] = vectori_and(value[0], mask);
+	component[1] = vectori_and(value[1], mask);
+	component[2] = value[2];
+	pack_unsmallest3(index, component, 15, q);
+}
+
+//! Map four unit vectors to the octahedron and quantize to [0, 2^bits - 2] per component so the
+//! axes are exact, v above u
+static FOUNDATION_FORCEINLINE vectori_t
+pack_octahedral(const vector_t* v, unsigned int bits) {
+	vector_t col[4];
+	vector_transpose4(v[0], v[1], v[2], v[3], col);
+	const vector_t zero = vector_zero();
+	const vector_t one = vector_one();
+	const vector_t neg_one = vector_uniform(-1);
+	const vector_t abs_sum =
+	    vector_add(vector_add(vector_abs(col[0]), vector_abs(col[1])), vector_abs(col[2]));
+	const vector_t inv_sum = vector_div(one, vector_max(abs_sum, vector_uniform(REAL_C(1e-30))));
+	const vector_t px = vector_mul(col[0], inv_sum);
+	const vector_t py = vector_mul(col[1], inv_sum);
+
+	// Lower hemisphere is folded over the diagonals
+	const vector_t sign_x = vector_select(vector_gequal(px, zero), one, neg_one);
+	const vector_t sign_y = vector_select(vector_gequal(py, zero), one, neg_one);
+	const vector_t fold_x = vector_mul(vector_sub(one, vector_abs(py)), sign_x);
+	const vector_t fold_y = vector_mul(vector_sub(one, vector_abs(px)), sign_y);
+	const vectori_t lower = vector_less(col[2], zero);
+	const vector_t ox = vector_select(lower, fold_x, px);
+	const vector_t oy = vector_select(lower, fold_y, py);
+
+	const vector_t half_max = vector_uniform((real)((1U << (bits - 1)) - 1));
+	const vectori_t u = vector_to_vectori_round(vector_muladd(ox, half_max, half_max));
+	const vectori_t w = vector_to_vectori_round(vector_muladd(oy, half_max, half_max));
+	return vectori_or(u, vectori_shift_left(w, bits));
+}
+
+static FOUNDATION_FORCEINLINE void
+pack_unoctahedral(const vectori_t packed, unsigned int bits, vector_t* v) {
+	const vectori_t mask = vectori_uniform((int32_t)((1U << bits) - 1));
+	const vector_t zero = vector_zero();
+	const vector_t one = vector_one();
+	const vector_t scale = vector_uniform(REAL_C(1.0) / (real)((1U << (bits - 1)) - 1));
+	const vector_t px = vector_sub(vector_mul(vectori_to_vector(vectori_and(packed, mask)), scale), one);
+	const vector_t py = vector_sub(
+	    vector_mul(vectori_to_vector(vectori_and(vectori_shift_right_logical(packed, bits), mask)), scale), one);
+	vector_t col[4];
+	col[2] = vector_sub(vector_sub(one, vector_abs(px)), vector_abs(py));
+	// Unfold lower hemisphere
+	const vector_t fold = vector_max(vector_neg(col[2]), zero);
+	col[0] = vector_add(px, vector_select(vector_gequal(px, zero), vector_neg(fold), fold));
+	col[1] = vector_add(py, vector_select(vector_gequal(py, zero), vector_neg(fold), fold));
+	const vector_t length_sqr =
+	    vector_muladd(col[0], col[0], vector_muladd(col[1], col[1], vector_mul(col[2], col[2])));
+	const vector_t inv_length = vector_div(one, vector_sqrt(length_sqr));
+	col[0] = vector_mul(col[0], inv_length);
+	col[1] = vector_mul(col[1], inv_length);
+	col[2] = vector_mul(col[2], inv_length);
+	col[3] = zero;
+	vector_transpose4(col[0], col[1], col[2], col[3], v);
+}
+
+void
+quaternion_pack_smallest3_32(const quaternion_t* q, size_t count, uint32_t* out) {
+	size_t iquat = 0;
+	for (; iquat + 4 <= count; iquat += 4)
+		pack_smallest3_32(q + iquat, out + iquat);
+	if (iquat < count) {
+		// Pad last group with identity rotations
+		quaternion_t last[4] = {quaternion_identity(), quaternion_identity(), quaternion_identity(),
+		                        quaternion_identity()};
+		uint32_t packed[4];
+		memcpy(last, q + iquat, sizeof(quaternion_t) * (count - iquat));
+		pack_smallest3_32(last, packed);
+		memcpy(out + iquat, packed, sizeof(uint32_t) * (count - iquat));
+	}
+}
+
+void
+quaternion_unpack_smallest3_32(const uint32_t* in, size_t count, quaternion_t* q) {
+	size_t iquat = 0;
+	for (; iquat + 4 <= count; iquat += 4)
+		pack_unsmallest3_32(in + iquat, q + iquat);
+	if (iquat < count) {
+		uint32_t packed[4] = {0};
+		quaternion_t last[4];
+		memcpy(packed, in + iquat, sizeof(uint32_t) * (count - iquat));
+		pack_unsmallest3_32(packed, last);
+		memcpy(q + iquat, last, sizeof(quaternion_t) * (count - iquat));
+	}
+}
+
+void
+quaternion_pack_smallest3_48(const quaternion_t* q, size_t count, uint16_t* out) {
+	size_t iquat = 0;
+	for (; iquat + 4 <= count; iquat += 4)
+		pack_smallest3_48(q + iquat, out + (iquat * 3));
+	if (iquat < count) {
+		quaternion_t last[4] = {quaternion_identity(), quaternion_identity(), quaternion_identity(),
+		                        quaternion_identity()};
+		uint16_t packed[12];
+		memcpy(last, q + iquat, sizeof(quaternion_t) * (count - iquat));
+		pack_smallest3_48(last, packed);
+		memcpy(out + (iquat * 3), packed, sizeof(uint16_t) * 3 * (count - iquat));
+	}
+}
+
+void
+quaternion_unpack_smallest3_48(const uint16_t* in, size_t count, quaternion_t* q) {
+	size_t iquat = 0;
+	for (; iquat + 4 <= count; iquat += 4)
+		pack_unsmallest3_48(in + (iquat * 3), q + iquat);
+	if (iquat < count) {
+		uint16_t packed[12] = {0};
+		quaternion_t last[4];
+		memcpy(packed, in + (iquat * 3), sizeof(uint16_t) * 3 * (count - iquat));
+		pack_unsmallest3_48(packed, last);
+		memcpy(q + iquat, last, sizeof(quaternion_t) * (count - iquat));
+	}
+}
+
+//! Pack vectors with octahedral mapping, giving four packed values per group. Last group
+//! is padded with z axis vectors
+static void
+pack_octahedral_array(const vector_t* v, size_t count, unsigned int bits, int32_t* packed) {
+	size_t ivec = 0;
+	for (; ivec + 4 <= count; ivec += 4)
+		pack_store(pack_octahedral(v + ivec, bits), packed + ivec);
+	if (ivec < count) {
+		vector_t last[4] = {vector_zaxis(), vector_zaxis(), vector_zaxis(), vector_zaxis()};
+		memcpy(last, v + ivec, sizeof(vector_t) * (count - ivec));
+		pack_store(pack_octahedral(last, bits), packed + ivec);
+	}
+}
+
+//! Unpack four vectors at a time with octahedral mapping, packed must hold whole groups
+static void
+pack_unoctahedral_array(const int32_t* packed, size_t count, unsigned int bits, vector_t* v) {
+	size_t ivec = 0;
+	for (; ivec + 4 <= count; ivec += 4)
+		pack_unoctahedral(pack_load(packed + ivec), bits, v + ivec);
+	if (ivec < count) {
+		vector_t last[4];
+		pack_unoctahedral(pack_load(packed + ivec), bits, last);
+		memcpy(v + ivec, last, sizeof(vector_t) * (count - ivec));
+	}
+}
+
+//! Elements converted per step by array functions needing an intermediate buffer
+#define PACK_BLOCK 256
+
+void
+vector_pack_octahedral16(const vector_t* v, size_t count, uint16_t* out) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		pack_octahedral_array(v + offset, block, 8, packed);
+		for (size_t ivec = 0; ivec < block; ++ivec)
+			out[offset + ivec] = (uint16_t)packed[ivec];
+	}
+}
+
+void
+vector_unpack_octahedral16(const uint16_t* in, size_t count, vector_t* v) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		for (size_t ivec = 0; ivec < ((block + 3) & ~(size_t)3); ++ivec)
+			packed[ivec] = (ivec < block) ? in[offset + ivec] : 0;
+		pack_unoctahedral_array(packed, block, 8, v + offset);
+	}
+}
+
+void
+vector_pack_octahedral24(const vector_t* v, size_t count, uint8_t* out) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		pack_octahedral_array(v + offset, block, 12, packed);
+		uint8_t* dst = out + (offset * 3);
+		for (size_t ivec = 0; ivec < block; ++ivec, dst += 3) {
+			dst[0] = (uint8_t)packed[ivec];
+			dst[1] = (uint8_t)(packed[ivec] >> 8);
+			dst[2] = (uint8_t)(packed[ivec] >> 16);
+		}
+	}
+}
+
+void
+vector_unpack_octahedral24(const uint8_t* in, size_t count, vector_t* v) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		const uint8_t* src = in + (offset * 3);
+		for (size_t ivec = 0; ivec < ((block + 3) & ~(size_t)3); ++ivec, src += 3)
+			packed[ivec] = (ivec < block) ? (int32_t)(src[0] | (src[1] << 8) | (src[2] << 16)) : 0;
+		pack_unoctahedral_array(packed, block, 12, v + offset);
+	}
+}
+
+void
+vector_pack_octahedral32(const vector_t* v, size_t count, uint32_t* out) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		pack_octahedral_array(v + offset, block, 16, packed);
+		memcpy(out + offset, packed, sizeof(uint32_t) * block);
+	}
+}
+
+void
+vector_unpack_octahedral32(const uint32_t* in, size_t count, vector_t* v) {
+	int32_t packed[PACK_BLOCK];
+	for (size_t offset = 0; offset < count; offset += PACK_BLOCK) {
+		const size_t block = (count - offset < PACK_BLOCK) ? (count - offset) : PACK_BLOCK;
+		memcpy(packed, in + offset, sizeof(uint32_t) * block);
+		for (size_t ivec = block; ivec < ((block + 3) & ~(size_t)3); ++ivec)
+			packed[ivec] = 0;
+		pack_unoctahedral_array(packed, block, 16, v + offset);
+	}
+}
@@ -0,0 +1,355 @@
+/* particle.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/particle.h>
+#include <vector/soa.h>
+#include <vector/job.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+//! Number of float streams in each buffer
+#define PARTICLE_STREAM_COUNT 8
+
+typedef struct particle_update_t particle_update_t;
+typedef struct particle_cull_t particle_cull_t;
+typedef struct particle_bounds_t particle_bounds_t;
+
+VECTOR_ALIGNED_STRUCT(particle_update_t) {
+	particle_system_t* system;
+	const particle_forces_t* forces;
+	vector_t gravity[3];
+	vector_t drag;
+	vector_t softening;
+	vector_t dt;
+	//! Field bounds minimum and cells per unit
+	vector_t field_min[3];
+	vector_t field_scale[3];
+	vectori_t field_max[3];
+};
+
+struct particle_cull_t {
+	particle_system_t* system;
+	//! Alive count of each chunk, then offset of each chunk in the compacted streams
+	size_t* chunk;
+	float32_t* target[PARTICLE_STREAM_COUNT];
+};
+
+struct particle_bounds_t {
+	const particle_system_t* system;
+	aabb_t* chunk;
+};
+
+static FOUNDATION_FORCEINLINE vector_t
+particle_load(const float32_t* stream, size_t offset) {
+	return vector_unaligned(stream + offset);
+}
+
+static FOUNDATION_FORCEINLINE void
+particle_store(float32_t* stream, size_t offset, const vector_t v) {
+	memcpy(stream + offset, &v, sizeof(vector_t));
+}
+
+//! Streams of buffer in the order position, velocity, age, lifetime
+static void
+particle_streams(float32_t* buffer, size_t stride, float32_t** stream) {
+	for (size_t istream = 0; istream < PARTICLE_STREAM_COUNT; ++istream)
+		stream[istream] = buffer + (istream * stride);
+}
+
+static void
+particle_set_buffer(particle_system_t* system, unsigned int current) {
+	float32_t* stream[PARTICLE_STREAM_COUNT];
+	const size_t stride = (system->capacity + 3) & ~(size_t)3;
+	particle_streams(system->buffer[current], stride, stream);
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		system->position[icomp] = stream[icomp];
+		system->velocity[icomp] = stream[3 + icomp];
+	}
+	system->age = stream[6];
+	system->lifetime = stream[7];
+	system->current = current;
+}
+
+void
+particle_system_initialize(particle_system_t* system, size_t capacity) {
+	memset(system, 0, sizeof(particle_system_t));
+	const size_t stride = (capacity + 3) & ~(size_t)3;
+	const size_t size = sizeof(float32_t) * ((stride > 4) ? stride : 4) * PARTICLE_STREAM_COUNT;
+	system->buffer[0] = memory_allocate(HASH_VECTOR, size, 16, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	system->buffer[1] = memory_allocate(HASH_VECTOR, size, 16, MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	system->capacity = capacity;
+	particle_set_buffer(system, 0);
+}
+
+void
+particle_system_finalize(particle_system_t* system) {
+	memory_deallocate(system->buffer[0]);
+	memory_deallocate(system->buffer[1]);
+	memset(system, 0, sizeof(particle_system_t));
+}
+
+size_t
+particle_emit(particle_system_t* system, const vector_t* position, const vector_t* velocity, const real* lifetime,
+              size_t count) {
+	const size_t available = system->capacity - system->count;
+	if (count > available)
+		count = available;
+	const size_t offset = system->count;
+	soa_from_vector(position, count, system->position[0] + offset, system->position[1] + offset,
+	                system->position[2] + offset, 0);
+	soa_from_vector(velocity, count, system->velocity[0] + offset, system->velocity[1] + offset,
+	                system->velocity[2] + offset, 0);
+	for (size_t iparticle = 0; iparticle < count; ++iparticle) {
+		system->age[offset + iparticle] = 0;
+		system->lifetime[offset + iparticle] = lifetime[iparticle];
+	}
+	system->count += count;
+	return count;
+}
+
+//! Nearest cell value of the field for four positions
+static FOUNDATION_FORCEINLINE void
+particle_field_lookup(const particle_update_t* update, const vector_t* position, vector_t* acceleration) {
+	const particle_field_t* field = update->forces->field;
+	vectori_t cell[3];
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		const vector_t local = vector_mul(vector_sub(position[icomp], update->field_min[icomp]),
+		                                  update->field_scale[icomp]);
+		cell[icomp] = vector_to_vectori_floor(local);
+		cell[icomp] = vectori_min(vectori_max(cell[icomp], vectori_zero()), update->field_max[icomp]);
+	}
+	const vectori_t row = vectori_add(cell[0], vectori_mul(cell[1], vectori_uniform((int32_t)field->dim[0])));
+	const vectori_t slice = vectori_mul(cell[2], vectori_uniform((int32_t)(field->dim[0] * field->dim[1])));
+	const vectori_t index = vectori_add(row, slice);
+	vector_t value[4];
+	value[0] = field->value[vectori_x(index)];
+	value[1] = field->value[vectori_y(index)];
+	value[2] = field->value[vectori_z(index)];
+	value[3] = field->value[vectori_w(index)];
+	vector_t col[4];
+	vector_transpose4(value[0], value[1], value[2], value[3], col);
+	for (int icomp = 0; icomp < 3; ++icomp)
+		acceleration[icomp] = vector_add(acceleration[icomp], col[icomp]);
+}
+
+static void
+particle_update_range(void* context, size_t begin, size_t end) {
+	const particle_update_t* update = context;
+	particle_system_t* system = update->system;
+	const particle_forces_t* forces = update->forces;
+	const vector_t dt = update->dt;
+	vector_t position[3];
+	vector_t velocity[3];
+	vector_t acceleration[3];
+	for (size_t offset = begin * 4; offset < end * 4; offset += 4) {
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			position[icomp] = particle_load(system->position[icomp], offset);
+			velocity[icomp] = particle_load(system->velocity[icomp], offset);
+			acceleration[icomp] = vector_sub(update->gravity[icomp], vector_mul(velocity[icomp], update->drag));
+		}
+
+		// Attractors with inverse square falloff, strength * d / |d|^3
+		for (size_t iattr = 0; iattr < forces->attractor_count; ++iattr) {
+			const vector_t attractor = forces->attractor[iattr];
+			vector_t delta[3];
+			delta[0] = vector_sub(vector_uniform(vector_x(attractor)), position[0]);
+			delta[1] = vector_sub(vector_uniform(vector_y(attractor)), position[1]);
+			delta[2] = vector_sub(vector_uniform(vector_z(attractor)), position[2]);
+			vector_t distance_sqr = vector_muladd(delta[0], delta[0], update->softening);
+			distance_sqr = vector_muladd(delta[1], delta[1], distance_sqr);
+			distance_sqr = vector_muladd(delta[2], delta[2], distance_sqr);
+			const vector_t inv_distance = vector_div(vector_one(), vector_sqrt(distance_sqr));
+			const vector_t inv_distance_cube = vector_mul(inv_distance, vector_mul(inv_distance, inv_distance));
+			const vector_t scale = vector_mul(inv_distance_cube, vector_uniform(vector_w(attractor)));
+			for (int icomp = 0; icomp < 3; ++icomp)
+				acceleration[icomp] = vector_muladd(delta[icomp], scale, acceleration[icomp]);
+		}
+
+		if (forces->field)
+			particle_field_lookup(update, position, acceleration);
+
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			velocity[icomp] = vector_muladd(acceleration[icomp], dt, velocity[icomp]);
+			position[icomp] = vector_muladd(velocity[icomp], dt, position[icomp]);
+			particle_store(system->velocity[icomp], offset, velocity[icomp]);
+			particle_store(system->position[icomp], offset, position[icomp]);
+		}
+		particle_store(system->age, offset, vector_add(particle_load(system->age, offset), dt));
+	}
+}
+
+void
+particle_update(particle_system_t* system, const particle_forces_t* forces, real dt) {
+	particle_update_t update;
+	update.system = system;
+	update.forces = forces;
+	update.gravity[0] = vector_uniform(vector_x(forces->gravity));
+	update.gravity[1] = vector_uniform(vector_y(forces->gravity));
+	update.gravity[2] = vector_uniform(vector_z(forces->gravity));
+	update.drag = vector_uniform(forces->drag);
+	update.softening = vector_uniform(forces->attractor_softening);
+	update.dt = vector_uniform(dt);
+	if (forces->field) {
+		const particle_field_t* field = forces->field;
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			const real extent = vector_component(field->bounds.max, icomp) - vector_component(field->bounds.min, icomp);
+			update.field_min[icomp] = vector_uniform(vector_component(field->bounds.min, icomp));
+			update.field_scale[icomp] = vector_uniform((extent > 0) ? (real)field->dim[icomp] / extent : 0);
+			update.field_max[icomp] = vectori_uniform((int32_t)field->dim[icomp] - 1);
+		}
+	}
+	vector_parallel_for(STRING_CONST("particle_update"), particle_update_range, &update, (system->count + 3) / 4, 0);
+}
+
+static void
+particle_cull_count_range(void* context, size_t begin, size_t end) {
+	particle_cull_t* cull = context;
+	const particle_system_t* system = cull->system;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		const size_t first = ichunk * PARTICLE_CHUNK;
+		const size_t last = (first + PARTICLE_CHUNK < system->count) ? first + PARTICLE_CHUNK : system->count;
+		const size_t last_group = first + ((last - first) & ~(size_t)3);
+		// Alive masks are -1, subtracting them counts alive particles per lane
+		vectori_t alive = vectori_zero();
+		size_t offset = first;
+		for (; offset < last_group; offset += 4) {
+			const vectori_t mask =
+			    vector_less(particle_load(system->age, offset), particle_load(system->lifetime, offset));
+			alive = vectori_sub(alive, mask);
+		}
+		size_t count = (size_t)(vectori_x(alive) + vectori_y(alive) + vectori_z(alive) + vectori_w(alive));
+		for (; offset < last; ++offset)
+			count += (system->age[offset] < system->lifetime[offset]) ? 1 : 0;
+		cull->chunk[ichunk] = count;
+	}
+}
+
+static void
+particle_cull_compact_range(void* context, size_t begin, size_t end) {
+	particle_cull_t* cull = context;
+	const particle_system_t* system = cull->system;
+	const float32_t* source[PARTICLE_STREAM_COUNT] = {
+	    system->position[0], system->position[1], system->position[2], system->velocity[0],
+	    system->velocity[1], system->velocity[2], system->age,         system->lifetime};
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		const size_t first = ichunk * PARTICLE_CHUNK;
+		const size_t last = (first + PARTICLE_CHUNK < system->count) ? first + PARTICLE_CHUNK : system->count;
+		size_t target = cull->chunk[ichunk];
+		for (size_t offset = first; offset < last; ++offset) {
+			if (system->age[offset] >= system->lifetime[offset])
+				continue;
+			for (size_t istream = 0; istream < PARTICLE_STREAM_COUNT; ++istream)
+				cull->target[istream][target] = source[istream][offset];
+			++target;
+		}
+	}
+}
+
+size_t
+particle_cull(particle_system_t* system) {
+	if (!system->count)
+		return 0;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	const size_t chunk_count = (system->count + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK;
+	particle_cull_t cull;
+	cull.system = system;
+	cull.chunk = vector_arena_allocate(arena, sizeof(size_t) * chunk_count, 0);
+	vector_parallel_for(STRING_CONST("particle_cull_count"), particle_cull_count_range, &cull, chunk_count, 1);
+
+	// Exclusive prefix sum gives the first target index of each chunk
+	size_t alive = 0;
+	for (size_t ichunk = 0; ichunk < chunk_count; ++ichunk) {
+		const size_t count = cull.chunk[ichunk];
+		cull.chunk[ichunk] = alive;
+		alive += count;
+	}
+	const size_t removed = system->count - alive;
+	if (removed) {
+		const unsigned int target = system->current ^ 1;
+		particle_streams(system->buffer[target], (system->capacity + 3) & ~(size_t)3, cull.target);
+		vector_parallel_for(STRING_CONST("particle_cull_compact"), particle_cull_compact_range, &cull, chunk_count,
+		                    1);
+		particle_set_buffer(system, target);
+		system->count = alive;
+	}
+	vector_arena_rewind(arena, mark);
+	return removed;
+}
+
+static void
+particle_bounds_range(void* context, size_t begin, size_t end) {
+	particle_bounds_t* bounds = context;
+	const particle_system_t* system = bounds->system;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		const size_t first = ichunk * PARTICLE_CHUNK;
+		const size_t last = (first + PARTICLE_CHUNK < system->count) ? first + PARTICLE_CHUNK : system->count;
+		const size_t last_group = first + ((last - first) & ~(size_t)3);
+		vector_t min[3];
+		vector_t max[3];
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			min[icomp] = vector_uniform(system->position[icomp][first]);
+			max[icomp] = min[icomp];
+		}
+		size_t offset = first;
+		for (; offset < last_group; offset += 4) {
+			for (int icomp = 0; icomp < 3; ++icomp) {
+				const vector_t value = particle_load(system->position[icomp], offset);
+				min[icomp] = vector_min(min[icomp], value);
+				max[icomp] = vector_max(max[icomp], value);
+			}
+		}
+		for (; offset < last; ++offset) {
+			for (int icomp = 0; icomp < 3; ++icomp) {
+				const vector_t value = vector_uniform(system->position[icomp][offset]);
+				min[icomp] = vector_min(min[icomp], value);
+				max[icomp] = vector_max(max[icomp], value);
+			}
+		}
+		// Reduce lanes, transposing gives one component per vector
+		const vector_t min_rows[4] = {min[0], min[1], min[2], vector_zero()};
+		const vector_t max_rows[4] = {max[0], max[1], max[2], vector_zero()};
+		vector_t min_cols[4];
+		vector_t max_cols[4];
+		vector_transpose4(min_rows[0], min_rows[1], min_rows[2], min_rows[3], min_cols);
+		vector_transpose4(max_rows[0], max_rows[1], max_rows[2], max_rows[3], max_cols);
+		const vector_t min_lanes =
+		    vector_min(vector_min(min_cols[0], min_cols[1]), vector_min(min_cols[2], min_cols[3]));
+		const vector_t max_lanes =
+		    vector_max(vector_max(max_cols[0], max_cols[1]), vector_max(max_cols[2], max_cols[3]));
+		bounds->chunk[ichunk] = aabb(min_lanes, max_lanes);
+	}
+}
+
+aabb_t
+particle_bounds(const particle_system_t* system) {
+	aabb_t box = aabb_empty();
+	if (!system->count)
+		return box;
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	const size_t chunk_count = (system->count + PARTICLE_CHUNK - 1) / PARTICLE_CHUNK;
+	particle_bounds_t bounds;
+	bounds.system = system;
+	bounds.chunk = vector_arena_allocate(arena, sizeof(aabb_t) * chunk_count, 0);
+	vector_parallel_for(STRING_CONST("particle_bounds"), particle_bounds_range, &bounds, chunk_count, 1);
+	for (size_t ichunk = 0; ichunk < chunk_count; ++ichunk)
+		box = aabb_merge(box, bounds.chunk[ichunk]);
+	vector_arena_rewind(arena, mark);
+	return box;
+}
@@ -0,0 +1,74 @@
+/* particle.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file particle.h
+    Particle simulation on component streams. Update accumulates gravity, linear drag, point
+    attractors and a vector field lookup, then integrates with semi-implicit Euler and advances
+    age, four particles at a time. Culling removes particles that reached their lifetime with
+    stream compaction into a second set of streams, keeping the order of the remaining
+    particles. All kernels are split across the job threads with vector_parallel_for, culling
+    and bounds work on fixed size chunks with a prefix sum of chunk counts between passes.
+
+    Update processes whole groups of four, particles after count up to the next multiple of
+    four are integrated as well but never read by culling or bounds. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+
+//! Number of particles per chunk in culling and bounds
+#define PARTICLE_CHUNK 4096
+
+//! Allocate streams for particles
+//! \param system Particle system
+//! \param capacity Max number of particles
+VECTOR_API void
+particle_system_initialize(particle_system_t* system, size_t capacity);
+
+VECTOR_API void
+particle_system_finalize(particle_system_t* system);
+
+//! Add particles with zero age
+//! \param system Particle system
+//! \param position Positions
+//! \param velocity Velocities
+//! \param lifetime Lifetimes
+//! \param count Number of particles
+//! \return Number of particles added, limited by capacity
+VECTOR_API size_t
+particle_emit(particle_system_t* system, const vector_t* position, const vector_t* velocity, const real* lifetime,
+              size_t count);
+
+//! Accumulate forces, integrate and advance age
+//! \param system Particle system
+//! \param forces Forces
+//! \param dt Time step
+VECTOR_API void
+particle_update(particle_system_t* system, const particle_forces_t* forces, real dt);
+
+//! Remove particles with age at or past lifetime, keeping the order of remaining particles
+//! \param system Particle system
+//! \return Number of particles removed
+VECTOR_API size_t
+particle_cull(particle_system_t* system);
+
+//! Bounds of particle positions, empty box if there are no particles
+//! \param system Particle system
+VECTOR_API aabb_t
+particle_bounds(const particle_system_t* system);
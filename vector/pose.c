@@ -0,0 +1,167 @@
+/* pose.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/pose.h>
+#include <vector/quaternion.h>
+#include <vector/internal.h>
+
+//! Load up to four bones as component vectors, missing bones are identity
+static FOUNDATION_FORCEINLINE void
+pose_load(const transform_t* pose, size_t remain, vector_t* rotation, vector_t* translation) {
+	vector_t row_rotation[4];
+	vector_t row_translation[4];
+	for (size_t ibone = 0; ibone < 4; ++ibone) {
+		if (ibone < remain) {
+			row_rotation[ibone] = pose[ibone].rotation;
+			row_translation[ibone] = pose[ibone].translation;
+		} else {
+			row_rotation[ibone] = quaternion_identity();
+			row_translation[ibone] = vector(0, 0, 0, 1);
+		}
+	}
+	vector_transpose4(row_rotation[0], row_rotation[1], row_rotation[2], row_rotation[3], rotation);
+	vector_transpose4(row_translation[0], row_translation[1], row_translation[2], row_translation[3], translation);
+}
+
+static FOUNDATION_FORCEINLINE void
+pose_store(const vector_t* rotation, const vector_t* translation, size_t remain, transform_t* pose) {
+	vector_t row_rotation[4];
+	vector_t row_translation[4];
+	vector_transpose4(rotation[0], rotation[1], rotation[2], rotation[3], row_rotation);
+	vector_transpose4(translation[0], translation[1], translation[2], translation[3], row_translation);
+	for (size_t ibone = 0; (ibone < 4) && (ibone < remain); ++ibone) {
+		pose[ibone].rotation = row_rotation[ibone];
+		pose[ibone].translation = row_translation[ibone];
+	}
+}
+
+//! Load up to four weights scaled by factor
+static FOUNDATION_FORCEINLINE vector_t
+pose_load_weight(const real* weight, real factor, size_t remain) {
+	if (!weight)
+		return vector_uniform(factor);
+	real value[4] = {0, 0, 0, 0};
+	for (size_t ibone = 0; (ibone < 4) && (ibone < remain); ++ibone)
+		value[ibone] = weight[ibone] * factor;
+	return vector(value[0], value[1], value[2], value[3]);
+}
+
+void
+pose_blend(const transform_t* a, const transform_t* b, real factor, const real* weight, size_t count,
+           transform_t* out) {
+	vector_t rotation[2][4];
+	vector_t translation[2][4];
+	for (size_t ibone = 0; ibone < count; ibone += 4) {
+		const size_t remain = count - ibone;
+		const vector_t bone_factor = pose_load_weight(weight ? weight + ibone : 0, factor, remain);
+		pose_load(a + ibone, remain, rotation[0], translation[0]);
+		pose_load(b + ibone, remain, rotation[1], translation[1]);
+		quaternion_soa_nlerp(rotation[0], rotation[1], bone_factor, rotation[0]);
+		vector_soa_lerp(translation[0], translation[1], bone_factor, translation[0]);
+		pose_store(rotation[0], translation[0], remain, out + ibone);
+	}
+}
+
+void
+pose_blend_n(const transform_t* const* pose, const real* pose_weight, const real* const* bone_weight,
+             size_t pose_count, size_t count, transform_t* out) {
+	if (!pose_count)
+		return;
+	vector_t reference[4];
+	vector_t reference_translation[4];
+	vector_t rotation[4];
+	vector_t translation[4];
+	vector_t sum[4];
+	vector_t sum_translation[4];
+	for (size_t ibone = 0; ibone < count; ibone += 4) {
+		const size_t remain = count - ibone;
+		pose_load(pose[0] + ibone, remain, reference, reference_translation);
+		vector_t total = vector_zero();
+		for (int icomp = 0; icomp < 4; ++icomp) {
+			sum[icomp] = vector_zero();
+			sum_translation[icomp] = vector_zero();
+		}
+		for (size_t ipose = 0; ipose < pose_count; ++ipose) {
+			const real* weight = (bone_weight && bone_weight[ipose]) ? bone_weight[ipose] + ibone : 0;
+			const vector_t bone_factor = pose_load_weight(weight, pose_weight[ipose], remain);
+			pose_load(pose[ipose] + ibone, remain, rotation, translation);
+			// Accumulate in the hemisphere of the first pose
+			const vectori_t opposite = vector_less(quaternion_soa_dot(reference, rotation), vector_zero());
+			const vector_t rotation_factor = vector_select(opposite, vector_neg(bone_factor), bone_factor);
+			for (int icomp = 0; icomp < 4; ++icomp) {
+				sum[icomp] = vector_muladd(rotation[icomp], rotation_factor, sum[icomp]);
+				sum_translation[icomp] = vector_muladd(translation[icomp], bone_factor, sum_translation[icomp]);
+			}
+			total = vector_add(total, bone_factor);
+		}
+		const vectori_t valid = vector_greater(total, vector_zero());
+		const vector_t inv_total = vector_div(vector_one(), vector_select(valid, total, vector_one()));
+		const vectori_t valid_rotation =
+		    vectori_and(valid, vector_greater(quaternion_soa_dot(sum, sum), vector_zero()));
+		for (int icomp = 0; icomp < 4; ++icomp) {
+			sum[icomp] = vector_select(valid_rotation, sum[icomp], reference[icomp]);
+			sum_translation[icomp] =
+			    vector_select(valid, vector_mul(sum_translation[icomp], inv_total), reference_translation[icomp]);
+		}
+		quaternion_soa_normalize(sum);
+		pose_store(sum, sum_translation, remain, out + ibone);
+	}
+}
+
+void
+pose_additive_make(const transform_t* pose, const transform_t* reference, size_t count, transform_t* delta) {
+	vector_t rotation[2][4];
+	vector_t translation[2][4];
+	for (size_t ibone = 0; ibone < count; ibone += 4) {
+		const size_t remain = count - ibone;
+		pose_load(pose + ibone, remain, rotation[0], translation[0]);
+		pose_load(reference + ibone, remain, rotation[1], translation[1]);
+		rotation[1][0] = vector_neg(rotation[1][0]);
+		rotation[1][1] = vector_neg(rotation[1][1]);
+		rotation[1][2] = vector_neg(rotation[1][2]);
+		quaternion_soa_mul(rotation[1], rotation[0], rotation[0]);
+		translation[0][0] = vector_sub(translation[0][0], translation[1][0]);
+		translation[0][1] = vector_sub(translation[0][1], translation[1][1]);
+		translation[0][2] = vector_sub(translation[0][2], translation[1][2]);
+		translation[0][3] = vector_div(translation[0][3], translation[1][3]);
+		pose_store(rotation[0], translation[0], remain, delta + ibone);
+	}
+}
+
+void
+pose_additive_apply(const transform_t* base, const transform_t* delta, real factor, const real* weight,
+                    size_t count, transform_t* out) {
+	const vector_t zero = vector_zero();
+	const vector_t one = vector_one();
+	const vector_t identity[4] = {zero, zero, zero, one};
+	const vector_t identity_translation[4] = {zero, zero, zero, one};
+	vector_t rotation[2][4];
+	vector_t translation[2][4];
+	for (size_t ibone = 0; ibone < count; ibone += 4) {
+		const size_t remain = count - ibone;
+		const vector_t bone_factor = pose_load_weight(weight ? weight + ibone : 0, factor, remain);
+		pose_load(base + ibone, remain, rotation[0], translation[0]);
+		pose_load(delta + ibone, remain, rotation[1], translation[1]);
+		quaternion_soa_nlerp(identity, rotation[1], bone_factor, rotation[1]);
+		quaternion_soa_mul(rotation[0], rotation[1], rotation[0]);
+		vector_soa_lerp(identity_translation, translation[1], bone_factor, translation[1]);
+		translation[0][0] = vector_add(translation[0][0], translation[1][0]);
+		translation[0][1] = vector_add(translation[0][1], translation[1][1]);
+		translation[0][2] = vector_add(translation[0][2], translation[1][2]);
+		translation[0][3] = vector_mul(translation[0][3], translation[1][3]);
+		pose_store(rotation[0], translation[0], remain, out + ibone);
+	}
+}
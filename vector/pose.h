@@ -0,0 +1,77 @@
+/* pose.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file pose.h
+    Blending of poses, arrays of bone transforms. Bones are processed four at a time with the
+    transforms transposed to component vectors. Rotations are blended with normalized lerp,
+    negating rotations in the opposite hemisphere so the shortest arc is used. Translation and
+    the uniform scale in translation w are blended linearly.
+
+    Per-bone weights scale the blend factor of each bone, and act as masks where a weight of
+    zero leaves the bone of the first pose unchanged. Weight arrays can be null for a weight of
+    one for all bones. Output can alias any input pose. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Blend two poses
+//! \param a First pose
+//! \param b Second pose
+//! \param factor Blend factor, 0 gives a and 1 gives b
+//! \param weight Per-bone weights scaling factor, can be null
+//! \param count Number of bones
+//! \param out Output pose
+VECTOR_API void
+pose_blend(const transform_t* a, const transform_t* b, real factor, const real* weight, size_t count,
+           transform_t* out);
+
+//! Blend any number of poses by weighted average. Rotations are accumulated in the hemisphere
+//! of the first pose. Bones with a total weight of zero are set from the first pose
+//! \param pose Poses
+//! \param pose_weight Weight of each pose
+//! \param bone_weight Per-bone weights of each pose, can be null or contain null arrays
+//! \param pose_count Number of poses
+//! \param count Number of bones
+//! \param out Output pose
+VECTOR_API void
+pose_blend_n(const transform_t* const* pose, const real* pose_weight, const real* const* bone_weight,
+             size_t pose_count, size_t count, transform_t* out);
+
+//! Make additive pose as the difference of pose from a reference pose. Rotation of delta is the
+//! Hamilton product conjugate(reference) * pose, the rotation from reference to pose in the
+//! local space of the bone. Translation is the difference and scale the ratio
+//! \param pose Pose
+//! \param reference Reference pose
+//! \param count Number of bones
+//! \param delta Output additive pose
+VECTOR_API void
+pose_additive_make(const transform_t* pose, const transform_t* reference, size_t count, transform_t* delta);
+
+//! Apply additive pose on top of a base pose. The delta is first blended from identity by the
+//! factor, then rotation is the Hamilton product base * delta, translation added and scale
+//! multiplied
+//! \param base Base pose
+//! \param delta Additive pose
+//! \param factor Blend factor of the additive pose
+//! \param weight Per-bone weights scaling factor, can be null
+//! \param count Number of bones
+//! \param out Output pose
+VECTOR_API void
+pose_additive_apply(const transform_t* base, const transform_t* delta, real factor, const real* weight,
+                    size_t count, transform_t* out);
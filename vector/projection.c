@@ -0,0 +1,126 @@
+/* projection.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/projection.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+typedef struct projection_points_t projection_points_t;
+
+VECTOR_ALIGNED_STRUCT(projection_points_t) {
+	matrix_t transform;
+	//! Viewport scale and offset in all lanes, y scale is negated to point down
+	vector_t scale_x;
+	vector_t scale_y;
+	vector_t offset_x;
+	vector_t offset_y;
+	//! Clip space depth of min depth plane in units of w, -1 or 0
+	vector_t min_depth;
+	//! Clip bits for points below min depth and above max depth
+	vectori_t min_clip;
+	vectori_t max_clip;
+	const vector_t* point;
+	size_t count;
+	vector_t* screen;
+	uint8_t* clip;
+};
+
+//! Reciprocal estimate refined with Newton-Raphson steps, r' = r * (2 - v * r)
+static FOUNDATION_FORCEINLINE vector_t
+projection_reciprocal(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	// Estimate instructions differ between processors
+	return vector_div(vector_one(), v);
+#elif VECTOR_IMPLEMENTATION_SSE4 || VECTOR_IMPLEMENTATION_SSE3 || VECTOR_IMPLEMENTATION_SSE2
+	const vector_t r = _mm_rcp_ps(v);
+	return vector_mul(r, vector_sub(vector_two(), vector_mul(v, r)));
+#elif VECTOR_IMPLEMENTATION_NEON
+	// Estimate has only about eight bits, two steps reach the precision of the SSE version
+	vector_t r = vrecpeq_f32(v);
+	r = vmulq_f32(r, vrecpsq_f32(v, r));
+	return vmulq_f32(r, vrecpsq_f32(v, r));
+#else
+	return vector_div(vector_one(), v);
+#endif
+}
+
+static FOUNDATION_FORCEINLINE vectori_t
+projection_clip_bit(const vectori_t outside, int32_t bit) {
+	return vectori_and(outside, vectori_uniform(bit));
+}
+
+static void
+projection_points_range(void* context, size_t begin, size_t end) {
+	const projection_points_t* project = context;
+	const matrix_t transform = project->transform;
+	// Groups of four points, transposed to one vector per clip space component
+	for (size_t group = begin; group < end; ++group) {
+		const size_t offset = group * 4;
+		const size_t valid = (offset + 4 <= project->count) ? 4 : project->count - offset;
+		vector_t clip[4];
+		for (size_t ipt = 0; ipt < 4; ++ipt)
+			clip[ipt] = vector_transform(project->point[offset + ((ipt < valid) ? ipt : 0)], transform);
+		vector_t comp[4];
+		vector_transpose4(clip[0], clip[1], clip[2], clip[3], comp);
+
+		const vector_t w = comp[3];
+		const vector_t neg_w = vector_neg(w);
+		vectori_t mask = projection_clip_bit(vector_less(comp[0], neg_w), PROJECTION_CLIP_LEFT);
+		mask = vectori_or(mask, projection_clip_bit(vector_greater(comp[0], w), PROJECTION_CLIP_RIGHT));
+		mask = vectori_or(mask, projection_clip_bit(vector_less(comp[1], neg_w), PROJECTION_CLIP_BOTTOM));
+		mask = vectori_or(mask, projection_clip_bit(vector_greater(comp[1], w), PROJECTION_CLIP_TOP));
+		mask = vectori_or(mask, vectori_and(vector_less(comp[2], vector_mul(project->min_depth, w)),
+		                                    project->min_clip));
+		mask = vectori_or(mask, vectori_and(vector_greater(comp[2], w), project->max_clip));
+		mask = vectori_or(mask, projection_clip_bit(vector_lequal(w, vector_zero()), PROJECTION_CLIP_NEAR));
+
+		const vector_t inv_w = projection_reciprocal(w);
+		const vector_t screen_x = vector_muladd(vector_mul(comp[0], inv_w), project->scale_x, project->offset_x);
+		const vector_t screen_y = vector_muladd(vector_mul(comp[1], inv_w), project->scale_y, project->offset_y);
+		const vector_t depth = vector_mul(comp[2], inv_w);
+		vector_t out[4];
+		vector_transpose4(screen_x, screen_y, depth, inv_w, out);
+
+		const int32_t lane[4] = {vectori_x(mask), vectori_y(mask), vectori_z(mask), vectori_w(mask)};
+		for (size_t ipt = 0; ipt < valid; ++ipt) {
+			project->screen[offset + ipt] = out[ipt];
+			project->clip[offset + ipt] = (uint8_t)lane[ipt];
+		}
+	}
+}
+
+void
+vector_project_points(const matrix_t transform, unsigned int flags, const vector_t viewport, const vector_t* point,
+                      size_t count, vector_t* screen, uint8_t* clip) {
+	projection_points_t project;
+	const real half_width = vector_z(viewport) * REAL_C(0.5);
+	const real half_height = vector_w(viewport) * REAL_C(0.5);
+	const bool reversed = (flags & PROJECTION_REVERSED_Z) != 0;
+	project.transform = transform;
+	project.scale_x = vector_uniform(half_width);
+	project.scale_y = vector_uniform(-half_height);
+	project.offset_x = vector_uniform(vector_x(viewport) + half_width);
+	project.offset_y = vector_uniform(vector_y(viewport) + half_height);
+	project.min_depth = vector_uniform((flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1);
+	project.min_clip = vectori_uniform(reversed ? PROJECTION_CLIP_FAR : PROJECTION_CLIP_NEAR);
+	project.max_clip = vectori_uniform(reversed ? PROJECTION_CLIP_NEAR : PROJECTION_CLIP_FAR);
+	project.point = point;
+	project.count = count;
+	project.screen = screen;
+	project.clip = clip;
+	vector_parallel_for(STRING_CONST("vector_project_points"), projection_points_range, &project, (count + 3) / 4,
+	                    0);
+}
@@ -0,0 +1,141 @@
+/* projection.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file projection.h
+    View and projection matrices and batch projection of points to screen space. Matrices use
+    the row vector convention of matrix.h and a right handed view space where the camera looks
+    down the negative z axis with y up. Projections map the view frustum to clip space where x
+    and y are in [-w, w] and depth is in [-w, w] or [0, w] depending on the projection flags. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+#include <vector/scalar.h>
+
+//! Perspective projection
+//! \param fov_y Vertical field of view in radians
+//! \param aspect Aspect ratio, width divided by height
+//! \param znear Distance to near plane, must be positive
+//! \param zfar Distance to far plane, ignored with PROJECTION_INFINITE_FAR
+//! \param flags Projection flags, see projection_flag_t
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_perspective(real fov_y, real aspect, real znear, real zfar, unsigned int flags);
+
+//! Orthographic projection of the given view space box
+//! \param flags Projection flags, see projection_flag_t. PROJECTION_INFINITE_FAR is ignored
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_orthographic(real left, real right, real bottom, real top, real znear, real zfar, unsigned int flags);
+
+//! View matrix of camera at eye looking in the given direction
+//! \param eye Camera position
+//! \param direction View direction, need not be normalized
+//! \param up Up direction, must not be parallel to view direction
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_look_to(const vector_t eye, const vector_t direction, const vector_t up);
+
+//! View matrix of camera at eye looking at target, same as matrix_look_to(eye, target - eye, up)
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_look_at(const vector_t eye, const vector_t target, const vector_t up);
+
+//! Project points to screen space, split across the job threads with vector_parallel_for. Points are
+//! transformed to clip space, classified against the frustum planes and divided by w using a reciprocal
+//! approximation refined with Newton-Raphson iteration (exact division in deterministic mode). Screen space
+//! has the origin at the top left corner of the viewport with y pointing down. Output is
+//! [screen x, screen y, normalized depth, 1 / w], undefined for points at or behind the eye plane
+//! \param transform View projection matrix
+//! \param flags Projection flags the projection matrix was built with, see projection_flag_t
+//! \param viewport Viewport as [x, y, width, height] in pixels
+//! \param point Input points, w component is used as is
+//! \param count Number of points
+//! \param screen Output screen coordinates
+//! \param clip Output clip masks, see projection_clip_t. Zero for points inside the frustum
+VECTOR_API void
+vector_project_points(const matrix_t transform, unsigned int flags, const vector_t viewport, const vector_t* point,
+                      size_t count, vector_t* screen, uint8_t* clip);
+
+//! Depth of near and far plane in normalized device coordinates
+static FOUNDATION_FORCEINLINE void
+projection_depth_range(unsigned int flags, real* near_depth, real* far_depth) {
+	const real min_depth = (flags & PROJECTION_DEPTH_ZERO_TO_ONE) ? 0 : -1;
+	*near_depth = (flags & PROJECTION_REVERSED_Z) ? 1 : min_depth;
+	*far_depth = (flags & PROJECTION_REVERSED_Z) ? min_depth : 1;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_perspective(real fov_y, real aspect, real znear, real zfar, unsigned int flags) {
+	const real ys = REAL_C(1.0) / vector_scalar_tan(fov_y * REAL_C(0.5));
+	const real xs = ys / aspect;
+	real near_depth, far_depth;
+	projection_depth_range(flags, &near_depth, &far_depth);
+	// Depth is (scale * z + offset) / -z, solved for the depth at the near and far planes. Written
+	// without differences of near equal terms to keep precision for reversed depth
+	real scale, offset;
+	if (flags & PROJECTION_INFINITE_FAR) {
+		scale = -far_depth;
+		offset = (near_depth - far_depth) * znear;
+	} else {
+		const real range = zfar - znear;
+		scale = (near_depth * znear - far_depth * zfar) / range;
+		offset = (near_depth - far_depth) * znear * zfar / range;
+	}
+	matrix_t m;
+	m.row[0] = vector(xs, 0, 0, 0);
+	m.row[1] = vector(0, ys, 0, 0);
+	m.row[2] = vector(0, 0, scale, -1);
+	m.row[3] = vector(0, 0, offset, 0);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_orthographic(real left, real right, real bottom, real top, real znear, real zfar, unsigned int flags) {
+	const real width = right - left;
+	const real height = top - bottom;
+	const real range = zfar - znear;
+	real near_depth, far_depth;
+	projection_depth_range(flags, &near_depth, &far_depth);
+	matrix_t m;
+	m.row[0] = vector(REAL_C(2.0) / width, 0, 0, 0);
+	m.row[1] = vector(0, REAL_C(2.0) / height, 0, 0);
+	m.row[2] = vector(0, 0, (near_depth - far_depth) / range, 0);
+	m.row[3] = vector(-(right + left) / width, -(top + bottom) / height,
+	                  (near_depth * zfar - far_depth * znear) / range, 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_look_to(const vector_t eye, const vector_t direction, const vector_t up) {
+	const vector_t forward = vector_set_component(vector_normalize3(direction), 3, 0);
+	const vector_t side = vector_set_component(vector_normalize3(vector_cross3(forward, up)), 3, 0);
+	const vector_t upward = vector_set_component(vector_cross3(side, forward), 3, 0);
+	// Camera axes are the columns of the rotation, translation moves eye to origin
+	matrix_t basis;
+	basis.row[0] = side;
+	basis.row[1] = upward;
+	basis.row[2] = vector_neg(forward);
+	basis.row[3] = vector(0, 0, 0, 1);
+	matrix_t m = matrix_transpose(basis);
+	m.row[3] = vector(-vector_x(vector_dot3(side, eye)), -vector_x(vector_dot3(upward, eye)),
+	                  vector_x(vector_dot3(forward, eye)), 1);
+	return m;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL matrix_t
+matrix_look_at(const vector_t eye, const vector_t target, const vector_t up) {
+	return matrix_look_to(eye, vector_sub(target, eye), up);
+}
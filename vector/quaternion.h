@@ -23,6 +23,7 @@ Rotation abstraction using quaternions */
 #include <vector/types.h>
 #include <vector/mask.h>
 #include <vector/vector.h>
+#include <vector/scalar.h>
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
 quaternion_zero(void);
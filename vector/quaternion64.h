@@ -0,0 +1,238 @@
+/* quaternion64.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file quaternion64.h
+    Double precision rotations using quaternions, [x, y, z] vector part and w scalar part */
+
+#include <vector/types.h>
+#include <vector/vector64.h>
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_zero(void);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_identity(void);
+
+//! Load scalars
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_scalar(float64_t x, float64_t y, float64_t z, float64_t w);
+
+//! Load unaligned
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL quaternion64_t
+quaternion64_unaligned(const float64_t* FOUNDATION_RESTRICT q);
+
+//! Load aligned (16-byte alignment)
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL quaternion64_t
+quaternion64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT q);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_from_quaternion(const quaternion_t q);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
+quaternion64_to_quaternion(const quaternion64_t q);
+
+//! Rotation of the upper 3x3 part of a matrix without scaling, same as quaternion_from_matrix
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_from_matrix(const matrix64_t m);
+
+//! Quaternion rotating "from" vector to "to" vector, same as quaternion_rotating_vector
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_rotating_vector(const vector64_t from, const vector64_t to);
+
+//! Quaternion conjugate, q' = (-q.x, -q.y, -q.z, q.w)
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_conjugate(const quaternion64_t q);
+
+//! Quaternion inverse. For a unit quaternion equivalent to conjugate
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_inverse(const quaternion64_t q);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_neg(const quaternion64_t q);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_normalize(const quaternion64_t q);
+
+//! Hamilton product q0 * q1, the rotation of q1 followed by the rotation of q0
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_mul(const quaternion64_t q0, const quaternion64_t q1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_add(const quaternion64_t q0, const quaternion64_t q1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_sub(const quaternion64_t q0, const quaternion64_t q1);
+
+// Quaternions must be unit length
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_slerp(const quaternion64_t q0, const quaternion64_t q1, float64_t factor);
+
+//! Rotate directional vector by q * v * q', returns [x', y', z', 0]
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+quaternion64_rotate(const quaternion64_t q, const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_zero(void) {
+	return vector64_zero();
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_identity(void) {
+	return vector64(0, 0, 0, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_scalar(float64_t x, float64_t y, float64_t z, float64_t w) {
+	return vector64(x, y, z, w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL quaternion64_t
+quaternion64_unaligned(const float64_t* FOUNDATION_RESTRICT q) {
+	return vector64_unaligned(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL quaternion64_t
+quaternion64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT q) {
+	return vector64_aligned(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_from_quaternion(const quaternion_t q) {
+	return vector64_from_vector(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
+quaternion64_to_quaternion(const quaternion64_t q) {
+	return vector64_to_vector(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_from_matrix(const matrix64_t m) {
+	// Ken Shoemake, "Quaternion Calculus and Fast Animation", same as quaternion_from_matrix
+	const float64_t trace = m.frow[0][0] + m.frow[1][1] + m.frow[2][2];
+	quaternion64_t q;
+
+	if (trace > 0) {
+		float64_t root = sqrt(trace + 1.0);
+		const float64_t w = 0.5 * root;
+		root = 0.5 / root;
+		q = vector64((m.frow[1][2] - m.frow[2][1]) * root, (m.frow[2][0] - m.frow[0][2]) * root,
+		             (m.frow[0][1] - m.frow[1][0]) * root, w);
+	} else {
+		const int next[3] = {1, 2, 0};
+		int i = 0;
+		if (m.frow[1][1] > m.frow[0][0])
+			i = 1;
+		if (m.frow[2][2] > m.frow[i][i])
+			i = 2;
+		const int j = next[i];
+		const int k = next[j];
+
+		float64_t root = sqrt(m.frow[i][i] - m.frow[j][j] - m.frow[k][k] + 1.0);
+		float64_t quat[4] = {0, 0, 0, 0};
+		quat[i] = 0.5 * root;
+		root = 0.5 / root;
+		quat[j] = (m.frow[i][j] + m.frow[j][i]) * root;
+		quat[k] = (m.frow[i][k] + m.frow[k][i]) * root;
+		quat[3] = (m.frow[j][k] - m.frow[k][j]) * root;
+		q = vector64_unaligned(quat);
+	}
+
+	return quaternion64_normalize(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_rotating_vector(const vector64_t from, const vector64_t to) {
+	// xyz: from x to, w: sqrt((from . from) * (to . to)) + (from . to)
+	const vector64_t axis = vector64_cross3(from, to);
+	const float64_t scalar = sqrt(vector64_x(vector64_length3_sqr(from)) * vector64_x(vector64_length3_sqr(to))) +
+	                         vector64_x(vector64_dot3(from, to));
+	return quaternion64_normalize(vector64_set_component(axis, 3, scalar));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_conjugate(const quaternion64_t q) {
+	return vector64_mul(q, vector64(-1, -1, -1, 1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_inverse(const quaternion64_t q) {
+	return vector64_div(quaternion64_conjugate(q), vector64_length_sqr(q));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_neg(const quaternion64_t q) {
+	return vector64_neg(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_normalize(const quaternion64_t q) {
+	return vector64_normalize(q);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_mul(const quaternion64_t q0, const quaternion64_t q1) {
+	// Vector part q0.w * q1.v + q1.w * q0.v + q0.v x q1.v, scalar part q0.w * q1.w - q0.v . q1.v
+	const vector64_t cross = vector64_cross3(q0, q1);
+	const vector64_t vec = vector64_muladd(vector64_uniform(vector64_w(q0)), q1,
+	                                       vector64_muladd(vector64_uniform(vector64_w(q1)), q0, cross));
+	const float64_t scalar = vector64_w(q0) * vector64_w(q1) - vector64_x(vector64_dot3(q0, q1));
+	return vector64_set_component(vec, 3, scalar);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_add(const quaternion64_t q0, const quaternion64_t q1) {
+	return vector64_add(q0, q1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_sub(const quaternion64_t q0, const quaternion64_t q1) {
+	return vector64_sub(q0, q1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion64_t
+quaternion64_slerp(const quaternion64_t q0, const quaternion64_t q1, float64_t factor) {
+	quaternion64_t qd = q1;
+	float64_t cosval = vector64_x(vector64_dot(q0, q1));
+
+	// Slerp to negated target for the shorter arc
+	if (cosval < 0) {
+		qd = quaternion64_neg(q1);
+		cosval = -cosval;
+	}
+
+	// Nearly parallel quaternions interpolate linearly to avoid division by a tiny sine
+	if (cosval > 0.9999995)
+		return quaternion64_normalize(vector64_lerp(q0, qd, factor));
+
+	const float64_t angle = acos(cosval);
+	const float64_t invsin = 1.0 / sin(angle);
+	const float64_t c0 = sin((1.0 - factor) * angle) * invsin;
+	const float64_t c1 = sin(factor * angle) * invsin;
+	return vector64_add(vector64_scale(q0, c0), vector64_scale(qd, c1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+quaternion64_rotate(const quaternion64_t q, const vector64_t v) {
+	// t = 2 * cross(q.xyz, v), v' = v + q.w * t + cross(q.xyz, t)
+	const vector64_t t = vector64_scale(vector64_cross3(q, v), 2.0);
+	const vector64_t rotated = vector64_add(vector64_muladd(vector64_uniform(vector64_w(q)), t, v),
+	                                        vector64_cross3(q, t));
+	return vector64_set_component(rotated, 3, 0);
+}
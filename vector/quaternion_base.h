@@ -100,9 +100,20 @@ quaternion_normalize(const quaternion_t q) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
 quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
+#if VECTOR_DETERMINISTIC
+	// Vector part q0.w * q1.v + q1.w * q0.v + q0.v x q1.v, scalar part q0.w * q1.w - q0.v . q1.v
+	// using only operations with the same result in all implementations
+	const vector_t q0w = vector_shuffle(q0, VECTOR_MASK_WWWW);
+	const vector_t q1w = vector_shuffle(q1, VECTOR_MASK_WWWW);
+	const vector_t axis = vector_add(vector_add(vector_mul(q0w, q1), vector_mul(q1w, q0)), vector_cross3(q0, q1));
+	const vector_t scalar = vector_sub(vector_mul(q0w, q1w), vector_dot3(q0, q1));
+	const vector_t comb = vector_shuffle2(axis, scalar, VECTOR_MASK_ZZWW);
+	return vector_shuffle2(axis, comb, VECTOR_MASK_XYXZ);
+#else
 	return vector(
-	    q1.w * q0.x + q1.x * q0.w + q1.y * q0.z - q1.z * q0.y, q1.w * q0.y - q1.x * q0.z + q1.y * q0.w + q1.z * q0.x,
-	    q1.w * q0.z + q1.x * q0.y - q1.y * q0.x + q1.z * q0.w, q1.w * q0.w - q1.x * q0.x - q1.y * q0.y - q1.z * q0.z);
+	    q0.w * q1.x + q0.x * q1.w + q0.y * q1.z - q0.z * q1.y, q0.w * q1.y - q0.x * q1.z + q0.y * q1.w + q0.z * q1.x,
+	    q0.w * q1.z + q0.x * q1.y - q0.y * q1.x + q0.z * q1.w, q0.w * q1.w - q0.x * q1.x - q0.y * q1.y - q0.z * q1.z);
+#endif
 }
 
 #endif
@@ -144,7 +155,7 @@ quaternion_slerp(const quaternion_t q0, const quaternion_t q1, real factor) {
 	real angle = 0.0f;
 	if (REAL_C(-1.0) < cosval) {
 		if (cosval < REAL_C(1.0))
-			angle = math_acos(cosval);
+			angle = vector_scalar_acos(cosval);
 		else
 			return qd;
 	} else
@@ -153,10 +164,10 @@ quaternion_slerp(const quaternion_t q0, const quaternion_t q1, real factor) {
 	if (math_real_is_zero(angle))
 		return qd;
 
-	real sinval = math_sin(angle);
+	real sinval = vector_scalar_sin(angle);
 	real invsin = REAL_C(1.0) / sinval;
-	real c1 = math_sin((REAL_C(1.0) - factor) * angle) * invsin;
-	real c2 = math_sin(factor * angle) * invsin;
+	real c1 = vector_scalar_sin((REAL_C(1.0) - factor) * angle) * invsin;
+	real c2 = vector_scalar_sin(factor * angle) * invsin;
 
 	return vector_add(vector_scale(q0, c1), vector_scale(qd, c2));
 }
@@ -167,6 +178,17 @@ quaternion_slerp(const quaternion_t q0, const quaternion_t q1, real factor) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 quaternion_rotate(const quaternion_t q, const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	// Same formula as the vectorized implementations, w component of input vector is preserved
+	const vector_t v1 = vector_cross3(q, v);
+	const vector_t qw = vector_shuffle(q, VECTOR_MASK_WWWW);
+	const vector_t v2 = vector_muladd(v, qw, v1);
+	const vector_t v3 = vector_cross3(v2, q);
+	const vector_t dot = vector_dot3(q, v);
+	const vector_t r = vector_muladd(q, dot, vector_muladd(v2, qw, vector_neg(v3)));
+	const vector_t splice = vector_shuffle2(r, v, VECTOR_MASK_ZZWW);
+	return vector_shuffle2(r, splice, VECTOR_MASK_XYXW);
+#else
 	// Quaternion "q" rotation of vector "w" is calculated by constructing
 	// a quaternion "v" with values (0,w) and the formula (where q' is the conjugate of q)
 	// q * v * q'
@@ -199,6 +221,7 @@ quaternion_rotate(const quaternion_t q, const vector_t v) {
 	vector_t r = {q.x * dot + v1.x * q.w - v2.x, q.y * dot + v1.y * q.w - v2.y, q.z * dot + v1.z * q.w - v2.z, v.w};
 
 	return r;
+#endif
 }
 
 #endif
@@ -15,7 +15,7 @@
  *
  */
 
-#ifndef VECTOR_HAVE_QUATERNION_MUL
+#if !defined(VECTOR_HAVE_QUATERNION_MUL) && !VECTOR_DETERMINISTIC
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
 quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
@@ -41,7 +41,7 @@ quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
 	const vector_t q1_yxzw = vector_shuffle(q1, VECTOR_MASK_YXZW);
 	const vector_t q0z_q1yxzw = vector_mul(q0_zzzz, q1_yxzw);
 
-	vector_arr_t signs = {1, -1, 1, -1};
+	vector_arr_t signs = {-1, 1, -1, 1};
 	const vector_t signshuffle = vector_aligned(signs);
 	vector_t e = vector_add(q0w_q1yxzw, vector_mul(q0x_q1zwxy, signshuffle));
 	e = vector_shuffle(e, VECTOR_MASK_ZXWY);
@@ -56,7 +56,7 @@ quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
 
 #endif
 
-#ifndef VECTOR_HAVE_QUATERNION_ROTATE
+#if !defined(VECTOR_HAVE_QUATERNION_ROTATE) && !VECTOR_DETERMINISTIC
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 quaternion_rotate(const quaternion_t q, const vector_t v) {
@@ -15,7 +15,7 @@
  *
  */
 
-#ifndef VECTOR_HAVE_QUATERNION_MUL
+#if !defined(VECTOR_HAVE_QUATERNION_MUL) && !VECTOR_DETERMINISTIC
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL quaternion_t
 quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
@@ -44,7 +44,7 @@ quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
 #if VECTOR_IMPLEMENTATION_SSE3 || VECTOR_IMPLEMENTATION_SSE4
 	vector_t e = _mm_addsub_ps(q0w_q1yxzw, q0x_q1zwxy);
 #else
-	vector_arr_t signs = {1, -1, 1, -1};
+	vector_arr_t signs = {-1, 1, -1, 1};
 	const vector_t signshuffle = vector_aligned(signs);
 	vector_t e = _mm_add_ps(q0w_q1yxzw, _mm_mul_ps(q0x_q1zwxy, signshuffle));
 #endif
@@ -68,7 +68,7 @@ quaternion_mul(const quaternion_t q0, const quaternion_t q1) {
 
 #endif
 
-#ifndef VECTOR_HAVE_QUATERNION_ROTATE
+#if !defined(VECTOR_HAVE_QUATERNION_ROTATE) && !VECTOR_DETERMINISTIC
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 quaternion_rotate(const quaternion_t q, const vector_t v) {
@@ -25,7 +25,7 @@ quaternion_conjugate(const quaternion_t q) {
 
 #endif
 
-#ifndef VECTOR_HAVE_QUATERNION_INVERSE
+#if !defined(VECTOR_HAVE_QUATERNION_INVERSE) && !VECTOR_DETERMINISTIC
 
 quaternion_t
 quaternion_inverse(const quaternion_t q) {
@@ -0,0 +1,133 @@
+/* ray.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file ray.h
+    Ray intersection tests */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/aabb.h>
+
+//! Construct from origin point and direction. Direction does not need to be normalized,
+//! distances reported by intersection tests are in units of direction length
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL ray_t
+ray(const vector_t origin, const vector_t direction);
+
+//! Point along ray at given distance, origin + direction * t
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+ray_point(const ray_t r, real t);
+
+//! Component-wise reciprocal of ray direction for use in repeated slab tests
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+ray_inverse_direction(const ray_t r);
+
+//! Slab test of ray against box in range [0, tmax]. Returns entry distance in distance,
+//! which is zero if ray origin is inside the box
+//! \param r Ray
+//! \param inv_direction Reciprocal direction as given by ray_inverse_direction
+//! \param box Box
+//! \param tmax Max distance
+//! \param distance Entry distance output, can be null
+//! \return true if ray hits box, false if not
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_aabb(const ray_t r, const vector_t inv_direction, const aabb_t box, real tmax, real* distance);
+
+//! Moller-Trumbore ray triangle test in range [0, tmax], double sided
+//! \param r Ray
+//! \param v0 First triangle corner
+//! \param v1 Second triangle corner
+//! \param v2 Third triangle corner
+//! \param tmax Max distance
+//! \param distance Hit distance output
+//! \param u Barycentric coordinate output (weight of v1)
+//! \param v Barycentric coordinate output (weight of v2)
+//! \return true if ray hits triangle, false if not
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_triangle(const ray_t r, const vector_t v0, const vector_t v1, const vector_t v2, real tmax,
+                       real* distance, real* u, real* v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL ray_t
+ray(const vector_t origin, const vector_t direction) {
+	ray_t r;
+	r.origin = origin;
+	r.direction = direction;
+	return r;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+ray_point(const ray_t r, real t) {
+	return vector_muladd(r.direction, vector_uniform(t), r.origin);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+ray_inverse_direction(const ray_t r) {
+	return vector_div(vector_one(), r.direction);
+}
+
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_aabb(const ray_t r, const vector_t inv_direction, const aabb_t box, real tmax, real* distance) {
+	const vector_t t0 = vector_mul(vector_sub(box.min, r.origin), inv_direction);
+	const vector_t t1 = vector_mul(vector_sub(box.max, r.origin), inv_direction);
+	const vector_t tnear = vector_min(t0, t1);
+	const vector_t tfar = vector_max(t0, t1);
+	real enter = 0;
+	real leave = tmax;
+	for (int axis = 0; axis < 3; ++axis) {
+		const real tenter = vector_component(tnear, axis);
+		const real tleave = vector_component(tfar, axis);
+		enter = (tenter > enter) ? tenter : enter;
+		leave = (tleave < leave) ? tleave : leave;
+	}
+	if (enter > leave)
+		return false;
+	if (distance)
+		*distance = enter;
+	return true;
+}
+
+static FOUNDATION_FORCEINLINE bool
+ray_intersect_triangle(const ray_t r, const vector_t v0, const vector_t v1, const vector_t v2, real tmax,
+                       real* distance, real* u, real* v) {
+	const vector_t edge0 = vector_sub(v1, v0);
+	const vector_t edge1 = vector_sub(v2, v0);
+	const vector_t pvec = vector_cross3(r.direction, edge1);
+	const real det = vector_x(vector_dot3(edge0, pvec));
+	if (math_abs(det) < REAL_C(1e-12))
+		return false;
+
+	const real inv_det = REAL_C(1.0) / det;
+	const vector_t tvec = vector_sub(r.origin, v0);
+	const real bu = vector_x(vector_dot3(tvec, pvec)) * inv_det;
+	if ((bu < 0) || (bu > REAL_C(1.0)))
+		return false;
+
+	const vector_t qvec = vector_cross3(tvec, edge0);
+	const real bv = vector_x(vector_dot3(r.direction, qvec)) * inv_det;
+	if ((bv < 0) || (bu + bv > REAL_C(1.0)))
+		return false;
+
+	const real t = vector_x(vector_dot3(edge1, qvec)) * inv_det;
+	if ((t < 0) || (t > tmax))
+		return false;
+
+	*distance = t;
+	*u = bu;
+	*v = bv;
+	return true;
+}
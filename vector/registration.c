@@ -0,0 +1,331 @@
+/* registration.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/registration.h>
+#include <vector/job.h>
+#include <vector/arena.h>
+#include <vector/internal.h>
+
+//! Point pairs per chunk, fixed so the summation order does not depend on the number of threads
+#define REGISTRATION_CHUNK_SIZE 4096
+
+typedef struct registration_moments_t registration_moments_t;
+typedef struct registration_batch_t registration_batch_t;
+
+//! Means and centered second moments of a set of point pairs
+VECTOR_ALIGNED_STRUCT(registration_moments_t) {
+	vector_t source_mean;
+	vector_t target_mean;
+	//! Row i is the sum of (source - source_mean)[i] * (target - target_mean)
+	matrix_t covariance;
+	//! Sums of squared distances to the means
+	real source_spread;
+	real target_spread;
+	real count;
+};
+
+VECTOR_ALIGNED_STRUCT(registration_batch_t) {
+	//! Source to target transform for pairing, ICP only
+	matrix_t transform;
+	const vector_t* source;
+	const vector_t* target;
+	size_t count;
+	registration_moments_t* moments;
+	//! Nearest neighbour lookup and per chunk storage of the accepted pairs, ICP only
+	const hashgrid_t* grid;
+	real max_distance_sqr;
+	vector_t* pair_source;
+	vector_t* pair_target;
+};
+
+static FOUNDATION_FORCEINLINE real
+registration_sum(const vector_t v) {
+	return (vector_x(v) + vector_y(v)) + (vector_z(v) + vector_w(v));
+}
+
+static void
+registration_moments(const vector_t* source, const vector_t* target, size_t count, registration_moments_t* moments) {
+	memset(moments, 0, sizeof(registration_moments_t));
+	if (!count)
+		return;
+
+	vector_t source_sum = vector_zero();
+	vector_t target_sum = vector_zero();
+	for (size_t ipt = 0; ipt < count; ++ipt) {
+		source_sum = vector_add(source_sum, source[ipt]);
+		target_sum = vector_add(target_sum, target[ipt]);
+	}
+	const vector_t scale = vector_uniform(REAL_C(1.0) / (real)count);
+	const vector_t source_mean = vector_set_component(vector_mul(source_sum, scale), 3, 0);
+	const vector_t target_mean = vector_set_component(vector_mul(target_sum, scale), 3, 0);
+
+	// Four pairs at a time with the components transposed into vectors, the nine lanes of the
+	// covariance products are summed at the end
+	const vector_t smx = vector_shuffle(source_mean, VECTOR_MASK_XXXX);
+	const vector_t smy = vector_shuffle(source_mean, VECTOR_MASK_YYYY);
+	const vector_t smz = vector_shuffle(source_mean, VECTOR_MASK_ZZZZ);
+	const vector_t tmx = vector_shuffle(target_mean, VECTOR_MASK_XXXX);
+	const vector_t tmy = vector_shuffle(target_mean, VECTOR_MASK_YYYY);
+	const vector_t tmz = vector_shuffle(target_mean, VECTOR_MASK_ZZZZ);
+	vector_t xx = vector_zero(), xy = vector_zero(), xz = vector_zero();
+	vector_t yx = vector_zero(), yy = vector_zero(), yz = vector_zero();
+	vector_t zx = vector_zero(), zy = vector_zero(), zz = vector_zero();
+	vector_t source_spread = vector_zero();
+	vector_t target_spread = vector_zero();
+	size_t ipt = 0;
+	for (; ipt + 4 <= count; ipt += 4) {
+		vector_t scomp[4];
+		vector_t tcomp[4];
+		vector_transpose4(source[ipt], source[ipt + 1], source[ipt + 2], source[ipt + 3], scomp);
+		vector_transpose4(target[ipt], target[ipt + 1], target[ipt + 2], target[ipt + 3], tcomp);
+		const vector_t sx = vector_sub(scomp[0], smx);
+		const vector_t sy = vector_sub(scomp[1], smy);
+		const vector_t sz = vector_sub(scomp[2], smz);
+		const vector_t tx = vector_sub(tcomp[0], tmx);
+		const vector_t ty = vector_sub(tcomp[1], tmy);
+		const vector_t tz = vector_sub(tcomp[2], tmz);
+		xx = vector_muladd(sx, tx, xx);
+		xy = vector_muladd(sx, ty, xy);
+		xz = vector_muladd(sx, tz, xz);
+		yx = vector_muladd(sy, tx, yx);
+		yy = vector_muladd(sy, ty, yy);
+		yz = vector_muladd(sy, tz, yz);
+		zx = vector_muladd(sz, tx, zx);
+		zy = vector_muladd(sz, ty, zy);
+		zz = vector_muladd(sz, tz, zz);
+		source_spread = vector_muladd(sz, sz, vector_muladd(sy, sy, vector_muladd(sx, sx, source_spread)));
+		target_spread = vector_muladd(tz, tz, vector_muladd(ty, ty, vector_muladd(tx, tx, target_spread)));
+	}
+	matrix_t covariance;
+	covariance.row[0] = vector(registration_sum(xx), registration_sum(xy), registration_sum(xz), 0);
+	covariance.row[1] = vector(registration_sum(yx), registration_sum(yy), registration_sum(yz), 0);
+	covariance.row[2] = vector(registration_sum(zx), registration_sum(zy), registration_sum(zz), 0);
+	covariance.row[3] = vector_zero();
+	real source_total = registration_sum(source_spread);
+	real target_total = registration_sum(target_spread);
+	for (; ipt < count; ++ipt) {
+		const vector_t ds = vector_set_component(vector_sub(source[ipt], source_mean), 3, 0);
+		const vector_t dt = vector_set_component(vector_sub(target[ipt], target_mean), 3, 0);
+		covariance.row[0] = vector_muladd(dt, vector_shuffle(ds, VECTOR_MASK_XXXX), covariance.row[0]);
+		covariance.row[1] = vector_muladd(dt, vector_shuffle(ds, VECTOR_MASK_YYYY), covariance.row[1]);
+		covariance.row[2] = vector_muladd(dt, vector_shuffle(ds, VECTOR_MASK_ZZZZ), covariance.row[2]);
+		source_total += vector_x(vector_dot3(ds, ds));
+		target_total += vector_x(vector_dot3(dt, dt));
+	}
+
+	moments->source_mean = source_mean;
+	moments->target_mean = target_mean;
+	moments->covariance = covariance;
+	moments->source_spread = source_total;
+	moments->target_spread = target_total;
+	moments->count = (real)count;
+}
+
+//! Merge chunk moments in order, shifting each chunk from its own means to the total means
+static void
+registration_merge(const registration_moments_t* chunk, size_t chunk_count, registration_moments_t* total) {
+	memset(total, 0, sizeof(registration_moments_t));
+	vector_t source_sum = vector_zero();
+	vector_t target_sum = vector_zero();
+	for (size_t ichunk = 0; ichunk < chunk_count; ++ichunk) {
+		const vector_t weight = vector_uniform(chunk[ichunk].count);
+		source_sum = vector_muladd(chunk[ichunk].source_mean, weight, source_sum);
+		target_sum = vector_muladd(chunk[ichunk].target_mean, weight, target_sum);
+		total->count += chunk[ichunk].count;
+	}
+	if (total->count <= 0)
+		return;
+	total->source_mean = vector_scale(source_sum, REAL_C(1.0) / total->count);
+	total->target_mean = vector_scale(target_sum, REAL_C(1.0) / total->count);
+
+	for (size_t ichunk = 0; ichunk < chunk_count; ++ichunk) {
+		const registration_moments_t* moments = chunk + ichunk;
+		if (moments->count <= 0)
+			continue;
+		const vector_t ds = vector_sub(moments->source_mean, total->source_mean);
+		const vector_t dt = vector_sub(moments->target_mean, total->target_mean);
+		const vector_t weighted = vector_scale(ds, moments->count);
+		total->covariance.row[0] = vector_add(total->covariance.row[0],
+		                                      vector_muladd(dt, vector_shuffle(weighted, VECTOR_MASK_XXXX),
+		                                                    moments->covariance.row[0]));
+		total->covariance.row[1] = vector_add(total->covariance.row[1],
+		                                      vector_muladd(dt, vector_shuffle(weighted, VECTOR_MASK_YYYY),
+		                                                    moments->covariance.row[1]));
+		total->covariance.row[2] = vector_add(total->covariance.row[2],
+		                                      vector_muladd(dt, vector_shuffle(weighted, VECTOR_MASK_ZZZZ),
+		                                                    moments->covariance.row[2]));
+		total->source_spread += moments->source_spread + moments->count * vector_x(vector_dot3(ds, ds));
+		total->target_spread += moments->target_spread + moments->count * vector_x(vector_dot3(dt, dt));
+	}
+}
+
+//! Closed form rotation of Horn, the unit quaternion maximizing the sum of target . rotated source
+//! is the eigenvector of the largest eigenvalue of a symmetric matrix of cross covariance sums
+static transform_t
+registration_solve(const registration_moments_t* moments, real* error) {
+	const matrix_t s = moments->covariance;
+	const real sxx = s.frow[0][0], sxy = s.frow[0][1], sxz = s.frow[0][2];
+	const real syx = s.frow[1][0], syy = s.frow[1][1], syz = s.frow[1][2];
+	const real szx = s.frow[2][0], szy = s.frow[2][1], szz = s.frow[2][2];
+	// Quaternion components ordered (w, x, y, z)
+	matrix_t n;
+	n.row[0] = vector(sxx + syy + szz, syz - szy, szx - sxz, sxy - syx);
+	n.row[1] = vector(syz - szy, sxx - syy - szz, sxy + syx, szx + sxz);
+	n.row[2] = vector(szx - sxz, sxy + syx, syy - sxx - szz, syz + szy);
+	n.row[3] = vector(sxy - syx, szx + sxz, syz + szy, szz - sxx - syy);
+
+	vector_t lambda;
+	matrix_t eigenvectors;
+	matrix_jacobi_symmetric(n, 4, &lambda, &eigenvectors);
+	int best = 0;
+	for (int i = 1; i < 4; ++i) {
+		if (vector_component(lambda, i) > vector_component(lambda, best))
+			best = i;
+	}
+	const vector_t q = eigenvectors.row[best];
+	const real largest = vector_component(lambda, best);
+
+	transform_t transform;
+	transform.rotation = quaternion_normalize(vector_shuffle(q, VECTOR_MASK_YZWX));
+	const vector_t rotated_mean = vector_rotate(moments->source_mean, matrix_from_quaternion(transform.rotation));
+	transform.translation = vector_set_component(vector_sub(moments->target_mean, rotated_mean), 3, 1);
+
+	if (error) {
+		// Sum of squared residuals is the spread of both sets minus twice the maximized sum
+		const real residual = moments->source_spread + moments->target_spread - 2 * largest;
+		*error = ((moments->count > 0) && (residual > 0)) ? math_sqrt(residual / moments->count) : 0;
+	}
+	return transform;
+}
+
+static FOUNDATION_FORCEINLINE size_t
+registration_chunk_size(size_t count, size_t ichunk) {
+	const size_t remain = count - ichunk * REGISTRATION_CHUNK_SIZE;
+	return (remain < REGISTRATION_CHUNK_SIZE) ? remain : REGISTRATION_CHUNK_SIZE;
+}
+
+static void
+registration_moments_range(void* context, size_t begin, size_t end) {
+	const registration_batch_t* batch = context;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		const size_t offset = ichunk * REGISTRATION_CHUNK_SIZE;
+		registration_moments(batch->source + offset, batch->target + offset,
+		                     registration_chunk_size(batch->count, ichunk), batch->moments + ichunk);
+	}
+}
+
+transform_t
+registration_rigid(const vector_t* source, const vector_t* target, size_t count, real* error) {
+	const size_t chunk_count = (count + REGISTRATION_CHUNK_SIZE - 1) / REGISTRATION_CHUNK_SIZE;
+	registration_moments_t total;
+	if (chunk_count <= 1) {
+		registration_moments(source, target, count, &total);
+		return registration_solve(&total, error);
+	}
+
+	registration_batch_t batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.source = source;
+	batch.target = target;
+	batch.count = count;
+
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	batch.moments = vector_arena_allocate(arena, sizeof(registration_moments_t) * chunk_count, 0);
+	vector_parallel_for(STRING_CONST("registration_rigid"), registration_moments_range, &batch, chunk_count, 1);
+	registration_merge(batch.moments, chunk_count, &total);
+	vector_arena_rewind(arena, mark);
+	return registration_solve(&total, error);
+}
+
+//! Pair each transformed source point in the chunks with its nearest target point, store the
+//! accepted pairs in the chunk range of the pair arrays and accumulate their moments
+static void
+registration_pair_range(void* context, size_t begin, size_t end) {
+	const registration_batch_t* batch = context;
+	for (size_t ichunk = begin; ichunk < end; ++ichunk) {
+		const size_t offset = ichunk * REGISTRATION_CHUNK_SIZE;
+		const size_t chunk_size = registration_chunk_size(batch->count, ichunk);
+		vector_t* pair_source = batch->pair_source + offset;
+		vector_t* pair_target = batch->pair_target + offset;
+		size_t pair_count = 0;
+		for (size_t ipt = offset; ipt < offset + chunk_size; ++ipt) {
+			const vector_t point = vector_transform(vector_set_component(batch->source[ipt], 3, 1), batch->transform);
+			uint32_t item;
+			real distance_sqr;
+			if (!hashgrid_query_nearest(batch->grid, point, 1, &item, &distance_sqr) ||
+			    (distance_sqr > batch->max_distance_sqr))
+				continue;
+			pair_source[pair_count] = batch->source[ipt];
+			pair_target[pair_count] = batch->target[item];
+			++pair_count;
+		}
+		registration_moments(pair_source, pair_target, pair_count, batch->moments + ichunk);
+	}
+}
+
+unsigned int
+registration_icp(const vector_t* source, size_t count, const vector_t* target, const hashgrid_t* grid,
+                 real max_distance, real tolerance, unsigned int max_iterations, transform_t* transform, real* error) {
+	real rms = REAL_MAX;
+	unsigned int iteration = 0;
+	if (!count || !max_iterations) {
+		if (error)
+			*error = rms;
+		return 0;
+	}
+
+	const size_t chunk_count = (count + REGISTRATION_CHUNK_SIZE - 1) / REGISTRATION_CHUNK_SIZE;
+	registration_batch_t batch;
+	memset(&batch, 0, sizeof(batch));
+	batch.source = source;
+	batch.target = target;
+	batch.count = count;
+	batch.grid = grid;
+	batch.max_distance_sqr = (max_distance < math_sqrt(REAL_MAX)) ? max_distance * max_distance : REAL_MAX;
+
+	vector_arena_t* arena = vector_arena_thread();
+	const size_t mark = vector_arena_mark(arena);
+	batch.moments = vector_arena_allocate(arena, sizeof(registration_moments_t) * chunk_count, 0);
+	batch.pair_source = vector_arena_allocate(arena, sizeof(vector_t) * count, 0);
+	batch.pair_target = vector_arena_allocate(arena, sizeof(vector_t) * count, 0);
+
+	transform_t current = *transform;
+	real previous = REAL_MAX;
+	while (iteration < max_iterations) {
+		batch.transform = matrix_from_quaternion(current.rotation);
+		batch.transform.row[3] = vector_set_component(current.translation, 3, 1);
+		vector_parallel_for(STRING_CONST("registration_icp"), registration_pair_range, &batch, chunk_count, 1);
+		registration_moments_t total;
+		registration_merge(batch.moments, chunk_count, &total);
+		++iteration;
+		// Too few pairs to fix a rotation, keep the current transform
+		if (total.count < 3)
+			break;
+		current = registration_solve(&total, &rms);
+		if (previous - rms <= tolerance)
+			break;
+		previous = rms;
+	}
+
+	vector_arena_rewind(arena, mark);
+
+	transform->rotation = current.rotation;
+	transform->translation = vector_set_component(current.translation, 3, 1);
+	if (error)
+		*error = rms;
+	return iteration;
+}
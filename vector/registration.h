@@ -0,0 +1,68 @@
+/* registration.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file registration.h
+    Rigid registration of point clouds. The rotation minimizing the squared distances between
+    corresponding points is found with the closed form method of Horn, as the eigenvector of the
+    largest eigenvalue of a symmetric 4x4 matrix built from the cross covariance of the centered
+    point sets. The cross covariance is accumulated in fixed size chunks split across the job
+    threads with vector_parallel_for, four point pairs at a time as vector operations, and the
+    chunks are merged in order so results do not depend on the number of threads.
+
+    Iterative closest point registration alternates between pairing each transformed source point
+    with its nearest target point, looked up in a hash grid built from the target points, and
+    solving for the rigid transform of the pairs. Transforms map a source point p to
+    vector_rotate(p, matrix_from_quaternion(rotation)) + translation, the scale in the w component
+    of the translation is always one. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+#include <vector/matrix.h>
+#include <vector/quaternion.h>
+#include <vector/hashgrid.h>
+
+//! Rigid transform best mapping source points onto the corresponding target points in the least
+//! squares sense. Reflections are never returned
+//! \param source Source points, w component is ignored
+//! \param target Target points, target[i] corresponds to source[i]
+//! \param count Number of point pairs. Less than three pairs or collinear points leave rotations
+//!              about the undetermined axes as identity
+//! \param error Output root mean square distance between transformed source and target points,
+//!              can be null
+//! \return Transform from source to target
+VECTOR_API transform_t
+registration_rigid(const vector_t* source, const vector_t* target, size_t count, real* error);
+
+//! Iterative closest point registration of source points against target points
+//! \param source Source points, w component is ignored
+//! \param count Number of source points
+//! \param target Target points
+//! \param grid Grid built from the target points with hashgrid_build_points
+//! \param max_distance Pairs further apart than this after transforming the source point are
+//!                     rejected, REAL_MAX to use all pairs
+//! \param tolerance Stop when the root mean square pair distance improves by less than this
+//! \param max_iterations Max number of iterations
+//! \param transform Initial transform on input, scale is ignored. Transform from source to target
+//!                  on output
+//! \param error Output root mean square distance of the pairs in the last iteration after
+//!              alignment, REAL_MAX if the first iteration found less than three pairs. Can be null
+//! \return Number of iterations done
+VECTOR_API unsigned int
+registration_icp(const vector_t* source, size_t count, const vector_t* target, const hashgrid_t* grid,
+                 real max_distance, real tolerance, unsigned int max_iterations, transform_t* transform, real* error);
@@ -0,0 +1,245 @@
+/* rigid.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/rigid.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+#include <foundation/memory.h>
+
+//! Number of float streams in a rigid body set
+#define RIGID_STREAM_COUNT 29
+
+typedef struct rigid_integrate_t rigid_integrate_t;
+
+VECTOR_ALIGNED_STRUCT(rigid_integrate_t) {
+	rigid_body_t* body;
+	vector_t gravity[3];
+	vector_t linear_damping;
+	vector_t angular_damping;
+	vector_t dt;
+};
+
+static FOUNDATION_FORCEINLINE vector_t
+rigid_load(const float32_t* stream, size_t offset) {
+	return vector_unaligned(stream + offset);
+}
+
+static FOUNDATION_FORCEINLINE void
+rigid_store(float32_t* stream, size_t offset, const vector_t v) {
+	memcpy(stream + offset, &v, sizeof(vector_t));
+}
+
+//! Inverse inertia R * diag(inverse_inertia_body) * R^T where the rows of the matrix from
+//! matrix_from_quaternion are the columns of R
+static FOUNDATION_FORCEINLINE void
+rigid_inertia(const vector_t* q, const vector_t* inverse_inertia_body, vector_t* inverse_inertia) {
+	const vector_t one = vector_one();
+	const vector_t tx = vector_add(q[0], q[0]);
+	const vector_t ty = vector_add(q[1], q[1]);
+	const vector_t tz = vector_add(q[2], q[2]);
+	const vector_t tsx = vector_mul(tx, q[3]);
+	const vector_t tsy = vector_mul(ty, q[3]);
+	const vector_t tsz = vector_mul(tz, q[3]);
+	const vector_t txx = vector_mul(tx, q[0]);
+	const vector_t txy = vector_mul(ty, q[0]);
+	const vector_t txz = vector_mul(tz, q[0]);
+	const vector_t tyy = vector_mul(ty, q[1]);
+	const vector_t tyz = vector_mul(tz, q[1]);
+	const vector_t tzz = vector_mul(tz, q[2]);
+	vector_t row[3][3];
+	row[0][0] = vector_sub(one, vector_add(tyy, tzz));
+	row[0][1] = vector_add(txy, tsz);
+	row[0][2] = vector_sub(txz, tsy);
+	row[1][0] = vector_sub(txy, tsz);
+	row[1][1] = vector_sub(one, vector_add(txx, tzz));
+	row[1][2] = vector_add(tyz, tsx);
+	row[2][0] = vector_add(txz, tsy);
+	row[2][1] = vector_sub(tyz, tsx);
+	row[2][2] = vector_sub(one, vector_add(txx, tyy));
+
+	// Element (i, j) is the sum over body axes k of row[k][i] * inertia[k] * row[k][j]
+	static const int index[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+	vector_t scaled[3][3];
+	for (int axis = 0; axis < 3; ++axis) {
+		for (int icomp = 0; icomp < 3; ++icomp)
+			scaled[axis][icomp] = vector_mul(row[axis][icomp], inverse_inertia_body[axis]);
+	}
+	for (int ielem = 0; ielem < 6; ++ielem) {
+		const int i = index[ielem][0];
+		const int j = index[ielem][1];
+		inverse_inertia[ielem] = vector_muladd(
+		    scaled[2][i], row[2][j], vector_muladd(scaled[1][i], row[1][j], vector_mul(scaled[0][i], row[0][j])));
+	}
+}
+
+//! Multiply symmetric tensor with components xx, yy, zz, xy, xz, yz by vector
+static FOUNDATION_FORCEINLINE void
+rigid_tensor_mul(const vector_t* tensor, const vector_t* v, vector_t* out) {
+	out[0] = vector_muladd(tensor[0], v[0], vector_muladd(tensor[3], v[1], vector_mul(tensor[4], v[2])));
+	out[1] = vector_muladd(tensor[3], v[0], vector_muladd(tensor[1], v[1], vector_mul(tensor[5], v[2])));
+	out[2] = vector_muladd(tensor[4], v[0], vector_muladd(tensor[5], v[1], vector_mul(tensor[2], v[2])));
+}
+
+static void
+rigid_body_update_inertia_range(void* context, size_t begin, size_t end) {
+	rigid_body_t* body = context;
+	vector_t q[4];
+	vector_t inverse_inertia_body[3];
+	vector_t inverse_inertia[6];
+	for (size_t offset = begin * 4; offset < end * 4; offset += 4) {
+		for (int icomp = 0; icomp < 4; ++icomp)
+			q[icomp] = rigid_load(body->orientation[icomp], offset);
+		for (int icomp = 0; icomp < 3; ++icomp)
+			inverse_inertia_body[icomp] = rigid_load(body->inverse_inertia_body[icomp], offset);
+		rigid_inertia(q, inverse_inertia_body, inverse_inertia);
+		for (int ielem = 0; ielem < 6; ++ielem)
+			rigid_store(body->inverse_inertia[ielem], offset, inverse_inertia[ielem]);
+	}
+}
+
+static void
+rigid_body_integrate_range(void* context, size_t begin, size_t end) {
+	const rigid_integrate_t* integrate = context;
+	rigid_body_t* body = integrate->body;
+	const vector_t dt = integrate->dt;
+	const vector_t half_dt = vector_mul(dt, vector_half());
+	const vector_t zero = vector_zero();
+	vector_t position[3];
+	vector_t velocity[3];
+	vector_t q[4];
+	vector_t angular_velocity[3];
+	vector_t torque[3];
+	vector_t angular_acceleration[3];
+	vector_t inverse_inertia_body[3];
+	vector_t inverse_inertia[6];
+	for (size_t offset = begin * 4; offset < end * 4; offset += 4) {
+		const vector_t inverse_mass = rigid_load(body->inverse_mass, offset);
+		// Bodies with zero inverse mass are not affected by gravity
+		const vectori_t dynamic = vector_greater(inverse_mass, zero);
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			const vector_t force = rigid_load(body->force[icomp], offset);
+			const vector_t acceleration =
+			    vector_muladd(force, inverse_mass, vector_select(dynamic, integrate->gravity[icomp], zero));
+			velocity[icomp] = vector_muladd(acceleration, dt, rigid_load(body->velocity[icomp], offset));
+			velocity[icomp] = vector_mul(velocity[icomp], integrate->linear_damping);
+			position[icomp] = vector_muladd(velocity[icomp], dt, rigid_load(body->position[icomp], offset));
+			rigid_store(body->velocity[icomp], offset, velocity[icomp]);
+			rigid_store(body->position[icomp], offset, position[icomp]);
+			rigid_store(body->force[icomp], offset, zero);
+		}
+
+		// Angular acceleration from torque with the inertia of the current orientation
+		for (int ielem = 0; ielem < 6; ++ielem)
+			inverse_inertia[ielem] = rigid_load(body->inverse_inertia[ielem], offset);
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			torque[icomp] = rigid_load(body->torque[icomp], offset);
+			rigid_store(body->torque[icomp], offset, zero);
+		}
+		rigid_tensor_mul(inverse_inertia, torque, angular_acceleration);
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			angular_velocity[icomp] =
+			    vector_muladd(angular_acceleration[icomp], dt, rigid_load(body->angular_velocity[icomp], offset));
+			angular_velocity[icomp] = vector_mul(angular_velocity[icomp], integrate->angular_damping);
+			rigid_store(body->angular_velocity[icomp], offset, angular_velocity[icomp]);
+		}
+
+		// Quaternion derivative 0.5 * (w, 0) * q
+		for (int icomp = 0; icomp < 4; ++icomp)
+			q[icomp] = rigid_load(body->orientation[icomp], offset);
+		const vector_t* w = angular_velocity;
+		const vector_t dx = vector_sub(vector_muladd(w[0], q[3], vector_mul(w[1], q[2])), vector_mul(w[2], q[1]));
+		const vector_t dy = vector_sub(vector_muladd(w[1], q[3], vector_mul(w[2], q[0])), vector_mul(w[0], q[2]));
+		const vector_t dz = vector_sub(vector_muladd(w[2], q[3], vector_mul(w[0], q[1])), vector_mul(w[1], q[0]));
+		const vector_t dw = vector_neg(vector_muladd(w[0], q[0], vector_muladd(w[1], q[1], vector_mul(w[2], q[2]))));
+		q[0] = vector_muladd(dx, half_dt, q[0]);
+		q[1] = vector_muladd(dy, half_dt, q[1]);
+		q[2] = vector_muladd(dz, half_dt, q[2]);
+		q[3] = vector_muladd(dw, half_dt, q[3]);
+		const vector_t length_sqr =
+		    vector_muladd(q[3], q[3], vector_muladd(q[2], q[2], vector_muladd(q[1], q[1], vector_mul(q[0], q[0]))));
+		const vector_t inv_length = vector_div(vector_one(), vector_sqrt(length_sqr));
+		for (int icomp = 0; icomp < 4; ++icomp) {
+			q[icomp] = vector_mul(q[icomp], inv_length);
+			rigid_store(body->orientation[icomp], offset, q[icomp]);
+		}
+
+		for (int icomp = 0; icomp < 3; ++icomp)
+			inverse_inertia_body[icomp] = rigid_load(body->inverse_inertia_body[icomp], offset);
+		rigid_inertia(q, inverse_inertia_body, inverse_inertia);
+		for (int ielem = 0; ielem < 6; ++ielem)
+			rigid_store(body->inverse_inertia[ielem], offset, inverse_inertia[ielem]);
+	}
+}
+
+static float32_t*
+rigid_stream(float32_t** stream, size_t stride) {
+	float32_t* current = *stream;
+	*stream += stride;
+	return current;
+}
+
+void
+rigid_body_initialize(rigid_body_t* body, size_t capacity) {
+	memset(body, 0, sizeof(rigid_body_t));
+	// Pad streams to groups of four, at least one group
+	const size_t stride = ((capacity + 3) & ~(size_t)3) + (capacity ? 0 : 4);
+	float32_t* stream = memory_allocate(HASH_VECTOR, sizeof(float32_t) * stride * RIGID_STREAM_COUNT, 16,
+	                                    MEMORY_PERSISTENT | MEMORY_ZERO_INITIALIZED);
+	for (int icomp = 0; icomp < 3; ++icomp) {
+		body->position[icomp] = rigid_stream(&stream, stride);
+		body->velocity[icomp] = rigid_stream(&stream, stride);
+		body->angular_velocity[icomp] = rigid_stream(&stream, stride);
+		body->force[icomp] = rigid_stream(&stream, stride);
+		body->torque[icomp] = rigid_stream(&stream, stride);
+		body->inverse_inertia_body[icomp] = rigid_stream(&stream, stride);
+	}
+	for (int icomp = 0; icomp < 4; ++icomp)
+		body->orientation[icomp] = rigid_stream(&stream, stride);
+	for (int ielem = 0; ielem < 6; ++ielem)
+		body->inverse_inertia[ielem] = rigid_stream(&stream, stride);
+	body->inverse_mass = rigid_stream(&stream, stride);
+	for (size_t ibody = 0; ibody < stride; ++ibody)
+		body->orientation[3][ibody] = 1;
+	body->capacity = capacity;
+}
+
+void
+rigid_body_finalize(rigid_body_t* body) {
+	memory_deallocate(body->position[0]);
+	memset(body, 0, sizeof(rigid_body_t));
+}
+
+void
+rigid_body_update_inertia(rigid_body_t* body) {
+	vector_parallel_for(STRING_CONST("rigid_body_update_inertia"), rigid_body_update_inertia_range, body,
+	                    (body->count + 3) / 4, 0);
+}
+
+void
+rigid_body_integrate(rigid_body_t* body, const vector_t gravity, real linear_damping, real angular_damping,
+                     real dt) {
+	rigid_integrate_t integrate;
+	integrate.body = body;
+	integrate.gravity[0] = vector_uniform(vector_x(gravity));
+	integrate.gravity[1] = vector_uniform(vector_y(gravity));
+	integrate.gravity[2] = vector_uniform(vector_z(gravity));
+	integrate.linear_damping = vector_uniform(REAL_C(1.0) / (REAL_C(1.0) + (dt * linear_damping)));
+	integrate.angular_damping = vector_uniform(REAL_C(1.0) / (REAL_C(1.0) + (dt * angular_damping)));
+	integrate.dt = vector_uniform(dt);
+	vector_parallel_for(STRING_CONST("rigid_body_integrate"), rigid_body_integrate_range, &integrate,
+	                    (body->count + 3) / 4, 0);
+}
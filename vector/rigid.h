@@ -0,0 +1,59 @@
+/* rigid.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file rigid.h
+    Rigid body integration with semi-implicit Euler. Body state is stored as component streams
+    and integrated four bodies at a time, split across the job threads with vector_parallel_for.
+    Velocities are updated first from force, torque and gravity, then positions and
+    orientations from the new velocities. Orientation is integrated with the quaternion
+    derivative 0.5 * (angular_velocity, 0) * orientation and renormalized, after which the
+    world space inverse inertia tensor is rotated from the body space diagonal with the rotation
+    matrix of the orientation, same as matrix_from_quaternion.
+
+    Streams are padded to a multiple of four bodies and a group of four is always processed
+    together, so bodies after count up to the next multiple of four are integrated as well.
+    Bodies with zero inverse mass are static for forces and gravity. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Allocate zero initialized streams, bodies have identity orientation
+//! \param body Rigid body set
+//! \param capacity Max number of bodies
+VECTOR_API void
+rigid_body_initialize(rigid_body_t* body, size_t capacity);
+
+VECTOR_API void
+rigid_body_finalize(rigid_body_t* body);
+
+//! Calculate world space inverse inertia from orientation and body space inverse inertia,
+//! for example after setting initial state
+//! \param body Rigid body set
+VECTOR_API void
+rigid_body_update_inertia(rigid_body_t* body);
+
+//! Integrate bodies one step and clear force and torque accumulators
+//! \param body Rigid body set
+//! \param gravity Gravity acceleration
+//! \param linear_damping Linear velocity damping per second
+//! \param angular_damping Angular velocity damping per second
+//! \param dt Time step
+VECTOR_API void
+rigid_body_integrate(rigid_body_t* body, const vector_t gravity, real linear_damping, real angular_damping,
+                     real dt);
@@ -0,0 +1,161 @@
+/* scalar.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file scalar.h
+    Scalar trigonometric functions used by the library. Normally these forward to the foundation
+    math functions. With VECTOR_DETERMINISTIC set they are polynomial approximations using only
+    addition, multiplication, division and square root, which are correctly rounded on all
+    platforms, giving bit identical results everywhere. Approximations have an absolute error
+    below 1e-6, growing to about 2e-6 for arguments of sin and cos of magnitude near 1e5. Tangent
+    is the ratio of the sine and cosine approximations. */
+
+#include <vector/types.h>
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_sin(real x);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_cos(real x);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_tan(real x);
+
+//! Arc cosine, argument is clamped to [-1, 1]
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_acos(real x);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_atan2(real y, real x);
+
+#if VECTOR_DETERMINISTIC
+
+//! Reduce to [-pi, pi]. 2pi is split in two parts where the first has few enough bits for the
+//! product with the period count to be exact
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_reduce(real x) {
+	const real periods = x * REAL_C(0.15915494309189533577);
+	const real k = (real)(int32_t)((periods >= 0) ? periods + REAL_C(0.5) : periods - REAL_C(0.5));
+	return (x - k * REAL_C(6.28125)) - k * REAL_C(0.0019353071795864769253);
+}
+
+//! Sine of reduced argument in [-pi, pi], folded to [-pi/2, pi/2] for an odd polynomial
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_sin_reduced(real r) {
+	if (r > REAL_HALFPI)
+		r = REAL_PI - r;
+	else if (r < -REAL_HALFPI)
+		r = -REAL_PI - r;
+	const real r2 = r * r;
+	real p = REAL_C(-2.5052108385441718775e-8);
+	p = p * r2 + REAL_C(2.7557319223985890653e-6);
+	p = p * r2 - REAL_C(1.9841269841269841270e-4);
+	p = p * r2 + REAL_C(8.3333333333333333333e-3);
+	p = p * r2 - REAL_C(1.6666666666666666667e-1);
+	return r + r * (r2 * p);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_sin(real x) {
+	return vector_scalar_sin_reduced(vector_scalar_reduce(x));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_cos(real x) {
+	// Phase shift after reduction to keep precision for large arguments
+	real r = vector_scalar_reduce(x) + REAL_HALFPI;
+	if (r > REAL_PI)
+		r -= REAL_TWOPI;
+	return vector_scalar_sin_reduced(r);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_tan(real x) {
+	return vector_scalar_sin(x) / vector_scalar_cos(x);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_acos(real x) {
+	// Abramowitz and Stegun 4.4.46, acos(x) = sqrt(1 - x) * p(x) for x in [0, 1]
+	const real ax = (x < 0) ? ((x > -1) ? -x : 1) : ((x < 1) ? x : 1);
+	real p = REAL_C(-0.0012624911);
+	p = p * ax + REAL_C(0.0066700901);
+	p = p * ax - REAL_C(0.0170881256);
+	p = p * ax + REAL_C(0.0308918810);
+	p = p * ax - REAL_C(0.0501743046);
+	p = p * ax + REAL_C(0.0889789874);
+	p = p * ax - REAL_C(0.2145988016);
+	p = p * ax + REAL_C(1.5707963050);
+	const real angle = math_sqrt(1 - ax) * p;
+	return (x < 0) ? REAL_PI - angle : angle;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_atan2(real y, real x) {
+	// Abramowitz and Stegun 4.4.49 on the ratio of the smaller to the larger magnitude
+	const real ay = (y < 0) ? -y : y;
+	const real ax = (x < 0) ? -x : x;
+	if (ay == 0 && ax == 0)
+		return 0;
+	const bool swap = ay > ax;
+	const real t = swap ? ax / ay : ay / ax;
+	const real t2 = t * t;
+	real p = REAL_C(0.0028662257);
+	p = p * t2 - REAL_C(0.0161657367);
+	p = p * t2 + REAL_C(0.0429096138);
+	p = p * t2 - REAL_C(0.0752896400);
+	p = p * t2 + REAL_C(0.1065626393);
+	p = p * t2 - REAL_C(0.1420889944);
+	p = p * t2 + REAL_C(0.1999355085);
+	p = p * t2 - REAL_C(0.3333314528);
+	real angle = t + t * (t2 * p);
+	if (swap)
+		angle = REAL_HALFPI - angle;
+	if (x < 0)
+		angle = REAL_PI - angle;
+	return (y < 0) ? -angle : angle;
+}
+
+#else
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_sin(real x) {
+	return math_sin(x);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_cos(real x) {
+	return math_cos(x);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_tan(real x) {
+	return math_tan(x);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_acos(real x) {
+	return math_acos((x < -1) ? -1 : ((x > 1) ? 1 : x));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
+vector_scalar_atan2(real y, real x) {
+	return math_atan2(y, x);
+}
+
+#endif
@@ -0,0 +1,299 @@
+/* soa.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/soa.h>
+#include <vector/internal.h>
+
+#if VECTOR_IMPLEMENTATION_SSE4 && defined(__AVX__)
+#include <immintrin.h>
+#define SOA_AVX 1
+#else
+#define SOA_AVX 0
+#endif
+
+//! Number of elements to prefetch ahead in gather and scatter
+#define SOA_PREFETCH_DISTANCE 8
+
+#if VECTOR_IMPLEMENTATION_SSE4 || VECTOR_IMPLEMENTATION_SSE3 || VECTOR_IMPLEMENTATION_SSE2
+#define soa_prefetch(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#elif FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
+#define soa_prefetch(addr) __builtin_prefetch(addr)
+#else
+#define soa_prefetch(addr) FOUNDATION_UNUSED(addr)
+#endif
+
+static FOUNDATION_FORCEINLINE void
+soa_store(float32_t* out, const vector_t v) {
+	memcpy(out, &v, sizeof(vector_t));
+}
+
+//! Replace w component
+static FOUNDATION_FORCEINLINE vector_t
+soa_set_w(const vector_t v, const vector_t w) {
+	const vector_t zw = vector_shuffle2(v, w, VECTOR_MASK(2, 2, 3, 3));
+	return vector_shuffle2(v, zw, VECTOR_MASK(0, 1, 0, 2));
+}
+
+static FOUNDATION_FORCEINLINE void
+soa_store_streams(const vector_t* col, size_t offset, float32_t* x, float32_t* y, float32_t* z, float32_t* w) {
+	soa_store(x + offset, col[0]);
+	soa_store(y + offset, col[1]);
+	soa_store(z + offset, col[2]);
+	if (w)
+		soa_store(w + offset, col[3]);
+}
+
+static FOUNDATION_FORCEINLINE void
+soa_store_element(const vector_t v, size_t offset, float32_t* x, float32_t* y, float32_t* z, float32_t* w) {
+	x[offset] = (float32_t)vector_x(v);
+	y[offset] = (float32_t)vector_y(v);
+	z[offset] = (float32_t)vector_z(v);
+	if (w)
+		w[offset] = (float32_t)vector_w(v);
+}
+
+void
+soa_from_vector(const vector_t* in, size_t count, float32_t* x, float32_t* y, float32_t* z, float32_t* w) {
+	size_t ivec = 0;
+#if SOA_AVX
+	for (; ivec + 8 <= count; ivec += 8) {
+		// Upper lanes hold vectors 4-7, so the 4x4 transpose in each half gives eight wide streams
+		const __m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[ivec]), in[ivec + 4], 1);
+		const __m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[ivec + 1]), in[ivec + 5], 1);
+		const __m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[ivec + 2]), in[ivec + 6], 1);
+		const __m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(in[ivec + 3]), in[ivec + 7], 1);
+		const __m256 xy01 = _mm256_unpacklo_ps(r0, r1);
+		const __m256 zw01 = _mm256_unpackhi_ps(r0, r1);
+		const __m256 xy23 = _mm256_unpacklo_ps(r2, r3);
+		const __m256 zw23 = _mm256_unpackhi_ps(r2, r3);
+		_mm256_storeu_ps(x + ivec, _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(1, 0, 1, 0)));
+		_mm256_storeu_ps(y + ivec, _mm256_shuffle_ps(xy01, xy23, _MM_SHUFFLE(3, 2, 3, 2)));
+		_mm256_storeu_ps(z + ivec, _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(1, 0, 1, 0)));
+		if (w)
+			_mm256_storeu_ps(w + ivec, _mm256_shuffle_ps(zw01, zw23, _MM_SHUFFLE(3, 2, 3, 2)));
+	}
+#endif
+	for (; ivec + 4 <= count; ivec += 4) {
+		vector_t col[4];
+		vector_transpose4(in[ivec], in[ivec + 1], in[ivec + 2], in[ivec + 3], col);
+		soa_store_streams(col, ivec, x, y, z, w);
+	}
+	for (; ivec < count; ++ivec)
+		soa_store_element(in[ivec], ivec, x, y, z, w);
+}
+
+void
+soa_to_vector(const float32_t* x, const float32_t* y, const float32_t* z, const float32_t* w, real w_fill,
+              size_t count, vector_t* out) {
+	size_t ivec = 0;
+#if SOA_AVX
+	const __m256 fill8 = _mm256_set1_ps(w_fill);
+	for (; ivec + 8 <= count; ivec += 8) {
+		const __m256 x8 = _mm256_loadu_ps(x + ivec);
+		const __m256 y8 = _mm256_loadu_ps(y + ivec);
+		const __m256 z8 = _mm256_loadu_ps(z + ivec);
+		const __m256 w8 = w ? _mm256_loadu_ps(w + ivec) : fill8;
+		const __m256 xy01 = _mm256_unpacklo_ps(x8, y8);
+		const __m256 xy23 = _mm256_unpackhi_ps(x8, y8);
+		const __m256 zw01 = _mm256_unpacklo_ps(z8, w8);
+		const __m256 zw23 = _mm256_unpackhi_ps(z8, w8);
+		const __m256 r0 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 r1 = _mm256_shuffle_ps(xy01, zw01, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 r2 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 r3 = _mm256_shuffle_ps(xy23, zw23, _MM_SHUFFLE(3, 2, 3, 2));
+		out[ivec] = _mm256_castps256_ps128(r0);
+		out[ivec + 1] = _mm256_castps256_ps128(r1);
+		out[ivec + 2] = _mm256_castps256_ps128(r2);
+		out[ivec + 3] = _mm256_castps256_ps128(r3);
+		out[ivec + 4] = _mm256_extractf128_ps(r0, 1);
+		out[ivec + 5] = _mm256_extractf128_ps(r1, 1);
+		out[ivec + 6] = _mm256_extractf128_ps(r2, 1);
+		out[ivec + 7] = _mm256_extractf128_ps(r3, 1);
+	}
+#endif
+	const vector_t fill = vector_uniform(w_fill);
+	for (; ivec + 4 <= count; ivec += 4) {
+		const vector_t w4 = w ? vector_unaligned(w + ivec) : fill;
+		vector_transpose4(vector_unaligned(x + ivec), vector_unaligned(y + ivec), vector_unaligned(z + ivec), w4,
+		                  out + ivec);
+	}
+	for (; ivec < count; ++ivec)
+		out[ivec] = vector(x[ivec], y[ivec], z[ivec], w ? w[ivec] : w_fill);
+}
+
+void
+soa_from_float3(const float32_t* in, size_t count, float32_t* x, float32_t* y, float32_t* z) {
+	size_t ielem = 0;
+	for (; ielem + 4 <= count; ielem += 4) {
+		// Four elements in three loads, (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+		const float32_t* src = in + (ielem * 3);
+		const vector_t a = vector_unaligned(src);
+		const vector_t b = vector_unaligned(src + 4);
+		const vector_t c = vector_unaligned(src + 8);
+		const vector_t xy23 = vector_shuffle2(b, c, VECTOR_MASK(2, 3, 1, 2));
+		const vector_t yz01 = vector_shuffle2(a, b, VECTOR_MASK(1, 2, 0, 1));
+		const vector_t z23 = vector_shuffle2(c, c, VECTOR_MASK(0, 3, 0, 3));
+		soa_store(x + ielem, vector_shuffle2(a, xy23, VECTOR_MASK(0, 3, 0, 2)));
+		soa_store(y + ielem, vector_shuffle2(yz01, xy23, VECTOR_MASK(0, 2, 1, 3)));
+		soa_store(z + ielem, vector_shuffle2(yz01, z23, VECTOR_MASK(1, 3, 0, 1)));
+	}
+	for (; ielem < count; ++ielem) {
+		const float32_t* src = in + (ielem * 3);
+		x[ielem] = src[0];
+		y[ielem] = src[1];
+		z[ielem] = src[2];
+	}
+}
+
+void
+soa_to_float3(const float32_t* x, const float32_t* y, const float32_t* z, size_t count, float32_t* out) {
+	size_t ielem = 0;
+	for (; ielem + 4 <= count; ielem += 4) {
+		const vector_t x4 = vector_unaligned(x + ielem);
+		const vector_t y4 = vector_unaligned(y + ielem);
+		const vector_t z4 = vector_unaligned(z + ielem);
+		const vector_t x0y0 = vector_shuffle2(x4, y4, VECTOR_MASK(0, 0, 0, 0));
+		const vector_t z0x1 = vector_shuffle2(z4, x4, VECTOR_MASK(0, 0, 1, 1));
+		const vector_t y1z1 = vector_shuffle2(y4, z4, VECTOR_MASK(1, 1, 1, 1));
+		const vector_t x2y2 = vector_shuffle2(x4, y4, VECTOR_MASK(2, 2, 2, 2));
+		const vector_t z2x3 = vector_shuffle2(z4, x4, VECTOR_MASK(2, 2, 3, 3));
+		const vector_t y3z3 = vector_shuffle2(y4, z4, VECTOR_MASK(3, 3, 3, 3));
+		float32_t* dst = out + (ielem * 3);
+		soa_store(dst, vector_shuffle2(x0y0, z0x1, VECTOR_MASK(0, 2, 0, 2)));
+		soa_store(dst + 4, vector_shuffle2(y1z1, x2y2, VECTOR_MASK(0, 2, 0, 2)));
+		soa_store(dst + 8, vector_shuffle2(z2x3, y3z3, VECTOR_MASK(0, 2, 0, 2)));
+	}
+	for (; ielem < count; ++ielem) {
+		float32_t* dst = out + (ielem * 3);
+		dst[0] = x[ielem];
+		dst[1] = y[ielem];
+		dst[2] = z[ielem];
+	}
+}
+
+void
+soa_float3_to_vector(const float32_t* in, size_t count, real w, vector_t* out) {
+	const vector_t w4 = vector_uniform(w);
+	size_t ielem = 0;
+	for (; ielem + 4 <= count; ielem += 4) {
+		// Last element loaded ending at the last float to not read past the array
+		const float32_t* src = in + (ielem * 3);
+		const vector_t last = vector_unaligned(src + 8);
+		out[ielem] = soa_set_w(vector_unaligned(src), w4);
+		out[ielem + 1] = soa_set_w(vector_unaligned(src + 3), w4);
+		out[ielem + 2] = soa_set_w(vector_unaligned(src + 6), w4);
+		out[ielem + 3] = soa_set_w(vector_shuffle(last, VECTOR_MASK(1, 2, 3, 3)), w4);
+	}
+	for (; ielem < count; ++ielem) {
+		const float32_t* src = in + (ielem * 3);
+		out[ielem] = vector(src[0], src[1], src[2], w);
+	}
+}
+
+void
+soa_vector_to_float3(const vector_t* in, size_t count, float32_t* out) {
+	size_t ielem = 0;
+	for (; ielem + 4 <= count; ielem += 4) {
+		const vector_t v0 = in[ielem];
+		const vector_t v1 = in[ielem + 1];
+		const vector_t v2 = in[ielem + 2];
+		const vector_t v3 = in[ielem + 3];
+		const vector_t z0x1 = vector_shuffle2(v0, v1, VECTOR_MASK(2, 2, 0, 0));
+		const vector_t z2x3 = vector_shuffle2(v2, v3, VECTOR_MASK(2, 2, 0, 0));
+		float32_t* dst = out + (ielem * 3);
+		soa_store(dst, vector_shuffle2(v0, z0x1, VECTOR_MASK(0, 1, 0, 2)));
+		soa_store(dst + 4, vector_shuffle2(v1, v2, VECTOR_MASK(1, 2, 0, 1)));
+		soa_store(dst + 8, vector_shuffle2(z2x3, v3, VECTOR_MASK(0, 2, 1, 2)));
+	}
+	for (; ielem < count; ++ielem) {
+		float32_t* dst = out + (ielem * 3);
+		dst[0] = (float32_t)vector_x(in[ielem]);
+		dst[1] = (float32_t)vector_y(in[ielem]);
+		dst[2] = (float32_t)vector_z(in[ielem]);
+	}
+}
+
+void
+soa_gather_vector(const vector_t* in, const uint32_t* index, size_t count, vector_t* out) {
+	for (size_t ivec = 0; ivec < count; ++ivec) {
+		if (ivec + SOA_PREFETCH_DISTANCE < count)
+			soa_prefetch(in + index[ivec + SOA_PREFETCH_DISTANCE]);
+		out[ivec] = in[index[ivec]];
+	}
+}
+
+void
+soa_scatter_vector(const vector_t* in, const uint32_t* index, size_t count, vector_t* out) {
+	for (size_t ivec = 0; ivec < count; ++ivec) {
+		if (ivec + SOA_PREFETCH_DISTANCE < count)
+			soa_prefetch(out + index[ivec + SOA_PREFETCH_DISTANCE]);
+		out[index[ivec]] = in[ivec];
+	}
+}
+
+void
+soa_gather(const vector_t* in, const uint32_t* index, size_t count, float32_t* x, float32_t* y, float32_t* z,
+           float32_t* w) {
+	size_t ivec = 0;
+	for (; ivec + 4 <= count; ivec += 4) {
+		if (ivec + SOA_PREFETCH_DISTANCE + 4 <= count) {
+			const uint32_t* ahead = index + ivec + SOA_PREFETCH_DISTANCE;
+			soa_prefetch(in + ahead[0]);
+			soa_prefetch(in + ahead[1]);
+			soa_prefetch(in + ahead[2]);
+			soa_prefetch(in + ahead[3]);
+		}
+		vector_t col[4];
+		vector_transpose4(in[index[ivec]], in[index[ivec + 1]], in[index[ivec + 2]], in[index[ivec + 3]], col);
+		soa_store_streams(col, ivec, x, y, z, w);
+	}
+	for (; ivec < count; ++ivec)
+		soa_store_element(in[index[ivec]], ivec, x, y, z, w);
+}
+
+void
+soa_scatter(const float32_t* x, const float32_t* y, const float32_t* z, const float32_t* w, const uint32_t* index,
+            size_t count, vector_t* out) {
+	size_t ivec = 0;
+	for (; ivec + 4 <= count; ivec += 4) {
+		const uint32_t* dst = index + ivec;
+		if (ivec + SOA_PREFETCH_DISTANCE + 4 <= count) {
+			const uint32_t* ahead = dst + SOA_PREFETCH_DISTANCE;
+			soa_prefetch(out + ahead[0]);
+			soa_prefetch(out + ahead[1]);
+			soa_prefetch(out + ahead[2]);
+			soa_prefetch(out + ahead[3]);
+		}
+		vector_t row[4];
+		const vector_t w4 = w ? vector_unaligned(w + ivec) : vector_zero();
+		vector_transpose4(vector_unaligned(x + ivec), vector_unaligned(y + ivec), vector_unaligned(z + ivec), w4, row);
+		if (w) {
+			out[dst[0]] = row[0];
+			out[dst[1]] = row[1];
+			out[dst[2]] = row[2];
+			out[dst[3]] = row[3];
+		} else {
+			out[dst[0]] = soa_set_w(row[0], out[dst[0]]);
+			out[dst[1]] = soa_set_w(row[1], out[dst[1]]);
+			out[dst[2]] = soa_set_w(row[2], out[dst[2]]);
+			out[dst[3]] = soa_set_w(row[3], out[dst[3]]);
+		}
+	}
+	for (; ivec < count; ++ivec) {
+		const vector_t v = vector(x[ivec], y[ivec], z[ivec], 0);
+		out[index[ivec]] = soa_set_w(v, w ? vector_uniform(w[ivec]) : out[index[ivec]]);
+	}
+}
@@ -0,0 +1,122 @@
+/* soa.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file soa.h
+    Conversion between arrays of vectors, tightly packed three component float arrays and
+    separate component streams (structure of arrays). Groups of four elements are converted
+    with 4x4 transposes, and eight at a time with AVX when available. Streams do not need
+    to be aligned. Gather and scatter functions prefetch the indexed elements ahead. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+//! Split vectors into component streams
+//! \param in Input vectors
+//! \param count Number of vectors
+//! \param x Output x stream
+//! \param y Output y stream
+//! \param z Output z stream
+//! \param w Output w stream, can be null
+VECTOR_API void
+soa_from_vector(const vector_t* in, size_t count, float32_t* x, float32_t* y, float32_t* z, float32_t* w);
+
+//! Merge component streams into vectors
+//! \param x Input x stream
+//! \param y Input y stream
+//! \param z Input z stream
+//! \param w Input w stream, or null to set all w components to w_fill
+//! \param w_fill Value of w components if w stream is null
+//! \param count Number of vectors
+//! \param out Output vectors
+VECTOR_API void
+soa_to_vector(const float32_t* x, const float32_t* y, const float32_t* z, const float32_t* w, real w_fill,
+              size_t count, vector_t* out);
+
+//! Split tightly packed three component elements into component streams
+//! \param in Input elements, three floats per element
+//! \param count Number of elements
+//! \param x Output x stream
+//! \param y Output y stream
+//! \param z Output z stream
+VECTOR_API void
+soa_from_float3(const float32_t* in, size_t count, float32_t* x, float32_t* y, float32_t* z);
+
+//! Merge component streams into tightly packed three component elements
+//! \param x Input x stream
+//! \param y Input y stream
+//! \param z Input z stream
+//! \param count Number of elements
+//! \param out Output elements, three floats per element
+VECTOR_API void
+soa_to_float3(const float32_t* x, const float32_t* y, const float32_t* z, size_t count, float32_t* out);
+
+//! Widen tightly packed three component elements to vectors
+//! \param in Input elements, three floats per element
+//! \param count Number of elements
+//! \param w Value of w components
+//! \param out Output vectors
+VECTOR_API void
+soa_float3_to_vector(const float32_t* in, size_t count, real w, vector_t* out);
+
+//! Narrow vectors to tightly packed three component elements, dropping w
+//! \param in Input vectors
+//! \param count Number of vectors
+//! \param out Output elements, three floats per element
+VECTOR_API void
+soa_vector_to_float3(const vector_t* in, size_t count, float32_t* out);
+
+//! Gather indexed vectors, out[i] = in[index[i]]
+//! \param in Input vectors
+//! \param index Indices into input
+//! \param count Number of indices
+//! \param out Output vectors, count elements
+VECTOR_API void
+soa_gather_vector(const vector_t* in, const uint32_t* index, size_t count, vector_t* out);
+
+//! Scatter vectors to indexed locations, out[index[i]] = in[i]
+//! \param in Input vectors, count elements
+//! \param index Indices into output
+//! \param count Number of indices
+//! \param out Output vectors
+VECTOR_API void
+soa_scatter_vector(const vector_t* in, const uint32_t* index, size_t count, vector_t* out);
+
+//! Gather indexed vectors into component streams
+//! \param in Input vectors
+//! \param index Indices into input
+//! \param count Number of indices
+//! \param x Output x stream
+//! \param y Output y stream
+//! \param z Output z stream
+//! \param w Output w stream, can be null
+VECTOR_API void
+soa_gather(const vector_t* in, const uint32_t* index, size_t count, float32_t* x, float32_t* y, float32_t* z,
+           float32_t* w);
+
+//! Scatter component streams to indexed vectors
+//! \param x Input x stream
+//! \param y Input y stream
+//! \param z Input z stream
+//! \param w Input w stream, or null to keep the w components of the output vectors
+//! \param index Indices into output
+//! \param count Number of indices
+//! \param out Output vectors
+VECTOR_API void
+soa_scatter(const float32_t* x, const float32_t* y, const float32_t* z, const float32_t* w, const uint32_t* index,
+            size_t count, vector_t* out);
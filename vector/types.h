@@ -31,6 +31,7 @@
 #include <emmintrin.h>
 
 #define VECTOR_ALIGN FOUNDATION_ALIGN(16)
+#define VECTOR_ALIGNMENT 16
 #define VECTOR_ALIGNED_STRUCT(s) FOUNDATION_ALIGNED_STRUCT(s, 16)
 
 #if FOUNDATION_COMPILER_GCC || FOUNDATION_COMPILER_CLANG
@@ -52,6 +53,7 @@ typedef VECTOR_ALIGN float vector_arr_t[4];
 #include <arm_neon.h>
 
 #define VECTOR_ALIGN FOUNDATION_ALIGN(16)
+#define VECTOR_ALIGNMENT 16
 #define VECTOR_ALIGNED_STRUCT(s) FOUNDATION_ALIGNED_STRUCT(s, 16)
 
 typedef float32x4_t vector_t VECTOR_ALIGN;
@@ -61,6 +63,7 @@ typedef float vector_arr_t[4] VECTOR_ALIGN;
 #else
 
 #define VECTOR_ALIGN
+#define VECTOR_ALIGNMENT 16
 #define VECTOR_ALIGNED_STRUCT(s) struct s
 
 typedef struct vector_t vector_t;
@@ -83,6 +86,28 @@ struct vectori_t {
 
 #endif
 
+typedef struct vector64_t vector64_t;
+
+#if VECTOR_IMPLEMENTATION_SSE4 || VECTOR_IMPLEMENTATION_SSE3 || VECTOR_IMPLEMENTATION_SSE2
+
+//! Double precision vector as a pair of registers holding [x, y] and [z, w]
+VECTOR_ALIGNED_STRUCT(vector64_t) {
+	__m128d xy;
+	__m128d zw;
+};
+
+#else
+
+//! Double precision vector
+VECTOR_ALIGNED_STRUCT(vector64_t) {
+	float64_t x;
+	float64_t y;
+	float64_t z;
+	float64_t w;
+};
+
+#endif
+
 typedef union matrix_t matrix_t;
 
 //! Row major matrix where matrix row elements reside next to each other in memory.
@@ -106,8 +131,53 @@ union matrix_t {
 typedef vector_t quaternion_t;
 typedef vector_t euler_angles_t;  // Order as uint32_t in w component
 
+typedef union matrix64_t matrix64_t;
+
+//! Double precision row major matrix, same layout as matrix_t
+union matrix64_t {
+	//! Component access
+	VECTOR_ALIGNED_STRUCT(matrix64_component_t) {
+		float64_t m00, m01, m02, m03;  // Row 0
+		float64_t m10, m11, m12, m13;  // Row 1
+		float64_t m20, m21, m22, m23;  // Row 2
+		float64_t m30, m31, m32, m33;  // Row 3
+	}
+	comp;
+	//! Array access, flat layout
+	VECTOR_ALIGN float64_t arr[16];
+	//! 2-dimensional row access, frow[row_index][column_index]
+	VECTOR_ALIGN float64_t frow[4][4];
+	//! Vector access, each row is one vector, row[row_index]
+	vector64_t row[4];
+};
+
+typedef vector64_t quaternion64_t;
+
 typedef struct dual_quaternion_t dual_quaternion_t;
 typedef struct transform_t transform_t;
+typedef struct aabb_t aabb_t;
+typedef struct ray_t ray_t;
+typedef struct obb_t obb_t;
+typedef struct bvh_node_t bvh_node_t;
+typedef struct bvh_hit_t bvh_hit_t;
+typedef struct bvh_t bvh_t;
+typedef struct hashgrid_cell_t hashgrid_cell_t;
+typedef struct hashgrid_t hashgrid_t;
+typedef struct broadphase_entry_t broadphase_entry_t;
+typedef struct broadphase_pair_t broadphase_pair_t;
+typedef struct broadphase_t broadphase_t;
+typedef struct convex_t convex_t;
+typedef struct convex_contact_t convex_contact_t;
+typedef struct mesh_adjacency_t mesh_adjacency_t;
+typedef struct animation_track_t animation_track_t;
+typedef struct animation_clip_t animation_clip_t;
+typedef struct animation_cursor_t animation_cursor_t;
+typedef struct rigid_body_t rigid_body_t;
+typedef struct particle_system_t particle_system_t;
+typedef struct particle_field_t particle_field_t;
+typedef struct particle_forces_t particle_forces_t;
+typedef struct vector_arena_t vector_arena_t;
+typedef struct vector_job_timing_t vector_job_timing_t;
 typedef struct vector_config_t vector_config_t;
 
 VECTOR_ALIGNED_STRUCT(dual_quaternion_t) {
@@ -119,6 +189,27 @@ VECTOR_ALIGNED_STRUCT(transform_t) {
 	vector_t translation;  // Scale in w component
 };
 
+//! Axis aligned bounding box, w components are ignored
+VECTOR_ALIGNED_STRUCT(aabb_t) {
+	vector_t min;
+	vector_t max;
+};
+
+//! Ray with origin point and direction, w components are ignored
+VECTOR_ALIGNED_STRUCT(ray_t) {
+	vector_t origin;
+	vector_t direction;
+};
+
+//! Oriented bounding box, w components of center and extent are ignored
+VECTOR_ALIGNED_STRUCT(obb_t) {
+	vector_t center;
+	//! Half size along each local axis
+	vector_t extent;
+	//! Local axes are the rows of matrix_from_quaternion(rotation)
+	quaternion_t rotation;
+};
+
 #define VECTOR_GETEULERORDER(i, p, r, f) ((((((i << 1) + p) << 1) + r) << 1) + f)
 
 #define VECTOR_EULER_STATICFRAME 0
@@ -168,12 +259,378 @@ typedef enum euler_angles_order_t {
 } euler_angles_order_t;
 
 typedef VECTOR_ALIGN float32_t float32_aligned128_t;
+typedef VECTOR_ALIGN float64_t float64_aligned128_t;
+
+//! Projection matrix flags, defaults are OpenGL style depth in [-1, 1] with far plane at max depth
+typedef enum projection_flag_t {
+	//! Depth in [0, 1] as in Direct3D, Vulkan and Metal
+	PROJECTION_DEPTH_ZERO_TO_ONE = 1,
+	//! Reversed depth, near plane at max depth and far plane at min depth
+	PROJECTION_REVERSED_Z = 2,
+	//! Far plane at infinite distance, far distance argument is ignored. Perspective only
+	PROJECTION_INFINITE_FAR = 4
+} projection_flag_t;
+
+//! Clip mask bits of projected points, one bit for each frustum plane the point is outside
+typedef enum projection_clip_t {
+	PROJECTION_CLIP_LEFT = 1,
+	PROJECTION_CLIP_RIGHT = 2,
+	PROJECTION_CLIP_BOTTOM = 4,
+	PROJECTION_CLIP_TOP = 8,
+	//! Also set for points at or behind the eye plane
+	PROJECTION_CLIP_NEAR = 16,
+	PROJECTION_CLIP_FAR = 32
+} projection_clip_t;
+
+//! Matrix decomposition flags, set for parts of a matrix a transform cannot represent
+typedef enum matrix_decompose_flag_t {
+	//! Scale differs between axes
+	MATRIX_DECOMPOSE_NONUNIFORM_SCALE = 1,
+	//! Stretch is not aligned with the local axes
+	MATRIX_DECOMPOSE_SHEAR = 2,
+	//! Negative determinant, rotation is proper and stretch has a negative eigenvalue
+	MATRIX_DECOMPOSE_REFLECTION = 4
+} matrix_decompose_flag_t;
+
+//! Primitive type stored in a bounding volume hierarchy
+typedef enum bvh_primitive_t {
+	//! Primitives are axis aligned bounding boxes
+	BVH_PRIMITIVE_AABB = 0,
+	//! Primitives are indexed triangles
+	BVH_PRIMITIVE_TRIANGLE
+} bvh_primitive_t;
+
+//! Four-wide hierarchy node. Child bounds are stored as structure-of-arrays, one lane
+//! per child, so a ray or box can be tested against all four children at once
+VECTOR_ALIGNED_STRUCT(bvh_node_t) {
+	vector_t min_x;
+	vector_t min_y;
+	vector_t min_z;
+	vector_t max_x;
+	vector_t max_y;
+	vector_t max_z;
+	//! Child node index for interior children, first primitive slot for leaf children
+	//! and negative for unused lanes
+	int32_t child[4];
+	//! Number of primitives in leaf children, zero for interior children
+	uint32_t count[4];
+};
+
+//! Result of a closest hit ray query
+struct bvh_hit_t {
+	//! Distance along ray in units of ray direction length
+	real distance;
+	//! Primitive index as given at build time
+	uint32_t primitive;
+	//! Barycentric coordinates of hit point for triangle primitives
+	real u;
+	real v;
+};
+
+//! Bounding volume hierarchy over a set of primitives
+struct bvh_t {
+	//! Nodes, root node at index zero. Child nodes always have a higher index than the parent
+	bvh_node_t* node;
+	uint32_t node_count;
+	uint32_t node_capacity;
+	//! Primitive index for each leaf slot
+	uint32_t* primitive;
+	uint32_t primitive_count;
+	uint32_t primitive_capacity;
+	//! Primitive bounds in leaf slot order
+	aabb_t* bounds;
+	bvh_primitive_t type;
+	//! Triangle vertex and index data, not owned by the hierarchy
+	const vector_t* vertex;
+	const uint32_t* index;
+};
+
+//! Item type stored in a spatial hash grid
+typedef enum hashgrid_item_t {
+	//! Items are points, each stored in a single cell
+	HASHGRID_ITEM_POINT = 0,
+	//! Items are axis aligned bounding boxes, each stored in every cell it overlaps
+	HASHGRID_ITEM_AABB
+} hashgrid_item_t;
+
+//! Open addressing hash table slot mapping a grid cell to its range of items
+struct hashgrid_cell_t {
+	//! Packed cell coordinate, all bits set for unused slots
+	uint64_t key;
+	//! First entry in item arrays
+	uint32_t begin;
+	//! Number of entries
+	uint32_t count;
+};
+
+//! Uniform grid with sparse cell storage in a hash table. Items are stored sorted by cell
+VECTOR_ALIGNED_STRUCT(hashgrid_t) {
+	//! Minimum and maximum occupied cell coordinates
+	vectori_t cell_min;
+	vectori_t cell_max;
+	real cell_size;
+	real cell_size_inv;
+	hashgrid_item_t type;
+	//! Number of items as given at build time
+	uint32_t count;
+	//! Cell table, capacity is a power of two
+	hashgrid_cell_t* cell;
+	uint32_t cell_count;
+	uint32_t cell_capacity;
+	//! Item index for each entry, grouped by cell
+	uint32_t* item;
+	uint32_t entry_count;
+	uint32_t entry_capacity;
+	//! Item position or bounds for each entry, grouped by cell
+	vector_t* point;
+	aabb_t* bounds;
+};
+
+//! Sweep list entry of a sweep and prune broadphase. Bounds are copies of the handle bounds with the
+//! components rotated so the sweep axis is in x
+VECTOR_ALIGNED_STRUCT(broadphase_entry_t) {
+	vector_t min;
+	vector_t max;
+	uint32_t handle;
+};
+
+//! Pair of overlapping handles, first is less than second
+struct broadphase_pair_t {
+	uint32_t first;
+	uint32_t second;
+};
+
+//! Incremental sweep and prune broadphase over boxes identified by handles
+struct broadphase_t {
+	//! Sweep axis index, 0-2
+	unsigned int axis;
+	//! Bounds for each handle
+	vector_t* min;
+	vector_t* max;
+	//! Nonzero for handles in use
+	uint8_t* active;
+	//! Number of handles ever allocated, handles are in [0, handle_count)
+	uint32_t handle_count;
+	uint32_t handle_capacity;
+	//! Released handles available for reuse
+	uint32_t* free;
+	uint32_t free_count;
+	//! Removed handles still in the sweep list, released by the next sort
+	uint32_t* removed;
+	uint32_t removed_count;
+	//! Sweep list sorted by min on the sweep axis, added handles are appended unsorted
+	broadphase_entry_t* entry;
+	uint32_t entry_count;
+	uint32_t unsorted_count;
+	//! Pair count per chunk of the sweep list, scratch for pair generation
+	size_t* chunk_pairs;
+	uint32_t chunk_capacity;
+};
+
+//! Core of a convex shape, the full shape is the core expanded by the shape radius
+typedef enum convex_type_t {
+	//! Single point at the origin, a sphere when expanded by the radius
+	CONVEX_SPHERE = 0,
+	//! Segment between -extent and extent, a capsule when expanded by the radius
+	CONVEX_CAPSULE,
+	//! Box with half size extent
+	CONVEX_BOX,
+	//! Convex hull of a point cloud
+	CONVEX_HULL,
+	//! Core given by a support function
+	CONVEX_CUSTOM
+} convex_type_t;
+
+//! Support function of a custom convex core, returns the point of the core furthest along the
+//! given direction. Both are in shape local space and the direction is not normalized
+typedef vector_t (*convex_support_fn)(const void* data, const vector_t direction);
+
+//! Convex shape given by a support mapping of the core in local space and a radius
+VECTOR_ALIGNED_STRUCT(convex_t) {
+	//! Local to world matrix, rows 0-2 are unit axes and row 3 is the position
+	matrix_t transform;
+	//! Half size of box, half segment of capsule
+	vector_t extent;
+	convex_type_t type;
+	//! Radius of the sphere swept over the core
+	real radius;
+	//! Hull points in local space, not owned by the shape
+	const vector_t* point;
+	size_t point_count;
+	//! Custom support function and data passed to it
+	convex_support_fn support;
+	const void* data;
+};
+
+//! Closest points of separated convex shapes or deepest points of overlapping shapes
+VECTOR_ALIGNED_STRUCT(convex_contact_t) {
+	//! Point on the surface of the first shape
+	vector_t point0;
+	//! Point on the surface of the second shape
+	vector_t point1;
+	//! Unit direction from the first to the second shape. Moving the second shape by
+	//! -distance * normal makes the shapes touch
+	vector_t normal;
+	//! Distance between the shapes, negative penetration depth for overlapping shapes
+	real distance;
+};
+
+//! Vertex to triangle corner adjacency of an indexed triangle mesh, stored compressed
+//! with the corners of each vertex in a contiguous range
+struct mesh_adjacency_t {
+	//! Offset of first corner for each vertex, vertex_count + 1 elements
+	uint32_t* offset;
+	//! Corner index (triangle * 3 + corner) grouped by vertex
+	uint32_t* corner;
+	uint32_t vertex_count;
+	uint32_t triangle_count;
+};
+
+//! Compressed rotation, translation and scale channels of one bone
+VECTOR_ALIGNED_STRUCT(animation_track_t) {
+	//! Translation in xyz and scale in w of quantized value zero
+	vector_t offset;
+	//! Range of translation in xyz and scale in w covered by quantized values
+	vector_t extent;
+	//! First key of each channel
+	uint32_t key[3];
+	//! Number of keys of each channel
+	uint32_t key_count[3];
+};
+
+//! Animation clip with keys of each channel sorted by time and stored back to back per bone
+struct animation_clip_t {
+	animation_track_t* track;
+	//! Frame index of keys for each channel
+	uint16_t* frame[3];
+	//! Rotation keys packed as smallest three, three values per key
+	uint16_t* rotation;
+	//! Quantized translation keys, three values per key
+	uint16_t* translation;
+	//! Quantized scale keys
+	uint16_t* scale;
+	uint32_t bone_count;
+	uint32_t frame_count;
+	real frame_rate;
+	real duration;
+};
+
+//! Playback state of an animation instance, caching the current key of each channel
+struct animation_cursor_t {
+	uint32_t* key;
+	uint32_t bone_count;
+};
+
+//! Rigid body state of a set of bodies as component streams, padded to a multiple of four bodies
+struct rigid_body_t {
+	float32_t* position[3];
+	float32_t* velocity[3];
+	//! Orientation quaternion
+	float32_t* orientation[4];
+	float32_t* angular_velocity[3];
+	//! Accumulated force, cleared by integration
+	float32_t* force[3];
+	//! Accumulated torque, cleared by integration
+	float32_t* torque[3];
+	float32_t* inverse_mass;
+	//! Diagonal of inverse inertia tensor in body space
+	float32_t* inverse_inertia_body[3];
+	//! Inverse inertia tensor in world space, components xx, yy, zz, xy, xz, yz
+	float32_t* inverse_inertia[6];
+	size_t count;
+	size_t capacity;
+};
+
+//! Particles as component streams, padded to a multiple of four particles
+struct particle_system_t {
+	float32_t* position[3];
+	float32_t* velocity[3];
+	//! Time since emission
+	float32_t* age;
+	//! Age at which the particle is removed
+	float32_t* lifetime;
+	size_t count;
+	size_t capacity;
+	//! Stream storage, culling compacts into the other buffer and swaps
+	float32_t* buffer[2];
+	unsigned int current;
+};
+
+//! Vector field on a regular grid over bounds, with the value of the nearest cell center
+VECTOR_ALIGNED_STRUCT(particle_field_t) {
+	aabb_t bounds;
+	//! Cell values with x varying fastest, dim[0] * dim[1] * dim[2] elements
+	const vector_t* value;
+	uint32_t dim[3];
+};
+
+//! Accelerations applied by particle_update
+VECTOR_ALIGNED_STRUCT(particle_forces_t) {
+	vector_t gravity;
+	//! Linear drag, acceleration -drag * velocity
+	real drag;
+	//! Point attractors, position in xyz and strength in w, can be null
+	const vector_t* attractor;
+	size_t attractor_count;
+	//! Squared distance added to attractor distances to limit acceleration close to attractors
+	real attractor_softening;
+	//! Acceleration field, can be null
+	const particle_field_t* field;
+};
 
 FOUNDATION_STATIC_ASSERT(sizeof(vector_t) == sizeof(float32_t) * 4, "vector size");
 FOUNDATION_STATIC_ASSERT(sizeof(matrix_t) == sizeof(float32_t) * 16, "matrix size");
+FOUNDATION_STATIC_ASSERT(sizeof(vector64_t) == sizeof(float64_t) * 4, "vector64 size");
+FOUNDATION_STATIC_ASSERT(sizeof(matrix64_t) == sizeof(float64_t) * 16, "matrix64 size");
 FOUNDATION_STATIC_ASSERT(sizeof(transform_t) == sizeof(float32_t) * 8, "transform size");
 FOUNDATION_STATIC_ASSERT(sizeof(euler_angles_t) == sizeof(float32_t) * 4, "euler angles size");
+FOUNDATION_STATIC_ASSERT(sizeof(aabb_t) == sizeof(float32_t) * 8, "aabb size");
+FOUNDATION_STATIC_ASSERT(sizeof(obb_t) == sizeof(float32_t) * 12, "obb size");
+FOUNDATION_STATIC_ASSERT(sizeof(bvh_node_t) == 128, "bvh node size");
+
+//! Linear allocator for temporary arrays, reset as a whole
+struct vector_arena_t {
+	//! Memory block, aligned to 64 bytes
+	char* buffer;
+	size_t capacity;
+	//! Offset of next free byte. Offsets past capacity are in overflow blocks
+	size_t offset;
+	//! Largest offset since last reset
+	size_t peak;
+	//! Overflow blocks used when the block is full, most recent first
+	void* overflow;
+	//! Next arena in the list of thread arenas
+	vector_arena_t* next;
+};
+
+//! Range function for parallel jobs, processing items [begin, end)
+typedef void (*vector_job_fn)(void* context, size_t begin, size_t end);
+
+//! Callback receiving timings of a completed parallel job
+typedef void (*vector_job_timing_fn)(const char* name, size_t length, const vector_job_timing_t* timing);
+
+//! Timings of a parallel job
+struct vector_job_timing_t {
+	//! Time from submit to completion on the submitting thread
+	tick_t elapsed;
+	//! Time spent in the job function summed over all threads
+	tick_t busy;
+	//! Number of items
+	size_t count;
+	//! Number of ranges the items were split into
+	uint32_t ranges;
+	//! Number of ranges executed by worker threads other than the submitting thread
+	uint32_t stolen;
+};
 
 struct vector_config_t {
-	int unused;
+	//! Number of threads used by parallel batch kernels including the calling thread.
+	//! Zero or one runs all kernels single threaded on the calling thread
+	unsigned int thread_count;
+	//! Default number of items below which a range is not split further, zero for default
+	size_t grain_size;
+	//! Optional callback receiving timings of each parallel job
+	vector_job_timing_fn job_timing;
+	//! Initial size in bytes of the temporary memory arena of each thread, zero for default
+	size_t arena_size;
 };
@@ -15,15 +15,23 @@
  */
 
 #include <vector/vector.h>
+#include <vector/internal.h>
 
 static bool vector_initialized;
 
 int
 vector_module_initialize(const vector_config_t config) {
-	FOUNDATION_UNUSED(config);
 	if (vector_initialized)
 		return 0;
 
+	int ret = vector_arena_module_initialize(config);
+	if (ret < 0)
+		return ret;
+
+	ret = vector_job_initialize(config);
+	if (ret < 0)
+		return ret;
+
 	vector_initialized = true;
 
 	return 0;
@@ -31,6 +39,10 @@ vector_module_initialize(const vector_config_t config) {
 
 void
 vector_module_finalize(void) {
+	if (vector_initialized) {
+		vector_job_finalize();
+		vector_arena_module_finalize();
+	}
 	vector_initialized = false;
 }
 
@@ -168,6 +168,18 @@ vector_max(const vector_t v0, const vector_t v1);
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_abs(const vector_t v);
 
+//! Round towards negative infinity
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v);
+
+//! Round towards positive infinity
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v);
+
+//! Round to nearest integer, halfway cases to even
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v);
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
 vector_x(const vector_t v);
 
@@ -201,6 +213,11 @@ vector_gequal(const vector_t v0, const vector_t v1);
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vector_greater(const vector_t v0, const vector_t v1);
 
+//! Select components from v0 where mask bits are set and from v1 where clear. Masks from
+//! comparisons have all bits either set or clear in each component
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_select(const vectori_t mask, const vector_t v0, const vector_t v1);
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vectori_zero(void);
 
@@ -228,6 +245,75 @@ vectori_and(const vectori_t v0, const vectori_t v1);
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vectori_or(const vectori_t v0, const vectori_t v1);
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori(const int32_t x, const int32_t y, const int32_t z, const int32_t w);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_uniform(const int32_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_add(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_sub(const vectori_t v0, const vectori_t v1);
+
+//! Multiply, keeping the low 32 bits of each product
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_mul(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_min(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_max(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_xor(const vectori_t v0, const vectori_t v1);
+
+//! Bitwise and of v0 with complement of v1, v0 & ~v1
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_andnot(const vectori_t v0, const vectori_t v1);
+
+//! Shift each component by count bits, count in range [0, 31]
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_left(const vectori_t v, const unsigned int count);
+
+//! Arithmetic shift, sign bit is shifted in
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right(const vectori_t v, const unsigned int count);
+
+//! Logical shift, zero bits are shifted in
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right_logical(const vectori_t v, const unsigned int count);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_equal(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_less(const vectori_t v0, const vectori_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_greater(const vectori_t v0, const vectori_t v1);
+
+//! Select components from v0 where mask bits are set and from v1 where clear
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_select(const vectori_t mask, const vectori_t v0, const vectori_t v1);
+
+//! Convert with truncation towards zero. Values outside int32 range give undefined results
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori(const vector_t v);
+
+//! Convert rounding to nearest integer, halfway cases to even
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_round(const vector_t v);
+
+//! Convert rounding towards negative infinity
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_floor(const vector_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vectori_to_vector(const vectori_t v);
+
 //! Treat vectors as row vectors, which puts axes in rows in matrix
 //                 [ m00 m01 m02 --- ]
 // [ vx vy vz vw ] [ m10 m11 m12 --- ] = [ m00*vx + m10*vy + m20*vz, m01*vx ..., ..., vw ]
@@ -265,3 +351,28 @@ string_from_vector_static(const vector_t v);
 #include <vector/quaternion.h>
 #include <vector/matrix.h>
 #include <vector/euler.h>
+#include <vector/projection.h>
+#include <vector/decompose.h>
+#include <vector/aabb.h>
+#include <vector/ray.h>
+#include <vector/obb.h>
+#include <vector/bvh.h>
+#include <vector/morton.h>
+#include <vector/hashgrid.h>
+#include <vector/broadphase.h>
+#include <vector/convex.h>
+#include <vector/registration.h>
+#include <vector/mesh.h>
+#include <vector/job.h>
+#include <vector/batch.h>
+#include <vector/arena.h>
+#include <vector/soa.h>
+#include <vector/half.h>
+#include <vector/pack.h>
+#include <vector/animation.h>
+#include <vector/pose.h>
+#include <vector/ik.h>
+#include <vector/rigid.h>
+#include <vector/particle.h>
+#include <vector/vector64.h>
+#include <vector/scalar.h>
@@ -0,0 +1,612 @@
+/* vector.hpp  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file vector.hpp
+    Optional C++ wrapper types Vec4, Mat4 and Quat over vector_t, matrix_t and quaternion_t. Not
+    included by vector.h, include explicitly from C++ code. Vector arithmetic builds expression
+    templates which are evaluated when assigned to a Vec4, which allows an expression like a * b + c
+    to be evaluated with a single vector_muladd. All operations forward to the C API functions.
+    On FMA targets vector_muladd is a fused multiply-add, so a * b + c may differ in the last bits
+    from separate vector_mul and vector_add calls. In deterministic mode vector_muladd is never
+    fused and the results are the same as the separate calls. Expressions hold their operands by
+    value and can safely be stored with auto. */
+
+#include <vector/vector.h>
+
+#ifdef __cplusplus
+
+namespace vectorlib {
+
+//! Base of all vector expressions, evaluated with eval()
+template <typename E>
+struct VecExpr {
+	FOUNDATION_FORCEINLINE const E&
+	expr() const {
+		return *static_cast<const E*>(this);
+	}
+};
+
+template <typename L, typename R>
+struct VecAddExpr;
+
+template <typename L, typename R>
+struct VecSubExpr;
+
+template <typename L, typename R>
+struct VecMulExpr;
+
+template <typename L, typename R>
+struct VecDivExpr;
+
+template <typename E>
+struct VecNegExpr;
+
+struct Vec4 : VecExpr<Vec4> {
+	vector_t v;
+
+	//! Uninitialized, same as a vector_t
+	Vec4() = default;
+
+	FOUNDATION_FORCEINLINE
+	Vec4(const vector_t value) : v(value) {
+	}
+
+	FOUNDATION_FORCEINLINE
+	Vec4(real x, real y, real z, real w) : v(vector(x, y, z, w)) {
+	}
+
+	//! Evaluate expression
+	template <typename E>
+	FOUNDATION_FORCEINLINE
+	Vec4(const VecExpr<E>& e) : v(e.expr().eval()) {
+	}
+
+	template <typename E>
+	FOUNDATION_FORCEINLINE Vec4&
+	operator=(const VecExpr<E>& e) {
+		v = e.expr().eval();
+		return *this;
+	}
+
+	template <typename E>
+	FOUNDATION_FORCEINLINE Vec4&
+	operator+=(const VecExpr<E>& e) {
+		v = VecAddExpr<Vec4, E>(*this, e.expr()).eval();
+		return *this;
+	}
+
+	template <typename E>
+	FOUNDATION_FORCEINLINE Vec4&
+	operator-=(const VecExpr<E>& e) {
+		v = VecSubExpr<Vec4, E>(*this, e.expr()).eval();
+		return *this;
+	}
+
+	template <typename E>
+	FOUNDATION_FORCEINLINE Vec4&
+	operator*=(const VecExpr<E>& e) {
+		v = VecMulExpr<Vec4, E>(*this, e.expr()).eval();
+		return *this;
+	}
+
+	template <typename E>
+	FOUNDATION_FORCEINLINE Vec4&
+	operator/=(const VecExpr<E>& e) {
+		v = VecDivExpr<Vec4, E>(*this, e.expr()).eval();
+		return *this;
+	}
+
+	FOUNDATION_FORCEINLINE Vec4&
+	operator*=(real s) {
+		v = vector_scale(v, s);
+		return *this;
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return v;
+	}
+
+	FOUNDATION_FORCEINLINE
+	operator vector_t() const {
+		return v;
+	}
+
+	FOUNDATION_FORCEINLINE real
+	x() const {
+		return vector_x(v);
+	}
+
+	FOUNDATION_FORCEINLINE real
+	y() const {
+		return vector_y(v);
+	}
+
+	FOUNDATION_FORCEINLINE real
+	z() const {
+		return vector_z(v);
+	}
+
+	FOUNDATION_FORCEINLINE real
+	w() const {
+		return vector_w(v);
+	}
+
+	FOUNDATION_FORCEINLINE real
+	operator[](int c) const {
+		return vector_component(v, c);
+	}
+
+	static FOUNDATION_FORCEINLINE Vec4
+	uniform(real s) {
+		return vector_uniform(s);
+	}
+
+	static FOUNDATION_FORCEINLINE Vec4
+	zero() {
+		return vector_zero();
+	}
+
+	static FOUNDATION_FORCEINLINE Vec4
+	one() {
+		return vector_one();
+	}
+
+	static FOUNDATION_FORCEINLINE Vec4
+	origo() {
+		return vector_origo();
+	}
+};
+
+//! Scalar broadcast to all components, used for vector-scalar expressions
+struct VecUniformExpr : VecExpr<VecUniformExpr> {
+	real s;
+
+	FOUNDATION_FORCEINLINE explicit VecUniformExpr(real value) : s(value) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_uniform(s);
+	}
+};
+
+template <typename L, typename R>
+struct VecMulExpr : VecExpr<VecMulExpr<L, R>> {
+	L l;
+	R r;
+
+	FOUNDATION_FORCEINLINE
+	VecMulExpr(const L& left, const R& right) : l(left), r(right) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_mul(l.eval(), r.eval());
+	}
+};
+
+// Sum with a product operand is evaluated as a multiply-add. Overloads are picked by partial
+// ordering, the last one resolves the ambiguity of two product operands
+template <typename L, typename R>
+FOUNDATION_FORCEINLINE vector_t
+vector_expr_add(const L& l, const R& r) {
+	return vector_add(l.eval(), r.eval());
+}
+
+template <typename A, typename B, typename R>
+FOUNDATION_FORCEINLINE vector_t
+vector_expr_add(const VecMulExpr<A, B>& l, const R& r) {
+	return vector_muladd(l.l.eval(), l.r.eval(), r.eval());
+}
+
+template <typename L, typename A, typename B>
+FOUNDATION_FORCEINLINE vector_t
+vector_expr_add(const L& l, const VecMulExpr<A, B>& r) {
+	return vector_muladd(r.l.eval(), r.r.eval(), l.eval());
+}
+
+template <typename A, typename B, typename C, typename D>
+FOUNDATION_FORCEINLINE vector_t
+vector_expr_add(const VecMulExpr<A, B>& l, const VecMulExpr<C, D>& r) {
+	return vector_muladd(l.l.eval(), l.r.eval(), r.eval());
+}
+
+template <typename L, typename R>
+struct VecAddExpr : VecExpr<VecAddExpr<L, R>> {
+	L l;
+	R r;
+
+	FOUNDATION_FORCEINLINE
+	VecAddExpr(const L& left, const R& right) : l(left), r(right) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_expr_add(l, r);
+	}
+};
+
+template <typename L, typename R>
+struct VecSubExpr : VecExpr<VecSubExpr<L, R>> {
+	L l;
+	R r;
+
+	FOUNDATION_FORCEINLINE
+	VecSubExpr(const L& left, const R& right) : l(left), r(right) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_sub(l.eval(), r.eval());
+	}
+};
+
+template <typename L, typename R>
+struct VecDivExpr : VecExpr<VecDivExpr<L, R>> {
+	L l;
+	R r;
+
+	FOUNDATION_FORCEINLINE
+	VecDivExpr(const L& left, const R& right) : l(left), r(right) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_div(l.eval(), r.eval());
+	}
+};
+
+template <typename E>
+struct VecNegExpr : VecExpr<VecNegExpr<E>> {
+	E e;
+
+	FOUNDATION_FORCEINLINE explicit VecNegExpr(const E& operand) : e(operand) {
+	}
+
+	FOUNDATION_FORCEINLINE vector_t
+	eval() const {
+		return vector_neg(e.eval());
+	}
+};
+
+template <typename L, typename R>
+FOUNDATION_FORCEINLINE VecAddExpr<L, R>
+operator+(const VecExpr<L>& l, const VecExpr<R>& r) {
+	return VecAddExpr<L, R>(l.expr(), r.expr());
+}
+
+template <typename L, typename R>
+FOUNDATION_FORCEINLINE VecSubExpr<L, R>
+operator-(const VecExpr<L>& l, const VecExpr<R>& r) {
+	return VecSubExpr<L, R>(l.expr(), r.expr());
+}
+
+template <typename L, typename R>
+FOUNDATION_FORCEINLINE VecMulExpr<L, R>
+operator*(const VecExpr<L>& l, const VecExpr<R>& r) {
+	return VecMulExpr<L, R>(l.expr(), r.expr());
+}
+
+template <typename L>
+FOUNDATION_FORCEINLINE VecMulExpr<L, VecUniformExpr>
+operator*(const VecExpr<L>& l, real s) {
+	return VecMulExpr<L, VecUniformExpr>(l.expr(), VecUniformExpr(s));
+}
+
+template <typename R>
+FOUNDATION_FORCEINLINE VecMulExpr<VecUniformExpr, R>
+operator*(real s, const VecExpr<R>& r) {
+	return VecMulExpr<VecUniformExpr, R>(VecUniformExpr(s), r.expr());
+}
+
+template <typename L, typename R>
+FOUNDATION_FORCEINLINE VecDivExpr<L, R>
+operator/(const VecExpr<L>& l, const VecExpr<R>& r) {
+	return VecDivExpr<L, R>(l.expr(), r.expr());
+}
+
+template <typename L>
+FOUNDATION_FORCEINLINE VecDivExpr<L, VecUniformExpr>
+operator/(const VecExpr<L>& l, real s) {
+	return VecDivExpr<L, VecUniformExpr>(l.expr(), VecUniformExpr(s));
+}
+
+template <typename E>
+FOUNDATION_FORCEINLINE VecNegExpr<E>
+operator-(const VecExpr<E>& e) {
+	return VecNegExpr<E>(e.expr());
+}
+
+FOUNDATION_FORCEINLINE real
+dot(const Vec4& v0, const Vec4& v1) {
+	return vector_x(vector_dot(v0.v, v1.v));
+}
+
+FOUNDATION_FORCEINLINE real
+dot3(const Vec4& v0, const Vec4& v1) {
+	return vector_x(vector_dot3(v0.v, v1.v));
+}
+
+FOUNDATION_FORCEINLINE Vec4
+cross3(const Vec4& v0, const Vec4& v1) {
+	return vector_cross3(v0.v, v1.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+normalize(const Vec4& v) {
+	return vector_normalize(v.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+normalize3(const Vec4& v) {
+	return vector_normalize3(v.v);
+}
+
+FOUNDATION_FORCEINLINE real
+length(const Vec4& v) {
+	return vector_x(vector_length(v.v));
+}
+
+FOUNDATION_FORCEINLINE real
+length_sqr(const Vec4& v) {
+	return vector_x(vector_length_sqr(v.v));
+}
+
+FOUNDATION_FORCEINLINE real
+length3(const Vec4& v) {
+	return vector_x(vector_length3(v.v));
+}
+
+FOUNDATION_FORCEINLINE real
+length3_sqr(const Vec4& v) {
+	return vector_x(vector_length3_sqr(v.v));
+}
+
+//! Linear interpolation with vector_lerp, using fused multiply-add where available
+FOUNDATION_FORCEINLINE Vec4
+lerp(const Vec4& from, const Vec4& to, real factor) {
+	return vector_lerp(from.v, to.v, factor);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+project(const Vec4& v, const Vec4& at) {
+	return vector_project(v.v, at.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+reflect(const Vec4& v, const Vec4& at) {
+	return vector_reflect(v.v, at.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+min(const Vec4& v0, const Vec4& v1) {
+	return vector_min(v0.v, v1.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+max(const Vec4& v0, const Vec4& v1) {
+	return vector_max(v0.v, v1.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+abs(const Vec4& v) {
+	return vector_abs(v.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+sqrt(const Vec4& v) {
+	return vector_sqrt(v.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+floor(const Vec4& v) {
+	return vector_floor(v.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+ceil(const Vec4& v) {
+	return vector_ceil(v.v);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+round(const Vec4& v) {
+	return vector_round(v.v);
+}
+
+struct Quat;
+
+//! Row major matrix with row vector convention, v' = v * M
+struct Mat4 {
+	matrix_t m;
+
+	//! Uninitialized, same as a matrix_t
+	Mat4() = default;
+
+	FOUNDATION_FORCEINLINE
+	Mat4(const matrix_t value) : m(value) {
+	}
+
+	//! Rotation matrix of unit quaternion
+	FOUNDATION_FORCEINLINE explicit Mat4(const Quat& q);
+
+	FOUNDATION_FORCEINLINE
+	operator matrix_t() const {
+		return m;
+	}
+
+	FOUNDATION_FORCEINLINE Vec4
+	row(int r) const {
+		return m.row[r];
+	}
+
+	FOUNDATION_FORCEINLINE Vec4
+	get_translation() const {
+		return matrix_get_translation(m);
+	}
+
+	static FOUNDATION_FORCEINLINE Mat4
+	zero() {
+		return matrix_zero();
+	}
+
+	static FOUNDATION_FORCEINLINE Mat4
+	identity() {
+		return matrix_identity();
+	}
+
+	static FOUNDATION_FORCEINLINE Mat4
+	scaling(const Vec4& scale) {
+		return matrix_scaling(scale.v);
+	}
+
+	static FOUNDATION_FORCEINLINE Mat4
+	translation(const Vec4& translation) {
+		return matrix_translation(translation.v);
+	}
+};
+
+FOUNDATION_FORCEINLINE Mat4
+operator*(const Mat4& m0, const Mat4& m1) {
+	return matrix_mul(m0.m, m1.m);
+}
+
+FOUNDATION_FORCEINLINE Mat4
+operator+(const Mat4& m0, const Mat4& m1) {
+	return matrix_add(m0.m, m1.m);
+}
+
+FOUNDATION_FORCEINLINE Mat4
+operator-(const Mat4& m0, const Mat4& m1) {
+	return matrix_sub(m0.m, m1.m);
+}
+
+//! Transform vector by matrix, same as transform
+FOUNDATION_FORCEINLINE Vec4
+operator*(const Vec4& v, const Mat4& m) {
+	return vector_transform(v.v, m.m);
+}
+
+FOUNDATION_FORCEINLINE Mat4
+transpose(const Mat4& m) {
+	return matrix_transpose(m.m);
+}
+
+//! Rotate by upper 3x3 part of matrix, preserving w
+FOUNDATION_FORCEINLINE Vec4
+rotate(const Vec4& v, const Mat4& m) {
+	return vector_rotate(v.v, m.m);
+}
+
+FOUNDATION_FORCEINLINE Vec4
+transform(const Vec4& v, const Mat4& m) {
+	return vector_transform(v.v, m.m);
+}
+
+//! Quaternion, [x, y, z] vector part and w scalar part. Construction from a quaternion_t is
+//! explicit since quaternion_t and vector_t are the same type
+struct Quat {
+	quaternion_t q;
+
+	//! Uninitialized, same as a quaternion_t
+	Quat() = default;
+
+	FOUNDATION_FORCEINLINE explicit Quat(const quaternion_t value) : q(value) {
+	}
+
+	FOUNDATION_FORCEINLINE
+	Quat(real x, real y, real z, real w) : q(vector(x, y, z, w)) {
+	}
+
+	FOUNDATION_FORCEINLINE
+	operator quaternion_t() const {
+		return q;
+	}
+
+	static FOUNDATION_FORCEINLINE Quat
+	identity() {
+		return Quat(quaternion_identity());
+	}
+
+	static FOUNDATION_FORCEINLINE Quat
+	from_matrix(const Mat4& m) {
+		return Quat(quaternion_from_matrix(m.m));
+	}
+
+	//! Rotation of vector "from" to vector "to"
+	static FOUNDATION_FORCEINLINE Quat
+	rotating_vector(const Vec4& from, const Vec4& to) {
+		return Quat(quaternion_rotating_vector(from.v, to.v));
+	}
+};
+
+FOUNDATION_FORCEINLINE
+Mat4::Mat4(const Quat& q) : m(matrix_from_quaternion(q.q)) {
+}
+
+FOUNDATION_FORCEINLINE Quat
+operator*(const Quat& q0, const Quat& q1) {
+	return Quat(quaternion_mul(q0.q, q1.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+operator+(const Quat& q0, const Quat& q1) {
+	return Quat(quaternion_add(q0.q, q1.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+operator-(const Quat& q0, const Quat& q1) {
+	return Quat(quaternion_sub(q0.q, q1.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+operator-(const Quat& q) {
+	return Quat(quaternion_neg(q.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+conjugate(const Quat& q) {
+	return Quat(quaternion_conjugate(q.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+inverse(const Quat& q) {
+	return Quat(quaternion_inverse(q.q));
+}
+
+FOUNDATION_FORCEINLINE Quat
+normalize(const Quat& q) {
+	return Quat(quaternion_normalize(q.q));
+}
+
+//! Quaternions must be unit length
+FOUNDATION_FORCEINLINE Quat
+slerp(const Quat& q0, const Quat& q1, real factor) {
+	return Quat(quaternion_slerp(q0.q, q1.q, factor));
+}
+
+//! Rotate directional vector
+FOUNDATION_FORCEINLINE Vec4
+rotate(const Quat& q, const Vec4& v) {
+	return quaternion_rotate(q.q, v.v);
+}
+
+}  // namespace vectorlib
+
+#endif
@@ -0,0 +1,102 @@
+/* vector64.c  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data types and
+ * functions to write applications and games in a platform-independent fashion. The latest source code is
+ * always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any restrictions.
+ *
+ */
+
+#include <vector/vector64.h>
+#include <vector/job.h>
+#include <vector/internal.h>
+
+typedef struct vector64_rebase_t vector64_rebase_t;
+
+VECTOR_ALIGNED_STRUCT(vector64_rebase_t) {
+	vector64_t origin;
+	//! Origin components in all lanes
+	vector64_t origin_comp[3];
+	const vector64_t* point;
+	const float64_t* const* point_stream;
+	const matrix64_t* matrix;
+	vector_t* out;
+	float32_t** out_stream;
+	matrix_t* out_matrix;
+	size_t count;
+};
+
+static void
+vector64_rebase_range(void* context, size_t begin, size_t end) {
+	const vector64_rebase_t* rebase = context;
+	for (size_t ipoint = begin; ipoint < end; ++ipoint)
+		rebase->out[ipoint] = vector64_to_vector(vector64_sub(rebase->point[ipoint], rebase->origin));
+}
+
+void
+vector64_rebase(const vector64_t* point, size_t count, const vector64_t origin, vector_t* out) {
+	vector64_rebase_t rebase;
+	rebase.origin = vector64_set_component(origin, 3, 0);
+	rebase.point = point;
+	rebase.out = out;
+	vector_parallel_for(STRING_CONST("vector64_rebase"), vector64_rebase_range, &rebase, count, 0);
+}
+
+static void
+vector64_rebase_streams_range(void* context, size_t begin, size_t end) {
+	const vector64_rebase_t* rebase = context;
+	// Groups of four components, the last group of the stream may be partial
+	for (size_t group = begin; group < end; ++group) {
+		const size_t offset = group * 4;
+		const size_t last = offset + 4;
+		for (int icomp = 0; icomp < 3; ++icomp) {
+			const float64_t* in = rebase->point_stream[icomp];
+			float32_t* out = rebase->out_stream[icomp];
+			if (last <= rebase->count) {
+				const vector_t v = vector64_to_vector(vector64_sub(vector64_unaligned(in + offset),
+				                                                   rebase->origin_comp[icomp]));
+				memcpy(out + offset, &v, sizeof(vector_t));
+			} else {
+				const float64_t origin = vector64_x(rebase->origin_comp[icomp]);
+				for (size_t ipoint = offset; ipoint < rebase->count; ++ipoint)
+					out[ipoint] = (float32_t)(in[ipoint] - origin);
+			}
+		}
+	}
+}
+
+void
+vector64_rebase_streams(const float64_t* const* point, size_t count, const vector64_t origin, float32_t** out) {
+	vector64_rebase_t rebase;
+	rebase.origin_comp[0] = vector64_uniform(vector64_x(origin));
+	rebase.origin_comp[1] = vector64_uniform(vector64_y(origin));
+	rebase.origin_comp[2] = vector64_uniform(vector64_z(origin));
+	rebase.point_stream = point;
+	rebase.out_stream = out;
+	rebase.count = count;
+	vector_parallel_for(STRING_CONST("vector64_rebase_streams"), vector64_rebase_streams_range, &rebase,
+	                    (count + 3) / 4, 0);
+}
+
+static void
+matrix64_rebase_range(void* context, size_t begin, size_t end) {
+	const vector64_rebase_t* rebase = context;
+	for (size_t imatrix = begin; imatrix < end; ++imatrix)
+		rebase->out_matrix[imatrix] = matrix64_rebase(rebase->matrix[imatrix], rebase->origin);
+}
+
+void
+matrix64_rebase_array(const matrix64_t* m, size_t count, const vector64_t origin, matrix_t* out) {
+	vector64_rebase_t rebase;
+	rebase.origin = origin;
+	rebase.matrix = m;
+	rebase.out_matrix = out;
+	vector_parallel_for(STRING_CONST("matrix64_rebase_array"), matrix64_rebase_range, &rebase, count, 0);
+}
@@ -0,0 +1,424 @@
+/* vector64.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+#pragma once
+
+/*! \file vector64.h
+    Double precision vector math for large world coordinates. The SSE implementations keep a
+    vector in two registers of two doubles each, other architectures use scalar components.
+    Functions mirror the single precision vector_* functions, except that component comparisons
+    (vector64_equal and the less/greater variants), vector64_select, vector64_shuffle and
+    vector64_shuffle2 and the integer vector conversions are not provided. There is no double
+    precision reciprocal square root estimate, the _fast length functions are exact.
+
+    Positions far from origin are kept in double precision and rebased to single precision
+    relative to a double precision origin, for example the camera position, before rendering
+    or simulation. See vector64_rebase and matrix64_rebase. */
+
+#include <vector/types.h>
+#include <vector/vector.h>
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64(const float64_t x, const float64_t y, const float64_t z, const float64_t w);
+
+//! Load unaligned
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector64_t
+vector64_unaligned(const float64_t* FOUNDATION_RESTRICT v);
+
+//! Load aligned (16-byte alignment)
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector64_t
+vector64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_uniform(const float64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_zero(void);  // [ 0, 0, 0, 0 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_one(void);  // [ 1, 1, 1, 1 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_half(void);  // [ 0.5, 0.5, 0.5, 0.5 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_two(void);  // [ 2, 2, 2, 2 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_origo(void);  // [ 0, 0, 0, 1 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_xaxis(void);  // [ 1, 0, 0, 1 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_yaxis(void);  // [ 0, 1, 0, 1 ]
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_zaxis(void);  // [ 0, 0, 1, 1 ]
+
+//! Widen single precision vector
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_from_vector(const vector_t v);
+
+//! Narrow to single precision vector, rounding to nearest
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector64_to_vector(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_normalize(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_normalize3(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot3(const vector64_t v0, const vector64_t v1);
+
+//! Cross product of xyz components, w component is zero
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_cross3(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_mul(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_div(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_add(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_add_triple(const vector64_t v0, const vector64_t v1, const vector64_t v2);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sub(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_neg(const vector64_t v);
+
+//! Multiply and add, v0 * v1 + v2
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_muladd(const vector64_t v0, const vector64_t v1, const vector64_t v2);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_scale(const vector64_t v, const float64_t s);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_lerp(const vector64_t from, const vector64_t to, const float64_t factor);
+
+//! Project and reflect on non-normalized vector (will call normalize internally)
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_project(const vector64_t v, const vector64_t at);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_reflect(const vector64_t v, const vector64_t at);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_project3(const vector64_t v, const vector64_t at);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_reflect3(const vector64_t v, const vector64_t at);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length(const vector64_t v);
+
+//! Same as vector64_length
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length_fast(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length_sqr(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3(const vector64_t v);
+
+//! Same as vector64_length3
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3_fast(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3_sqr(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sqrt(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_min(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_max(const vector64_t v0, const vector64_t v1);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_abs(const vector64_t v);
+
+//! Round towards negative infinity
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_floor(const vector64_t v);
+
+//! Round towards positive infinity
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_ceil(const vector64_t v);
+
+//! Round to nearest integer, halfway cases to even
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_round(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_x(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_y(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_z(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_w(const vector64_t v);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_component(const vector64_t v, int c);
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_set_component(const vector64_t v, int c, float64_t val);
+
+//! Treat vectors as row vectors, same as vector_rotate, w component is kept
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_rotate(const vector64_t v, const matrix64_t m);
+
+//! Treat vectors as row vectors, same as vector_transform
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_transform(const vector64_t v, const matrix64_t m);
+
+//! Rebase points to single precision coordinates relative to an origin, w components are
+//! kept. Split across the job threads for large arrays
+//! \param point Double precision points
+//! \param count Number of points
+//! \param origin Double precision origin
+//! \param out Single precision points relative to origin, point - origin
+VECTOR_API void
+vector64_rebase(const vector64_t* point, size_t count, const vector64_t origin, vector_t* out);
+
+//! Rebase points given as component streams to single precision component streams
+//! \param point Double precision x, y and z streams
+//! \param count Number of points
+//! \param origin Double precision origin
+//! \param out Single precision x, y and z streams relative to origin
+VECTOR_API void
+vector64_rebase_streams(const float64_t* const* point, size_t count, const vector64_t origin, float32_t** out);
+
+#if VECTOR_IMPLEMENTATION_SSE4 || VECTOR_IMPLEMENTATION_SSE3 || VECTOR_IMPLEMENTATION_SSE2
+#include <vector/vector64_sse2.h>
+#else
+#include <vector/vector64_fallback.h>
+#endif
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector64_t
+vector64_aligned(const float64_aligned128_t* FOUNDATION_RESTRICT v) {
+	return *(const vector64_t*)v;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_half(void) {
+	return vector64_uniform(0.5);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_two(void) {
+	return vector64_uniform(2.0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_xaxis(void) {
+	return vector64(1, 0, 0, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_yaxis(void) {
+	return vector64(0, 1, 0, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_zaxis(void) {
+	return vector64(0, 0, 1, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_add_triple(const vector64_t v0, const vector64_t v1, const vector64_t v2) {
+	return vector64_add(vector64_add(v0, v1), v2);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_muladd(const vector64_t v0, const vector64_t v1, const vector64_t v2) {
+	return vector64_add(vector64_mul(v0, v1), v2);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_scale(const vector64_t v, const float64_t s) {
+	return vector64_mul(v, vector64_uniform(s));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_lerp(const vector64_t from, const vector64_t to, const float64_t factor) {
+	return vector64_muladd(vector64_sub(to, from), vector64_uniform(factor), from);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length(const vector64_t v) {
+	return vector64_sqrt(vector64_dot(v, v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length_fast(const vector64_t v) {
+	return vector64_length(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length_sqr(const vector64_t v) {
+	return vector64_dot(v, v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3(const vector64_t v) {
+	return vector64_sqrt(vector64_dot3(v, v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3_fast(const vector64_t v) {
+	return vector64_length3(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_length3_sqr(const vector64_t v) {
+	return vector64_dot3(v, v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_normalize(const vector64_t v) {
+	return vector64_div(v, vector64_length(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_normalize3(const vector64_t v) {
+	const float64_t inv_length = 1.0 / vector64_x(vector64_length3(v));
+	return vector64_mul(v, vector64(inv_length, inv_length, inv_length, 1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_project(const vector64_t v, const vector64_t at) {
+	const vector64_t normal = vector64_normalize(at);
+	return vector64_mul(normal, vector64_dot(normal, v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_reflect(const vector64_t v, const vector64_t at) {
+	return vector64_sub(vector64_scale(vector64_project(v, at), 2.0), v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_project3(const vector64_t v, const vector64_t at) {
+	const vector64_t normal = vector64_normalize3(at);
+	const vector64_t projected = vector64_mul(normal, vector64_dot3(normal, v));
+	return vector64_set_component(projected, 3, vector64_w(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_reflect3(const vector64_t v, const vector64_t at) {
+	const vector64_t normal = vector64_normalize3(at);
+	const vector64_t projected = vector64_mul(normal, vector64_dot3(normal, v));
+	return vector64_set_component(vector64_sub(vector64_scale(projected, 2.0), v), 3, vector64_w(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_round_component(const float64_t v) {
+	// Adding and subtracting 2^52 with the sign of the value drops the fraction using round to
+	// nearest even, values of larger magnitude are already integral
+	if (!(fabs(v) < 4503599627370496.0) || (v == 0))
+		return v;
+	const float64_t magic = (v < 0) ? -4503599627370496.0 : 4503599627370496.0;
+	const float64_t rounded = (v + magic) - magic;
+	return ((v < 0) && (rounded == 0)) ? -0.0 : rounded;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_floor_component(const float64_t v) {
+	const float64_t rounded = vector64_round_component(v);
+	return (rounded > v) ? rounded - 1.0 : rounded;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_ceil_component(const float64_t v) {
+	// Negative values rounded up to zero keep the sign
+	const float64_t rounded = vector64_round_component(v);
+	const float64_t ceiled = (rounded < v) ? rounded + 1.0 : rounded;
+	return ((v < 0) && (ceiled == 0)) ? -0.0 : ceiled;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_floor(const vector64_t v) {
+	return vector64(vector64_floor_component(vector64_x(v)), vector64_floor_component(vector64_y(v)),
+	                vector64_floor_component(vector64_z(v)), vector64_floor_component(vector64_w(v)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_ceil(const vector64_t v) {
+	return vector64(vector64_ceil_component(vector64_x(v)), vector64_ceil_component(vector64_y(v)),
+	                vector64_ceil_component(vector64_z(v)), vector64_ceil_component(vector64_w(v)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_round(const vector64_t v) {
+	return vector64(vector64_round_component(vector64_x(v)), vector64_round_component(vector64_y(v)),
+	                vector64_round_component(vector64_z(v)), vector64_round_component(vector64_w(v)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_component(const vector64_t v, int c) {
+	if (c == 0)
+		return vector64_x(v);
+	if (c == 1)
+		return vector64_y(v);
+	if (c == 2)
+		return vector64_z(v);
+	return vector64_w(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_set_component(const vector64_t v, int c, float64_t val) {
+	return vector64((c == 0) ? val : vector64_x(v), (c == 1) ? val : vector64_y(v), (c == 2) ? val : vector64_z(v),
+	                (c == 3) ? val : vector64_w(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_rotate(const vector64_t v, const matrix64_t m) {
+	vector64_t result = vector64_mul(m.row[0], vector64_uniform(vector64_x(v)));
+	result = vector64_muladd(m.row[1], vector64_uniform(vector64_y(v)), result);
+	result = vector64_muladd(m.row[2], vector64_uniform(vector64_z(v)), result);
+	return vector64_set_component(result, 3, vector64_w(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_transform(const vector64_t v, const matrix64_t m) {
+	vector64_t result = vector64_mul(m.row[0], vector64_uniform(vector64_x(v)));
+	result = vector64_muladd(m.row[1], vector64_uniform(vector64_y(v)), result);
+	result = vector64_muladd(m.row[2], vector64_uniform(vector64_z(v)), result);
+	return vector64_muladd(m.row[3], vector64_uniform(vector64_w(v)), result);
+}
+
+#include <vector/quaternion64.h>
+#include <vector/matrix64.h>
@@ -0,0 +1,143 @@
+/* vector64_fallback.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64(const float64_t x, const float64_t y, const float64_t z, const float64_t w) {
+	vector64_t v;
+	v.x = x;
+	v.y = y;
+	v.z = z;
+	v.w = w;
+	return v;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector64_t
+vector64_unaligned(const float64_t* FOUNDATION_RESTRICT v) {
+	return vector64(v[0], v[1], v[2], v[3]);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_uniform(const float64_t v) {
+	return vector64(v, v, v, v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_zero(void) {
+	return vector64(0, 0, 0, 0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_one(void) {
+	return vector64(1, 1, 1, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_origo(void) {
+	return vector64(0, 0, 0, 1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_from_vector(const vector_t v) {
+	return vector64(vector_x(v), vector_y(v), vector_z(v), vector_w(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector64_to_vector(const vector64_t v) {
+	return vector((float32_t)v.x, (float32_t)v.y, (float32_t)v.z, (float32_t)v.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot(const vector64_t v0, const vector64_t v1) {
+	return vector64_uniform(v0.x * v1.x + v0.y * v1.y + v0.z * v1.z + v0.w * v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot3(const vector64_t v0, const vector64_t v1) {
+	return vector64_uniform(v0.x * v1.x + v0.y * v1.y + v0.z * v1.z);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_cross3(const vector64_t v0, const vector64_t v1) {
+	return vector64(v0.y * v1.z - v0.z * v1.y, v0.z * v1.x - v0.x * v1.z, v0.x * v1.y - v0.y * v1.x, 0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_mul(const vector64_t v0, const vector64_t v1) {
+	return vector64(v0.x * v1.x, v0.y * v1.y, v0.z * v1.z, v0.w * v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_div(const vector64_t v0, const vector64_t v1) {
+	return vector64(v0.x / v1.x, v0.y / v1.y, v0.z / v1.z, v0.w / v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_add(const vector64_t v0, const vector64_t v1) {
+	return vector64(v0.x + v1.x, v0.y + v1.y, v0.z + v1.z, v0.w + v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sub(const vector64_t v0, const vector64_t v1) {
+	return vector64(v0.x - v1.x, v0.y - v1.y, v0.z - v1.z, v0.w - v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_neg(const vector64_t v) {
+	return vector64(-v.x, -v.y, -v.z, -v.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sqrt(const vector64_t v) {
+	return vector64(sqrt(v.x), sqrt(v.y), sqrt(v.z), sqrt(v.w));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_min(const vector64_t v0, const vector64_t v1) {
+	return vector64((v0.x < v1.x) ? v0.x : v1.x, (v0.y < v1.y) ? v0.y : v1.y, (v0.z < v1.z) ? v0.z : v1.z,
+	                (v0.w < v1.w) ? v0.w : v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_max(const vector64_t v0, const vector64_t v1) {
+	return vector64((v0.x > v1.x) ? v0.x : v1.x, (v0.y > v1.y) ? v0.y : v1.y, (v0.z > v1.z) ? v0.z : v1.z,
+	                (v0.w > v1.w) ? v0.w : v1.w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_abs(const vector64_t v) {
+	return vector64(fabs(v.x), fabs(v.y), fabs(v.z), fabs(v.w));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_x(const vector64_t v) {
+	return v.x;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_y(const vector64_t v) {
+	return v.y;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_z(const vector64_t v) {
+	return v.z;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_w(const vector64_t v) {
+	return v.w;
+}
@@ -0,0 +1,204 @@
+/* vector64_sse2.h  -  Vector library  -  Public Domain  -  2013 Mattias Jansson
+ *
+ * This library provides a cross-platform vector math library in C11 providing basic support data
+ * types and functions to write applications and games in a platform-independent fashion. The latest
+ * source code is always available at
+ *
+ * https://github.com/mjansson/vector_lib
+ *
+ * This library is built on top of the foundation library available at
+ *
+ * https://github.com/mjansson/foundation_lib
+ *
+ * This library is put in the public domain; you can redistribute it and/or modify it without any
+ * restrictions.
+ *
+ */
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64(const float64_t x, const float64_t y, const float64_t z, const float64_t w) {
+	vector64_t v;
+	v.xy = _mm_setr_pd(x, y);
+	v.zw = _mm_setr_pd(z, w);
+	return v;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_PURECALL vector64_t
+vector64_unaligned(const float64_t* FOUNDATION_RESTRICT v) {
+	vector64_t rv;
+	rv.xy = _mm_loadu_pd(v);
+	rv.zw = _mm_loadu_pd(v + 2);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_uniform(const float64_t v) {
+	vector64_t rv;
+	rv.xy = _mm_set1_pd(v);
+	rv.zw = rv.xy;
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_zero(void) {
+	vector64_t v;
+	v.xy = _mm_setzero_pd();
+	v.zw = v.xy;
+	return v;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_one(void) {
+	return vector64_uniform(1.0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_origo(void) {
+	vector64_t v;
+	v.xy = _mm_setzero_pd();
+	v.zw = _mm_setr_pd(0, 1);
+	return v;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_from_vector(const vector_t v) {
+	vector64_t rv;
+	rv.xy = _mm_cvtps_pd(v);
+	rv.zw = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector64_to_vector(const vector64_t v) {
+	return _mm_movelh_ps(_mm_cvtpd_ps(v.xy), _mm_cvtpd_ps(v.zw));
+}
+
+//! Sum of both lanes in both lanes
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL __m128d
+vector64_hadd(const __m128d v) {
+	return _mm_add_pd(v, _mm_shuffle_pd(v, v, 1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot(const vector64_t v0, const vector64_t v1) {
+	const __m128d sum = _mm_add_pd(_mm_mul_pd(v0.xy, v1.xy), _mm_mul_pd(v0.zw, v1.zw));
+	vector64_t rv;
+	rv.xy = vector64_hadd(sum);
+	rv.zw = rv.xy;
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_dot3(const vector64_t v0, const vector64_t v1) {
+	const __m128d z = _mm_mul_sd(v0.zw, v1.zw);
+	const __m128d sum = _mm_add_pd(vector64_hadd(_mm_mul_pd(v0.xy, v1.xy)), _mm_unpacklo_pd(z, z));
+	vector64_t rv;
+	rv.xy = sum;
+	rv.zw = sum;
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_cross3(const vector64_t v0, const vector64_t v1) {
+	// [y, z] [x, y] and [z, x] [y, y] orderings, the w lanes cancel out
+	const __m128d v0_yz = _mm_shuffle_pd(v0.xy, v0.zw, 1);
+	const __m128d v1_yz = _mm_shuffle_pd(v1.xy, v1.zw, 1);
+	const __m128d v0_zx = _mm_shuffle_pd(v0.zw, v0.xy, 0);
+	const __m128d v1_zx = _mm_shuffle_pd(v1.zw, v1.xy, 0);
+	const __m128d v0_yy = _mm_unpackhi_pd(v0.xy, v0.xy);
+	const __m128d v1_yy = _mm_unpackhi_pd(v1.xy, v1.xy);
+	vector64_t rv;
+	rv.xy = _mm_sub_pd(_mm_mul_pd(v0_yz, v1_zx), _mm_mul_pd(v0_zx, v1_yz));
+	rv.zw = _mm_sub_pd(_mm_mul_pd(v0.xy, v1_yy), _mm_mul_pd(v0_yy, v1.xy));
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_mul(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_mul_pd(v0.xy, v1.xy);
+	rv.zw = _mm_mul_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_div(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_div_pd(v0.xy, v1.xy);
+	rv.zw = _mm_div_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_add(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_add_pd(v0.xy, v1.xy);
+	rv.zw = _mm_add_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sub(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_sub_pd(v0.xy, v1.xy);
+	rv.zw = _mm_sub_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_neg(const vector64_t v) {
+	return vector64_sub(vector64_zero(), v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_sqrt(const vector64_t v) {
+	vector64_t rv;
+	rv.xy = _mm_sqrt_pd(v.xy);
+	rv.zw = _mm_sqrt_pd(v.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_min(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_min_pd(v0.xy, v1.xy);
+	rv.zw = _mm_min_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_max(const vector64_t v0, const vector64_t v1) {
+	vector64_t rv;
+	rv.xy = _mm_max_pd(v0.xy, v1.xy);
+	rv.zw = _mm_max_pd(v0.zw, v1.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector64_t
+vector64_abs(const vector64_t v) {
+	const __m128d sign = _mm_set1_pd(-0.0);
+	vector64_t rv;
+	rv.xy = _mm_andnot_pd(sign, v.xy);
+	rv.zw = _mm_andnot_pd(sign, v.zw);
+	return rv;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_x(const vector64_t v) {
+	return _mm_cvtsd_f64(v.xy);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_y(const vector64_t v) {
+	return _mm_cvtsd_f64(_mm_unpackhi_pd(v.xy, v.xy));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_z(const vector64_t v) {
+	return _mm_cvtsd_f64(v.zw);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float64_t
+vector64_w(const vector64_t v) {
+	return _mm_cvtsd_f64(_mm_unpackhi_pd(v.zw, v.zw));
+}
@@ -85,6 +85,9 @@ vector_zaxis(void) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_normalize(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	return vector_div(v, vector_sqrt(vector_dot(v, v)));
+#else
 	float32_t inv_length = math_rsqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
 	vector_t rv = v;
 	rv.x *= inv_length;
@@ -92,21 +95,32 @@ vector_normalize(const vector_t v) {
 	rv.z *= inv_length;
 	rv.w *= inv_length;
 	return rv;
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_normalize3(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	const vector_t length = vector_sqrt(vector_dot3(v, v));
+	return (vector_t){v.x / length.x, v.y / length.y, v.z / length.z, v.w};
+#else
 	float32_t inv_length = math_rsqrt(v.x * v.x + v.y * v.y + v.z * v.z);
 	vector_t rv = v;
 	rv.x *= inv_length;
 	rv.y *= inv_length;
 	rv.z *= inv_length;
 	return rv;
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_dot(const vector_t v0, const vector_t v1) {
+#if VECTOR_DETERMINISTIC
+	// Pairwise sum in the same order as the vectorized implementations
+	return vector_uniform((v0.x * v1.x + v0.y * v1.y) + (v0.z * v1.z + v0.w * v1.w));
+#else
 	return vector_uniform(v0.x * v1.x + v0.y * v1.y + v0.z * v1.z + v0.w * v1.w);
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -116,7 +130,7 @@ vector_dot3(const vector_t v0, const vector_t v1) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_cross3(const vector_t v0, const vector_t v1) {
-	return (vector_t){v0.y * v1.z - v0.z * v1.y, v0.z * v1.x - v0.x * v1.z, v0.x * v1.y - v0.y * v1.x, 1};
+	return (vector_t){v0.y * v1.z - v0.z * v1.y, v0.z * v1.x - v0.x * v1.z, v0.x * v1.y - v0.y * v1.x, 0};
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -176,8 +190,13 @@ vector_scale(const vector_t v, const real s) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_lerp(const vector_t from, const vector_t to, const real factor) {
+#if VECTOR_DETERMINISTIC
+	// Same operations as the vectorized implementations
+	return vector_add(vector_scale(to, factor), vector_sub(from, vector_scale(from, factor)));
+#else
 	return (vector_t){from.x + (to.x - from.x) * factor, from.y + (to.y - from.y) * factor,
 	                  from.z + (to.z - from.z) * factor, from.w + (to.w - from.w) * factor};
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -217,12 +236,20 @@ vector_length_fast(const vector_t v) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_length(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	return vector_uniform(math_sqrt((v.x * v.x + v.y * v.y) + (v.z * v.z + v.w * v.w)));
+#else
 	return vector_uniform(math_sqrt(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w));
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_length_sqr(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	return vector_uniform((v.x * v.x + v.y * v.y) + (v.z * v.z + v.w * v.w));
+#else
 	return vector_uniform(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -262,6 +289,49 @@ vector_abs(const vector_t v) {
 	return (vector_t){math_abs(v.x), math_abs(v.y), math_abs(v.z), math_abs(v.w)};
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float32_t
+vector_round_component(const float32_t v) {
+	// Adding and subtracting 2^23 with the sign of the value drops the fraction using round to
+	// nearest even, values of larger magnitude are already integral
+	if (!(math_abs(v) < 8388608.0f) || (v == 0))
+		return v;
+	const float32_t magic = (v < 0) ? -8388608.0f : 8388608.0f;
+	const float32_t rounded = (v + magic) - magic;
+	return ((v < 0) && (rounded == 0)) ? -0.0f : rounded;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float32_t
+vector_floor_component(const float32_t v) {
+	const float32_t rounded = vector_round_component(v);
+	return (rounded > v) ? rounded - 1.0f : rounded;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL float32_t
+vector_ceil_component(const float32_t v) {
+	// Negative values rounded up to zero keep the sign
+	const float32_t rounded = vector_round_component(v);
+	const float32_t ceiled = (rounded < v) ? rounded + 1.0f : rounded;
+	return ((v < 0) && (ceiled == 0)) ? -0.0f : ceiled;
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v) {
+	return (vector_t){vector_floor_component(v.x), vector_floor_component(v.y), vector_floor_component(v.z),
+	                  vector_floor_component(v.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v) {
+	return (vector_t){vector_ceil_component(v.x), vector_ceil_component(v.y), vector_ceil_component(v.z),
+	                  vector_ceil_component(v.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v) {
+	return (vector_t){vector_round_component(v.x), vector_round_component(v.y), vector_round_component(v.z),
+	                  vector_round_component(v.w)};
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
 vector_x(const vector_t v) {
 	return v.x;
@@ -339,6 +409,124 @@ vectori_or(const vectori_t v0, const vectori_t v1) {
 	return (vectori_t){v0.x | v1.x, v0.y | v1.y, v0.z | v1.z, v0.w | v1.w};
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL int32_t
+vectori_shift_right_component(const int32_t v, const unsigned int count) {
+	// Complement before and after shift of negative values to get arithmetic shift without
+	// relying on implementation defined behaviour of signed right shift
+	return (v < 0) ? ~(int32_t)(~(uint32_t)v >> count) : (int32_t)((uint32_t)v >> count);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori(const int32_t x, const int32_t y, const int32_t z, const int32_t w) {
+	return (vectori_t){x, y, z, w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_uniform(const int32_t v) {
+	return (vectori_t){v, v, v, v};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_add(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(int32_t)((uint32_t)v0.x + (uint32_t)v1.x), (int32_t)((uint32_t)v0.y + (uint32_t)v1.y),
+	                   (int32_t)((uint32_t)v0.z + (uint32_t)v1.z), (int32_t)((uint32_t)v0.w + (uint32_t)v1.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_sub(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(int32_t)((uint32_t)v0.x - (uint32_t)v1.x), (int32_t)((uint32_t)v0.y - (uint32_t)v1.y),
+	                   (int32_t)((uint32_t)v0.z - (uint32_t)v1.z), (int32_t)((uint32_t)v0.w - (uint32_t)v1.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_mul(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(int32_t)((uint32_t)v0.x * (uint32_t)v1.x), (int32_t)((uint32_t)v0.y * (uint32_t)v1.y),
+	                   (int32_t)((uint32_t)v0.z * (uint32_t)v1.z), (int32_t)((uint32_t)v0.w * (uint32_t)v1.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_min(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(v0.x < v1.x) ? v0.x : v1.x, (v0.y < v1.y) ? v0.y : v1.y, (v0.z < v1.z) ? v0.z : v1.z,
+	                   (v0.w < v1.w) ? v0.w : v1.w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_max(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(v0.x > v1.x) ? v0.x : v1.x, (v0.y > v1.y) ? v0.y : v1.y, (v0.z > v1.z) ? v0.z : v1.z,
+	                   (v0.w > v1.w) ? v0.w : v1.w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_xor(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){v0.x ^ v1.x, v0.y ^ v1.y, v0.z ^ v1.z, v0.w ^ v1.w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_andnot(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){v0.x & ~v1.x, v0.y & ~v1.y, v0.z & ~v1.z, v0.w & ~v1.w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_left(const vectori_t v, const unsigned int count) {
+	return (vectori_t){(int32_t)((uint32_t)v.x << count), (int32_t)((uint32_t)v.y << count),
+	                   (int32_t)((uint32_t)v.z << count), (int32_t)((uint32_t)v.w << count)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right(const vectori_t v, const unsigned int count) {
+	return (vectori_t){vectori_shift_right_component(v.x, count), vectori_shift_right_component(v.y, count),
+	                   vectori_shift_right_component(v.z, count), vectori_shift_right_component(v.w, count)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right_logical(const vectori_t v, const unsigned int count) {
+	return (vectori_t){(int32_t)((uint32_t)v.x >> count), (int32_t)((uint32_t)v.y >> count),
+	                   (int32_t)((uint32_t)v.z >> count), (int32_t)((uint32_t)v.w >> count)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_equal(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){v0.x == v1.x ? -1 : 0, v0.y == v1.y ? -1 : 0, v0.z == v1.z ? -1 : 0, v0.w == v1.w ? -1 : 0};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_less(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){v0.x < v1.x ? -1 : 0, v0.y < v1.y ? -1 : 0, v0.z < v1.z ? -1 : 0, v0.w < v1.w ? -1 : 0};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_greater(const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){v0.x > v1.x ? -1 : 0, v0.y > v1.y ? -1 : 0, v0.z > v1.z ? -1 : 0, v0.w > v1.w ? -1 : 0};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_select(const vectori_t mask, const vectori_t v0, const vectori_t v1) {
+	return (vectori_t){(mask.x & v0.x) | (~mask.x & v1.x), (mask.y & v0.y) | (~mask.y & v1.y),
+	                   (mask.z & v0.z) | (~mask.z & v1.z), (mask.w & v0.w) | (~mask.w & v1.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori(const vector_t v) {
+	return (vectori_t){(int32_t)v.x, (int32_t)v.y, (int32_t)v.z, (int32_t)v.w};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_round(const vector_t v) {
+	return (vectori_t){(int32_t)vector_round_component(v.x), (int32_t)vector_round_component(v.y),
+	                   (int32_t)vector_round_component(v.z), (int32_t)vector_round_component(v.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_floor(const vector_t v) {
+	return (vectori_t){(int32_t)vector_floor_component(v.x), (int32_t)vector_floor_component(v.y),
+	                   (int32_t)vector_floor_component(v.z), (int32_t)vector_floor_component(v.w)};
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vectori_to_vector(const vectori_t v) {
+	return (vector_t){(float32_t)v.x, (float32_t)v.y, (float32_t)v.z, (float32_t)v.w};
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vector_equal(const vector_t v0, const vector_t v1) {
 	return (vectori_t){v0.x == v1.x ? -1 : 0, v0.y == v1.y ? -1 : 0, v0.z == v1.z ? -1 : 0, v0.w == v1.w ? -1 : 0};
@@ -364,6 +552,11 @@ vector_greater(const vector_t v0, const vector_t v1) {
 	return (vectori_t){v0.x > v1.x ? -1 : 0, v0.y > v1.y ? -1 : 0, v0.z > v1.z ? -1 : 0, v0.w > v1.w ? -1 : 0};
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_select(const vectori_t mask, const vector_t v0, const vector_t v1) {
+	return (vector_t){mask.x ? v0.x : v1.x, mask.y ? v0.y : v1.y, mask.z ? v0.z : v1.z, mask.w ? v0.w : v1.w};
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_rotate(const vector_t v, const matrix_t m) {
 	return vector((m.frow[0][0] * v.x) + (m.frow[1][0] * v.y) + (m.frow[2][0] * v.z),
@@ -199,7 +199,7 @@ vector_neg(const vector_t v) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_muladd(const vector_t v0, const vector_t v1, const vector_t v2) {
-#if defined(__aarch64__)
+#if defined(__aarch64__) && !VECTOR_DETERMINISTIC
 	return vfmaq_f32(v2, v1, v0);
 #else
 	return vector_add(vector_mul(v0, v1), v2);
@@ -301,6 +301,55 @@ vector_abs(const vector_t v) {
 	return vabsq_f32(v);
 }
 
+#if FOUNDATION_ARCH_ARM_64
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v) {
+	return vrndmq_f32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v) {
+	return vrndpq_f32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v) {
+	return vrndnq_f32(v);
+}
+
+#else
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v) {
+	const vector_t rounded = vector_round(v);
+	const uint32x4_t one = vreinterpretq_u32_f32(vector_one());
+	return vsubq_f32(rounded, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(rounded, v), one)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v) {
+	// Sign of the value is restored to keep the sign of negative values rounded up to zero
+	const vector_t rounded = vector_round(v);
+	const uint32x4_t one = vreinterpretq_u32_f32(vector_one());
+	const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000U));
+	const vector_t ceiled = vaddq_f32(rounded, vreinterpretq_f32_u32(vandq_u32(vcltq_f32(rounded, v), one)));
+	return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(ceiled), sign));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v) {
+	// Adding and subtracting 2^23 with the sign of the value drops the fraction using round to
+	// nearest even, values of larger magnitude are already integral
+	const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000U));
+	const vector_t magic = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(8388608.0f)), sign));
+	const vector_t rounded =
+	    vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vsubq_f32(vaddq_f32(v, magic), magic)), sign));
+	return vbslq_f32(vcgeq_f32(vabsq_f32(v), vdupq_n_f32(8388608.0f)), v, rounded);
+}
+
+#endif
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
 vector_x(const vector_t v) {
 	return vgetq_lane_f32(v, 0);
@@ -378,6 +427,107 @@ vectori_or(const vectori_t v0, const vectori_t v1) {
 	return vorrq_s32(v0, v1);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori(const int32_t x, const int32_t y, const int32_t z, const int32_t w) {
+	const int32_t data[4] = {x, y, z, w};
+	return vld1q_s32(data);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_uniform(const int32_t v) {
+	return vdupq_n_s32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_add(const vectori_t v0, const vectori_t v1) {
+	return vaddq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_sub(const vectori_t v0, const vectori_t v1) {
+	return vsubq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_mul(const vectori_t v0, const vectori_t v1) {
+	return vmulq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_min(const vectori_t v0, const vectori_t v1) {
+	return vminq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_max(const vectori_t v0, const vectori_t v1) {
+	return vmaxq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_xor(const vectori_t v0, const vectori_t v1) {
+	return veorq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_andnot(const vectori_t v0, const vectori_t v1) {
+	return vbicq_s32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_left(const vectori_t v, const unsigned int count) {
+	return vshlq_s32(v, vdupq_n_s32((int32_t)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right(const vectori_t v, const unsigned int count) {
+	return vshlq_s32(v, vdupq_n_s32(-(int32_t)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right_logical(const vectori_t v, const unsigned int count) {
+	return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(v), vdupq_n_s32(-(int32_t)count)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_equal(const vectori_t v0, const vectori_t v1) {
+	return vreinterpretq_s32_u32(vceqq_s32(v0, v1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_less(const vectori_t v0, const vectori_t v1) {
+	return vreinterpretq_s32_u32(vcltq_s32(v0, v1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_greater(const vectori_t v0, const vectori_t v1) {
+	return vreinterpretq_s32_u32(vcgtq_s32(v0, v1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_select(const vectori_t mask, const vectori_t v0, const vectori_t v1) {
+	return vbslq_s32(vreinterpretq_u32_s32(mask), v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori(const vector_t v) {
+	return vcvtq_s32_f32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_round(const vector_t v) {
+	return vcvtq_s32_f32(vector_round(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_floor(const vector_t v) {
+	return vcvtq_s32_f32(vector_floor(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vectori_to_vector(const vectori_t v) {
+	return vcvtq_f32_s32(v);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vector_equal(const vector_t v0, const vector_t v1) {
 	return vceqq_f32(v0, v1);
@@ -403,6 +553,11 @@ vector_greater(const vector_t v0, const vector_t v1) {
 	return vcgtq_f32(v0, v1);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_select(const vectori_t mask, const vector_t v0, const vector_t v1) {
+	return vbslq_f32(vreinterpretq_u32_s32(mask), v0, v1);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_rotate(const vector_t v, const matrix_t m) {
 	vector_t vr;
@@ -123,6 +123,13 @@ vector_dot(const vector_t v0, const vector_t v1) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_dot3(const vector_t v0, const vector_t v1) {
+#if VECTOR_DETERMINISTIC
+	// Same order of additions as the other implementations, masking adds a zero which can flip
+	// the sign of a zero result
+	const vector_t r = _mm_mul_ps(v0, v1);
+	return _mm_add_ps(_mm_add_ps(vector_shuffle(r, VECTOR_MASK_XXXX), vector_shuffle(r, VECTOR_MASK_YYYY)),
+	                  vector_shuffle(r, VECTOR_MASK_ZZZZ));
+#else
 	__m128i one = _mm_setzero_si128();
 	one = _mm_cmpeq_epi32(one, one);
 	vector_t mask = _mm_move_ss(_mm_castsi128_ps(one), vector_zero());
@@ -132,6 +139,7 @@ vector_dot3(const vector_t v0, const vector_t v1) {
 	r = _mm_add_ps(r, rp);
 	rp = _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 1, 2, 3));
 	return _mm_add_ps(r, rp);
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -277,6 +285,31 @@ vector_abs(const vector_t v) {
 	return _mm_and_ps(_mm_castsi128_ps(_mm_srli_epi32(_mm_set1_epi32(-1), 1)), v);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v) {
+	const vector_t rounded = vector_round(v);
+	return _mm_sub_ps(rounded, _mm_and_ps(_mm_cmpgt_ps(rounded, v), vector_one()));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v) {
+	// Sign of the value is restored to keep the sign of negative values rounded up to zero
+	const vector_t rounded = vector_round(v);
+	const vector_t sign = _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)));
+	return _mm_or_ps(_mm_add_ps(rounded, _mm_and_ps(_mm_cmplt_ps(rounded, v), vector_one())), sign);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v) {
+	// Adding and subtracting 2^23 with the sign of the value drops the fraction using round to
+	// nearest even, values of larger magnitude are already integral
+	const vector_t sign = _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)));
+	const vector_t magic = _mm_or_ps(_mm_set1_ps(8388608.0f), sign);
+	const vector_t rounded = _mm_or_ps(_mm_sub_ps(_mm_add_ps(v, magic), magic), sign);
+	const vectori_t integral = _mm_castps_si128(_mm_cmpge_ps(vector_abs(v), _mm_set1_ps(8388608.0f)));
+	return vector_select(integral, v, rounded);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
 vector_x(const vector_t v) {
 	return *(const float32_t*)&v;
@@ -354,6 +387,111 @@ vectori_or(const vectori_t v0, const vectori_t v1) {
 	return _mm_or_si128(v0, v1);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori(const int32_t x, const int32_t y, const int32_t z, const int32_t w) {
+	return _mm_setr_epi32(x, y, z, w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_uniform(const int32_t v) {
+	return _mm_set1_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_add(const vectori_t v0, const vectori_t v1) {
+	return _mm_add_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_sub(const vectori_t v0, const vectori_t v1) {
+	return _mm_sub_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_mul(const vectori_t v0, const vectori_t v1) {
+	// Multiply even and odd components separately into 64-bit products and interleave low halves
+	const vectori_t even = _mm_mul_epu32(v0, v1);
+	const vectori_t odd = _mm_mul_epu32(_mm_srli_epi64(v0, 32), _mm_srli_epi64(v1, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_min(const vectori_t v0, const vectori_t v1) {
+	return vectori_select(_mm_cmpgt_epi32(v0, v1), v1, v0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_max(const vectori_t v0, const vectori_t v1) {
+	return vectori_select(_mm_cmpgt_epi32(v0, v1), v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_xor(const vectori_t v0, const vectori_t v1) {
+	return _mm_xor_si128(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_andnot(const vectori_t v0, const vectori_t v1) {
+	return _mm_andnot_si128(v1, v0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_left(const vectori_t v, const unsigned int count) {
+	return _mm_sll_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right(const vectori_t v, const unsigned int count) {
+	return _mm_sra_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right_logical(const vectori_t v, const unsigned int count) {
+	return _mm_srl_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_equal(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmpeq_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_less(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmplt_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_greater(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmpgt_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_select(const vectori_t mask, const vectori_t v0, const vectori_t v1) {
+	return _mm_or_si128(_mm_and_si128(mask, v0), _mm_andnot_si128(mask, v1));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori(const vector_t v) {
+	return _mm_cvttps_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_round(const vector_t v) {
+	// Default rounding mode is round to nearest even
+	return _mm_cvtps_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_floor(const vector_t v) {
+	return _mm_cvttps_epi32(vector_floor(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vectori_to_vector(const vectori_t v) {
+	return _mm_cvtepi32_ps(v);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vector_equal(const vector_t v0, const vector_t v1) {
 	return _mm_castps_si128(_mm_cmpeq_ps(v0, v1));
@@ -379,6 +517,12 @@ vector_greater(const vector_t v0, const vector_t v1) {
 	return _mm_castps_si128(_mm_cmpgt_ps(v0, v1));
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_select(const vectori_t mask, const vector_t v0, const vector_t v1) {
+	const vector_t fmask = _mm_castsi128_ps(mask);
+	return _mm_or_ps(_mm_and_ps(fmask, v0), _mm_andnot_ps(fmask, v1));
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_rotate(const vector_t v, const matrix_t m) {
 	vector_t vr;
@@ -108,7 +108,11 @@ vector_normalize(const vector_t v) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_normalize3(const vector_t v) {
+#if VECTOR_DETERMINISTIC
+	return _mm_blend_ps(vector_div(v, _mm_sqrt_ps(vector_dot3(v, v))), v, 8);
+#else
 	return vector_div(v, _mm_sqrt_ps(_mm_dp_ps(v, v, 0x77)));
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -118,7 +122,14 @@ vector_dot(const vector_t v0, const vector_t v1) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_dot3(const vector_t v0, const vector_t v1) {
+#if VECTOR_DETERMINISTIC
+	// Same order of additions and same result in all components as the other implementations
+	const vector_t r = _mm_mul_ps(v0, v1);
+	return _mm_add_ps(_mm_add_ps(vector_shuffle(r, VECTOR_MASK_XXXX), vector_shuffle(r, VECTOR_MASK_YYYY)),
+	                  vector_shuffle(r, VECTOR_MASK_ZZZZ));
+#else
 	return _mm_dp_ps(v0, v1, 0x77);
+#endif
 }
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
@@ -127,7 +138,7 @@ vector_cross3(const vector_t v0, const vector_t v1) {
 	vector_t v1yzx = vector_shuffle(v1, VECTOR_MASK_YZXW);
 	vector_t v0zxy = vector_shuffle(v0, VECTOR_MASK_ZXYW);
 	vector_t v1zxy = vector_shuffle(v1, VECTOR_MASK_ZXYW);
-#if FOUNDATION_ARCH_SSE4_FMA3
+#if FOUNDATION_ARCH_SSE4_FMA3 && !VECTOR_DETERMINISTIC
 	vector_t interm = vector_mul(v0yzx, v1zxy);
 	return _mm_fnmadd_ps(v0zxy, v1yzx, interm);
 #else
@@ -167,7 +178,7 @@ vector_neg(const vector_t v) {
 
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_muladd(const vector_t v0, const vector_t v1, const vector_t v2) {
-#if FOUNDATION_ARCH_SSE4_FMA3
+#if FOUNDATION_ARCH_SSE4_FMA3 && !VECTOR_DETERMINISTIC
 	return _mm_fmadd_ps(v0, v1, v2);
 #else
 	return vector_add(vector_mul(v0, v1), v2);
@@ -182,7 +193,7 @@ vector_scale(const vector_t v, const real s) {
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_lerp(const vector_t from, const vector_t to, const real factor) {
 	vector_t s = _mm_set1_ps(factor);
-#if FOUNDATION_ARCH_SSE4_FMA3
+#if FOUNDATION_ARCH_SSE4_FMA3 && !VECTOR_DETERMINISTIC
 	return _mm_fmadd_ps(to, s, _mm_fnmadd_ps(from, s, from));
 #else
 	return _mm_add_ps(_mm_mul_ps(s, to), _mm_sub_ps(from, _mm_mul_ps(s, from)));
@@ -273,6 +284,21 @@ vector_abs(const vector_t v) {
 	return _mm_and_ps(_mm_castsi128_ps(_mm_srli_epi32(_mm_set1_epi32(-1), 1)), v);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_floor(const vector_t v) {
+	return _mm_floor_ps(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_ceil(const vector_t v) {
+	return _mm_ceil_ps(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_round(const vector_t v) {
+	return _mm_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL real
 vector_x(const vector_t v) {
 	return *(const float32_t*)&v;
@@ -352,6 +378,107 @@ vectori_or(const vectori_t v0, const vectori_t v1) {
 	return _mm_or_si128(v0, v1);
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori(const int32_t x, const int32_t y, const int32_t z, const int32_t w) {
+	return _mm_setr_epi32(x, y, z, w);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_uniform(const int32_t v) {
+	return _mm_set1_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_add(const vectori_t v0, const vectori_t v1) {
+	return _mm_add_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_sub(const vectori_t v0, const vectori_t v1) {
+	return _mm_sub_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_mul(const vectori_t v0, const vectori_t v1) {
+	return _mm_mullo_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_min(const vectori_t v0, const vectori_t v1) {
+	return _mm_min_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_max(const vectori_t v0, const vectori_t v1) {
+	return _mm_max_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_xor(const vectori_t v0, const vectori_t v1) {
+	return _mm_xor_si128(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_andnot(const vectori_t v0, const vectori_t v1) {
+	return _mm_andnot_si128(v1, v0);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_left(const vectori_t v, const unsigned int count) {
+	return _mm_sll_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right(const vectori_t v, const unsigned int count) {
+	return _mm_sra_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_shift_right_logical(const vectori_t v, const unsigned int count) {
+	return _mm_srl_epi32(v, _mm_cvtsi32_si128((int)count));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_equal(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmpeq_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_less(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmplt_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_greater(const vectori_t v0, const vectori_t v1) {
+	return _mm_cmpgt_epi32(v0, v1);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vectori_select(const vectori_t mask, const vectori_t v0, const vectori_t v1) {
+	return _mm_blendv_epi8(v1, v0, mask);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori(const vector_t v) {
+	return _mm_cvttps_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_round(const vector_t v) {
+	// Default rounding mode is round to nearest even
+	return _mm_cvtps_epi32(v);
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
+vector_to_vectori_floor(const vector_t v) {
+	return _mm_cvttps_epi32(vector_floor(v));
+}
+
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vectori_to_vector(const vectori_t v) {
+	return _mm_cvtepi32_ps(v);
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vectori_t
 vector_equal(const vector_t v0, const vector_t v1) {
 	return _mm_castps_si128(_mm_cmpeq_ps(v0, v1));
@@ -377,6 +504,11 @@ vector_greater(const vector_t v0, const vector_t v1) {
 	return _mm_castps_si128(_mm_cmpgt_ps(v0, v1));
 }
 
+static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
+vector_select(const vectori_t mask, const vector_t v0, const vector_t v1) {
+	return _mm_blendv_ps(v1, v0, _mm_castsi128_ps(mask));
+}
+
 static FOUNDATION_FORCEINLINE FOUNDATION_CONSTCALL vector_t
 vector_rotate(const vector_t v, const matrix_t m) {
 	vector_t vr;